@@ -0,0 +1,223 @@
+#pragma once
+
+/// @file anomaly.hpp
+/// @brief Kinematic plausibility checks on incoming reports.
+///
+/// @code
+///   QuarantineBatch  header | count u32 | count × (flags u8 | TrackUpdate record)
+/// @endcode
+///
+/// Every report is compared with the last accepted state of its target:
+///
+///   teleport        horizontal distance > max_speed · dt + slack_m
+///   acceleration    |velocity change|   > max_accel · dt + slack_mps
+///   altitude spike  |altitude change|   > max_climb · dt + slack_m
+///
+/// A batch is checked in three passes: gather each report and its
+/// target's baseline into contiguous arrays (one hash lookup per report),
+/// run the checks over the arrays in one branch-free loop the compiler
+/// vectorises, then move baselines forward. Suspect reports do not move
+/// their baseline, so a spoofed position cannot drag the track with it;
+/// after rebase_after suspects in a row the target is taken to have
+/// really moved and the latest report becomes the baseline.
+///
+/// Distances use a flat plane around the baseline (adequate between
+/// consecutive reports).
+///
+/// Demonstrates:
+/// - Gather to structure-of-arrays, then a vectorised check loop
+/// - Bit flags built from comparisons without branches
+/// - Trivial Class Pattern with Builder Methods for configuration
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "track.hpp"
+#include "wire.hpp"
+
+namespace protocol {
+
+/// Anomaly bits (a report may carry several).
+constexpr std::uint8_t kAnomalyTeleport = 0x01;
+constexpr std::uint8_t kAnomalyAcceleration = 0x02;
+constexpr std::uint8_t kAnomalyAltitude = 0x04;
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// AnomalyConfig — Trivial Class Pattern with Builder Methods
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Physical limits and measurement slack.
+struct AnomalyConfig {
+    // Rule of Six: All Default
+    AnomalyConfig() = default;
+    ~AnomalyConfig() = default;
+    AnomalyConfig(const AnomalyConfig&) = default;
+    AnomalyConfig& operator=(const AnomalyConfig&) = default;
+    AnomalyConfig(AnomalyConfig&&) noexcept = default;
+    AnomalyConfig& operator=(AnomalyConfig&&) noexcept = default;
+
+    float max_speed_mps{1500.0F};     ///< Fastest plausible ground speed
+    float max_accel_mps2{150.0F};     ///< Largest plausible velocity change rate
+    float max_climb_mps{400.0F};      ///< Fastest plausible altitude change
+    float slack_m{50.0F};             ///< Position noise allowed at any dt
+    float slack_mps{10.0F};           ///< Velocity noise allowed at any dt
+
+    /// Consecutive suspects after which the latest becomes the baseline.
+    std::uint32_t rebase_after{3};
+
+    [[nodiscard]] auto with_max_speed(float mps) && -> AnomalyConfig {
+        max_speed_mps = mps;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_max_accel(float mps2) && -> AnomalyConfig {
+        max_accel_mps2 = mps2;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_max_climb(float mps) && -> AnomalyConfig {
+        max_climb_mps = mps;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_rebase_after(std::uint32_t n) && -> AnomalyConfig {
+        rebase_after = n;
+        return std::move(*this);
+    }
+};
+
+/// What check() found.
+struct AnomalyCounts {
+    std::uint64_t checked{0};
+    std::uint64_t suspect{0};         ///< Reports with any flag
+    std::uint64_t teleports{0};
+    std::uint64_t accelerations{0};
+    std::uint64_t altitude{0};
+    std::uint64_t rebased{0};         ///< Suspects accepted as the new baseline
+
+    auto operator+=(const AnomalyCounts& o) noexcept -> AnomalyCounts& {
+        checked += o.checked;
+        suspect += o.suspect;
+        teleports += o.teleports;
+        accelerations += o.accelerations;
+        altitude += o.altitude;
+        rebased += o.rebased;
+        return *this;
+    }
+};
+
+/// A quarantined report and why.
+struct Suspect {
+    TrackUpdate report;
+    std::uint8_t flags{0};
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// AnomalyDetector — Per-Target Baselines, Batched Checks
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Holds a hash map and scratch vectors (value type)
+// • Scratch pointers are only live inside check(), so copies are safe
+// • Compiler-generated operations are correct
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Streaming kinematic anomaly detector.
+///
+/// @par Thread Safety
+/// Not thread-safe (check() reuses scratch).
+///
+/// @par Example
+/// @code
+/// AnomalyDetector detector{AnomalyConfig{}};
+/// std::vector<std::uint8_t> flags;
+/// detector.check(batch, flags);   // flags[i] != 0: quarantine batch[i]
+/// @endcode
+class AnomalyDetector {
+public:
+    // Rule of Six: All Default
+    AnomalyDetector() = default;
+    ~AnomalyDetector() = default;
+    AnomalyDetector(const AnomalyDetector&) = default;
+    AnomalyDetector& operator=(const AnomalyDetector&) = default;
+    AnomalyDetector(AnomalyDetector&&) noexcept = default;
+    AnomalyDetector& operator=(AnomalyDetector&&) noexcept = default;
+
+    explicit AnomalyDetector(const AnomalyConfig& cfg) : cfg_{cfg} {}
+
+    /// Check `reports` in order; `flags` is resized to match (0 = clean).
+    /// A target's first report is clean and becomes its baseline.
+    auto check(std::span<const TrackUpdate> reports, std::vector<std::uint8_t>& flags) -> AnomalyCounts;
+
+    /// Drop a target's baseline (e.g. when the track is dropped).
+    void forget(std::uint64_t target_id) { baseline_.erase(target_id); }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return baseline_.size(); }
+    [[nodiscard]] auto config() const noexcept -> const AnomalyConfig& { return cfg_; }
+
+private:
+    struct Baseline {
+        TrackUpdate state;
+        double ref_lat{0.0};          ///< Latitude m_per_deg_lon was computed at
+        float m_per_deg_lon{0.0F};
+        std::uint32_t suspects{0};    ///< In a row
+    };
+
+    AnomalyConfig cfg_;
+    std::unordered_map<std::uint64_t, Baseline> baseline_;
+
+    // Per-batch scratch: deltas from the baseline, then one flag word each
+    std::vector<float> dt_, dx_, dy_, dz_, dvn_, dve_, dvu_;
+    std::vector<std::uint32_t> bits_;
+    std::vector<Baseline*> at_;
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Codecs
+// ═══════════════════════════════════════════════════════════════════════════
+
+[[nodiscard]] inline auto encode_quarantine(std::span<const Suspect> suspects) -> std::string {
+    wire::ByteWriter w{wire::FrameKind::QuarantineBatch, 0,
+                       wire::kHeaderSize + 4 + suspects.size() * (1 + kTrackRecordSize)};
+    w.put_u32(static_cast<std::uint32_t>(suspects.size()));
+    for (const auto& s : suspects) {
+        w.put_u8(s.flags);
+        encode_track(w, s.report);
+    }
+    return std::move(w).take();
+}
+
+/// Decode QuarantineBatch. Returns nullopt on malformed input.
+[[nodiscard]] inline auto decode_quarantine(std::string_view frame) -> std::optional<std::vector<Suspect>> {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    if (!header || header->kind != wire::FrameKind::QuarantineBatch) {
+        return std::nullopt;
+    }
+    const auto count = r.get_u32();
+    if (!r.ok() || r.remaining() < static_cast<std::size_t>(count) * (1 + kTrackRecordSize)) {
+        return std::nullopt;
+    }
+    std::vector<Suspect> out(count);
+    for (auto& s : out) {
+        s.flags = r.get_u8();
+        s.report = decode_track(r);
+    }
+    if (!r.ok()) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+}  // namespace protocol
@@ -0,0 +1,283 @@
+#pragma once
+
+/// @file columnar.hpp
+/// @brief Columnar track files for analytics, and a journal exporter.
+///
+/// Rows are cut into row groups; each group stores one chunk per column
+/// with min/max statistics, so a reader decodes only the columns it asks
+/// for and can skip whole groups on their statistics.
+///
+/// @code
+///   header   magic u32 "TCOL" | version u16 | columns u16 | group_rows u32
+///   chunks   column data, group by group, column by column
+///   footer   groups u32, then per group: rows u32, then per column:
+///              encoding u8 | offset u64 | bytes u32 | min u64 | max u64
+///   trailer  footer_offset u64 | magic u32
+/// @endcode
+///
+/// Encodings (chosen per chunk; bit-packed data is padded by 8 bytes so
+/// every value is read with one unaligned 64-bit load):
+/// - Plain         little-endian values
+/// - DeltaBitPack  base i64 | width u8 | zigzag deltas, `width` bits each
+/// - Dictionary    entries u32 | entry u64… | width u8 | indices, `width` bits each
+/// - BitPack       base u64 | width u8 | (value − base), `width` bits each
+///
+/// Statistics are stored as raw 64-bit patterns: two's complement for the
+/// integer columns, IEEE-754 double for Lat, Lon and Alt.
+///
+/// Demonstrates:
+/// - Column chunks with zone-map statistics
+/// - Delta, frame-of-reference bit-packing and dictionary encodings
+/// - Branch-free decode loops over a read-only mapping
+/// - Rule of Six: Move-only writer (owns a file) and reader (owns a mapping)
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "posix_file.hpp"
+#include "track.hpp"
+
+namespace protocol {
+
+// ───────────────────────────────────────────────────────────────────────────
+// Columns and Encodings
+// ───────────────────────────────────────────────────────────────────────────
+
+/// Exported fields, in file order.
+enum class Column : std::uint8_t {
+    Time    = 0,   ///< TrackUpdate::time_ns (i64)
+    Id      = 1,   ///< TrackUpdate::target_id (u64)
+    Lat     = 2,   ///< f64
+    Lon     = 3,   ///< f64
+    Alt     = 4,   ///< f32
+    Urgency = 5    ///< u8
+};
+
+constexpr std::size_t kColumnCount = 6;
+
+/// Set of columns to decode (bit per Column).
+using ColumnMask = std::uint8_t;
+
+[[nodiscard]] constexpr auto column_bit(Column c) noexcept -> ColumnMask {
+    return static_cast<ColumnMask>(1U << static_cast<unsigned>(c));
+}
+
+constexpr ColumnMask kAllColumns = (1U << kColumnCount) - 1;
+
+enum class ColumnEncoding : std::uint8_t {
+    Plain        = 0,
+    DeltaBitPack = 1,
+    Dictionary   = 2,
+    BitPack      = 3
+};
+
+[[nodiscard]] constexpr auto to_string(Column c) noexcept -> std::string_view {
+    switch (c) {
+        case Column::Time:    return "time";
+        case Column::Id:      return "id";
+        case Column::Lat:     return "lat";
+        case Column::Lon:     return "lon";
+        case Column::Alt:     return "alt";
+        case Column::Urgency: return "urgency";
+    }
+    return "?";
+}
+
+/// File layout constants.
+constexpr std::uint32_t kColumnarMagic = 0x4C4F4354;   // "TCOL" little-endian
+constexpr std::uint16_t kColumnarVersion = 1;
+constexpr std::size_t kColumnarHeaderSize = 4 + 2 + 2 + 4;
+constexpr std::size_t kColumnarTrailerSize = 8 + 4;
+
+/// Rows per row group (~1.3 MB of decoded columns).
+constexpr std::uint32_t kColumnarGroupRows = 1U << 16;
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// File Metadata
+// ───────────────────────────────────────────────────────────────────────────
+
+/// Where one column chunk lives and what it holds.
+struct ChunkInfo {
+    ColumnEncoding encoding{ColumnEncoding::Plain};
+    std::uint64_t offset{0};
+    std::uint32_t bytes{0};
+    std::uint64_t min_bits{0};
+    std::uint64_t max_bits{0};
+
+    [[nodiscard]] auto min_i64() const noexcept -> std::int64_t { return static_cast<std::int64_t>(min_bits); }
+    [[nodiscard]] auto max_i64() const noexcept -> std::int64_t { return static_cast<std::int64_t>(max_bits); }
+    [[nodiscard]] auto min_f64() const noexcept -> double { return std::bit_cast<double>(min_bits); }
+    [[nodiscard]] auto max_f64() const noexcept -> double { return std::bit_cast<double>(max_bits); }
+};
+
+/// One row group: row count and a chunk per column.
+struct RowGroupInfo {
+    std::uint32_t rows{0};
+    std::array<ChunkInfo, kColumnCount> chunks{};
+
+    [[nodiscard]] auto chunk(Column c) const noexcept -> const ChunkInfo& {
+        return chunks[static_cast<std::size_t>(c)];
+    }
+};
+
+/// Decoded columns; only the requested ones are filled.
+struct ColumnData {
+    std::vector<std::int64_t> time;
+    std::vector<std::uint64_t> id;
+    std::vector<double> lat;
+    std::vector<double> lon;
+    std::vector<float> alt;
+    std::vector<std::uint8_t> urgency;
+};
+
+/// What an export or write produced.
+struct ColumnarFileStats {
+    std::uint64_t rows{0};
+    std::uint32_t groups{0};
+    std::uint64_t bytes{0};                                   ///< Whole file
+    std::array<std::uint64_t, kColumnCount> column_bytes{};   ///< Encoded chunk bytes per column
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ColumnarWriter — Move-Only Resource Class
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Owns the PosixFile of a file being written (move-only)
+// • Destructor: an unfinished file is removed, never left half-written
+// • Copy ops: DELETED (implicitly, via PosixFile)
+//
+// FLOW:
+// • Rows are buffered column-wise; every group_rows rows the group is
+//   encoded and written
+// • finish() writes the footer, syncs, and renames `<path>.tmp` to `path`
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Streaming columnar file writer.
+///
+/// @par Thread Safety
+/// Not thread-safe.
+class ColumnarWriter {
+public:
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: Move-Only Pattern
+    // ───────────────────────────────────────────────────────────────────────
+
+    ColumnarWriter() = delete;
+    ~ColumnarWriter();
+    ColumnarWriter(const ColumnarWriter&) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+    ColumnarWriter(ColumnarWriter&&) noexcept = default;
+    ColumnarWriter& operator=(ColumnarWriter&&) noexcept = default;
+
+    /// Start writing `path` (via `<path>.tmp`).
+    ///
+    /// @throws std::system_error on I/O failure
+    /// @throws std::invalid_argument if group_rows is 0
+    [[nodiscard]] static auto create(std::filesystem::path path,
+                                     std::uint32_t group_rows = kColumnarGroupRows) -> ColumnarWriter;
+
+    /// Buffer one row; writes a row group when it fills.
+    void append(const TrackUpdate& t);
+
+    /// Write the remaining rows and the footer, then publish the file.
+    auto finish() -> ColumnarFileStats;
+
+private:
+    ColumnarWriter(std::filesystem::path path, std::uint32_t group_rows, PosixFile file);
+
+    void write_group();
+
+    std::filesystem::path path_;
+    std::filesystem::path tmp_;
+    std::uint32_t group_rows_{kColumnarGroupRows};
+    PosixFile file_;
+    std::uint64_t offset_{0};
+    ColumnData pending_;
+    std::vector<RowGroupInfo> groups_;
+    ColumnarFileStats stats_;
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ColumnarReader — Move-Only Resource Class
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Owns the file's MappedFile (move-only)
+// • Default ctor: DELETED (use open())
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Column-selective reader over a mapped columnar file.
+///
+/// @par Thread Safety
+/// Const member functions may be called concurrently.
+///
+/// @par Example
+/// @code
+/// const auto file = ColumnarReader::open("mission.tcol");
+/// ColumnData cols;
+/// for (std::size_t g = 0; g < file.groups().size(); ++g) {
+///     if (file.groups()[g].chunk(Column::Time).max_i64() < from_ns) continue;
+///     file.read_group(g, column_bit(Column::Time) | column_bit(Column::Lat), cols);
+/// }
+/// @endcode
+class ColumnarReader {
+public:
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: Move-Only Pattern
+    // ───────────────────────────────────────────────────────────────────────
+
+    ColumnarReader() = delete;
+    ~ColumnarReader() = default;
+    ColumnarReader(const ColumnarReader&) = delete;
+    ColumnarReader& operator=(const ColumnarReader&) = delete;
+    ColumnarReader(ColumnarReader&&) noexcept = default;
+    ColumnarReader& operator=(ColumnarReader&&) noexcept = default;
+
+    /// Map `path` and parse its footer.
+    ///
+    /// @throws std::system_error if the file cannot be mapped
+    /// @throws std::runtime_error if it is not a valid columnar file
+    [[nodiscard]] static auto open(const std::filesystem::path& path) -> ColumnarReader;
+
+    /// Append the requested columns of row group `g` to `out`.
+    ///
+    /// @throws std::runtime_error if a chunk is malformed
+    void read_group(std::size_t g, ColumnMask columns, ColumnData& out) const;
+
+    /// Decode the requested columns of every row group.
+    [[nodiscard]] auto read(ColumnMask columns) const -> ColumnData;
+
+    [[nodiscard]] auto rows() const noexcept -> std::uint64_t { return rows_; }
+    [[nodiscard]] auto groups() const noexcept -> const std::vector<RowGroupInfo>& { return groups_; }
+
+private:
+    ColumnarReader(MappedFile file, std::vector<RowGroupInfo> groups, std::uint64_t rows);
+
+    MappedFile file_;
+    std::vector<RowGroupInfo> groups_;
+    std::uint64_t rows_{0};
+};
+
+
+/// Convert every record of the journal segments in `journal_dir` to a
+/// columnar file at `out`.
+///
+/// @throws std::system_error on I/O failure
+[[nodiscard]] auto export_journal_columnar(const std::filesystem::path& journal_dir,
+                                           const std::filesystem::path& out,
+                                           std::uint32_t group_rows = kColumnarGroupRows)
+    -> ColumnarFileStats;
+
+}  // namespace protocol
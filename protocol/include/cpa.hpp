@@ -0,0 +1,193 @@
+#pragma once
+
+/// @file cpa.hpp
+/// @brief Closest-point-of-approach screening for every pair of tracks.
+///
+/// @code
+///   CpaAlert  header | count u32 | count × Alert
+///   Alert     target_a u64 | target_b u64 | t_cpa_s f32 | miss_m f32 | urgency u8
+/// @endcode
+///
+/// Each track is propagated to the screening time and then along its
+/// velocity for the horizon; the segment it sweeps, grown by half the
+/// alert distance on every side, is binned into a uniform grid of the
+/// local plane. Two tracks can only come within the distance if their
+/// grown boxes overlap, so only pairs sharing a cell are evaluated, each
+/// in exactly one cell (the one holding the lower corner of the boxes'
+/// overlap). Cells are screened in parallel on a TaskPool. A track whose
+/// box spans more than a few dozen cells on an axis (far faster than the
+/// rest) is left out of the grid and checked against every overlapping
+/// box instead, so binning stays linear. Reports that fail is_plausible()
+/// or are stamped more than max_age from now are not screened.
+///
+/// Positions are projected onto a flat plane around the tracks' centroid
+/// (equirectangular, longitude wrapped at ±180°; adequate over a few
+/// hundred km) and evaluated in single precision relative to it.
+///
+/// Demonstrates:
+/// - Uniform-grid broad phase with single-owner pair deduplication
+/// - Structure-of-arrays narrow phase written for auto-vectorisation
+/// - Parallel tiles with TaskPool::parallel_for and per-tile results
+/// - Trivial Class Pattern with Builder Methods for screening parameters
+/// - Binary alert frames for subscribed consoles
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "protocol.hpp"
+#include "task_pool.hpp"
+#include "track.hpp"
+#include "wire.hpp"
+
+namespace protocol {
+
+using namespace std::chrono_literals;
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// CpaConfig — Trivial Class Pattern with Builder Methods
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Which approaches to report, and how urgently.
+struct CpaConfig {
+    // Rule of Six: All Default
+    CpaConfig() = default;
+    ~CpaConfig() = default;
+    CpaConfig(const CpaConfig&) = default;
+    CpaConfig& operator=(const CpaConfig&) = default;
+    CpaConfig(CpaConfig&&) noexcept = default;
+    CpaConfig& operator=(CpaConfig&&) noexcept = default;
+
+    /// Report pairs predicted to come within this distance (metres, 3-D).
+    double distance_m{500.0};
+
+    /// ...within this time of the screening instant.
+    std::chrono::milliseconds horizon{60s};
+
+    /// Approaches closer in time than this are Red; later ones Yellow.
+    std::chrono::milliseconds red_within{15s};
+
+    /// Tracks not updated for this long are left out (their extrapolation
+    /// is no longer meaningful).
+    std::chrono::milliseconds max_age{30s};
+
+    /// Screening period when run by the server.
+    std::chrono::milliseconds interval{1s};
+
+    [[nodiscard]] auto with_distance(double metres) && -> CpaConfig {
+        distance_m = metres;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_horizon(std::chrono::milliseconds h) && -> CpaConfig {
+        horizon = h;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_red_within(std::chrono::milliseconds r) && -> CpaConfig {
+        red_within = r;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_max_age(std::chrono::milliseconds a) && -> CpaConfig {
+        max_age = a;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_interval(std::chrono::milliseconds i) && -> CpaConfig {
+        interval = i;
+        return std::move(*this);
+    }
+};
+
+/// One predicted approach (target_a < target_b).
+struct CpaConflict {
+    std::uint64_t target_a{0};
+    std::uint64_t target_b{0};
+    float t_cpa_s{0.0F};      ///< Seconds from the screening instant to closest approach
+    float miss_m{0.0F};       ///< Predicted separation at closest approach
+    Urgency urgency{Urgency::Yellow};
+};
+
+/// What a screening pass cost.
+struct CpaStats {
+    std::size_t tracks{0};              ///< Screened (after the age and plausibility filter)
+    std::size_t cells{0};               ///< Occupied grid cells
+    std::size_t wide{0};                ///< Tracks too wide to bin, screened against all
+    double cell_m{0.0};                 ///< Grid cell edge
+    std::uint64_t candidate_pairs{0};   ///< Pairs evaluated by the narrow phase
+    std::chrono::microseconds elapsed{0};
+};
+
+/// Conflicts, most urgent and soonest first.
+struct CpaResult {
+    std::vector<CpaConflict> conflicts;
+    CpaStats stats;
+};
+
+/// Screen `tracks` for approaches within `cfg` as seen at `now_ns`.
+///
+/// Blocks until done; safe to call from a worker of `pool`.
+[[nodiscard]] auto screen_cpa(std::span<const TrackUpdate> tracks,
+                              std::int64_t now_ns,
+                              const CpaConfig& cfg,
+                              exec::TaskPool& pool) -> CpaResult;
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Codecs
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Encoded size of one alert record.
+constexpr std::size_t kCpaAlertSize = 8 + 8 + 4 + 4 + 1;
+
+[[nodiscard]] inline auto encode_cpa_alerts(std::span<const CpaConflict> alerts) -> std::string {
+    wire::ByteWriter w{wire::FrameKind::CpaAlert, 0, wire::kHeaderSize + 4 + alerts.size() * kCpaAlertSize};
+    w.put_u32(static_cast<std::uint32_t>(alerts.size()));
+    for (const auto& a : alerts) {
+        w.put_u64(a.target_a);
+        w.put_u64(a.target_b);
+        w.put_f32(a.t_cpa_s);
+        w.put_f32(a.miss_m);
+        w.put_u8(static_cast<std::uint8_t>(a.urgency));
+    }
+    return std::move(w).take();
+}
+
+/// Decode CpaAlert. Returns nullopt on malformed input.
+[[nodiscard]] inline auto decode_cpa_alerts(std::string_view frame) -> std::optional<std::vector<CpaConflict>> {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    if (!header || header->kind != wire::FrameKind::CpaAlert) {
+        return std::nullopt;
+    }
+    const auto count = r.get_u32();
+    if (!r.ok() || r.remaining() < static_cast<std::size_t>(count) * kCpaAlertSize) {
+        return std::nullopt;
+    }
+    std::vector<CpaConflict> out(count);
+    for (auto& a : out) {
+        a.target_a = r.get_u64();
+        a.target_b = r.get_u64();
+        a.t_cpa_s = r.get_f32();
+        a.miss_m = r.get_f32();
+        const auto urgency = r.get_u8();
+        if (urgency > static_cast<std::uint8_t>(Urgency::Red)) {
+            return std::nullopt;
+        }
+        a.urgency = static_cast<Urgency>(urgency);
+    }
+    if (!r.ok()) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+}  // namespace protocol
@@ -0,0 +1,204 @@
+#pragma once
+
+/// @file dedup.hpp
+/// @brief Time-windowed duplicate suppression for sensor reports.
+///
+/// Redundant sensors and multi-path links deliver the same report more than
+/// once. TrackBatch carries no per-report sequence, so a report is keyed by
+/// a hash of its content (report_key()); a copy arriving within the window
+/// of the first is a duplicate.
+///
+/// The filter is a fixed-size table of 32-bit fingerprints in 4-slot
+/// buckets. As in a cuckoo filter each key has two candidate buckets (the
+/// second derived from the first and the fingerprint), but entries are
+/// never relocated: each slot carries the tick it was written and an
+/// expired or, failing that, the oldest slot is overwritten. Lookups and
+/// inserts touch 8 slots — O(1), no allocation after construction.
+///
+/// A live entry evicted by an overfull table lets a late copy through
+/// (see evictions()); a distinct report is wrongly dropped with
+/// probability ~8 / 2^32.
+///
+/// Demonstrates:
+/// - Content-hash keys over the fixed record fields
+/// - Cuckoo-style partial-key bucket pairs without kicking
+/// - Wrapping 32-bit time stamps for window expiry
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "hash_ring.hpp"
+#include "track.hpp"
+
+namespace protocol {
+
+using namespace std::chrono_literals;
+
+/// Content key of one report: every field of the encoded record.
+[[nodiscard]] inline auto report_key(const TrackUpdate& t) noexcept -> std::uint64_t {
+    auto h = mix64(t.target_id);
+    h = mix64(h ^ static_cast<std::uint64_t>(t.time_ns));
+    h = mix64(h ^ std::bit_cast<std::uint64_t>(t.lat));
+    h = mix64(h ^ std::bit_cast<std::uint64_t>(t.lon));
+    h = mix64(h ^ (std::uint64_t{std::bit_cast<std::uint32_t>(t.alt)} << 32
+                   | std::bit_cast<std::uint32_t>(t.vn)));
+    h = mix64(h ^ (std::uint64_t{std::bit_cast<std::uint32_t>(t.ve)} << 32
+                   | std::bit_cast<std::uint32_t>(t.vu)));
+    return mix64(h ^ static_cast<std::uint64_t>(t.urgency));
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DedupConfig — Trivial Class Pattern with Builder Methods
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Filter window and size.
+struct DedupConfig {
+    // Rule of Six: All Default
+    DedupConfig() = default;
+    ~DedupConfig() = default;
+    DedupConfig(const DedupConfig&) = default;
+    DedupConfig& operator=(const DedupConfig&) = default;
+    DedupConfig(DedupConfig&&) noexcept = default;
+    DedupConfig& operator=(DedupConfig&&) noexcept = default;
+
+    /// How long after its first arrival a copy still counts as a duplicate.
+    std::chrono::milliseconds window{5s};
+
+    /// Slots (rounded up to a power of two); 8 bytes each. Size for the
+    /// reports expected within one window, with headroom.
+    std::size_t capacity{1U << 17};
+
+    [[nodiscard]] auto with_window(std::chrono::milliseconds w) && -> DedupConfig {
+        window = w;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_capacity(std::size_t n) && -> DedupConfig {
+        capacity = n;
+        return std::move(*this);
+    }
+};
+
+/// Reports seen and dropped, e.g. per origin.
+struct DedupCounts {
+    std::uint64_t reports{0};
+    std::uint64_t duplicates{0};
+
+    [[nodiscard]] auto duplicate_ratio() const noexcept -> double {
+        return reports > 0 ? static_cast<double>(duplicates) / static_cast<double>(reports) : 0.0;
+    }
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DedupFilter — Fixed-Memory Windowed Fingerprint Table
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Holds a vector of buckets and plain counters (value type)
+// • Compiler-generated operations are correct
+//
+// TIME:
+// • Stamps are wall-clock ns >> kTickShift (~1 ms ticks) truncated to
+//   32 bits; ages use wrapping subtraction, good for ~52 days
+// • A clock step backwards makes entries look expired, never fresh
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Remembers report keys for one window.
+///
+/// @par Thread Safety
+/// Not thread-safe.
+class DedupFilter {
+public:
+    static constexpr std::size_t kBucketSlots = 4;
+    static constexpr unsigned kTickShift = 20;
+
+    // Rule of Six: All Default
+    DedupFilter() : DedupFilter{DedupConfig{}} {}
+    ~DedupFilter() = default;
+    DedupFilter(const DedupFilter&) = default;
+    DedupFilter& operator=(const DedupFilter&) = default;
+    DedupFilter(DedupFilter&&) noexcept = default;
+    DedupFilter& operator=(DedupFilter&&) noexcept = default;
+
+    explicit DedupFilter(const DedupConfig& cfg)
+        : cfg_{cfg}
+        , buckets_(std::bit_ceil(std::max<std::size_t>(cfg.capacity / kBucketSlots, 2)))
+        , window_ticks_{static_cast<std::uint32_t>(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(cfg.window).count() >> kTickShift)}
+    {}
+
+    /// True if `key` was recorded within the window before `now_ns`;
+    /// otherwise records it and returns false.
+    auto seen(std::uint64_t key, std::int64_t now_ns) noexcept -> bool {
+        const auto fp = fingerprint(key);
+        const auto mask = buckets_.size() - 1;
+        const auto i1 = static_cast<std::size_t>(key) & mask;
+        const auto i2 = (i1 ^ static_cast<std::size_t>(mix64(fp))) & mask;
+        const auto tick = static_cast<std::uint32_t>(static_cast<std::uint64_t>(now_ns) >> kTickShift);
+
+        constexpr auto kFree = std::numeric_limits<std::uint32_t>::max();
+        Slot* victim = nullptr;
+        std::uint32_t victim_age = 0;
+        for (auto* bucket : {&buckets_[i1], &buckets_[i2]}) {
+            for (auto& slot : *bucket) {
+                const std::uint32_t age = tick - slot.stamp;
+                const bool live = slot.fingerprint != 0 && age <= window_ticks_;
+                if (live && slot.fingerprint == fp) {
+                    ++stats_.duplicates;
+                    ++stats_.reports;
+                    return true;
+                }
+                // Prefer a free slot, then the oldest
+                const auto score = live ? age : kFree;
+                if (!victim || score > victim_age) {
+                    victim = &slot;
+                    victim_age = score;
+                }
+            }
+        }
+        if (victim_age != kFree) {
+            ++evictions_;
+        }
+        *victim = Slot{fp, tick};
+        ++stats_.reports;
+        return false;
+    }
+
+    [[nodiscard]] auto stats() const noexcept -> const DedupCounts& { return stats_; }
+
+    /// Live entries overwritten because both buckets were full (a rising
+    /// count means capacity is too small for the window).
+    [[nodiscard]] auto evictions() const noexcept -> std::uint64_t { return evictions_; }
+
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t { return buckets_.size() * kBucketSlots; }
+    [[nodiscard]] auto config() const noexcept -> const DedupConfig& { return cfg_; }
+
+private:
+    struct Slot {
+        std::uint32_t fingerprint{0};   ///< 0 = empty
+        std::uint32_t stamp{0};
+    };
+    using Bucket = std::array<Slot, kBucketSlots>;
+
+    [[nodiscard]] static constexpr auto fingerprint(std::uint64_t key) noexcept -> std::uint32_t {
+        const auto fp = static_cast<std::uint32_t>(key >> 32);
+        return fp != 0 ? fp : 1;
+    }
+
+    DedupConfig cfg_;
+    std::vector<Bucket> buckets_;
+    std::uint32_t window_ticks_{0};
+    DedupCounts stats_;
+    std::uint64_t evictions_{0};
+};
+
+}  // namespace protocol
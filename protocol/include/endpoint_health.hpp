@@ -0,0 +1,273 @@
+#pragma once
+
+/// @file endpoint_health.hpp
+/// @brief Health scoring and selection across redundant server endpoints.
+///
+/// Demonstrates:
+/// - EWMA RTT and failure-rate scoring per endpoint
+/// - Exponential cooldown so a dead endpoint is skipped, not waited on
+/// - Periodic probing of endpoints that have recovered
+/// - Clock as a template parameter for deterministic testing
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace protocol::health {
+
+using namespace std::chrono_literals;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Configuration & Report
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Scoring and cooldown parameters.
+struct EndpointHealthConfig {
+    // Rule of Six: All Default (trivial aggregate)
+    EndpointHealthConfig() = default;
+    ~EndpointHealthConfig() = default;
+    EndpointHealthConfig(const EndpointHealthConfig&) = default;
+    EndpointHealthConfig& operator=(const EndpointHealthConfig&) = default;
+    EndpointHealthConfig(EndpointHealthConfig&&) noexcept = default;
+    EndpointHealthConfig& operator=(EndpointHealthConfig&&) noexcept = default;
+
+    /// EWMA weight of the newest RTT sample and attempt outcome.
+    double alpha{0.3};
+
+    /// Score multiplier per unit of failure rate (score = rtt × (1 + w × rate)).
+    double failure_weight{4.0};
+
+    /// RTT assumed for an endpoint never reached.
+    std::chrono::microseconds initial_rtt{50ms};
+
+    /// Cooldown after the first consecutive failure; doubles per failure.
+    std::chrono::milliseconds cooldown{1s};
+
+    /// Upper bound on the cooldown.
+    std::chrono::milliseconds max_cooldown{30s};
+
+    /// Minimum interval between probes of one endpoint.
+    std::chrono::milliseconds probe_interval{10s};
+
+    [[nodiscard]] auto with_cooldown(std::chrono::milliseconds base, std::chrono::milliseconds max) && -> EndpointHealthConfig {
+        cooldown = base;
+        max_cooldown = max;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_probe_interval(std::chrono::milliseconds d) && -> EndpointHealthConfig {
+        probe_interval = d;
+        return std::move(*this);
+    }
+};
+
+/// Point-in-time health of one endpoint.
+struct EndpointReport {
+    std::size_t index{0};
+    double score{0.0};                       ///< Lower is better
+    std::chrono::microseconds rtt{0};        ///< Smoothed handshake/pong RTT
+    double failure_rate{0.0};                ///< EWMA of attempt outcomes (1 = failed)
+    std::uint64_t attempts{0};
+    std::uint64_t failures{0};
+    std::uint64_t drops{0};                  ///< Established connections lost
+    bool cooling{false};                     ///< Skipped until its cooldown ends
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// EndpointSelector — Ranked Endpoint Choice
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// ORDER:
+// Endpoints outside their cooldown, best score first (ties keep the
+// configured order, so the first endpoint is the preferred primary); then
+// cooling endpoints by cooldown expiry. A caller sweeps the ranking in one
+// go, so a dead endpoint costs one failed attempt, never a backoff.
+//
+// DROPS:
+// Losing an established connection counts as a failure and starts a
+// cooldown, so the reconnect that follows goes to another endpoint.
+//
+// RULE OF SIX RATIONALE:
+// • Contains a vector of PODs and a config
+// • Compiler-generated operations are correct
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Health-scored endpoint ranking.
+///
+/// @par Thread Safety
+/// Not thread-safe; owned by one client on one executor.
+///
+/// @tparam ClockT Monotonic clock (steady_clock in production)
+template<typename ClockT = std::chrono::steady_clock>
+class EndpointSelector {
+public:
+    using clock = ClockT;
+    using time_point = typename ClockT::time_point;
+    using duration = typename ClockT::duration;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: All Defaulted
+    // ───────────────────────────────────────────────────────────────────────
+
+    EndpointSelector() = default;
+    ~EndpointSelector() = default;
+    EndpointSelector(const EndpointSelector&) = default;
+    EndpointSelector& operator=(const EndpointSelector&) = default;
+    EndpointSelector(EndpointSelector&&) noexcept = default;
+    EndpointSelector& operator=(EndpointSelector&&) noexcept = default;
+
+    explicit EndpointSelector(std::size_t endpoints, EndpointHealthConfig cfg = {})
+        : cfg_{std::move(cfg)}
+        , state_(endpoints, State{cfg_.initial_rtt})
+    {}
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Selection
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Endpoint indices in the order they should be tried.
+    [[nodiscard]] auto ranked(time_point now) const -> std::vector<std::size_t> {
+        std::vector<std::size_t> order(state_.size());
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            const bool ca = cooling(a, now);
+            const bool cb = cooling(b, now);
+            if (ca != cb) {
+                return cb;
+            }
+            if (ca) {
+                return state_[a].cooldown_until < state_[b].cooldown_until;
+            }
+            return score(a) < score(b);
+        });
+        return order;
+    }
+
+    /// An endpoint other than `current` worth a background probe: out of
+    /// cooldown, previously failed, and not probed within probe_interval.
+    [[nodiscard]] auto probe_candidate(std::optional<std::size_t> current, time_point now)
+        -> std::optional<std::size_t>
+    {
+        for (const auto i : ranked(now)) {
+            auto& s = state_[i];
+            if (i == current || cooling(i, now) || s.failures == 0) {
+                continue;
+            }
+            if (s.probed && now - *s.probed < cfg_.probe_interval) {
+                continue;
+            }
+            s.probed = now;
+            return i;
+        }
+        return std::nullopt;
+    }
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Outcomes
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Connection established; `handshake` is the time it took.
+    void on_success(std::size_t i, duration handshake) {
+        auto& s = state_[i];
+        ++s.attempts;
+        s.consecutive_failures = 0;
+        s.cooldown_until = time_point{};
+        s.failure_rate *= 1.0 - cfg_.alpha;
+        on_rtt(i, std::chrono::duration_cast<std::chrono::microseconds>(handshake));
+    }
+
+    /// Connection attempt failed.
+    void on_failure(std::size_t i, time_point now) {
+        auto& s = state_[i];
+        ++s.attempts;
+        ++s.failures;
+        fail(s, now);
+    }
+
+    /// Established connection lost.
+    void on_drop(std::size_t i, time_point now) {
+        auto& s = state_[i];
+        ++s.drops;
+        ++s.failures;
+        fail(s, now);
+    }
+
+    /// RTT sample from the live connection (e.g. probe pong).
+    void on_rtt(std::size_t i, std::chrono::microseconds rtt) {
+        auto& s = state_[i];
+        const auto sample = static_cast<double>(rtt.count());
+        s.rtt_us = s.sampled ? s.rtt_us + cfg_.alpha * (sample - s.rtt_us) : sample;
+        s.sampled = true;
+    }
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Accessors
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// rtt × (1 + failure_weight × failure_rate); lower is better.
+    [[nodiscard]] auto score(std::size_t i) const noexcept -> double {
+        const auto& s = state_[i];
+        return s.rtt_us * (1.0 + cfg_.failure_weight * s.failure_rate);
+    }
+
+    [[nodiscard]] auto cooling(std::size_t i, time_point now) const noexcept -> bool {
+        return state_[i].cooldown_until > now;
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return state_.size(); }
+    [[nodiscard]] auto config() const noexcept -> const EndpointHealthConfig& { return cfg_; }
+
+    [[nodiscard]] auto report(time_point now) const -> std::vector<EndpointReport> {
+        std::vector<EndpointReport> out;
+        out.reserve(state_.size());
+        for (std::size_t i = 0; i < state_.size(); ++i) {
+            const auto& s = state_[i];
+            out.push_back(EndpointReport{
+                i, score(i),
+                std::chrono::microseconds{static_cast<std::int64_t>(s.rtt_us)},
+                s.failure_rate, s.attempts, s.failures, s.drops, cooling(i, now)
+            });
+        }
+        return out;
+    }
+
+private:
+    struct State {
+        explicit State(std::chrono::microseconds initial_rtt)
+            : rtt_us{static_cast<double>(initial_rtt.count())}
+        {}
+
+        double rtt_us{0.0};
+        double failure_rate{0.0};
+        std::uint64_t attempts{0};
+        std::uint64_t failures{0};
+        std::uint64_t drops{0};
+        unsigned consecutive_failures{0};
+        time_point cooldown_until{};
+        std::optional<time_point> probed;
+        bool sampled{false};
+    };
+
+    void fail(State& s, time_point now) {
+        s.failure_rate += cfg_.alpha * (1.0 - s.failure_rate);
+        const auto shift = std::min(s.consecutive_failures, 16U);
+        ++s.consecutive_failures;
+        const auto backoff = std::min<std::chrono::milliseconds>(cfg_.cooldown * (1LL << shift), cfg_.max_cooldown);
+        s.cooldown_until = now + std::chrono::duration_cast<duration>(backoff);
+    }
+
+    EndpointHealthConfig cfg_;
+    std::vector<State> state_;
+};
+
+/// Production selector on the monotonic clock.
+using SteadyEndpointSelector = EndpointSelector<std::chrono::steady_clock>;
+
+}  // namespace protocol::health
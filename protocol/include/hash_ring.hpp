@@ -0,0 +1,96 @@
+#pragma once
+
+/// @file hash_ring.hpp
+/// @brief Consistent-hash ring with virtual nodes for target ownership.
+///
+/// Each node contributes `virtual_nodes` points to a 64-bit ring; a key is
+/// owned by the first point at or after its hash. Adding or removing a
+/// node moves only the keys whose nearest point changes — roughly 1/N of
+/// them — and virtual nodes keep the shares even.
+///
+/// Demonstrates:
+/// - Sorted-vector ring (binary search, no node allocations)
+/// - Rule of Six for value types
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace protocol {
+
+/// Default points per node; ~5% share deviation at a handful of nodes.
+constexpr std::size_t kDefaultVirtualNodes = 64;
+
+/// 64-bit finaliser (splitmix64) — cheap, well-mixed, deterministic
+/// across processes and builds, unlike std::hash.
+[[nodiscard]] constexpr auto mix64(std::uint64_t x) noexcept -> std::uint64_t {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// HashRing — Key → Owning Node
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Contains a vector of points (manages own memory)
+// • Compiler-generated operations are correct
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Consistent-hash ring over node ids.
+///
+/// @par Thread Safety
+/// Not thread-safe; const lookups may run concurrently with each other.
+class HashRing {
+public:
+    // Rule of Six: All Default
+    HashRing() = default;
+    ~HashRing() = default;
+    HashRing(const HashRing&) = default;
+    HashRing& operator=(const HashRing&) = default;
+    HashRing(HashRing&&) noexcept = default;
+    HashRing& operator=(HashRing&&) noexcept = default;
+
+    explicit HashRing(std::size_t virtual_nodes) : virtual_nodes_{virtual_nodes > 0 ? virtual_nodes : 1} {}
+
+    /// Add a node's points. Returns false if already present.
+    auto add(std::uint32_t node) -> bool;
+
+    /// Remove a node's points. Returns false if absent.
+    auto remove(std::uint32_t node) -> bool;
+
+    /// Owning node of `key`, or nullopt when the ring is empty.
+    [[nodiscard]] auto owner(std::uint64_t key) const noexcept -> std::optional<std::uint32_t>;
+
+    [[nodiscard]] auto contains(std::uint32_t node) const noexcept -> bool;
+    [[nodiscard]] auto nodes() const -> std::vector<std::uint32_t>;
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return points_.size() / virtual_nodes_; }
+    [[nodiscard]] auto empty() const noexcept -> bool { return points_.empty(); }
+    [[nodiscard]] auto virtual_nodes() const noexcept -> std::size_t { return virtual_nodes_; }
+
+private:
+    struct Point {
+        std::uint64_t hash{0};
+        std::uint32_t node{0};
+
+        friend constexpr auto operator<(const Point& a, const Point& b) noexcept -> bool {
+            return a.hash != b.hash ? a.hash < b.hash : a.node < b.node;
+        }
+    };
+
+    [[nodiscard]] static constexpr auto point_hash(std::uint32_t node, std::size_t replica) noexcept
+        -> std::uint64_t
+    {
+        return mix64((static_cast<std::uint64_t>(node) << 32) ^ static_cast<std::uint64_t>(replica));
+    }
+
+    std::size_t virtual_nodes_{kDefaultVirtualNodes};
+    std::vector<Point> points_;
+};
+
+}  // namespace protocol
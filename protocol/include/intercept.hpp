@@ -0,0 +1,249 @@
+#pragma once
+
+/// @file intercept.hpp
+/// @brief Constant-velocity intercept solutions for shooter × hostile pairs.
+///
+/// @code
+///   InterceptSubscribe  header | count u32 | count × Shooter
+///     Shooter           id u64 | lat f64 | lon f64 | alt f32 | speed f32 | max_range f32
+///   InterceptBatch      header | solved_ns i64 | count u32 | count × Solution
+///     Solution          shooter u64 | target u64 | tti f32 | aim_lat f64 | aim_lon f64
+///                       | aim_alt f32 | bearing f32 | range f32
+/// @endcode
+///
+/// A session sends InterceptSubscribe with its firing platforms (an empty
+/// list unsubscribes). The server answers with solutions for every Red
+/// track it holds, then streams an InterceptBatch whenever Red tracks are
+/// accepted, holding solutions for those tracks only.
+///
+/// A weapon leaves the shooter at `speed` on a straight line; the target
+/// keeps its reported velocity. The intercept time is the smallest t > 0
+/// with |D + V·t| = speed·t (D target − shooter, V target velocity), and is
+/// kept only if the weapon flies at most `max_range` to get there. Pairs
+/// are first gated on their current range: a target further away than
+/// max_range plus the distance it covers in the weapon's longest flight
+/// cannot be reached, so the quadratic is never evaluated for it.
+///
+/// Distances use a flat plane around each shooter (adequate within weapon
+/// range).
+///
+/// Demonstrates:
+/// - Structure-of-arrays gate and solve loops written for auto-vectorisation
+/// - Early rejection by range before the quadratic
+/// - Fail-soft decoding via ByteReader
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "track.hpp"
+#include "wire.hpp"
+
+namespace protocol::intercept {
+
+/// Most shooters one session may subscribe.
+constexpr std::size_t kMaxShooters = 4096;
+
+constexpr std::size_t kShooterRecordSize = 8 + 8 + 8 + 4 + 4 + 4;
+constexpr std::size_t kSolutionRecordSize = 8 + 8 + 4 + 8 + 8 + 4 + 4 + 4;
+
+/// One firing platform and its weapon.
+struct Shooter {
+    std::uint64_t id{0};
+    double lat{0.0};
+    double lon{0.0};
+    float alt{0.0F};
+    float speed_mps{0.0F};      ///< Weapon speed
+    float max_range_m{0.0F};    ///< Longest weapon flight
+};
+
+/// Where and when a shooter's weapon meets a target.
+struct Solution {
+    std::uint64_t shooter_id{0};
+    std::uint64_t target_id{0};
+    float tti_s{0.0F};          ///< Time to intercept from the solve instant
+    double aim_lat{0.0};
+    double aim_lon{0.0};
+    float aim_alt{0.0F};
+    float bearing_deg{0.0F};    ///< True bearing from the shooter to the aim point
+    float range_m{0.0F};        ///< Shooter to target at the solve instant
+};
+
+/// Work done by solve().
+struct SolveCounts {
+    std::uint64_t pairs{0};          ///< Shooter × target pairs considered
+    std::uint64_t gated{0};          ///< Rejected on current range
+    std::uint64_t solutions{0};
+
+    auto operator+=(const SolveCounts& o) noexcept -> SolveCounts& {
+        pairs += o.pairs;
+        gated += o.gated;
+        solutions += o.solutions;
+        return *this;
+    }
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Solver — Shooters in Structure-of-Arrays Form
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Holds vectors (shooter arrays and per-call scratch); value type
+// • Compiler-generated operations are correct
+//
+// PER TARGET:
+// • Gate: current range against each shooter's reach, one pass over all
+//   shooters, survivors compacted into scratch
+// • Solve: the intercept quadratic over the survivors, one pass
+// • Emit: solutions within weapon range
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Intercept solver for one set of shooters.
+///
+/// @par Thread Safety
+/// Not thread-safe (solve() reuses scratch).
+class Solver {
+public:
+    // Rule of Six: All Default
+    Solver() = default;
+    ~Solver() = default;
+    Solver(const Solver&) = default;
+    Solver& operator=(const Solver&) = default;
+    Solver(Solver&&) noexcept = default;
+    Solver& operator=(Solver&&) noexcept = default;
+
+    explicit Solver(std::span<const Shooter> shooters);
+
+    /// Append solutions for every shooter against every target, with the
+    /// targets propagated to `now_ns`.
+    auto solve(std::span<const TrackUpdate> targets, std::int64_t now_ns, std::vector<Solution>& out)
+        -> SolveCounts;
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return id_.size(); }
+    [[nodiscard]] auto empty() const noexcept -> bool { return id_.empty(); }
+
+private:
+    // Shooters
+    std::vector<std::uint64_t> id_;
+    std::vector<double> lat_, lon_;
+    std::vector<float> alt_, m_per_deg_lon_, speed_, range_, max_tof_;
+
+    // Per-target scratch: all shooters, then the gate's survivors
+    std::vector<float> margin_;
+    std::vector<std::uint32_t> keep_;
+    std::vector<float> cx_, cy_, cz_, cd2_, cspeed_, ctof_, tti_;
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Codecs
+// ═══════════════════════════════════════════════════════════════════════════
+
+[[nodiscard]] inline auto encode_subscribe(std::span<const Shooter> shooters) -> std::string {
+    wire::ByteWriter w{wire::FrameKind::InterceptSubscribe, 0,
+                       wire::kHeaderSize + 4 + shooters.size() * kShooterRecordSize};
+    w.put_u32(static_cast<std::uint32_t>(shooters.size()));
+    for (const auto& s : shooters) {
+        w.put_u64(s.id);
+        w.put_f64(s.lat);
+        w.put_f64(s.lon);
+        w.put_f32(s.alt);
+        w.put_f32(s.speed_mps);
+        w.put_f32(s.max_range_m);
+    }
+    return std::move(w).take();
+}
+
+/// Decode InterceptSubscribe. Returns nullopt on malformed input, too many
+/// shooters or a non-positive weapon speed or range.
+[[nodiscard]] inline auto decode_subscribe(std::string_view frame) -> std::optional<std::vector<Shooter>> {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    if (!header || header->kind != wire::FrameKind::InterceptSubscribe) {
+        return std::nullopt;
+    }
+    const auto count = r.get_u32();
+    if (!r.ok() || count > kMaxShooters || r.remaining() < count * kShooterRecordSize) {
+        return std::nullopt;
+    }
+    std::vector<Shooter> out(count);
+    for (auto& s : out) {
+        s.id = r.get_u64();
+        s.lat = r.get_f64();
+        s.lon = r.get_f64();
+        s.alt = r.get_f32();
+        s.speed_mps = r.get_f32();
+        s.max_range_m = r.get_f32();
+        if (!(s.speed_mps > 0.0F) || !(s.max_range_m > 0.0F)) {
+            return std::nullopt;
+        }
+    }
+    if (!r.ok()) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+[[nodiscard]] inline auto encode_solutions(std::span<const Solution> solutions, std::int64_t solved_ns)
+    -> std::string
+{
+    wire::ByteWriter w{wire::FrameKind::InterceptBatch, 0,
+                       wire::kHeaderSize + 8 + 4 + solutions.size() * kSolutionRecordSize};
+    w.put_i64(solved_ns);
+    w.put_u32(static_cast<std::uint32_t>(solutions.size()));
+    for (const auto& s : solutions) {
+        w.put_u64(s.shooter_id);
+        w.put_u64(s.target_id);
+        w.put_f32(s.tti_s);
+        w.put_f64(s.aim_lat);
+        w.put_f64(s.aim_lon);
+        w.put_f32(s.aim_alt);
+        w.put_f32(s.bearing_deg);
+        w.put_f32(s.range_m);
+    }
+    return std::move(w).take();
+}
+
+/// Decoded InterceptBatch.
+struct SolutionBatch {
+    std::int64_t solved_ns{0};
+    std::vector<Solution> solutions;
+};
+
+/// Decode InterceptBatch. Returns nullopt on malformed input.
+[[nodiscard]] inline auto decode_solutions(std::string_view frame) -> std::optional<SolutionBatch> {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    if (!header || header->kind != wire::FrameKind::InterceptBatch) {
+        return std::nullopt;
+    }
+    SolutionBatch out;
+    out.solved_ns = r.get_i64();
+    const auto count = r.get_u32();
+    if (!r.ok() || r.remaining() < static_cast<std::size_t>(count) * kSolutionRecordSize) {
+        return std::nullopt;
+    }
+    out.solutions.resize(count);
+    for (auto& s : out.solutions) {
+        s.shooter_id = r.get_u64();
+        s.target_id = r.get_u64();
+        s.tti_s = r.get_f32();
+        s.aim_lat = r.get_f64();
+        s.aim_lon = r.get_f64();
+        s.aim_alt = r.get_f32();
+        s.bearing_deg = r.get_f32();
+        s.range_m = r.get_f32();
+    }
+    if (!r.ok()) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+}  // namespace protocol::intercept
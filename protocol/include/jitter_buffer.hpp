@@ -0,0 +1,308 @@
+#pragma once
+
+/// @file jitter_buffer.hpp
+/// @brief Timestamp-ordered reorder stage for multi-sensor ingest.
+///
+/// Reports from different sensors arrive out of measurement order because
+/// their links have different latencies. A JitterBuffer holds each report
+/// for a fixed hold time past its measurement time and releases reports
+/// in measurement order, so the store (whose conflict rule drops a report
+/// older than the one it holds) sees each target's history in sequence.
+///
+/// Sensor clocks are not the server's, so reports are ordered by their
+/// min-delay-corrected time: measurement time plus the origin's
+/// ClockSkewEstimator offset (clock offset + the link's fastest delay), fed
+/// online by the reports themselves. A sensor whose link is slower than
+/// the hold is therefore not permanently behind a faster one. The link's
+/// probe-derived offset (link_quality.hpp), when the caller has one, is
+/// only reported through clock_offset(). A report mapped behind what was
+/// already released for its target is late and handled by LatePolicy.
+///
+/// Demonstrates:
+/// - Binary min-heap over measurement time (std::push_heap / pop_heap)
+/// - Windowed-minimum one-way delay as an online clock offset estimate
+/// - Explicit late-arrival policy and bounded memory
+/// - Trivial Class Pattern with Builder Methods for configuration
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "track.hpp"
+
+namespace protocol {
+
+using namespace std::chrono_literals;
+
+/// What happens to a report older than the last one released.
+enum class LatePolicy : std::uint8_t {
+    Drop    = 0,   ///< Discard it (the store would reject most of them anyway)
+    Release = 1    ///< Release it at the next drain, out of order
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// JitterConfig — Trivial Class Pattern with Builder Methods
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Reorder stage tuning. A zero hold disables the stage.
+struct JitterConfig {
+    // Rule of Six: All Default
+    JitterConfig() = default;
+    ~JitterConfig() = default;
+    JitterConfig(const JitterConfig&) = default;
+    JitterConfig& operator=(const JitterConfig&) = default;
+    JitterConfig(JitterConfig&&) noexcept = default;
+    JitterConfig& operator=(JitterConfig&&) noexcept = default;
+
+    /// How long past its (server-clock) measurement time a report is held;
+    /// covers the link delay spread between sensors.
+    std::chrono::milliseconds hold{0ms};
+
+    LatePolicy late{LatePolicy::Drop};
+
+    /// Most reports held; beyond it the earliest are released early.
+    std::size_t capacity{1U << 16};
+
+    /// Span of the clock offset estimator's minimum (see ClockSkewEstimator);
+    /// also how long a quiet target's watermark is remembered.
+    std::chrono::milliseconds skew_window{10s};
+
+    [[nodiscard]] auto with_hold(std::chrono::milliseconds h) && -> JitterConfig {
+        hold = h;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_late_policy(LatePolicy p) && -> JitterConfig {
+        late = p;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_capacity(std::size_t n) && -> JitterConfig {
+        capacity = n;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_skew_window(std::chrono::milliseconds w) && -> JitterConfig {
+        skew_window = w;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto enabled() const noexcept -> bool { return hold > 0ms; }
+};
+
+/// Reorder stage counters.
+struct JitterStats {
+    std::uint64_t buffered{0};          ///< Reports accepted
+    std::uint64_t released{0};          ///< Reports handed on (in or out of order)
+    std::uint64_t late_dropped{0};
+    std::uint64_t late_released{0};
+    std::uint64_t overflow{0};          ///< Released before their hold expired (capacity)
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ClockSkewEstimator — Windowed Minimum Delay
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// ESTIMATE:
+// • Each report gives arrival − measurement = clock offset + link delay
+// • The minimum over a window is the offset plus the link's fastest
+//   delay — queueing noise removed, so it is stable enough to order by,
+//   but sensors whose fastest delays differ stay skewed by the difference
+// • Two half-window epochs: the estimate is the minimum of the current
+//   and previous one, so it tracks drift within one window
+//
+// RULE OF SIX RATIONALE:
+// • Plain integers; compiler-generated operations are correct
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Online offset from one sensor's clock to the server's.
+class ClockSkewEstimator {
+public:
+    // Rule of Six: All Default
+    ClockSkewEstimator() = default;
+    ~ClockSkewEstimator() = default;
+    ClockSkewEstimator(const ClockSkewEstimator&) = default;
+    ClockSkewEstimator& operator=(const ClockSkewEstimator&) = default;
+    ClockSkewEstimator(ClockSkewEstimator&&) noexcept = default;
+    ClockSkewEstimator& operator=(ClockSkewEstimator&&) noexcept = default;
+
+    /// Fold in one report measured at `sensor_ns` and received at `arrival_ns`.
+    void observe(std::int64_t sensor_ns, std::int64_t arrival_ns, std::chrono::nanoseconds window) noexcept {
+        const auto half = std::max<std::int64_t>(window.count() / 2, 1);
+        if (samples_ == 0 || arrival_ns - epoch_start_ns_ >= half) {
+            previous_min_ = samples_ == 0 ? kNone : current_min_;
+            current_min_ = kNone;
+            epoch_start_ns_ = arrival_ns;
+        }
+        current_min_ = std::min(current_min_, arrival_ns - sensor_ns);
+        ++samples_;
+    }
+
+    /// Offset + fastest delay (ns to add to sensor time); nullopt before
+    /// the first report.
+    [[nodiscard]] auto offset() const noexcept -> std::optional<std::int64_t> {
+        if (samples_ == 0) {
+            return std::nullopt;
+        }
+        return std::min(current_min_, previous_min_);
+    }
+
+    [[nodiscard]] auto samples() const noexcept -> std::uint64_t { return samples_; }
+
+private:
+    static constexpr std::int64_t kNone = std::numeric_limits<std::int64_t>::max();
+
+    std::int64_t current_min_{kNone};
+    std::int64_t previous_min_{kNone};
+    std::int64_t epoch_start_ns_{0};
+    std::uint64_t samples_{0};
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// JitterBuffer — Reorder Stage
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Holds a heap vector and an estimator map (value type)
+// • Compiler-generated operations are correct
+//
+// RELEASE RULE:
+// • A report's due time is its mapped measurement time + hold
+// • drain(now) pops every report due by `now` (and the earliest beyond
+//   capacity) in mapped-time order; ties keep arrival order
+// • Each target's watermark is the latest mapped time released for it; a
+//   report mapped before its target's watermark is late. Other targets'
+//   releases never make it late
+// • Watermarks of targets quiet for skew_window are forgotten
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Bounded-latency reorder buffer keyed by origin (e.g. session id).
+///
+/// @par Thread Safety
+/// Not thread-safe.
+///
+/// @par Example
+/// @code
+/// JitterBuffer jb{JitterConfig{}.with_hold(50ms)};
+/// jb.push(session_id, update, now_ns);
+/// jb.drain(now_ns, [&](std::uint64_t origin, const TrackUpdate& t, const auto& trace) {
+///     apply(origin, t, trace);
+/// });
+/// @endcode
+class JitterBuffer {
+public:
+    // Rule of Six: All Default
+    JitterBuffer() = default;
+    ~JitterBuffer() = default;
+    JitterBuffer(const JitterBuffer&) = default;
+    JitterBuffer& operator=(const JitterBuffer&) = default;
+    JitterBuffer(JitterBuffer&&) noexcept = default;
+    JitterBuffer& operator=(JitterBuffer&&) noexcept = default;
+
+    explicit JitterBuffer(const JitterConfig& cfg) : cfg_{cfg} {}
+
+    /// Accept a report from `origin` received at `arrival_ns`.
+    ///
+    /// @param link_offset Probe-derived local − sensor clock offset, if
+    ///        known; reported by clock_offset() (ordering always uses the
+    ///        min-delay-corrected estimate)
+    /// @param trace Latency trace of the report's batch, handed back with
+    ///        the report on release
+    /// @return false if it was late and dropped (LatePolicy::Drop)
+    auto push(std::uint64_t origin,
+              const TrackUpdate& update,
+              std::int64_t arrival_ns,
+              std::optional<std::chrono::nanoseconds> link_offset = std::nullopt,
+              std::shared_ptr<const LatencyTrace> trace = nullptr) -> bool;
+
+    /// Release due reports to `sink(origin, update, trace)` in order.
+    template<typename Sink>
+    void drain(std::int64_t now_ns, Sink&& sink) {
+        const auto hold_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(cfg_.hold).count();
+        while (!heap_.empty()) {
+            const bool due = heap_.front().order_ns <= now_ns - hold_ns;
+            if (!due && heap_.size() <= cfg_.capacity) {
+                break;
+            }
+            std::pop_heap(heap_.begin(), heap_.end(), Later{});
+            auto entry = std::move(heap_.back());
+            heap_.pop_back();
+
+            if (!due) {
+                ++stats_.overflow;
+            }
+            auto& mark = watermarks_[entry.update.target_id];
+            mark = std::max(mark, entry.order_ns);
+            ++stats_.released;
+            sink(entry.origin, entry.update, entry.trace);
+        }
+        sweep_watermarks(now_ns);
+    }
+
+    /// Stop tracking `origin`'s clock (its held reports are still released).
+    void forget(std::uint64_t origin) { clocks_.erase(origin); }
+
+    /// `origin`'s clock offset (sensor → server clock): the probe-derived
+    /// one when push() was given it, else the report-based estimate.
+    [[nodiscard]] auto clock_offset(std::uint64_t origin) const -> std::optional<std::chrono::nanoseconds>;
+
+    /// Server time at which the earliest held report is due.
+    [[nodiscard]] auto next_due_ns() const noexcept -> std::optional<std::int64_t> {
+        if (heap_.empty()) {
+            return std::nullopt;
+        }
+        return heap_.front().order_ns
+             + std::chrono::duration_cast<std::chrono::nanoseconds>(cfg_.hold).count();
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return heap_.size(); }
+    [[nodiscard]] auto stats() const noexcept -> const JitterStats& { return stats_; }
+    [[nodiscard]] auto config() const noexcept -> const JitterConfig& { return cfg_; }
+
+private:
+    struct Entry {
+        std::int64_t order_ns{0};    ///< Measurement time on the server clock
+        std::uint64_t arrival{0};    ///< Tie-break: arrival order
+        std::uint64_t origin{0};
+        TrackUpdate update;
+        std::shared_ptr<const LatencyTrace> trace;  ///< Shared by its batch
+    };
+
+    /// Heap comparator: the earliest entry on top.
+    struct Later {
+        auto operator()(const Entry& a, const Entry& b) const noexcept -> bool {
+            return a.order_ns != b.order_ns ? a.order_ns > b.order_ns : a.arrival > b.arrival;
+        }
+    };
+
+    /// Per-origin estimator and the offset last applied.
+    struct OriginClock {
+        ClockSkewEstimator estimator;
+        std::int64_t offset_ns{0};
+    };
+
+    /// Forget watermarks not advanced within skew_window (once per window).
+    void sweep_watermarks(std::int64_t now_ns);
+
+    JitterConfig cfg_;
+    std::vector<Entry> heap_;
+    std::unordered_map<std::uint64_t, OriginClock> clocks_;
+    std::unordered_map<std::uint64_t, std::int64_t> watermarks_;   ///< Per target
+    std::int64_t next_sweep_ns_{0};
+    std::uint64_t next_arrival_{0};
+    JitterStats stats_;
+};
+
+}  // namespace protocol
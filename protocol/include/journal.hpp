@@ -0,0 +1,270 @@
+#pragma once
+
+/// @file journal.hpp
+/// @brief Append-only ingest journal in fixed-size-record segment files.
+///
+/// Every change applied to the server's TrackStore is appended as one
+/// record with a journal-wide sequence number. The journal is the unit of
+/// log shipping (warm standby) and of post-mission analysis.
+///
+/// @code
+///   segment file  journal-<first_seq, 20 digits>.seg
+///   header        magic u32 "TJNL" | version u16 | reserved u16 | first_seq u64
+///   record        seq u64 | ingest_ns i64 | origin u32 | origin_seq u64 | TrackUpdate
+/// @endcode
+///
+/// A target the server expires is journalled as a drop record: origin_seq
+/// is kJournalDropSeq and the TrackUpdate is the target's last state, so
+/// replay and a standby erase it rather than bring it back.
+///
+/// Records are fixed-size, so record N of a segment sits at a computable
+/// offset and a torn tail write is detected (and truncated) from the file
+/// size alone. Sequence numbers are contiguous within a segment.
+///
+/// Each segment is summarised in a sidecar index block (journal_index.hpp)
+/// when it is sealed — on roll and on close — so post-mission queries
+/// (journal_query.hpp) can skip segments without reading them.
+///
+/// Demonstrates:
+/// - Rule of Six: Move-only owner of the active segment file
+/// - Write batching with an in-memory tail for cheap recent reads
+/// - Segment rolling with per-segment index blocks
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "journal_index.hpp"
+#include "posix_file.hpp"
+#include "track.hpp"
+#include "wire.hpp"
+
+namespace protocol {
+
+// ───────────────────────────────────────────────────────────────────────────
+// Record Format
+// ───────────────────────────────────────────────────────────────────────────
+
+/// origin_seq of a drop record (the target was erased from the store).
+constexpr std::uint64_t kJournalDropSeq = std::numeric_limits<std::uint64_t>::max();
+
+/// One journalled store change.
+struct JournalRecord {
+    std::uint64_t seq{0};          ///< Journal sequence (1-based, contiguous)
+    std::int64_t ingest_ns{0};     ///< Wall time the change was applied
+    std::uint32_t origin{0};       ///< Node that ingested the update
+    std::uint64_t origin_seq{0};   ///< Origin's replication sequence (0 = local)
+    TrackUpdate update;
+
+    /// True for a drop record; `update` is the erased target's last state.
+    [[nodiscard]] auto is_drop() const noexcept -> bool { return origin_seq == kJournalDropSeq; }
+};
+
+/// Encoded size of one record.
+constexpr std::size_t kJournalRecordSize = 8 + 8 + 4 + 8 + kTrackRecordSize;
+
+/// Segment file header size and identification.
+constexpr std::size_t kSegmentHeaderSize = 16;
+constexpr std::uint32_t kJournalMagic = 0x4C4E4A54;   // "TJNL" little-endian
+constexpr std::uint16_t kJournalVersion = 1;
+
+inline void encode_journal_record(wire::ByteWriter& w, const JournalRecord& r) {
+    w.put_u64(r.seq);
+    w.put_i64(r.ingest_ns);
+    w.put_u32(r.origin);
+    w.put_u64(r.origin_seq);
+    encode_track(w, r.update);
+}
+
+/// Read one record. Check reader.ok() afterwards.
+[[nodiscard]] inline auto decode_journal_record(wire::ByteReader& r) noexcept -> JournalRecord {
+    JournalRecord out;
+    out.seq = r.get_u64();
+    out.ingest_ns = r.get_i64();
+    out.origin = r.get_u32();
+    out.origin_seq = r.get_u64();
+    out.update = decode_track(r);
+    return out;
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// JournalConfig — Trivial Class Pattern with Builder Methods
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Journal placement and sizing. An empty dir keeps the journal in memory
+/// only (tail_records most recent records).
+struct JournalConfig {
+    // Rule of Six: All Default
+    JournalConfig() = default;
+    ~JournalConfig() = default;
+    JournalConfig(const JournalConfig&) = default;
+    JournalConfig& operator=(const JournalConfig&) = default;
+    JournalConfig(JournalConfig&&) noexcept = default;
+    JournalConfig& operator=(JournalConfig&&) noexcept = default;
+
+    /// Segment directory (empty = memory only).
+    std::filesystem::path dir;
+
+    /// Records per segment before rolling (~69 MB at 1M records).
+    std::size_t segment_records{1U << 20};
+
+    /// Recent records kept in memory for shipping and reads.
+    std::size_t tail_records{1U << 16};
+
+    /// Bytes buffered before a write() to the segment.
+    std::size_t write_buffer{64U * 1024U};
+
+    [[nodiscard]] auto with_dir(std::filesystem::path d) && -> JournalConfig {
+        dir = std::move(d);
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_segment_records(std::size_t n) && -> JournalConfig {
+        segment_records = n;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_tail_records(std::size_t n) && -> JournalConfig {
+        tail_records = n;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto persistent() const noexcept -> bool { return !dir.empty(); }
+};
+
+/// One on-disk segment.
+struct SegmentInfo {
+    std::filesystem::path path;
+    std::uint64_t first_seq{0};
+    std::uint64_t records{0};
+};
+
+/// Segment file name for a first sequence number.
+[[nodiscard]] auto segment_path(const std::filesystem::path& dir, std::uint64_t first_seq)
+    -> std::filesystem::path;
+
+/// Segments in `dir`, ordered by first_seq (torn tails are not repaired).
+[[nodiscard]] auto list_segments(const std::filesystem::path& dir) -> std::vector<SegmentInfo>;
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Journal — Move-Only Resource Class
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Owns the active segment's PosixFile (move-only)
+// • Default ctor: memory-only journal
+// • Copy ops: DELETED (implicitly, via PosixFile)
+// • Move ops: Defaulted — every member moves correctly
+//
+// DURABILITY:
+// append() buffers; flush() hands buffered records to the OS; sync() also
+// fdatasyncs. The server flushes on a short timer.
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Segmented ingest journal.
+///
+/// @par Thread Safety
+/// Not thread-safe; owned by the server's io_context thread.
+class Journal {
+public:
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: Move-Only Pattern
+    // ───────────────────────────────────────────────────────────────────────
+
+    Journal() = default;
+    ~Journal();
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+    Journal(Journal&&) noexcept = default;
+    Journal& operator=(Journal&&) noexcept = default;
+
+    /// Open (creating the directory if needed) and recover the tail segment.
+    ///
+    /// @throws std::system_error on I/O failure
+    [[nodiscard]] static auto open(JournalConfig cfg) -> Journal;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Writing
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Append a new record; returns its sequence number.
+    auto append(std::int64_t ingest_ns,
+                std::uint32_t origin,
+                std::uint64_t origin_seq,
+                const TrackUpdate& update) -> std::uint64_t;
+
+    /// Append a record keeping its sequence (log shipping). A sequence
+    /// beyond next_seq() starts a new segment; an older one is ignored.
+    ///
+    /// @return false if the record was older than the journal head
+    auto append(const JournalRecord& record) -> bool;
+
+    /// Append a drop record for a target erased from the store.
+    ///
+    /// @param last The target's last stored state
+    auto append_drop(std::int64_t ingest_ns, std::uint32_t origin, const TrackUpdate& last) -> std::uint64_t {
+        return append(ingest_ns, origin, kJournalDropSeq, last);
+    }
+
+    /// Continue numbering at `next_seq` (no-op if not ahead). Used when a
+    /// snapshot covers records the journal lost, so sequences never repeat.
+    void skip_to(std::uint64_t next_seq) noexcept { next_seq_ = std::max(next_seq_, next_seq); }
+
+    /// Write buffered records to the segment file.
+    void flush();
+
+    /// flush() and fdatasync the active segment.
+    void sync();
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Reading
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Append up to `max` records starting at `from_seq` to `out`.
+    ///
+    /// Recent records come from memory; older ones from segment files.
+    /// Reading starts at first_seq() if `from_seq` has been discarded.
+    auto read(std::uint64_t from_seq, std::size_t max, std::vector<JournalRecord>& out)
+        -> std::size_t;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Accessors
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Oldest readable sequence (next_seq() when empty).
+    [[nodiscard]] auto first_seq() const noexcept -> std::uint64_t;
+
+    /// Newest sequence (0 when empty).
+    [[nodiscard]] auto last_seq() const noexcept -> std::uint64_t { return next_seq_ - 1; }
+    [[nodiscard]] auto next_seq() const noexcept -> std::uint64_t { return next_seq_; }
+    [[nodiscard]] auto segments() const noexcept -> const std::vector<SegmentInfo>& { return segments_; }
+    [[nodiscard]] auto config() const noexcept -> const JournalConfig& { return cfg_; }
+
+private:
+    explicit Journal(JournalConfig cfg) : cfg_{std::move(cfg)} {}
+
+    void push(const JournalRecord& record);
+    void roll(std::uint64_t first_seq);
+    void write_index();
+    auto read_segment(const SegmentInfo& seg, std::uint64_t from_seq, std::size_t max,
+                      std::vector<JournalRecord>& out) const -> std::size_t;
+
+    JournalConfig cfg_;
+    std::vector<SegmentInfo> segments_;
+    PosixFile active_;
+    wire::ByteWriter buffer_;
+    std::deque<JournalRecord> tail_;
+    SegmentIndex index_;        ///< Active segment's index block, kept current
+    std::uint64_t next_seq_{1};
+};
+
+}  // namespace protocol
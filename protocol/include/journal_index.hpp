@@ -0,0 +1,233 @@
+#pragma once
+
+/// @file journal_index.hpp
+/// @brief Per-segment index blocks: time range, bounding box, target bloom.
+///
+/// Every sealed journal segment gets a small sidecar block summarising its
+/// records, so a query can skip a segment without opening it.
+///
+/// @code
+///   index file  journal-<first_seq, 20 digits>.idx
+///   block       magic u32 "TJIX" | version u16 | bloom_log2 u16
+///               | first_seq u64 | records u64
+///               | time_min i64 | time_max i64                (track time_ns)
+///               | lat_min f64 | lat_max f64 | lon_min f64 | lon_max f64
+///               | bloom bytes (2^bloom_log2 bits, target ids, kBloomHashes probes)
+/// @endcode
+///
+/// A block whose `records` differs from its segment's is stale (the
+/// segment grew after the block was written) and must not be used to prune.
+///
+/// Demonstrates:
+/// - Zone maps (min/max per segment) for time and space pruning
+/// - Bloom filter with double hashing over mix64
+/// - Fixed-offset field reads straight from a mapped segment
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "hash_ring.hpp"
+
+namespace protocol {
+
+struct SegmentInfo;
+
+// ───────────────────────────────────────────────────────────────────────────
+// Record Field Offsets
+// ───────────────────────────────────────────────────────────────────────────
+//
+// Scans test these fields in place and decode only records that match
+// (layout in journal.hpp).
+
+constexpr std::size_t kRecordOriginSeqOffset = 8 + 8 + 4;
+constexpr std::size_t kRecordTargetOffset = kRecordOriginSeqOffset + 8;
+constexpr std::size_t kRecordTimeOffset = kRecordTargetOffset + 8;
+constexpr std::size_t kRecordLatOffset = kRecordTimeOffset + 8;
+constexpr std::size_t kRecordLonOffset = kRecordLatOffset + 8;
+
+/// Load a little-endian field from an encoded record.
+template<typename T>
+[[nodiscard]] inline auto load_field(const char* record, std::size_t offset) noexcept -> T {
+    if constexpr (std::is_floating_point_v<T>) {
+        using Bits = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+        return std::bit_cast<T>(load_field<Bits>(record, offset));
+    } else {
+        T v;
+        std::memcpy(&v, record + offset, sizeof(T));
+        if constexpr (sizeof(T) > 1 && std::endian::native == std::endian::big) {
+            v = std::byteswap(v);
+        }
+        return v;
+    }
+}
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// Geometry
+// ───────────────────────────────────────────────────────────────────────────
+
+/// Latitude/longitude box in degrees (inclusive). Default-constructed
+/// boxes are empty and grow with extend().
+struct GeoBox {
+    double lat_min{std::numeric_limits<double>::infinity()};
+    double lat_max{-std::numeric_limits<double>::infinity()};
+    double lon_min{std::numeric_limits<double>::infinity()};
+    double lon_max{-std::numeric_limits<double>::infinity()};
+
+    void extend(double lat, double lon) noexcept {
+        lat_min = std::min(lat_min, lat);
+        lat_max = std::max(lat_max, lat);
+        lon_min = std::min(lon_min, lon);
+        lon_max = std::max(lon_max, lon);
+    }
+
+    [[nodiscard]] auto contains(double lat, double lon) const noexcept -> bool {
+        return lat >= lat_min && lat <= lat_max && lon >= lon_min && lon <= lon_max;
+    }
+
+    [[nodiscard]] auto intersects(const GeoBox& o) const noexcept -> bool {
+        return lat_min <= o.lat_max && o.lat_min <= lat_max
+            && lon_min <= o.lon_max && o.lon_min <= lon_max;
+    }
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SegmentIndex — Value Type
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Index block layout constants.
+constexpr std::uint32_t kIndexMagic = 0x58494A54;     // "TJIX" little-endian
+constexpr std::uint16_t kIndexVersion = 1;
+constexpr std::size_t kIndexHeaderSize = 4 + 2 + 2 + 8 + 8 + 8 + 8 + 4 * 8;
+
+/// Bloom filter size: 64 Kibit (8 KiB), ~4% false positives at 10k targets.
+constexpr std::uint16_t kBloomLog2 = 16;
+constexpr std::size_t kBloomHashes = 4;
+
+/// Summary of one segment's records.
+///
+/// @par Thread Safety
+/// Value type; a const index may be shared between threads.
+class SegmentIndex {
+public:
+    // Rule of Six: All Default
+    SegmentIndex() : SegmentIndex{0} {}
+    ~SegmentIndex() = default;
+    SegmentIndex(const SegmentIndex&) = default;
+    SegmentIndex& operator=(const SegmentIndex&) = default;
+    SegmentIndex(SegmentIndex&&) noexcept = default;
+    SegmentIndex& operator=(SegmentIndex&&) noexcept = default;
+
+    /// Empty index for the segment starting at `first_seq`.
+    explicit SegmentIndex(std::uint64_t first_seq)
+        : first_seq_{first_seq}
+        , bloom_((std::size_t{1} << kBloomLog2) / 64, 0)
+    {}
+
+    /// Fold one record in.
+    void add(std::uint64_t target_id, std::int64_t time_ns, double lat, double lon) noexcept {
+        ++records_;
+        time_min_ = std::min(time_min_, time_ns);
+        time_max_ = std::max(time_max_, time_ns);
+        box_.extend(lat, lon);
+        const auto h = bloom_hashes(target_id);
+        for (std::size_t i = 0; i < kBloomHashes; ++i) {
+            const auto bit = (h.first + i * h.second) & bloom_mask();
+            bloom_[bit / 64] |= std::uint64_t{1} << (bit % 64);
+        }
+    }
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Pruning Tests (false = no record in the segment can match)
+    // ───────────────────────────────────────────────────────────────────────
+
+    [[nodiscard]] auto overlaps_time(std::int64_t from_ns, std::int64_t to_ns) const noexcept -> bool {
+        return records_ > 0 && time_min_ <= to_ns && from_ns <= time_max_;
+    }
+
+    [[nodiscard]] auto overlaps_box(const GeoBox& box) const noexcept -> bool {
+        return records_ > 0 && box_.intersects(box);
+    }
+
+    [[nodiscard]] auto may_contain(std::uint64_t target_id) const noexcept -> bool {
+        const auto h = bloom_hashes(target_id);
+        for (std::size_t i = 0; i < kBloomHashes; ++i) {
+            const auto bit = (h.first + i * h.second) & bloom_mask();
+            if ((bloom_[bit / 64] & (std::uint64_t{1} << (bit % 64))) == 0) {
+                return false;
+            }
+        }
+        return records_ > 0;
+    }
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Accessors and Codec
+    // ───────────────────────────────────────────────────────────────────────
+
+    [[nodiscard]] auto first_seq() const noexcept -> std::uint64_t { return first_seq_; }
+    [[nodiscard]] auto records() const noexcept -> std::uint64_t { return records_; }
+    [[nodiscard]] auto time_min() const noexcept -> std::int64_t { return time_min_; }
+    [[nodiscard]] auto time_max() const noexcept -> std::int64_t { return time_max_; }
+    [[nodiscard]] auto box() const noexcept -> const GeoBox& { return box_; }
+
+    [[nodiscard]] auto encode() const -> std::string;
+
+    /// Parse a block; nullopt if malformed or from another version.
+    [[nodiscard]] static auto decode(std::string_view bytes) -> std::optional<SegmentIndex>;
+
+private:
+    [[nodiscard]] static constexpr auto bloom_mask() noexcept -> std::uint64_t {
+        return (std::uint64_t{1} << kBloomLog2) - 1;
+    }
+
+    /// Double hashing: probe i is h1 + i·h2 (h2 odd, so probes differ).
+    [[nodiscard]] static constexpr auto bloom_hashes(std::uint64_t id) noexcept
+        -> std::pair<std::uint64_t, std::uint64_t>
+    {
+        const auto h = mix64(id);
+        return {h, mix64(h) | 1};
+    }
+
+    std::uint64_t first_seq_{0};
+    std::uint64_t records_{0};
+    std::int64_t time_min_{std::numeric_limits<std::int64_t>::max()};
+    std::int64_t time_max_{std::numeric_limits<std::int64_t>::min()};
+    GeoBox box_;
+    std::vector<std::uint64_t> bloom_;
+};
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// Index Files
+// ───────────────────────────────────────────────────────────────────────────
+
+/// Index file for the segment starting at `first_seq`.
+[[nodiscard]] auto index_path(const std::filesystem::path& dir, std::uint64_t first_seq)
+    -> std::filesystem::path;
+
+/// Write `index` next to its segment (atomic replace).
+///
+/// @throws std::system_error on I/O failure
+void write_segment_index(const std::filesystem::path& dir, const SegmentIndex& index);
+
+/// Load the index for `seg`; nullopt when missing, malformed or stale.
+[[nodiscard]] auto load_segment_index(const SegmentInfo& seg) -> std::optional<SegmentIndex>;
+
+/// Build an index by scanning `seg` (used for segments written before a crash).
+///
+/// @throws std::system_error if the segment cannot be mapped
+[[nodiscard]] auto build_segment_index(const SegmentInfo& seg) -> SegmentIndex;
+
+}  // namespace protocol
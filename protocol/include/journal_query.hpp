@@ -0,0 +1,140 @@
+#pragma once
+
+/// @file journal_query.hpp
+/// @brief Time, area and target queries over journal segments on disk.
+///
+/// A query first prunes segments with their index blocks (time range,
+/// bounding box, target bloom; see journal_index.hpp), then maps every
+/// surviving segment and scans it in fixed-size slices on a TaskPool.
+/// Records are tested field by field in the mapping and only matches are
+/// decoded, so a scan runs close to memory bandwidth. Segments without a
+/// current index block (the active one, or one from before a crash) are
+/// scanned in full.
+///
+/// Queries read the files only and may run while a Journal appends to the
+/// same directory; records still in the writer's buffer are not seen.
+///
+/// Demonstrates:
+/// - Index-based segment pruning ahead of a full scan
+/// - Parallel mmap scans with TaskPool::parallel_for
+/// - Trivial Class Pattern with Builder Methods for query parameters
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "journal.hpp"
+#include "journal_index.hpp"
+#include "task_pool.hpp"
+
+namespace protocol {
+
+/// Default cap on records returned by one query.
+constexpr std::size_t kJournalQueryLimit = 100'000;
+
+/// Polygon vertex (degrees).
+struct GeoPoint {
+    double lat{0.0};
+    double lon{0.0};
+};
+
+/// True if (lat, lon) lies inside the polygon (even-odd rule; the closing
+/// edge is implied). Longitude is treated as planar — no antimeridian wrap.
+[[nodiscard]] auto polygon_contains(const std::vector<GeoPoint>& polygon, double lat, double lon) noexcept
+    -> bool;
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// JournalQuery — Trivial Class Pattern with Builder Methods
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Which records to return. Every criterion left at its default matches all.
+struct JournalQuery {
+    // Rule of Six: All Default
+    JournalQuery() = default;
+    ~JournalQuery() = default;
+    JournalQuery(const JournalQuery&) = default;
+    JournalQuery& operator=(const JournalQuery&) = default;
+    JournalQuery(JournalQuery&&) noexcept = default;
+    JournalQuery& operator=(JournalQuery&&) noexcept = default;
+
+    /// Track time window (TrackUpdate::time_ns, inclusive).
+    std::int64_t from_ns{std::numeric_limits<std::int64_t>::min()};
+    std::int64_t to_ns{std::numeric_limits<std::int64_t>::max()};
+
+    /// Area of interest (empty = anywhere; otherwise at least 3 vertices).
+    std::vector<GeoPoint> polygon;
+
+    /// Targets of interest (empty = all).
+    std::vector<std::uint64_t> targets;
+
+    /// Most records returned; the earliest (by sequence) are kept.
+    std::size_t limit{kJournalQueryLimit};
+
+    [[nodiscard]] auto with_time_range(std::int64_t from, std::int64_t to) && -> JournalQuery {
+        from_ns = from;
+        to_ns = to;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_polygon(std::vector<GeoPoint> vertices) && -> JournalQuery {
+        polygon = std::move(vertices);
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_box(const GeoBox& box) && -> JournalQuery {
+        polygon = {{box.lat_min, box.lon_min}, {box.lat_min, box.lon_max},
+                   {box.lat_max, box.lon_max}, {box.lat_max, box.lon_min}};
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_targets(std::vector<std::uint64_t> ids) && -> JournalQuery {
+        targets = std::move(ids);
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_limit(std::size_t n) && -> JournalQuery {
+        limit = n;
+        return std::move(*this);
+    }
+};
+
+/// What a query cost.
+struct JournalQueryStats {
+    std::size_t segments{0};            ///< Segments in the directory
+    std::size_t pruned{0};              ///< Skipped on their index block
+    std::size_t unindexed{0};           ///< Scanned without a current index block
+    std::uint64_t records_scanned{0};
+    std::uint64_t bytes_scanned{0};
+    std::uint64_t matches{0};           ///< Records returned
+    bool truncated{false};              ///< Stopped at JournalQuery::limit
+    std::chrono::microseconds elapsed{0};
+
+    [[nodiscard]] auto bytes_per_second() const noexcept -> double {
+        return elapsed.count() > 0 ? static_cast<double>(bytes_scanned) * 1e6 / static_cast<double>(elapsed.count())
+                                   : 0.0;
+    }
+};
+
+/// Matching records in sequence order, and the query's cost.
+struct JournalQueryResult {
+    std::vector<JournalRecord> records;
+    JournalQueryStats stats;
+};
+
+/// Run `query` against the journal segments in `dir`.
+///
+/// Blocks until done; safe to call from a worker of `pool` (the join
+/// helps run the scan).
+///
+/// @throws std::invalid_argument if the polygon has 1 or 2 vertices
+/// @throws std::system_error if a segment cannot be mapped
+[[nodiscard]] auto query_journal(const std::filesystem::path& dir,
+                                 const JournalQuery& query,
+                                 exec::TaskPool& pool) -> JournalQueryResult;
+
+}  // namespace protocol
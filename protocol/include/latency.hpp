@@ -0,0 +1,230 @@
+#pragma once
+
+/// @file latency.hpp
+/// @brief End-to-end latency trace (frame header extension) and per-hop breakdown.
+///
+/// A frame with wire::kFlagLatencyTrace set carries, right after the
+/// standard header:
+///
+/// @code
+///   origin_ns i64 | hop_count u8 | hop_count × (node u32 | ingress_ns i64 | egress_ns i64)
+/// @endcode
+///
+/// All stamps are wall-clock nanoseconds. Each hop rebases the trace onto
+/// its own clock (adding the estimated offset to the previous hop) before
+/// appending its ingress stamp, so at the consumer every stamp is on the
+/// consumer's clock and segment latencies are plain differences.
+///
+/// Demonstrates:
+/// - Optional, flag-gated header extension (old decoders skip nothing)
+/// - Per-segment histograms for sensor-to-screen latency
+/// - Rule of Six for value types
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "link_quality.hpp"
+#include "wire.hpp"
+
+namespace protocol {
+
+// ═══════════════════════════════════════════════════════════════════════════
+// LatencyTrace — Origin + Per-Hop Stamps
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Maximum hops recorded; further hops are not stamped.
+constexpr std::size_t kMaxTraceHops = 8;
+
+/// One relay's residence interval.
+struct HopStamp {
+    std::uint32_t node{0};        ///< Relay identity
+    std::int64_t ingress_ns{0};   ///< Frame read
+    std::int64_t egress_ns{0};    ///< Frame written (0 until sent)
+};
+
+/// Timestamps accumulated by a frame on its way from sensor to screen.
+///
+/// Rule of Six: All Default (vector manages its own memory).
+struct LatencyTrace {
+    LatencyTrace() = default;
+    ~LatencyTrace() = default;
+    LatencyTrace(const LatencyTrace&) = default;
+    LatencyTrace& operator=(const LatencyTrace&) = default;
+    LatencyTrace(LatencyTrace&&) noexcept = default;
+    LatencyTrace& operator=(LatencyTrace&&) noexcept = default;
+
+    explicit LatencyTrace(std::int64_t origin) : origin_ns{origin} {}
+
+    std::int64_t origin_ns{0};
+    std::vector<HopStamp> hops;
+
+    /// Shift every stamp by `offset` (peer clock → local clock).
+    void rebase(std::chrono::nanoseconds offset) noexcept {
+        const auto d = offset.count();
+        origin_ns += d;
+        for (auto& h : hops) {
+            h.ingress_ns += d;
+            if (h.egress_ns != 0) {
+                h.egress_ns += d;
+            }
+        }
+    }
+
+    /// Append an ingress stamp for this relay (ignored past kMaxTraceHops).
+    void stamp_ingress(std::uint32_t node, std::int64_t now_ns) {
+        if (hops.size() < kMaxTraceHops) {
+            hops.push_back(HopStamp{node, now_ns, 0});
+        }
+    }
+
+    /// Stamp egress on the latest hop (the relay now forwarding the frame).
+    void stamp_egress(std::int64_t now_ns) noexcept {
+        if (!hops.empty() && hops.back().egress_ns == 0) {
+            hops.back().egress_ns = now_ns;
+        }
+    }
+};
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// Extension Codec
+// ───────────────────────────────────────────────────────────────────────────
+
+/// Encoded size of a trace.
+[[nodiscard]] inline auto trace_size(const LatencyTrace& t) noexcept -> std::size_t {
+    return 8 + 1 + t.hops.size() * (4 + 8 + 8);
+}
+
+/// Append trace extension (caller sets kFlagLatencyTrace).
+inline void encode_trace(wire::ByteWriter& w, const LatencyTrace& t) {
+    w.put_i64(t.origin_ns);
+    w.put_u8(static_cast<std::uint8_t>(t.hops.size()));
+    for (const auto& h : t.hops) {
+        w.put_u32(h.node);
+        w.put_i64(h.ingress_ns);
+        w.put_i64(h.egress_ns);
+    }
+}
+
+/// Read trace extension. Returns nullopt on malformed input.
+[[nodiscard]] inline auto decode_trace(wire::ByteReader& r) -> std::optional<LatencyTrace> {
+    LatencyTrace t{r.get_i64()};
+    const auto n = r.get_u8();
+    if (!r.ok() || n > kMaxTraceHops) {
+        return std::nullopt;
+    }
+    t.hops.reserve(n);
+    for (std::uint8_t i = 0; i < n; ++i) {
+        HopStamp h;
+        h.node = r.get_u32();
+        h.ingress_ns = r.get_i64();
+        h.egress_ns = r.get_i64();
+        t.hops.push_back(h);
+    }
+    if (!r.ok()) {
+        return std::nullopt;
+    }
+    return t;
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// LatencyBreakdown — Consumer-Side Histograms
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// SEGMENTS (trace with hops h0..hn-1, received at R):
+//
+//   uplink     origin      → h0.ingress
+//   residence  hi.ingress  → hi.egress      (per hop)
+//   link       hi.egress   → hi+1.ingress   (per hop; last one ends at R)
+//   total      origin      → R
+//
+// Segments are indexed by hop position, not node id. Negative spans
+// (residual clock error) are recorded as zero.
+//
+// RULE OF SIX RATIONALE:
+// • Contains arrays of histograms (trivially copyable)
+// • Compiler-generated operations are correct
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Percentiles of one latency segment.
+struct SegmentLatency {
+    std::string name;
+    std::uint64_t samples{0};
+    std::chrono::microseconds p50{0};
+    std::chrono::microseconds p99{0};
+};
+
+/// One-way latency histograms broken down by hop.
+class LatencyBreakdown {
+public:
+    // Rule of Six: All Default
+    LatencyBreakdown() = default;
+    ~LatencyBreakdown() = default;
+    LatencyBreakdown(const LatencyBreakdown&) = default;
+    LatencyBreakdown& operator=(const LatencyBreakdown&) = default;
+    LatencyBreakdown(LatencyBreakdown&&) noexcept = default;
+    LatencyBreakdown& operator=(LatencyBreakdown&&) noexcept = default;
+
+    /// Record a trace received at `receipt_ns` (local clock).
+    void record(const LatencyTrace& t, std::int64_t receipt_ns) {
+        total_.record(span_us(t.origin_ns, receipt_ns));
+        if (t.hops.empty()) {
+            return;
+        }
+
+        uplink_.record(span_us(t.origin_ns, t.hops.front().ingress_ns));
+        for (std::size_t i = 0; i < t.hops.size(); ++i) {
+            const auto& h = t.hops[i];
+            if (h.egress_ns == 0) {
+                continue;
+            }
+            residence_[i].record(span_us(h.ingress_ns, h.egress_ns));
+            const auto next = i + 1 < t.hops.size() ? t.hops[i + 1].ingress_ns : receipt_ns;
+            link_[i].record(span_us(h.egress_ns, next));
+        }
+    }
+
+    [[nodiscard]] auto samples() const noexcept -> std::uint64_t { return total_.count(); }
+    [[nodiscard]] auto total() const noexcept -> const link::RttHistogram& { return total_; }
+
+    /// Non-empty segments in path order, ending with the total.
+    [[nodiscard]] auto report() const -> std::vector<SegmentLatency> {
+        std::vector<SegmentLatency> out;
+        const auto add = [&out](std::string name, const link::RttHistogram& h) {
+            if (h.count() > 0) {
+                out.push_back(SegmentLatency{std::move(name), h.count(),
+                                             h.percentile(50.0), h.percentile(99.0)});
+            }
+        };
+        add("uplink", uplink_);
+        for (std::size_t i = 0; i < kMaxTraceHops; ++i) {
+            add("hop" + std::to_string(i) + ".residence", residence_[i]);
+            add("hop" + std::to_string(i) + ".link", link_[i]);
+        }
+        add("total", total_);
+        return out;
+    }
+
+private:
+    [[nodiscard]] static auto span_us(std::int64_t from_ns, std::int64_t to_ns) noexcept
+        -> std::chrono::microseconds
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::nanoseconds{to_ns - from_ns});
+    }
+
+    link::RttHistogram total_;
+    link::RttHistogram uplink_;
+    std::array<link::RttHistogram, kMaxTraceHops> residence_{};
+    std::array<link::RttHistogram, kMaxTraceHops> link_{};
+};
+
+}  // namespace protocol
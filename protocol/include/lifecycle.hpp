@@ -0,0 +1,316 @@
+#pragma once
+
+/// @file lifecycle.hpp
+/// @brief Track lifecycle states with timing-wheel expiry.
+///
+/// @code
+///   TrackDrop  header | count u32 | count × target_id u64
+/// @endcode
+///
+/// Targets never say goodbye; they just stop reporting. Every target
+/// moves through:
+///
+///   Tentative ──(confirm_updates reports)──► Confirmed
+///   Confirmed ──(silent coast_after)───────► Coasting ──(report)──► Confirmed
+///   Coasting  ──(silent drop_after)────────► Dropped
+///   Tentative ──(silent coast_after)───────► Dropped   (never confirmed)
+///
+/// Timeouts run on a hashed timing wheel: each target has one entry, in
+/// the slot of its next deadline. A report only records the time; the
+/// entry is not moved. When a slot comes round, an entry whose target has
+/// reported since is re-armed at its new deadline, so expiry costs work
+/// per deadline reached, never a scan of every target. Deadlines past the
+/// wheel's span go round again the same way.
+///
+/// Per-target state lives in dense parallel arrays. A dropped target's
+/// slot is filled by the last one (swap-with-last), so the arrays stay
+/// packed without a separate compaction pass.
+///
+/// Demonstrates:
+/// - Hashed timing wheel with lazy re-arming
+/// - Structure-of-arrays state kept dense by swap-remove
+/// - Trivial Class Pattern with Builder Methods for configuration
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "wire.hpp"
+
+namespace protocol {
+
+using namespace std::chrono_literals;
+
+/// Where a target is in its life.
+enum class TrackState : std::uint8_t {
+    Tentative = 0,   ///< Seen, not yet confirmed
+    Confirmed = 1,   ///< Reporting
+    Coasting  = 2,   ///< Silent; kept at its last report
+    Dropped   = 3    ///< Gone (reported once, then forgotten)
+};
+
+[[nodiscard]] constexpr auto to_string(TrackState s) noexcept -> std::string_view {
+    switch (s) {
+        case TrackState::Tentative: return "tentative";
+        case TrackState::Confirmed: return "confirmed";
+        case TrackState::Coasting:  return "coasting";
+        case TrackState::Dropped:   return "dropped";
+    }
+    return "unknown";
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// LifecycleConfig — Trivial Class Pattern with Builder Methods
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Confirmation count, timeouts and wheel geometry.
+struct LifecycleConfig {
+    // Rule of Six: All Default
+    LifecycleConfig() = default;
+    ~LifecycleConfig() = default;
+    LifecycleConfig(const LifecycleConfig&) = default;
+    LifecycleConfig& operator=(const LifecycleConfig&) = default;
+    LifecycleConfig(LifecycleConfig&&) noexcept = default;
+    LifecycleConfig& operator=(LifecycleConfig&&) noexcept = default;
+
+    /// Reports that confirm a tentative target.
+    std::uint32_t confirm_updates{3};
+
+    /// Silence after which a target coasts (or, if tentative, drops).
+    std::chrono::milliseconds coast_after{5s};
+
+    /// Silence after which a coasting target drops (from its last report).
+    std::chrono::milliseconds drop_after{30s};
+
+    /// Wheel resolution; deadlines are reached within one tick.
+    std::chrono::milliseconds tick{250ms};
+
+    /// Wheel slots (span = slots × tick).
+    std::size_t slots{256};
+
+    [[nodiscard]] auto with_confirm_updates(std::uint32_t n) && -> LifecycleConfig {
+        confirm_updates = n;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_coast_after(std::chrono::milliseconds d) && -> LifecycleConfig {
+        coast_after = d;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_drop_after(std::chrono::milliseconds d) && -> LifecycleConfig {
+        drop_after = d;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_tick(std::chrono::milliseconds t) && -> LifecycleConfig {
+        tick = t;
+        return std::move(*this);
+    }
+};
+
+/// One state change.
+struct Transition {
+    std::uint64_t target_id{0};
+    TrackState from{TrackState::Tentative};
+    TrackState to{TrackState::Tentative};
+};
+
+/// Lifecycle counters.
+struct LifecycleStats {
+    std::uint64_t confirmed{0};      ///< Transitions into Confirmed (incl. resumed)
+    std::uint64_t coasted{0};
+    std::uint64_t dropped{0};
+    std::uint64_t fired{0};          ///< Wheel entries reached
+    std::uint64_t rearmed{0};        ///< ...of which had reported since
+    std::size_t tentative_now{0};
+    std::size_t confirmed_now{0};
+    std::size_t coasting_now{0};
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TimingWheel — Hashed Wheel of Target Ids
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Holds vectors (value type)
+// • Compiler-generated operations are correct
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Ids filed by deadline tick. The wheel does not know what a deadline
+/// means: advance() hands back every id whose slot came round, and the
+/// caller decides (drop it, or schedule() it again).
+class TimingWheel {
+public:
+    // Rule of Six: All Default
+    TimingWheel() = default;
+    ~TimingWheel() = default;
+    TimingWheel(const TimingWheel&) = default;
+    TimingWheel& operator=(const TimingWheel&) = default;
+    TimingWheel(TimingWheel&&) noexcept = default;
+    TimingWheel& operator=(TimingWheel&&) noexcept = default;
+
+    TimingWheel(std::chrono::nanoseconds tick, std::size_t slots)
+        : tick_ns_{std::max<std::int64_t>(tick.count(), 1)}, slots_(std::max<std::size_t>(slots, 1)) {}
+
+    /// File `id` to come round at `deadline_ns` (or the next tick, if due).
+    void schedule(std::uint64_t id, std::int64_t deadline_ns);
+
+    /// Visit the ids of every slot passed up to `now_ns`; each is removed
+    /// from the wheel before `fn` sees it.
+    template<typename F>
+    void advance(std::int64_t now_ns, F&& fn) {
+        const auto target = now_ns / tick_ns_;
+        // First call, or a long pause: one full turn visits every slot
+        const auto turns = static_cast<std::int64_t>(slots_.size());
+        if (!started_ || target - current_ > turns) {
+            started_ = true;
+            current_ = target - turns + 1;
+        }
+        while (current_ <= target) {
+            auto& slot = slots_[index(current_)];
+            // Cursor moves first, so an id scheduled from `fn` lands ahead
+            ++current_;
+            if (slot.empty()) {
+                continue;
+            }
+            firing_.swap(slot);
+            for (const auto id : firing_) {
+                fn(id);
+            }
+            firing_.clear();
+        }
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t;
+
+private:
+    [[nodiscard]] auto index(std::int64_t tick) const noexcept -> std::size_t {
+        return static_cast<std::size_t>(tick) % slots_.size();
+    }
+
+    std::int64_t tick_ns_{1};
+    std::vector<std::vector<std::uint64_t>> slots_{1};
+    std::vector<std::uint64_t> firing_;
+    std::int64_t current_{0};   ///< Next tick to visit
+    bool started_{false};
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TrackLifecycle — States, Counts and Deadlines per Target
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Holds vectors, a hash map and a TimingWheel (value type)
+// • Compiler-generated operations are correct
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Lifecycle of every target the store holds.
+///
+/// @par Thread Safety
+/// Not thread-safe.
+///
+/// @par Example
+/// @code
+/// TrackLifecycle life{LifecycleConfig{}.with_drop_after(30s)};
+/// life.observe(t.target_id, now_ns);             // on every accepted report
+/// for (const auto& tr : life.advance(now_ns)) {  // every tick
+///     if (tr.to == TrackState::Dropped) store.erase(tr.target_id);
+/// }
+/// @endcode
+class TrackLifecycle {
+public:
+    // Rule of Six: All Default
+    TrackLifecycle() = default;
+    ~TrackLifecycle() = default;
+    TrackLifecycle(const TrackLifecycle&) = default;
+    TrackLifecycle& operator=(const TrackLifecycle&) = default;
+    TrackLifecycle(TrackLifecycle&&) noexcept = default;
+    TrackLifecycle& operator=(TrackLifecycle&&) noexcept = default;
+
+    explicit TrackLifecycle(const LifecycleConfig& cfg)
+        : cfg_{cfg}, wheel_{cfg.tick, cfg.slots} {}
+
+    /// A report for `target_id` was accepted at `now_ns` (local clock).
+    /// Returns the transition it caused, if any.
+    auto observe(std::uint64_t target_id, std::int64_t now_ns) -> std::optional<Transition>;
+
+    /// Track a target already confirmed (restored from a snapshot or
+    /// journal), last heard at `last_ns`.
+    void restore(std::uint64_t target_id, std::int64_t last_ns);
+
+    /// Apply every timeout due by `now_ns`. Dropped targets are forgotten.
+    auto advance(std::int64_t now_ns) -> std::vector<Transition>;
+
+    [[nodiscard]] auto state(std::uint64_t target_id) const -> std::optional<TrackState>;
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return id_.size(); }
+    [[nodiscard]] auto stats() const noexcept -> LifecycleStats;
+    [[nodiscard]] auto config() const noexcept -> const LifecycleConfig& { return cfg_; }
+
+private:
+    [[nodiscard]] auto deadline(std::size_t i) const noexcept -> std::int64_t;
+    void add(std::uint64_t target_id, TrackState state, std::uint32_t updates, std::int64_t last_ns);
+    void remove(std::size_t i);
+
+    LifecycleConfig cfg_;
+    TimingWheel wheel_;
+
+    // Dense per-target state
+    std::vector<std::uint64_t> id_;
+    std::vector<std::int64_t> last_ns_;
+    std::vector<std::uint32_t> updates_;
+    std::vector<TrackState> state_;
+    std::unordered_map<std::uint64_t, std::size_t> index_;
+
+    LifecycleStats stats_;
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Codecs
+// ═══════════════════════════════════════════════════════════════════════════
+
+[[nodiscard]] inline auto encode_track_drop(std::span<const std::uint64_t> ids) -> std::string {
+    wire::ByteWriter w{wire::FrameKind::TrackDrop, 0, wire::kHeaderSize + 4 + ids.size() * 8};
+    w.put_u32(static_cast<std::uint32_t>(ids.size()));
+    for (const auto id : ids) {
+        w.put_u64(id);
+    }
+    return std::move(w).take();
+}
+
+/// Decode TrackDrop. Returns nullopt on malformed input.
+[[nodiscard]] inline auto decode_track_drop(std::string_view frame) -> std::optional<std::vector<std::uint64_t>> {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    if (!header || header->kind != wire::FrameKind::TrackDrop) {
+        return std::nullopt;
+    }
+    const auto count = r.get_u32();
+    if (!r.ok() || r.remaining() < static_cast<std::size_t>(count) * 8) {
+        return std::nullopt;
+    }
+    std::vector<std::uint64_t> out(count);
+    for (auto& id : out) {
+        id = r.get_u64();
+    }
+    if (!r.ok()) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+}  // namespace protocol
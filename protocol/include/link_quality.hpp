@@ -0,0 +1,429 @@
+#pragma once
+
+/// @file link_quality.hpp
+/// @brief Ping/pong round-trip measurement and link quality telemetry.
+///
+/// Demonstrates:
+/// - Log-linear latency histogram (fixed buckets, O(1) record)
+/// - RFC 6298 smoothed RTT and RFC 3550 interarrival jitter
+/// - Pong-loss accounting and stall detection ahead of the idle timeout
+/// - Peer clock-offset estimation from the peer's own probe pings
+/// - Clock as a template parameter for deterministic testing
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "wire.hpp"
+
+namespace protocol::link {
+
+using namespace std::chrono_literals;
+
+/// Wall-clock time in nanoseconds since the Unix epoch.
+[[nodiscard]] inline auto wall_clock_ns() noexcept -> std::int64_t {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// RttHistogram — Log-Linear Microsecond Histogram
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// BUCKET LAYOUT:
+// • 0–7 µs: one bucket per microsecond
+// • Above: 4 sub-buckets per power of two (≤ 25% relative error)
+// • Last bucket absorbs everything ≥ 2^28 µs (~4.5 min)
+//
+// RULE OF SIX RATIONALE:
+// • Contains a std::array of counters (trivially copyable)
+// • Compiler-generated operations are correct
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Fixed-size latency histogram.
+class RttHistogram {
+public:
+    static constexpr std::size_t kSubBuckets = 4;
+    static constexpr std::size_t kBuckets = 28 * kSubBuckets;
+
+    // Rule of Six: All Default
+    RttHistogram() = default;
+    ~RttHistogram() = default;
+    RttHistogram(const RttHistogram&) = default;
+    RttHistogram& operator=(const RttHistogram&) = default;
+    RttHistogram(RttHistogram&&) noexcept = default;
+    RttHistogram& operator=(RttHistogram&&) noexcept = default;
+
+    void record(std::chrono::microseconds rtt) noexcept {
+        const auto us = static_cast<std::uint64_t>(std::max<std::int64_t>(rtt.count(), 0));
+        ++counts_[bucket_for(us)];
+        ++total_;
+    }
+
+    /// Upper bound of the bucket holding the p-th percentile (0 < p ≤ 100).
+    [[nodiscard]] auto percentile(double p) const noexcept -> std::chrono::microseconds {
+        if (total_ == 0) {
+            return std::chrono::microseconds{0};
+        }
+        const auto rank = static_cast<std::uint64_t>(
+            std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * static_cast<double>(total_)));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            seen += counts_[i];
+            if (seen >= std::max<std::uint64_t>(rank, 1)) {
+                return std::chrono::microseconds{
+                    static_cast<std::int64_t>(lower_bound(i + 1))};
+            }
+        }
+        return std::chrono::microseconds{static_cast<std::int64_t>(lower_bound(kBuckets))};
+    }
+
+    [[nodiscard]] auto count() const noexcept -> std::uint64_t { return total_; }
+    [[nodiscard]] auto bucket(std::size_t i) const noexcept -> std::uint64_t { return counts_[i]; }
+
+    /// Smallest microsecond value that lands in bucket i.
+    [[nodiscard]] static constexpr auto lower_bound(std::size_t i) noexcept -> std::uint64_t {
+        if (i < 2 * kSubBuckets) {
+            return i;
+        }
+        const auto octave = i / kSubBuckets + 1;
+        const auto sub = i % kSubBuckets;
+        return (kSubBuckets + sub) << (octave - 2);
+    }
+
+    [[nodiscard]] static constexpr auto bucket_for(std::uint64_t us) noexcept -> std::size_t {
+        if (us < 2 * kSubBuckets) {
+            return static_cast<std::size_t>(us);
+        }
+        const auto octave = static_cast<std::size_t>(std::bit_width(us)) - 1;
+        const auto sub = static_cast<std::size_t>((us >> (octave - 2)) & (kSubBuckets - 1));
+        return std::min((octave - 1) * kSubBuckets + sub, kBuckets - 1);
+    }
+
+private:
+    std::array<std::uint64_t, kBuckets> counts_{};
+    std::uint64_t total_{0};
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Configuration & Report
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Link probing parameters.
+struct LinkQualityConfig {
+    // Rule of Six: All Default (trivial aggregate)
+    LinkQualityConfig() = default;
+    ~LinkQualityConfig() = default;
+    LinkQualityConfig(const LinkQualityConfig&) = default;
+    LinkQualityConfig& operator=(const LinkQualityConfig&) = default;
+    LinkQualityConfig(LinkQualityConfig&&) noexcept = default;
+    LinkQualityConfig& operator=(LinkQualityConfig&&) noexcept = default;
+
+    /// Interval between probe pings.
+    std::chrono::milliseconds ping_interval{1s};
+
+    /// A ping unanswered for this long counts as a lost pong.
+    std::chrono::milliseconds pong_timeout{3s};
+
+    /// No pong for this long declares the link stalled.
+    std::chrono::milliseconds stall_timeout{10s};
+
+    /// Peer pings kept for the clock-offset minimum filter.
+    std::size_t offset_window{16};
+
+    [[nodiscard]] auto with_ping_interval(std::chrono::milliseconds d) && -> LinkQualityConfig {
+        ping_interval = d;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_pong_timeout(std::chrono::milliseconds d) && -> LinkQualityConfig {
+        pong_timeout = d;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_stall_timeout(std::chrono::milliseconds d) && -> LinkQualityConfig {
+        stall_timeout = d;
+        return std::move(*this);
+    }
+};
+
+/// Point-in-time link quality report.
+struct LinkStats {
+    std::chrono::microseconds rtt_last{0};      ///< Most recent sample
+    std::chrono::microseconds rtt_smoothed{0};  ///< SRTT (RFC 6298)
+    std::chrono::microseconds rtt_min{0};       ///< Lowest sample seen
+    std::chrono::microseconds rtt_p50{0};
+    std::chrono::microseconds rtt_p99{0};
+    std::chrono::microseconds jitter{0};        ///< Interarrival jitter (RFC 3550)
+    std::uint64_t pings_sent{0};
+    std::uint64_t pongs_received{0};
+    std::uint64_t pongs_lost{0};
+    double loss_ratio{0.0};                     ///< lost / (received + lost)
+    bool stalled{false};
+    std::optional<std::chrono::nanoseconds> clock_offset;  ///< local − peer wall clock
+};
+
+/// Thrown by a session torn down because its link stalled.
+///
+/// Distinct type so retry predicates can treat it as transient.
+class LinkStalledError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/// Retry predicate: true when the error is a link stall.
+[[nodiscard]] inline auto is_link_stall(const std::exception_ptr& err) noexcept -> bool {
+    if (!err) {
+        return false;
+    }
+    try {
+        std::rethrow_exception(err);
+    } catch (const LinkStalledError&) {
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// LinkMonitor — Per-Connection Probe State
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// PROBE PAYLOAD (Probe frame, fits the 125-byte control-frame limit):
+//
+//   header(4) | seq u64 | sent_ns i64 (monotonic) | wall_ns i64 (epoch)
+//
+// The peer's WebSocket stack echoes the payload in its pong, so RTT needs
+// no per-ping lookup; the outstanding list exists only for loss accounting.
+// Pongs without a Probe header (e.g. Beast's idle keep-alive) are ignored.
+//
+// CLOCK OFFSET:
+// Both ends probe. A peer ping received at local wall time R carrying peer
+// wall time W gives R − W = offset + one-way delay. The smallest sample in
+// a sliding window has the least queueing; assuming a symmetric path, its
+// one-way delay is min RTT / 2:
+//
+//   offset (local − peer) ≈ min(R − W) − min RTT / 2
+//
+// RULE OF SIX RATIONALE:
+// • Contains a deque, histogram and PODs (all manage their own memory)
+// • Compiler-generated operations are correct
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Round-trip tracker for one WebSocket connection.
+///
+/// @par Thread Safety
+/// Not thread-safe; owned by one connection on one executor.
+///
+/// @tparam ClockT Monotonic clock (steady_clock in production)
+template<typename ClockT = std::chrono::steady_clock>
+class LinkMonitor {
+public:
+    using clock = ClockT;
+    using time_point = typename ClockT::time_point;
+    using duration = typename ClockT::duration;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: All Defaulted
+    // ───────────────────────────────────────────────────────────────────────
+
+    LinkMonitor() = default;
+    ~LinkMonitor() = default;
+    LinkMonitor(const LinkMonitor&) = default;
+    LinkMonitor& operator=(const LinkMonitor&) = default;
+    LinkMonitor(LinkMonitor&&) noexcept = default;
+    LinkMonitor& operator=(LinkMonitor&&) noexcept = default;
+
+    explicit LinkMonitor(LinkQualityConfig cfg, time_point now = clock::now())
+        : cfg_{std::move(cfg)}
+        , last_pong_{now}
+    {}
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Probing
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Build the next ping payload and record it as outstanding.
+    [[nodiscard]] auto make_ping(time_point now, std::int64_t wall_ns = wall_clock_ns())
+        -> std::string
+    {
+        const auto seq = next_seq_++;
+        outstanding_.push_back(Outstanding{seq, now});
+        ++sent_;
+
+        wire::ByteWriter w{wire::FrameKind::Probe, 0, wire::kHeaderSize + 24};
+        w.put_u64(seq);
+        w.put_i64(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            now.time_since_epoch()).count());
+        w.put_i64(wall_ns);
+        return std::move(w).take();
+    }
+
+    /// Record a ping sent by the peer (clock-offset sample).
+    void on_peer_ping(std::string_view payload, std::int64_t local_wall_ns) {
+        wire::ByteReader r{payload};
+        const auto header = r.get_header();
+        (void)r.get_u64();
+        (void)r.get_i64();
+        const auto peer_wall_ns = r.get_i64();
+        if (!header || header->kind != wire::FrameKind::Probe || !r.ok()) {
+            return;
+        }
+
+        offset_samples_.push_back(local_wall_ns - peer_wall_ns);
+        while (offset_samples_.size() > std::max<std::size_t>(cfg_.offset_window, 1)) {
+            offset_samples_.pop_front();
+        }
+    }
+
+    /// Record a pong. Returns the RTT when the payload is one of our probes.
+    auto on_pong(std::string_view payload, time_point now) -> std::optional<duration> {
+        wire::ByteReader r{payload};
+        const auto header = r.get_header();
+        const auto seq = r.get_u64();
+        const auto sent_ns = r.get_i64();
+        if (!header || header->kind != wire::FrameKind::Probe || !r.ok()) {
+            return std::nullopt;
+        }
+
+        // Drop the acknowledged probe; anything older was skipped by the peer
+        bool known = false;
+        while (!outstanding_.empty() && outstanding_.front().seq <= seq) {
+            if (outstanding_.front().seq == seq) {
+                known = true;
+            } else {
+                ++lost_;
+            }
+            outstanding_.pop_front();
+        }
+        if (!known) {
+            return std::nullopt;  // Late pong already counted as lost
+        }
+
+        const time_point sent{std::chrono::duration_cast<duration>(
+            std::chrono::nanoseconds{sent_ns})};
+        const auto rtt = std::max(now - sent, duration::zero());
+        record(rtt);
+        last_pong_ = now;
+        return rtt;
+    }
+
+    /// Age out unanswered probes. Call before each ping.
+    void expire(time_point now) {
+        while (!outstanding_.empty() && now - outstanding_.front().sent >= cfg_.pong_timeout) {
+            outstanding_.pop_front();
+            ++lost_;
+        }
+    }
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Queries
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// True when no pong has arrived for stall_timeout.
+    [[nodiscard]] auto stalled(time_point now) const noexcept -> bool {
+        return now - last_pong_ >= cfg_.stall_timeout;
+    }
+
+    [[nodiscard]] auto smoothed_rtt() const noexcept -> duration { return srtt_; }
+    [[nodiscard]] auto min_rtt() const noexcept -> duration { return min_rtt_; }
+    [[nodiscard]] auto has_samples() const noexcept -> bool { return histogram_.count() > 0; }
+    [[nodiscard]] auto histogram() const noexcept -> const RttHistogram& { return histogram_; }
+    [[nodiscard]] auto config() const noexcept -> const LinkQualityConfig& { return cfg_; }
+
+    /// Estimated local − peer wall-clock offset; add to a peer timestamp to
+    /// express it on the local clock. Empty until both directions have probed.
+    [[nodiscard]] auto clock_offset() const -> std::optional<std::chrono::nanoseconds> {
+        if (offset_samples_.empty() || !has_samples()) {
+            return std::nullopt;
+        }
+        const auto min_sample = *std::min_element(offset_samples_.begin(), offset_samples_.end());
+        const auto half_rtt = std::chrono::duration_cast<std::chrono::nanoseconds>(min_rtt_) / 2;
+        return std::chrono::nanoseconds{min_sample} - half_rtt;
+    }
+
+    [[nodiscard]] auto stats(time_point now) const -> LinkStats {
+        using std::chrono::duration_cast;
+        using us = std::chrono::microseconds;
+
+        const auto answered = histogram_.count();
+        LinkStats s;
+        s.rtt_last = duration_cast<us>(last_rtt_);
+        s.rtt_smoothed = duration_cast<us>(srtt_);
+        s.rtt_min = duration_cast<us>(min_rtt_);
+        s.rtt_p50 = histogram_.percentile(50.0);
+        s.rtt_p99 = histogram_.percentile(99.0);
+        s.jitter = duration_cast<us>(jitter_);
+        s.pings_sent = sent_;
+        s.pongs_received = answered;
+        s.pongs_lost = lost_;
+        s.loss_ratio = (answered + lost_) > 0
+            ? static_cast<double>(lost_) / static_cast<double>(answered + lost_)
+            : 0.0;
+        s.stalled = stalled(now);
+        s.clock_offset = clock_offset();
+        return s;
+    }
+
+private:
+    struct Outstanding {
+        std::uint64_t seq;
+        time_point sent;
+    };
+
+    void record(duration rtt) {
+        histogram_.record(std::chrono::duration_cast<std::chrono::microseconds>(rtt));
+
+        if (histogram_.count() == 1) {
+            srtt_ = rtt;
+            min_rtt_ = rtt;
+        } else {
+            // SRTT ← 7/8·SRTT + 1/8·R;  J ← J + (|ΔR| − J)/16
+            srtt_ = srtt_ + (rtt - srtt_) / 8;
+            min_rtt_ = std::min(min_rtt_, rtt);
+            const auto delta = rtt > last_rtt_ ? rtt - last_rtt_ : last_rtt_ - rtt;
+            jitter_ = jitter_ + (delta - jitter_) / 16;
+        }
+        last_rtt_ = rtt;
+    }
+
+    LinkQualityConfig cfg_;
+    RttHistogram histogram_;
+    std::deque<Outstanding> outstanding_;
+    std::deque<std::int64_t> offset_samples_;
+
+    std::uint64_t next_seq_{1};
+    std::uint64_t sent_{0};
+    std::uint64_t lost_{0};
+
+    duration last_rtt_{};
+    duration srtt_{};
+    duration min_rtt_{};
+    duration jitter_{};
+    time_point last_pong_{};
+};
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// Type Aliases
+// ───────────────────────────────────────────────────────────────────────────
+
+using SteadyLinkMonitor = LinkMonitor<std::chrono::steady_clock>;
+
+}  // namespace protocol::link
@@ -0,0 +1,340 @@
+#pragma once
+
+/// @file lod.hpp
+/// @brief Level-of-detail tile aggregates for zoomed-out consoles.
+///
+/// @code
+///   LodSubscribe  header | zoom u8 | lat_min f64 | lat_max f64 | lon_min f64 | lon_max f64
+///   LodBatch      header | zoom u8 | count u32 | count × Tile
+///     Tile        x u32 | y u32 | total u32 | max_urgency u8 | points u8 | points × Point
+///     Point       urgency u8 | count u32 | lat f64 | lon f64
+/// @endcode
+///
+/// The world is cut into 2^zoom × 2^zoom equal-angle tiles at each
+/// configured zoom. Every tile keeps, per urgency, the number of tracks in
+/// it and the sum of their positions; its representative points are the
+/// centroids of those classes, and its urgency is the highest class
+/// present. A report moves its track out of the old tile and into the new
+/// one at every level in O(levels), so the aggregates are always current
+/// and never rebuilt.
+///
+/// A console sends LodSubscribe with the zoom it renders and its viewport
+/// (zoom kUnsubscribe unsubscribes). It is served the deepest
+/// configured level not finer than its zoom: all non-empty tiles in view
+/// at once, then every interval the tiles in view that changed (a tile
+/// with total 0 has emptied). What a console receives is bounded by the
+/// tiles on its screen, not by the number of tracks.
+///
+/// Demonstrates:
+/// - Incrementally maintained multi-resolution aggregates (sums, not samples)
+/// - Dirty-tile deltas materialised once and filtered per viewport
+/// - Trivial Class Pattern with Builder Methods for configuration
+/// - Fail-soft decoding via ByteReader
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "protocol.hpp"
+#include "track.hpp"
+#include "wire.hpp"
+
+namespace protocol::lod {
+
+using namespace std::chrono_literals;
+
+/// Finest zoom a level may use (tile indices fit 32 bits).
+constexpr std::uint8_t kMaxZoom = 24;
+
+/// LodSubscribe zoom that ends a subscription.
+constexpr std::uint8_t kUnsubscribe = 0xFF;
+
+/// Urgency classes aggregated per tile (Green, Yellow, Red).
+constexpr std::size_t kClasses = 3;
+
+constexpr std::size_t kSubscribeSize = 1 + 4 * 8;
+constexpr std::size_t kTileHeaderSize = 4 + 4 + 4 + 1 + 1;
+constexpr std::size_t kPointSize = 1 + 4 + 8 + 8;
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// LodConfig — Trivial Class Pattern with Builder Methods
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Precomputed zoom levels and delta cadence.
+struct LodConfig {
+    // Rule of Six: All Default
+    LodConfig() = default;
+    ~LodConfig() = default;
+    LodConfig(const LodConfig&) = default;
+    LodConfig& operator=(const LodConfig&) = default;
+    LodConfig(LodConfig&&) noexcept = default;
+    LodConfig& operator=(LodConfig&&) noexcept = default;
+
+    /// Zoom levels maintained, coarsest first (each at most kMaxZoom).
+    std::vector<std::uint8_t> zooms{4, 7, 10};
+
+    /// Delta cadence when run by the server.
+    std::chrono::milliseconds interval{500ms};
+
+    [[nodiscard]] auto with_zooms(std::vector<std::uint8_t> z) && -> LodConfig {
+        zooms = std::move(z);
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_interval(std::chrono::milliseconds i) && -> LodConfig {
+        interval = i;
+        return std::move(*this);
+    }
+};
+
+/// Area a console shows (no antimeridian wrap: lon_min <= lon_max).
+struct Viewport {
+    double lat_min{-90.0};
+    double lat_max{90.0};
+    double lon_min{-180.0};
+    double lon_max{180.0};
+};
+
+/// What a console asks for.
+struct Subscription {
+    std::uint8_t zoom{0};
+    Viewport view;
+};
+
+/// Centroid of the tracks of one urgency in a tile.
+struct Point {
+    Urgency urgency{Urgency::Green};
+    std::uint32_t count{0};
+    double lat{0.0};
+    double lon{0.0};
+};
+
+/// One tile as a console renders it.
+struct Tile {
+    std::uint32_t x{0};              ///< Column from lon −180
+    std::uint32_t y{0};              ///< Row from lat −90
+    std::uint32_t total{0};          ///< 0: the tile has emptied
+    Urgency max_urgency{Urgency::Green};
+    std::vector<Point> points;       ///< One per urgency present
+};
+
+/// Changed tiles of one level, for one delta.
+struct LevelDelta {
+    std::uint8_t zoom{0};
+    std::vector<Tile> tiles;
+};
+
+/// Aggregation counters.
+struct LodStats {
+    std::uint64_t updates{0};        ///< Reports fed in
+    std::uint64_t moves{0};          ///< Tile changes summed over levels
+    std::uint64_t deltas{0};
+    std::uint64_t tiles_changed{0};  ///< Summed over deltas and levels
+    std::size_t tracks{0};           ///< Currently held
+    std::size_t tiles{0};            ///< Non-empty, all levels
+};
+
+/// True when `tile` at `zoom` holds part of `view`.
+[[nodiscard]] auto in_view(std::uint8_t zoom, const Tile& tile, const Viewport& view) noexcept -> bool;
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// LodIndex — Per-Level Tile Aggregates
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Holds hash maps and vectors (value type)
+// • Compiler-generated operations are correct
+//
+// UPDATE:
+// • First report of a target: add to its tile at every level
+// • Later reports: per level, if the tile key changed, subtract from the
+//   old tile and add to the new; else adjust the position sums in place.
+//   Either way the tiles are queued dirty once per delta.
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Tile aggregates of the latest report of every target.
+///
+/// @par Thread Safety
+/// Not thread-safe.
+///
+/// @par Example
+/// @code
+/// LodIndex lod{LodConfig{}.with_zooms({4, 8})};
+/// for (const auto& t : batch) lod.update(t);
+/// for (const auto& level : lod.drain()) { ... }   // send in-view tiles
+/// @endcode
+class LodIndex {
+public:
+    // Rule of Six: All Default
+    LodIndex() = default;
+    ~LodIndex() = default;
+    LodIndex(const LodIndex&) = default;
+    LodIndex& operator=(const LodIndex&) = default;
+    LodIndex(LodIndex&&) noexcept = default;
+    LodIndex& operator=(LodIndex&&) noexcept = default;
+
+    /// Levels are the configured zooms, sorted and capped at kMaxZoom.
+    explicit LodIndex(const LodConfig& cfg);
+
+    /// Move a target to its reported position and urgency.
+    void update(const TrackUpdate& t);
+
+    /// Take a target out of its tiles (e.g. dropped by the lifecycle).
+    void remove(std::uint64_t target_id);
+
+    /// Tiles changed since the last drain(), per level (levels without
+    /// changes omitted).
+    auto drain() -> std::vector<LevelDelta>;
+
+    /// Deepest level not finer than `zoom` (the coarsest if all are).
+    [[nodiscard]] auto level_for(std::uint8_t zoom) const noexcept -> std::uint8_t;
+
+    /// Non-empty tiles of level `zoom` (as from level_for()) inside `view`.
+    [[nodiscard]] auto tiles(std::uint8_t zoom, const Viewport& view) const -> std::vector<Tile>;
+
+    [[nodiscard]] auto stats() const noexcept -> LodStats;
+    [[nodiscard]] auto config() const noexcept -> const LodConfig& { return cfg_; }
+
+private:
+    struct Aggregate {
+        std::array<std::uint32_t, kClasses> count{};
+        std::array<double, kClasses> lat{};   ///< Sums
+        std::array<double, kClasses> lon{};
+        bool dirty{false};
+    };
+
+    struct Level {
+        std::uint8_t zoom{0};
+        std::unordered_map<std::uint64_t, Aggregate> tiles;
+        std::vector<std::uint64_t> dirty;
+    };
+
+    struct Held {
+        double lat{0.0};
+        double lon{0.0};
+        std::size_t cls{0};
+    };
+
+    [[nodiscard]] static auto key_of(std::uint8_t zoom, double lat, double lon) noexcept -> std::uint64_t;
+    [[nodiscard]] static auto make_tile(std::uint64_t key, const Aggregate& a) -> Tile;
+    static void mark(Level& level, std::uint64_t key, Aggregate& a);
+
+    LodConfig cfg_;
+    std::vector<Level> levels_;
+    std::unordered_map<std::uint64_t, Held> tracks_;
+    LodStats stats_;
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Codecs
+// ═══════════════════════════════════════════════════════════════════════════
+
+[[nodiscard]] inline auto encode_subscribe(const Subscription& s) -> std::string {
+    wire::ByteWriter w{wire::FrameKind::LodSubscribe, 0, wire::kHeaderSize + kSubscribeSize};
+    w.put_u8(s.zoom);
+    w.put_f64(s.view.lat_min);
+    w.put_f64(s.view.lat_max);
+    w.put_f64(s.view.lon_min);
+    w.put_f64(s.view.lon_max);
+    return std::move(w).take();
+}
+
+/// Decode LodSubscribe. Returns nullopt on malformed input or an
+/// inverted viewport.
+[[nodiscard]] inline auto decode_subscribe(std::string_view frame) -> std::optional<Subscription> {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    if (!header || header->kind != wire::FrameKind::LodSubscribe) {
+        return std::nullopt;
+    }
+    Subscription s;
+    s.zoom = r.get_u8();
+    s.view.lat_min = r.get_f64();
+    s.view.lat_max = r.get_f64();
+    s.view.lon_min = r.get_f64();
+    s.view.lon_max = r.get_f64();
+    if (!r.ok() || !(s.view.lat_min <= s.view.lat_max) || !(s.view.lon_min <= s.view.lon_max)) {
+        return std::nullopt;
+    }
+    return s;
+}
+
+[[nodiscard]] inline auto encode_tiles(std::uint8_t zoom, const std::vector<const Tile*>& tiles) -> std::string {
+    std::size_t size = wire::kHeaderSize + 1 + 4;
+    for (const auto* t : tiles) {
+        size += kTileHeaderSize + t->points.size() * kPointSize;
+    }
+    wire::ByteWriter w{wire::FrameKind::LodBatch, 0, size};
+    w.put_u8(zoom);
+    w.put_u32(static_cast<std::uint32_t>(tiles.size()));
+    for (const auto* t : tiles) {
+        w.put_u32(t->x);
+        w.put_u32(t->y);
+        w.put_u32(t->total);
+        w.put_u8(static_cast<std::uint8_t>(t->max_urgency));
+        w.put_u8(static_cast<std::uint8_t>(t->points.size()));
+        for (const auto& p : t->points) {
+            w.put_u8(static_cast<std::uint8_t>(p.urgency));
+            w.put_u32(p.count);
+            w.put_f64(p.lat);
+            w.put_f64(p.lon);
+        }
+    }
+    return std::move(w).take();
+}
+
+/// Decode LodBatch. Returns nullopt on malformed input.
+[[nodiscard]] inline auto decode_tiles(std::string_view frame) -> std::optional<LevelDelta> {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    if (!header || header->kind != wire::FrameKind::LodBatch) {
+        return std::nullopt;
+    }
+    LevelDelta out;
+    out.zoom = r.get_u8();
+    const auto count = r.get_u32();
+    if (!r.ok() || r.remaining() < static_cast<std::size_t>(count) * kTileHeaderSize) {
+        return std::nullopt;
+    }
+    out.tiles.resize(count);
+    for (auto& t : out.tiles) {
+        t.x = r.get_u32();
+        t.y = r.get_u32();
+        t.total = r.get_u32();
+        const auto max_urgency = r.get_u8();
+        const auto points = r.get_u8();
+        if (!r.ok() || max_urgency >= kClasses || points > kClasses
+            || r.remaining() < static_cast<std::size_t>(points) * kPointSize) {
+            return std::nullopt;
+        }
+        t.max_urgency = static_cast<Urgency>(max_urgency);
+        t.points.resize(points);
+        for (auto& p : t.points) {
+            const auto urgency = r.get_u8();
+            if (urgency >= kClasses) {
+                return std::nullopt;
+            }
+            p.urgency = static_cast<Urgency>(urgency);
+            p.count = r.get_u32();
+            p.lat = r.get_f64();
+            p.lon = r.get_f64();
+        }
+    }
+    if (!r.ok()) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+}  // namespace protocol::lod
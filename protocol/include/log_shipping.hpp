@@ -0,0 +1,112 @@
+#pragma once
+
+/// @file log_shipping.hpp
+/// @brief Primary → standby journal shipping frames.
+///
+/// @code
+///   StandbyHello  header | next_seq u64
+///   JournalBatch  header | primary_last_seq u64 | u32 count | journal records
+///   JournalAck    header | seq u64
+/// @endcode
+///
+/// The standby connects to the primary like any client, sends StandbyHello
+/// with the first sequence it is missing, and acks each applied batch.
+/// primary_last_seq lets the standby report how far behind it is.
+///
+/// Demonstrates:
+/// - Reuse of the journal record codec on the wire
+/// - Fail-soft decoding via ByteReader
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "journal.hpp"
+#include "wire.hpp"
+
+namespace protocol::shipping {
+
+/// Decoded JournalBatch.
+struct JournalBatch {
+    std::uint64_t primary_last_seq{0};
+    std::vector<JournalRecord> records;
+};
+
+[[nodiscard]] inline auto encode_standby_hello(std::uint64_t next_seq) -> std::string {
+    wire::ByteWriter w{wire::FrameKind::StandbyHello, 0, wire::kHeaderSize + 8};
+    w.put_u64(next_seq);
+    return std::move(w).take();
+}
+
+[[nodiscard]] inline auto decode_standby_hello(std::string_view frame) noexcept
+    -> std::optional<std::uint64_t>
+{
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    const auto next_seq = r.get_u64();
+    if (!header || header->kind != wire::FrameKind::StandbyHello || !r.ok()) {
+        return std::nullopt;
+    }
+    return next_seq;
+}
+
+[[nodiscard]] inline auto encode_journal_batch(std::uint64_t primary_last_seq,
+                                               std::span<const JournalRecord> records)
+    -> std::string
+{
+    wire::ByteWriter w{wire::FrameKind::JournalBatch, 0,
+                       wire::kHeaderSize + 8 + 4 + records.size() * kJournalRecordSize};
+    w.put_u64(primary_last_seq);
+    w.put_u32(static_cast<std::uint32_t>(records.size()));
+    for (const auto& rec : records) {
+        encode_journal_record(w, rec);
+    }
+    return std::move(w).take();
+}
+
+[[nodiscard]] inline auto decode_journal_batch(std::string_view frame) -> std::optional<JournalBatch> {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    if (!header || header->kind != wire::FrameKind::JournalBatch) {
+        return std::nullopt;
+    }
+
+    JournalBatch out;
+    out.primary_last_seq = r.get_u64();
+    const auto count = r.get_u32();
+    if (!r.ok() || r.remaining() < static_cast<std::size_t>(count) * kJournalRecordSize) {
+        return std::nullopt;
+    }
+    out.records.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        out.records.push_back(decode_journal_record(r));
+    }
+    if (!r.ok()) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+[[nodiscard]] inline auto encode_journal_ack(std::uint64_t seq) -> std::string {
+    wire::ByteWriter w{wire::FrameKind::JournalAck, 0, wire::kHeaderSize + 8};
+    w.put_u64(seq);
+    return std::move(w).take();
+}
+
+[[nodiscard]] inline auto decode_journal_ack(std::string_view frame) noexcept
+    -> std::optional<std::uint64_t>
+{
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    const auto seq = r.get_u64();
+    if (!header || header->kind != wire::FrameKind::JournalAck || !r.ok()) {
+        return std::nullopt;
+    }
+    return seq;
+}
+
+}  // namespace protocol::shipping
@@ -0,0 +1,239 @@
+#pragma once
+
+/// @file mirror.hpp
+/// @brief Compressed track-table snapshots for mirroring clients, and the
+///        server-side cache that shares them.
+///
+/// @code
+///   Subscribe      header | [mode u8]
+///   TrackSnapshot  header | seq u64 | part u16 | parts u16 | count u32 | size u32 | size bytes
+///     record       (varints, records sorted by target_id)
+///                  id Δ | time zigzag Δ | lat zigzag Δ | lon zigzag Δ | alt zigzag Δ
+///                  | vn zigzag | ve zigzag | vu zigzag | urgency u8
+/// @endcode
+///
+/// A console that keeps its own copy of the track table subscribes with
+/// mode kModeMirror. Instead of one TrackBatch per stored track it is sent
+/// a snapshot, then the ordinary track feed. Every feed batch carries its
+/// session's feed sequence (wire::kFlagFeedSeq). The snapshot carries a
+/// sequence too, and the session's feed continues from it: a mirror
+/// applies batch seq+1, seq+2, … on top of the snapshot, and any other
+/// sequence is a gap that it repairs by subscribing again.
+///
+/// A snapshot is a set of `parts` frames of at most kSnapshotChunk records
+/// each (so no frame nears a WebSocket message limit), sent back to back.
+/// Part 0 replaces the table; the table is complete after the last part.
+///
+/// Snapshot records are sorted by id and delta-coded against the previous
+/// record of their part as LEB128 varints. Positions are quantised to
+/// 1e-7° (about 1 cm), altitude to centimetres and velocities to cm/s; the
+/// feed that follows is exact, so a quantised track is corrected by its
+/// next report.
+///
+/// @par Snapshot Cache
+/// Encoding the table for each subscriber would cost the most exactly when
+/// it is least affordable: every console re-subscribing after a network
+/// blip. SnapshotCache holds one encoded frame set, shared immutably by
+/// every subscriber, with the store change sequence it was built at. It
+/// follows store changes (ids only) from then on; a subscriber is sent the
+/// cached frames, then catches up with the current state of the targets
+/// changed since, and a TrackDrop for those removed since. The cache is
+/// rebuilt on demand once it is older than max_age or the catch-up has
+/// grown past max_changed of the table.
+///
+/// Demonstrates:
+/// - Sort + delta + zigzag + varint compression without a codec dependency
+/// - Sequence numbers that make a snapshot and a delta stream composable
+/// - Immutable encoded frames shared across sessions (shared_ptr to const)
+/// - Trivial Class Pattern with Builder Methods for configuration
+/// - Fail-soft decoding via ByteReader
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "track.hpp"
+#include "track_store.hpp"
+#include "wire.hpp"
+
+namespace protocol::mirror {
+
+/// Subscribe payload: legacy feed (one TrackBatch per stored track first).
+constexpr std::uint8_t kModeFeed = 0;
+
+/// Subscribe payload: TrackSnapshot first, then the sequenced feed.
+constexpr std::uint8_t kModeMirror = 1;
+
+/// Most records in one TrackSnapshot frame.
+constexpr std::size_t kSnapshotChunk = 65536;
+
+/// An encoded snapshot frame, shared by every session sending it.
+using SharedFrame = std::shared_ptr<const std::string>;
+
+/// One decoded TrackSnapshot frame.
+struct Snapshot {
+    std::uint64_t seq{0};             ///< Last change the snapshot contains
+    std::uint16_t part{0};
+    std::uint16_t parts{1};
+    std::vector<TrackUpdate> tracks;  ///< Sorted by target_id
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SnapshotCacheConfig — Trivial Class Pattern with Builder Methods
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// When a cached snapshot is rebuilt.
+struct SnapshotCacheConfig {
+    // Rule of Six: All Default
+    SnapshotCacheConfig() = default;
+    ~SnapshotCacheConfig() = default;
+    SnapshotCacheConfig(const SnapshotCacheConfig&) = default;
+    SnapshotCacheConfig& operator=(const SnapshotCacheConfig&) = default;
+    SnapshotCacheConfig(SnapshotCacheConfig&&) noexcept = default;
+    SnapshotCacheConfig& operator=(SnapshotCacheConfig&&) noexcept = default;
+
+    /// Oldest snapshot handed to a subscriber.
+    std::chrono::milliseconds max_age{1000};
+
+    /// Rebuild once targets changed since the build exceed this fraction
+    /// of the table (bounds every subscriber's catch-up).
+    double max_changed{0.25};
+
+    [[nodiscard]] auto with_max_age(std::chrono::milliseconds age) && -> SnapshotCacheConfig {
+        max_age = age;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_max_changed(double fraction) && -> SnapshotCacheConfig {
+        max_changed = fraction;
+        return std::move(*this);
+    }
+};
+
+/// Cache counters.
+struct SnapshotCacheStats {
+    std::uint64_t builds{0};
+    std::uint64_t served{0};          ///< Subscribers sent a cached snapshot
+    std::uint64_t catch_up_tracks{0}; ///< Changed targets sent after it
+    std::uint64_t catch_up_drops{0};  ///< Removed targets sent after it
+    std::size_t tracks{0};            ///< In the current snapshot
+    std::size_t frames{0};
+    std::size_t bytes{0};
+};
+
+/// What to send a new subscriber, in order.
+struct CachedSnapshot {
+    std::uint64_t seq{0};                 ///< Store change sequence of the build
+    std::vector<SharedFrame> frames;      ///< TrackSnapshot parts
+    std::vector<TrackUpdate> changed;     ///< Current state of targets changed since
+    std::vector<std::uint64_t> dropped;   ///< Targets removed since
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SnapshotCache — Shared Encoded Snapshot with Change Catch-Up
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Owns vectors, hash sets and shared_ptrs to immutable frames
+// • Copies share the frames, which never change (value semantics hold)
+// • Compiler-generated operations are correct
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Encoded snapshot of a TrackStore, rebuilt on demand.
+///
+/// @par Thread Safety
+/// Not thread-safe; owned by the server's io_context thread. The frames
+/// it hands out are immutable and may be read from any thread.
+///
+/// @par Example
+/// @code
+/// store.set_on_apply([&](const StoredTrack& t) { cache.on_apply(t.update.target_id); });
+/// const auto snap = cache.take(store, now_ns);   // frames, then catch-up
+/// @endcode
+class SnapshotCache {
+public:
+    // Rule of Six: All Default
+    SnapshotCache() = default;
+    ~SnapshotCache() = default;
+    SnapshotCache(const SnapshotCache&) = default;
+    SnapshotCache& operator=(const SnapshotCache&) = default;
+    SnapshotCache(SnapshotCache&&) noexcept = default;
+    SnapshotCache& operator=(SnapshotCache&&) noexcept = default;
+
+    explicit SnapshotCache(const SnapshotCacheConfig& cfg) : cfg_{cfg} {}
+
+    /// A target was stored (every accepted TrackStore::apply()).
+    void on_apply(std::uint64_t target_id);
+
+    /// A target was removed from the store.
+    void on_erase(std::uint64_t target_id);
+
+    /// Snapshot for one new subscriber, rebuilding first when stale.
+    [[nodiscard]] auto take(const TrackStore& store, std::int64_t now_ns) -> CachedSnapshot;
+
+    /// Store changes seen (the sequence a build is stamped with).
+    [[nodiscard]] auto seq() const noexcept -> std::uint64_t { return seq_; }
+
+    [[nodiscard]] auto stats() const noexcept -> const SnapshotCacheStats& { return stats_; }
+    [[nodiscard]] auto config() const noexcept -> const SnapshotCacheConfig& { return cfg_; }
+
+private:
+    void rebuild(const TrackStore& store, std::int64_t now_ns);
+
+    SnapshotCacheConfig cfg_;
+    std::uint64_t seq_{0};
+
+    // Current build (none until the first subscriber)
+    bool built_{false};
+    std::int64_t built_ns_{0};
+    std::uint64_t built_seq_{0};
+    std::vector<SharedFrame> frames_;
+
+    /// Targets stored or removed since the build (tracked only once built).
+    std::unordered_set<std::uint64_t> changed_;
+    std::unordered_set<std::uint64_t> dropped_;
+
+    SnapshotCacheStats stats_;
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Codecs
+// ═══════════════════════════════════════════════════════════════════════════
+
+[[nodiscard]] inline auto encode_subscribe(std::uint8_t mode) -> std::string {
+    wire::ByteWriter w{wire::FrameKind::Subscribe, 0, wire::kHeaderSize + 1};
+    w.put_u8(mode);
+    return std::move(w).take();
+}
+
+/// Subscribe mode; a header-only Subscribe is kModeFeed.
+[[nodiscard]] inline auto decode_subscribe(std::string_view frame) noexcept -> std::uint8_t {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    if (!header || header->kind != wire::FrameKind::Subscribe || r.remaining() == 0) {
+        return kModeFeed;
+    }
+    return r.get_u8();
+}
+
+/// Encode TrackSnapshot frames of at most `chunk` records (sorts a copy of
+/// `tracks` by id). An empty table is one empty part.
+[[nodiscard]] auto encode_snapshot(std::span<const TrackUpdate> tracks, std::uint64_t seq,
+                                   std::size_t chunk = kSnapshotChunk) -> std::vector<std::string>;
+
+/// Decode one TrackSnapshot frame. Returns nullopt on malformed input.
+[[nodiscard]] auto decode_snapshot(std::string_view frame) -> std::optional<Snapshot>;
+
+}  // namespace protocol::mirror
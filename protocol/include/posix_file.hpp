@@ -0,0 +1,175 @@
+#pragma once
+
+/// @file posix_file.hpp
+/// @brief Move-only RAII wrappers over a POSIX file descriptor and mapping.
+///
+/// Demonstrates:
+/// - Rule of Six: Move-only resources (std::exchange on the handle)
+/// - Positional I/O (pread/pwrite) without a shared file offset
+/// - Read-only mmap for zero-copy bulk loads
+/// - std::system_error for OS failures
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <utility>
+
+namespace protocol {
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PosixFile — Move-Only Resource Class
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+//
+// A file descriptor is a unique OS resource.
+//
+// DECISION: Move-only semantics
+// • Default ctor: Not-open handle (fd = -1)
+// • Destructor: Closes the descriptor
+// • Copy ops: DELETED — a descriptor must have one owner
+// • Move ops: std::exchange the descriptor, leaving -1 behind
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Owned file descriptor.
+///
+/// All operations throw std::system_error on failure; short reads at end of
+/// file are not failures.
+class PosixFile {
+public:
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: Move-Only Pattern
+    // ───────────────────────────────────────────────────────────────────────
+
+    PosixFile() = default;
+    ~PosixFile() { close(); }
+    PosixFile(const PosixFile&) = delete;
+    PosixFile& operator=(const PosixFile&) = delete;
+
+    PosixFile(PosixFile&& other) noexcept
+        : fd_{std::exchange(other.fd_, -1)}
+    {}
+
+    PosixFile& operator=(PosixFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            fd_ = std::exchange(other.fd_, -1);
+        }
+        return *this;
+    }
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Factory Methods
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Open (or create, for writing) an append-only file.
+    [[nodiscard]] static auto open_append(const std::filesystem::path& path) -> PosixFile;
+
+    /// Open (creating if needed) for positional reads and writes.
+    [[nodiscard]] static auto open_read_write(const std::filesystem::path& path) -> PosixFile;
+
+    /// Open an existing file read-only.
+    [[nodiscard]] static auto open_read(const std::filesystem::path& path) -> PosixFile;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // I/O
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Write all bytes at the current offset (append mode: end of file).
+    void write_all(std::string_view data);
+
+    /// Write all bytes at `offset`.
+    void pwrite_all(std::string_view data, std::uint64_t offset);
+
+    /// Read up to out.size() bytes at `offset`; returns bytes read.
+    auto pread_some(std::span<char> out, std::uint64_t offset) const -> std::size_t;
+
+    /// Current file size.
+    [[nodiscard]] auto size() const -> std::uint64_t;
+
+    /// Shrink or extend the file to `length` bytes.
+    void truncate(std::uint64_t length);
+
+    /// Flush file data to stable storage.
+    void sync();
+
+    /// Close now (idempotent, never throws).
+    void close() noexcept;
+
+    [[nodiscard]] auto is_open() const noexcept -> bool { return fd_ >= 0; }
+    [[nodiscard]] auto fd() const noexcept -> int { return fd_; }
+
+private:
+    explicit PosixFile(int fd) noexcept : fd_{fd} {}
+
+    int fd_{-1};
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// MappedFile — Move-Only Resource Class
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Owns one read-only mapping (munmap in the destructor)
+// • Copy ops: DELETED — a mapping must have one owner
+// • Move ops: std::exchange the address, leaving nullptr behind
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Whole-file read-only memory map (empty files map to an empty view).
+class MappedFile {
+public:
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: Move-Only Pattern
+    // ───────────────────────────────────────────────────────────────────────
+
+    MappedFile() = default;
+    ~MappedFile() { unmap(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : data_{std::exchange(other.data_, nullptr)}
+        , size_{std::exchange(other.size_, 0)}
+    {}
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    /// Map an existing file for sequential reading.
+    ///
+    /// @throws std::system_error if the file cannot be opened or mapped
+    [[nodiscard]] static auto map_read(const std::filesystem::path& path) -> MappedFile;
+
+    [[nodiscard]] auto bytes() const noexcept -> std::string_view {
+        return data_ ? std::string_view{static_cast<const char*>(data_), size_} : std::string_view{};
+    }
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return size_; }
+
+private:
+    MappedFile(void* data, std::size_t size) noexcept : data_{data}, size_{size} {}
+
+    void unmap() noexcept;
+
+    void* data_{nullptr};
+    std::size_t size_{0};
+};
+
+
+/// Replace `path` with `data` atomically: write a sibling temp file,
+/// fdatasync it, rename it over `path` and sync the directory.
+///
+/// @throws std::system_error on I/O failure (the old file is left intact)
+void write_file_atomic(const std::filesystem::path& path, std::string_view data);
+
+}  // namespace protocol
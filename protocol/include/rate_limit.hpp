@@ -0,0 +1,382 @@
+#pragma once
+
+/// @file rate_limit.hpp
+/// @brief Token-bucket ingest rate limiting for WebSocket sessions.
+///
+/// Demonstrates:
+/// - Debt-based token buckets that yield a pause instead of a drop
+/// - Per-record urgency cost overrides (RED records skip the message budget)
+/// - Rule of Six for value-type limiter state
+/// - Clock as a template parameter for deterministic testing
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "protocol.hpp"
+
+namespace protocol::ratelimit {
+
+using namespace std::chrono_literals;
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Defaults
+// ═══════════════════════════════════════════════════════════════════════════
+
+constexpr double kDefaultMessagesPerSec = 500.0;
+constexpr double kDefaultMessageBurst = 1000.0;
+constexpr double kDefaultBytesPerSec = 4.0 * 1024 * 1024;
+constexpr double kDefaultByteBurst = 8.0 * 1024 * 1024;
+constexpr double kDefaultSourceScale = 4.0;
+constexpr double kDefaultPeerScale = 16.0;
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TokenBucket — Debt-Based Token Bucket
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// A classic bucket refuses work when empty. For ingest we always accept the
+// frame that is already in memory and let the balance go negative; the
+// returned duration is how long the reader must pause before the balance is
+// back to zero. Pausing the read loop lets TCP flow control push back on the
+// sender instead of silently dropping telemetry.
+//
+// RULE OF SIX RATIONALE:
+// • Contains doubles and a time_point (trivially copyable)
+// • Compiler-generated operations are correct
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Token bucket refilled continuously at a fixed rate.
+///
+/// A non-positive rate disables the bucket (every consume is free).
+///
+/// @tparam ClockT Monotonic clock (steady_clock in production)
+template<typename ClockT = std::chrono::steady_clock>
+class TokenBucket {
+public:
+    using clock = ClockT;
+    using time_point = typename ClockT::time_point;
+    using duration = typename ClockT::duration;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: All Defaulted
+    // ───────────────────────────────────────────────────────────────────────
+
+    TokenBucket() = default;
+    ~TokenBucket() = default;
+    TokenBucket(const TokenBucket&) = default;
+    TokenBucket& operator=(const TokenBucket&) = default;
+    TokenBucket(TokenBucket&&) noexcept = default;
+    TokenBucket& operator=(TokenBucket&&) noexcept = default;
+
+    /// Construct full bucket.
+    ///
+    /// @param rate Tokens added per second
+    /// @param burst Bucket capacity
+    /// @param now Initial refill timestamp
+    TokenBucket(double rate, double burst, time_point now = ClockT::now()) noexcept
+        : rate_{rate}
+        , burst_{std::max(burst, 0.0)}
+        , tokens_{std::max(burst, 0.0)}
+        , last_{now}
+    {}
+
+    /// Debit tokens unconditionally.
+    ///
+    /// @return Time until the balance is non-negative again (zero if in credit)
+    auto consume(double tokens, time_point now) noexcept -> duration {
+        if (!enabled()) {
+            return duration::zero();
+        }
+        refill(now);
+        tokens_ -= tokens;
+        return deficit_delay();
+    }
+
+    /// Debit tokens only if the bucket currently holds enough.
+    [[nodiscard]] auto try_consume(double tokens, time_point now) noexcept -> bool {
+        if (!enabled()) {
+            return true;
+        }
+        refill(now);
+        if (tokens_ < tokens) {
+            return false;
+        }
+        tokens_ -= tokens;
+        return true;
+    }
+
+    /// Current balance (negative while in debt).
+    [[nodiscard]] auto available(time_point now) noexcept -> double {
+        refill(now);
+        return tokens_;
+    }
+
+    /// True once the bucket has refilled to capacity (always when disabled).
+    [[nodiscard]] auto full(time_point now) noexcept -> bool {
+        return !enabled() || available(now) >= burst_;
+    }
+
+    [[nodiscard]] auto enabled() const noexcept -> bool { return rate_ > 0.0; }
+    [[nodiscard]] auto rate() const noexcept -> double { return rate_; }
+    [[nodiscard]] auto burst() const noexcept -> double { return burst_; }
+
+private:
+    void refill(time_point now) noexcept {
+        if (now <= last_) {
+            return;
+        }
+        const std::chrono::duration<double> elapsed = now - last_;
+        tokens_ = std::min(burst_, tokens_ + elapsed.count() * rate_);
+        last_ = now;
+    }
+
+    [[nodiscard]] auto deficit_delay() const noexcept -> duration {
+        if (tokens_ >= 0.0) {
+            return duration::zero();
+        }
+        const std::chrono::duration<double> wait{-tokens_ / rate_};
+        return std::chrono::ceil<duration>(wait);
+    }
+
+    double rate_{0.0};
+    double burst_{0.0};
+    double tokens_{0.0};
+    time_point last_{};
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IngestLimitConfig — Configuration Value Class
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Ingest limits for one session and for one source address.
+///
+/// Source limits apply to the sum of all sessions opened from the same
+/// remote address, so a replay tool cannot dodge limits by fanning out.
+/// A session that identifies itself as a peer node carries a whole
+/// node's traffic: it leaves both and is held to the peer budget alone.
+struct IngestLimitConfig {
+    // Rule of Six: All Default (trivial aggregate)
+    IngestLimitConfig() = default;
+    ~IngestLimitConfig() = default;
+    IngestLimitConfig(const IngestLimitConfig&) = default;
+    IngestLimitConfig& operator=(const IngestLimitConfig&) = default;
+    IngestLimitConfig(IngestLimitConfig&&) noexcept = default;
+    IngestLimitConfig& operator=(IngestLimitConfig&&) noexcept = default;
+
+    /// Per-session message rate and burst.
+    double messages_per_sec{kDefaultMessagesPerSec};
+    double message_burst{kDefaultMessageBurst};
+
+    /// Per-session byte rate and burst.
+    double bytes_per_sec{kDefaultBytesPerSec};
+    double byte_burst{kDefaultByteBurst};
+
+    /// Per-source message rate and burst.
+    double source_messages_per_sec{kDefaultMessagesPerSec * kDefaultSourceScale};
+    double source_message_burst{kDefaultMessageBurst * kDefaultSourceScale};
+
+    /// Per-source byte rate and burst.
+    double source_bytes_per_sec{kDefaultBytesPerSec * kDefaultSourceScale};
+    double source_byte_burst{kDefaultByteBurst * kDefaultSourceScale};
+
+    /// Message rate and burst of one identified peer node.
+    double peer_messages_per_sec{kDefaultMessagesPerSec * kDefaultPeerScale};
+    double peer_message_burst{kDefaultMessageBurst * kDefaultPeerScale};
+
+    /// Byte rate and burst of one identified peer node.
+    double peer_bytes_per_sec{kDefaultBytesPerSec * kDefaultPeerScale};
+    double peer_byte_burst{kDefaultByteBurst * kDefaultPeerScale};
+
+    /// Message-token cost multiplier indexed by Urgency. Zero exempts a
+    /// record from the message bucket; bytes are always charged.
+    std::array<double, 3> urgency_cost{1.0, 1.0, 0.0};
+
+    /// Master switch.
+    bool enabled{true};
+
+    // Builder methods
+    [[nodiscard]] auto with_session_messages(double rate, double burst) && -> IngestLimitConfig {
+        messages_per_sec = rate;
+        message_burst = burst;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_session_bytes(double rate, double burst) && -> IngestLimitConfig {
+        bytes_per_sec = rate;
+        byte_burst = burst;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_source_messages(double rate, double burst) && -> IngestLimitConfig {
+        source_messages_per_sec = rate;
+        source_message_burst = burst;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_source_bytes(double rate, double burst) && -> IngestLimitConfig {
+        source_bytes_per_sec = rate;
+        source_byte_burst = burst;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_peer_messages(double rate, double burst) && -> IngestLimitConfig {
+        peer_messages_per_sec = rate;
+        peer_message_burst = burst;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_peer_bytes(double rate, double burst) && -> IngestLimitConfig {
+        peer_bytes_per_sec = rate;
+        peer_byte_burst = burst;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_urgency_cost(Urgency u, double cost) && -> IngestLimitConfig {
+        urgency_cost[static_cast<std::size_t>(u)] = cost;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto disabled() && -> IngestLimitConfig {
+        enabled = false;
+        return std::move(*this);
+    }
+
+    /// Token cost of one frame at the given urgency.
+    [[nodiscard]] auto cost_for(Urgency u) const noexcept -> double {
+        const auto idx = static_cast<std::size_t>(u);
+        return idx < urgency_cost.size() ? urgency_cost[idx] : 1.0;
+    }
+
+    /// Message-token cost of one frame carrying `records` (anything with an
+    /// `urgency` member): each record pays its urgency's share of the frame,
+    /// so Red records exempt only themselves, never their batch-mates.
+    template<typename Records>
+    [[nodiscard]] auto cost_for_records(const Records& records) const noexcept -> double {
+        double total = 0.0;
+        std::size_t n = 0;
+        for (const auto& r : records) {
+            total += cost_for(r.urgency);
+            ++n;
+        }
+        return n == 0 ? cost_for(Urgency::Green) : total / static_cast<double>(n);
+    }
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IngestLimiter — Message + Byte Buckets
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Limiter statistics.
+struct LimiterStats {
+    std::uint64_t frames{0};          ///< Frames admitted
+    std::uint64_t bytes{0};           ///< Bytes admitted
+    std::uint64_t bypassed{0};        ///< Frames admitted at zero message cost (urgency override)
+    std::uint64_t throttled{0};       ///< Frames that triggered a read pause
+    std::chrono::milliseconds paused{0};  ///< Total pause requested
+};
+
+/// Pair of token buckets (messages and bytes) guarding one ingest stream.
+///
+/// @tparam ClockT Monotonic clock
+template<typename ClockT = std::chrono::steady_clock>
+class IngestLimiter {
+public:
+    using time_point = typename ClockT::time_point;
+    using duration = typename ClockT::duration;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: All Defaulted
+    // ───────────────────────────────────────────────────────────────────────
+
+    IngestLimiter() = default;
+    ~IngestLimiter() = default;
+    IngestLimiter(const IngestLimiter&) = default;
+    IngestLimiter& operator=(const IngestLimiter&) = default;
+    IngestLimiter(IngestLimiter&&) noexcept = default;
+    IngestLimiter& operator=(IngestLimiter&&) noexcept = default;
+
+    IngestLimiter(double msg_rate, double msg_burst,
+                  double byte_rate, double byte_burst,
+                  time_point now = ClockT::now()) noexcept
+        : messages_{msg_rate, msg_burst, now}
+        , bytes_{byte_rate, byte_burst, now}
+    {}
+
+    /// Per-session limiter from config.
+    [[nodiscard]] static auto for_session(const IngestLimitConfig& cfg) -> IngestLimiter {
+        return IngestLimiter{cfg.messages_per_sec, cfg.message_burst,
+                             cfg.bytes_per_sec, cfg.byte_burst};
+    }
+
+    /// Per-source limiter from config.
+    [[nodiscard]] static auto for_source(const IngestLimitConfig& cfg) -> IngestLimiter {
+        return IngestLimiter{cfg.source_messages_per_sec, cfg.source_message_burst,
+                             cfg.source_bytes_per_sec, cfg.source_byte_burst};
+    }
+
+    /// Per-peer-node limiter from config.
+    [[nodiscard]] static auto for_peer(const IngestLimitConfig& cfg) -> IngestLimiter {
+        return IngestLimiter{cfg.peer_messages_per_sec, cfg.peer_message_burst,
+                             cfg.peer_bytes_per_sec, cfg.peer_byte_burst};
+    }
+
+    /// Account for one received frame.
+    ///
+    /// @param frame_bytes Frame size
+    /// @param cost Message-token cost (0 = skip the message bucket)
+    /// @return Pause the reader should take before the next read
+    auto admit(std::size_t frame_bytes, double cost, time_point now) noexcept -> duration {
+        ++stats_.frames;
+        stats_.bytes += frame_bytes;
+
+        // Bytes are never free: urgency cannot smuggle bulk past the limit
+        auto wait = bytes_.consume(static_cast<double>(frame_bytes), now);
+        if (cost > 0.0) {
+            wait = std::max(wait, messages_.consume(cost, now));
+        } else {
+            ++stats_.bypassed;
+        }
+
+        if (wait > duration::zero()) {
+            ++stats_.throttled;
+            stats_.paused += std::chrono::ceil<std::chrono::milliseconds>(wait);
+        }
+        return wait;
+    }
+
+    /// True once both buckets have refilled: dropping the limiter now
+    /// grants nothing a fresh one would not.
+    [[nodiscard]] auto idle(time_point now) noexcept -> bool {
+        return messages_.full(now) && bytes_.full(now);
+    }
+
+    [[nodiscard]] auto stats() const noexcept -> const LimiterStats& {
+        return stats_;
+    }
+
+private:
+    TokenBucket<ClockT> messages_;
+    TokenBucket<ClockT> bytes_;
+    LimiterStats stats_;
+};
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// Type Aliases
+// ───────────────────────────────────────────────────────────────────────────
+
+/// Default steady-clock bucket.
+using SteadyTokenBucket = TokenBucket<std::chrono::steady_clock>;
+
+/// Default steady-clock ingest limiter.
+using SteadyIngestLimiter = IngestLimiter<std::chrono::steady_clock>;
+
+}  // namespace protocol::ratelimit
@@ -0,0 +1,165 @@
+#pragma once
+
+/// @file replication.hpp
+/// @brief Node-to-node replication frames.
+///
+/// @code
+///   PeerHello     header | node u32
+///   ReplicaBatch  header | origin u32 | seq u64 | ingest_ns i64 | u32 count | records
+///   ForwardBatch  (same layout as ReplicaBatch)
+///   ReplicaAck    header | origin u32 | seq u64 | ingest_ns i64
+/// @endcode
+///
+/// `seq` numbers the batches one origin sends over one link, starting at 1;
+/// a receiver that sees a gap knows updates were coalesced or lost during a
+/// reconnect (the sender re-sends a snapshot after every reconnect).
+/// `ingest_ns` is the origin's wall clock when the oldest update in the
+/// batch was ingested; the ack echoes it so the origin can measure
+/// replication lag on its own clock.
+///
+/// A ForwardBatch carries raw ingest for targets the sender does not own
+/// (sharded clusters, see hash_ring.hpp); the receiver processes it as its
+/// own ingest. Both kinds share one sequence per link and are both acked.
+///
+/// Demonstrates:
+/// - Reuse of the TrackUpdate record codec inside a different frame kind
+/// - Fail-soft decoding via ByteReader
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "track.hpp"
+#include "wire.hpp"
+
+namespace protocol::replication {
+
+/// Decoded ReplicaBatch or ForwardBatch.
+struct ReplicaBatch {
+    bool forwarded{false};           ///< ForwardBatch: receiver owns these targets
+    std::uint32_t origin{0};
+    std::uint64_t seq{0};
+    std::int64_t ingest_ns{0};
+    std::vector<TrackUpdate> tracks;
+};
+
+/// Decoded ReplicaAck.
+struct ReplicaAck {
+    std::uint32_t origin{0};
+    std::uint64_t seq{0};
+    std::int64_t ingest_ns{0};
+};
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// PeerHello
+// ───────────────────────────────────────────────────────────────────────────
+
+[[nodiscard]] inline auto encode_peer_hello(std::uint32_t node) -> std::string {
+    wire::ByteWriter w{wire::FrameKind::PeerHello, 0, wire::kHeaderSize + 4};
+    w.put_u32(node);
+    return std::move(w).take();
+}
+
+[[nodiscard]] inline auto decode_peer_hello(std::string_view frame) noexcept
+    -> std::optional<std::uint32_t>
+{
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    const auto node = r.get_u32();
+    if (!header || header->kind != wire::FrameKind::PeerHello || !r.ok()) {
+        return std::nullopt;
+    }
+    return node;
+}
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// ReplicaBatch / ForwardBatch
+// ───────────────────────────────────────────────────────────────────────────
+
+[[nodiscard]] inline auto encode_replica_batch(std::uint32_t origin,
+                                               std::uint64_t seq,
+                                               std::int64_t ingest_ns,
+                                               std::span<const TrackUpdate> tracks,
+                                               bool forwarded = false)
+    -> std::string
+{
+    const auto kind = forwarded ? wire::FrameKind::ForwardBatch : wire::FrameKind::ReplicaBatch;
+    wire::ByteWriter w{kind, 0,
+                       wire::kHeaderSize + 4 + 8 + 8 + 4 + tracks.size() * kTrackRecordSize};
+    w.put_u32(origin);
+    w.put_u64(seq);
+    w.put_i64(ingest_ns);
+    w.put_u32(static_cast<std::uint32_t>(tracks.size()));
+    for (const auto& t : tracks) {
+        encode_track(w, t);
+    }
+    return std::move(w).take();
+}
+
+[[nodiscard]] inline auto decode_replica_batch(std::string_view frame)
+    -> std::optional<ReplicaBatch>
+{
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    if (!header || (header->kind != wire::FrameKind::ReplicaBatch &&
+                    header->kind != wire::FrameKind::ForwardBatch)) {
+        return std::nullopt;
+    }
+
+    ReplicaBatch out;
+    out.forwarded = header->kind == wire::FrameKind::ForwardBatch;
+    out.origin = r.get_u32();
+    out.seq = r.get_u64();
+    out.ingest_ns = r.get_i64();
+    const auto count = r.get_u32();
+    if (!r.ok() || r.remaining() < static_cast<std::size_t>(count) * kTrackRecordSize) {
+        return std::nullopt;
+    }
+
+    out.tracks.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        out.tracks.push_back(decode_track(r));
+    }
+    if (!r.ok()) {
+        return std::nullopt;
+    }
+    // Implausible reports are dropped, not the batch: its seq is still acked
+    std::erase_if(out.tracks, [](const TrackUpdate& t) { return !is_plausible(t); });
+    return out;
+}
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// ReplicaAck
+// ───────────────────────────────────────────────────────────────────────────
+
+[[nodiscard]] inline auto encode_replica_ack(const ReplicaAck& ack) -> std::string {
+    wire::ByteWriter w{wire::FrameKind::ReplicaAck, 0, wire::kHeaderSize + 4 + 8 + 8};
+    w.put_u32(ack.origin);
+    w.put_u64(ack.seq);
+    w.put_i64(ack.ingest_ns);
+    return std::move(w).take();
+}
+
+[[nodiscard]] inline auto decode_replica_ack(std::string_view frame) noexcept
+    -> std::optional<ReplicaAck>
+{
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    ReplicaAck ack;
+    ack.origin = r.get_u32();
+    ack.seq = r.get_u64();
+    ack.ingest_ns = r.get_i64();
+    if (!header || header->kind != wire::FrameKind::ReplicaAck || !r.ok()) {
+        return std::nullopt;
+    }
+    return ack;
+}
+
+}  // namespace protocol::replication
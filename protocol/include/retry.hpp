@@ -184,7 +184,7 @@ public:
     {}
     
     [[nodiscard]] auto delay_for(std::size_t attempt) const noexcept -> Duration {
-        auto delay = initial_ + (increment_ * attempt);
+        auto delay = initial_ + increment_ * static_cast<Duration::rep>(attempt);
         return std::min(delay, max_delay_);
     }
     
@@ -406,15 +406,16 @@ public:
                 co_return result;
             } catch (...) {
                 result.last_error = std::current_exception();
+            }
+            
+            // Don't delay after last attempt (co_await is not allowed
+            // inside a handler, so the backoff happens out here)
+            if (attempt + 1 < policy_.max_attempts()) {
+                auto delay = policy_.delay_for(attempt);
+                result.total_delay += delay;
                 
-                // Don't delay after last attempt
-                if (attempt + 1 < policy_.max_attempts()) {
-                    auto delay = policy_.delay_for(attempt);
-                    result.total_delay += delay;
-                    
-                    asio::steady_timer timer{executor_, delay};
-                    co_await timer.async_wait(asio::use_awaitable);
-                }
+                asio::steady_timer timer{executor_, delay};
+                co_await timer.async_wait(asio::use_awaitable);
             }
         }
         
@@ -438,14 +439,14 @@ public:
                 co_return result;
             } catch (...) {
                 result.last_error = std::current_exception();
+            }
+            
+            if (attempt + 1 < policy_.max_attempts()) {
+                auto delay = policy_.delay_for(attempt);
+                result.total_delay += delay;
                 
-                if (attempt + 1 < policy_.max_attempts()) {
-                    auto delay = policy_.delay_for(attempt);
-                    result.total_delay += delay;
-                    
-                    asio::steady_timer timer{executor_, delay};
-                    co_await timer.async_wait(asio::use_awaitable);
-                }
+                asio::steady_timer timer{executor_, delay};
+                co_await timer.async_wait(asio::use_awaitable);
             }
         }
         
@@ -475,19 +476,19 @@ public:
                 co_return result;
             } catch (...) {
                 result.last_error = std::current_exception();
+            }
+            
+            // Check if error is retryable
+            if (!std::invoke(should_retry, result.last_error)) {
+                co_return result;  // Non-retryable, bail out
+            }
+            
+            if (attempt + 1 < policy_.max_attempts()) {
+                auto delay = policy_.delay_for(attempt);
+                result.total_delay += delay;
                 
-                // Check if error is retryable
-                if (!std::invoke(std::forward<Predicate>(should_retry), result.last_error)) {
-                    co_return result;  // Non-retryable, bail out
-                }
-                
-                if (attempt + 1 < policy_.max_attempts()) {
-                    auto delay = policy_.delay_for(attempt);
-                    result.total_delay += delay;
-                    
-                    asio::steady_timer timer{executor_, delay};
-                    co_await timer.async_wait(asio::use_awaitable);
-                }
+                asio::steady_timer timer{executor_, delay};
+                co_await timer.async_wait(asio::use_awaitable);
             }
         }
         
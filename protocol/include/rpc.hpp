@@ -0,0 +1,278 @@
+#pragma once
+
+/// @file rpc.hpp
+/// @brief Request/response frames with correlation ids.
+///
+/// @code
+///   RpcRequest   header | id u64 | method str | urgency u8 | payload str
+///   RpcResponse  header | id u64 | status u8 | urgency u8 | payload str
+/// @endcode
+///
+/// Request and response bodies are protocol::Packet values, so a handler
+/// sees the same payload + urgency a ProtocolAPI packet carries. `id` is
+/// chosen by the caller and unique among its outstanding calls on one
+/// connection; responses may arrive in any order and are matched by it.
+/// A failed call carries its error message as the response payload.
+///
+/// The built-in track queries (kMethodSnapshot, kMethodTarget,
+/// kMethodArea, kMethodJournal) answer with a TrackBatch frame as the
+/// payload.
+///
+/// Demonstrates:
+/// - Correlation ids for pipelined, out-of-order responses
+/// - Fail-soft decoding via ByteReader
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "journal_query.hpp"
+#include "protocol.hpp"
+#include "wire.hpp"
+
+namespace protocol::rpc {
+
+/// Longest method name.
+constexpr std::size_t kMaxMethodLength = 64;
+
+/// Built-in query methods.
+constexpr std::string_view kMethodSnapshot = "tracks.snapshot";   ///< Every stored track
+constexpr std::string_view kMethodTarget = "tracks.target";       ///< One target (payload: id u64)
+constexpr std::string_view kMethodArea = "tracks.area";           ///< Tracks in an AreaQuery box
+constexpr std::string_view kMethodJournal = "journal.query";      ///< Journal history (payload: JournalQuery)
+
+/// Outcome of a call.
+enum class RpcStatus : std::uint8_t {
+    Ok            = 0,
+    UnknownMethod = 1,
+    BadRequest    = 2,   ///< Handler rejected the payload
+    Failed        = 3,   ///< Handler threw
+    Busy          = 4,   ///< Too many calls outstanding on the connection
+    TimedOut      = 5,   ///< Local: no response within the call's timeout
+    Disconnected  = 6    ///< Local: the link dropped before the response
+};
+
+[[nodiscard]] constexpr auto to_string(RpcStatus s) noexcept -> std::string_view {
+    switch (s) {
+        case RpcStatus::Ok:            return "ok";
+        case RpcStatus::UnknownMethod: return "unknown method";
+        case RpcStatus::BadRequest:    return "bad request";
+        case RpcStatus::Failed:        return "failed";
+        case RpcStatus::Busy:          return "busy";
+        case RpcStatus::TimedOut:      return "timed out";
+        case RpcStatus::Disconnected:  return "disconnected";
+    }
+    return "?";
+}
+
+/// Decoded RpcRequest.
+struct Request {
+    std::uint64_t id{0};
+    std::string method;
+    Packet body;
+};
+
+/// Decoded RpcResponse.
+struct Response {
+    std::uint64_t id{0};
+    RpcStatus status{RpcStatus::Ok};
+    Packet body;
+
+    [[nodiscard]] auto ok() const noexcept -> bool { return status == RpcStatus::Ok; }
+};
+
+/// Thrown by handlers for a payload they cannot parse (→ BadRequest).
+class BadRequestError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Codecs
+// ═══════════════════════════════════════════════════════════════════════════
+
+namespace detail {
+
+inline void put_packet(wire::ByteWriter& w, const Packet& p) {
+    const auto bytes = p.payload_view();
+    w.put_u8(static_cast<std::uint8_t>(p.urgency()));
+    w.put_string({reinterpret_cast<const char*>(bytes.data()), bytes.size()});
+}
+
+[[nodiscard]] inline auto get_packet(wire::ByteReader& r) -> Packet {
+    const auto urgency = r.get_u8();
+    const auto bytes = r.get_string();
+    return Packet::from_bytes({reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size()},
+                              static_cast<Urgency>(urgency));
+}
+
+}  // namespace detail
+
+[[nodiscard]] inline auto encode_request(std::uint64_t id, std::string_view method, const Packet& body)
+    -> std::string
+{
+    wire::ByteWriter w{wire::FrameKind::RpcRequest, 0,
+                       wire::kHeaderSize + 8 + 4 + method.size() + 5 + body.size()};
+    w.put_u64(id);
+    w.put_string(method);
+    detail::put_packet(w, body);
+    return std::move(w).take();
+}
+
+[[nodiscard]] inline auto decode_request(std::string_view frame) -> std::optional<Request> {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    if (!header || header->kind != wire::FrameKind::RpcRequest) {
+        return std::nullopt;
+    }
+    Request out;
+    out.id = r.get_u64();
+    const auto method = r.get_string();
+    out.body = detail::get_packet(r);
+    if (!r.ok() || method.size() > kMaxMethodLength) {
+        return std::nullopt;
+    }
+    out.method = method;
+    return out;
+}
+
+[[nodiscard]] inline auto encode_response(std::uint64_t id, RpcStatus status, const Packet& body)
+    -> std::string
+{
+    wire::ByteWriter w{wire::FrameKind::RpcResponse, 0, wire::kHeaderSize + 8 + 1 + 5 + body.size()};
+    w.put_u64(id);
+    w.put_u8(static_cast<std::uint8_t>(status));
+    detail::put_packet(w, body);
+    return std::move(w).take();
+}
+
+[[nodiscard]] inline auto decode_response(std::string_view frame) -> std::optional<Response> {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    if (!header || header->kind != wire::FrameKind::RpcResponse) {
+        return std::nullopt;
+    }
+    Response out;
+    out.id = r.get_u64();
+    const auto status = r.get_u8();
+    out.body = detail::get_packet(r);
+    if (!r.ok() || status > static_cast<std::uint8_t>(RpcStatus::Disconnected)) {
+        return std::nullopt;
+    }
+    out.status = static_cast<RpcStatus>(status);
+    return out;
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Track Query Payloads
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Bounding box for kMethodArea (degrees, inclusive).
+struct AreaQuery {
+    double lat_min{0.0};
+    double lat_max{0.0};
+    double lon_min{0.0};
+    double lon_max{0.0};
+
+    [[nodiscard]] auto contains(double lat, double lon) const noexcept -> bool {
+        return lat >= lat_min && lat <= lat_max && lon >= lon_min && lon <= lon_max;
+    }
+};
+
+[[nodiscard]] inline auto make_area_query(const AreaQuery& q, Urgency urgency = Urgency::Green) -> Packet {
+    wire::ByteWriter w;
+    w.put_f64(q.lat_min);
+    w.put_f64(q.lat_max);
+    w.put_f64(q.lon_min);
+    w.put_f64(q.lon_max);
+    return Packet::from_string(w.view(), urgency);
+}
+
+[[nodiscard]] inline auto parse_area_query(const Packet& p) -> std::optional<AreaQuery> {
+    const auto bytes = p.payload_view();
+    wire::ByteReader r{{reinterpret_cast<const char*>(bytes.data()), bytes.size()}};
+    AreaQuery q;
+    q.lat_min = r.get_f64();
+    q.lat_max = r.get_f64();
+    q.lon_min = r.get_f64();
+    q.lon_max = r.get_f64();
+    if (!r.ok() || r.remaining() != 0) {
+        return std::nullopt;
+    }
+    return q;
+}
+
+[[nodiscard]] inline auto make_target_query(std::uint64_t target_id, Urgency urgency = Urgency::Green) -> Packet {
+    wire::ByteWriter w;
+    w.put_u64(target_id);
+    return Packet::from_string(w.view(), urgency);
+}
+
+[[nodiscard]] inline auto parse_target_query(const Packet& p) -> std::optional<std::uint64_t> {
+    const auto bytes = p.payload_view();
+    wire::ByteReader r{{reinterpret_cast<const char*>(bytes.data()), bytes.size()}};
+    const auto id = r.get_u64();
+    if (!r.ok() || r.remaining() != 0) {
+        return std::nullopt;
+    }
+    return id;
+}
+
+/// JournalQuery payload:
+/// from i64 | to i64 | limit u32 | vertices u32 | (lat f64, lon f64)… | targets u32 | id u64…
+[[nodiscard]] inline auto make_journal_query(const JournalQuery& q, Urgency urgency = Urgency::Green) -> Packet {
+    wire::ByteWriter w;
+    w.put_i64(q.from_ns);
+    w.put_i64(q.to_ns);
+    w.put_u32(static_cast<std::uint32_t>(std::min<std::size_t>(q.limit, std::numeric_limits<std::uint32_t>::max())));
+    w.put_u32(static_cast<std::uint32_t>(q.polygon.size()));
+    for (const auto& v : q.polygon) {
+        w.put_f64(v.lat);
+        w.put_f64(v.lon);
+    }
+    w.put_u32(static_cast<std::uint32_t>(q.targets.size()));
+    for (const auto id : q.targets) {
+        w.put_u64(id);
+    }
+    return Packet::from_string(w.view(), urgency);
+}
+
+[[nodiscard]] inline auto parse_journal_query(const Packet& p) -> std::optional<JournalQuery> {
+    const auto bytes = p.payload_view();
+    wire::ByteReader r{{reinterpret_cast<const char*>(bytes.data()), bytes.size()}};
+    JournalQuery q;
+    q.from_ns = r.get_i64();
+    q.to_ns = r.get_i64();
+    q.limit = r.get_u32();
+
+    // Counts are checked against the bytes left before anything is allocated
+    const auto vertices = r.get_u32();
+    if (!r.ok() || vertices > r.remaining() / 16 || vertices == 1 || vertices == 2) {
+        return std::nullopt;
+    }
+    q.polygon.resize(vertices);
+    for (auto& v : q.polygon) {
+        v.lat = r.get_f64();
+        v.lon = r.get_f64();
+    }
+    const auto targets = r.get_u32();
+    if (!r.ok() || targets != r.remaining() / 8 || r.remaining() % 8 != 0) {
+        return std::nullopt;
+    }
+    q.targets.resize(targets);
+    for (auto& id : q.targets) {
+        id = r.get_u64();
+    }
+    return q;
+}
+
+}  // namespace protocol::rpc
@@ -0,0 +1,347 @@
+#pragma once
+
+/// @file sector.hpp
+/// @brief Running per-sector counts, traffic windows and heatmaps.
+///
+/// @code
+///   SectorQuery   header | mode u8 | lat_min f64 | lat_max f64 | lon_min f64 | lon_max f64
+///   SectorReport  header | sector_deg f64 | window_ms u32 | count u32 | count × Sector | Heatmap
+///     Sector      x u32 | y u32 | tracks 3 × u32 | reports u32 | kBuckets × u32 (newest first)
+///     Heatmap     stride u32 | x0 u32 | y0 u32 | cols u32 | rows u32 | rows × cols × reports u32
+/// @endcode
+///
+/// The world is cut into sector_deg × sector_deg sectors (x from lon −180,
+/// y from lat −90). Every sector keeps running counters:
+///
+///   tracks    targets currently in the sector, per urgency
+///   buckets   reports received per time bucket over the last window,
+///             a ring of kBuckets, plus their running sum (reports)
+///
+/// A report costs O(1): move its target between sectors if it crossed a
+/// boundary or changed urgency, and count it in the current bucket. A
+/// sector's ring is rolled forward lazily, when it is next touched or
+/// read, so idle sectors cost nothing.
+///
+/// A console sends SectorQuery for an area: Query answers once,
+/// Subscribe also streams a report every SectorConfig::interval, and
+/// Unsubscribe stops the stream. A report lists the occupied sectors in
+/// the area and a heatmap raster of reports per window, read from the
+/// sector counters. A raster over more than kMaxHeatCells sectors is
+/// binned: each cell sums stride × stride sectors.
+///
+/// Demonstrates:
+/// - O(1) incremental counters with a lazily rolled sliding window
+/// - Rasters read from running sums, never recomputed from tracks
+/// - Trivial Class Pattern with Builder Methods for configuration
+/// - Fail-soft decoding via ByteReader
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "lod.hpp"
+#include "protocol.hpp"
+#include "track.hpp"
+#include "wire.hpp"
+
+namespace protocol::sector {
+
+using namespace std::chrono_literals;
+
+/// Urgency classes counted per sector (Green, Yellow, Red).
+constexpr std::size_t kClasses = 3;
+
+/// Time buckets per traffic window.
+constexpr std::size_t kBuckets = 12;
+
+/// Largest heatmap raster sent; wider areas are binned.
+constexpr std::size_t kMaxHeatCells = 16384;
+
+constexpr std::size_t kQuerySize = 1 + 4 * 8;
+constexpr std::size_t kSectorSize = 4 + 4 + kClasses * 4 + 4 + kBuckets * 4;
+
+/// What a SectorQuery asks for.
+enum class Mode : std::uint8_t {
+    Query       = 0,   ///< One report
+    Subscribe   = 1,   ///< One report now, then every interval
+    Unsubscribe = 2
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SectorConfig — Trivial Class Pattern with Builder Methods
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Sector size, traffic window and stream cadence.
+struct SectorConfig {
+    // Rule of Six: All Default
+    SectorConfig() = default;
+    ~SectorConfig() = default;
+    SectorConfig(const SectorConfig&) = default;
+    SectorConfig& operator=(const SectorConfig&) = default;
+    SectorConfig(SectorConfig&&) noexcept = default;
+    SectorConfig& operator=(SectorConfig&&) noexcept = default;
+
+    /// Sector edge in degrees.
+    double sector_deg{0.25};
+
+    /// Traffic window (kBuckets buckets of window / kBuckets).
+    std::chrono::milliseconds window{60s};
+
+    /// Subscription cadence when run by the server.
+    std::chrono::milliseconds interval{2s};
+
+    [[nodiscard]] auto with_sector_deg(double deg) && -> SectorConfig {
+        sector_deg = deg;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_window(std::chrono::milliseconds w) && -> SectorConfig {
+        window = w;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_interval(std::chrono::milliseconds i) && -> SectorConfig {
+        interval = i;
+        return std::move(*this);
+    }
+};
+
+/// A decoded SectorQuery.
+struct Query {
+    Mode mode{Mode::Query};
+    lod::Viewport area;
+};
+
+/// One occupied sector as reported.
+struct Sector {
+    std::uint32_t x{0};
+    std::uint32_t y{0};
+    std::array<std::uint32_t, kClasses> tracks{};   ///< Per urgency
+    std::uint32_t reports{0};                       ///< Over the window
+    std::array<std::uint32_t, kBuckets> buckets{};  ///< Newest first
+};
+
+/// Reports per window over an area, binned stride × stride sectors.
+struct Heatmap {
+    std::uint32_t stride{1};
+    std::uint32_t x0{0};                 ///< First sector column
+    std::uint32_t y0{0};                 ///< First sector row
+    std::uint32_t cols{0};
+    std::uint32_t rows{0};
+    std::vector<std::uint32_t> cells;    ///< Row-major, rows × cols
+};
+
+/// Everything a console receives for one area.
+struct Report {
+    double sector_deg{0.0};
+    std::chrono::milliseconds window{0};
+    std::vector<Sector> sectors;
+    Heatmap heat;
+};
+
+/// Engine counters.
+struct SectorStats {
+    std::uint64_t updates{0};     ///< Reports counted
+    std::uint64_t moves{0};       ///< Targets moved between sectors
+    std::uint64_t reports{0};     ///< Reports built
+    std::size_t tracks{0};        ///< Currently held
+    std::size_t sectors{0};       ///< With tracks or recent traffic
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SectorGrid — Running Sector Counters
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Holds hash maps (value type)
+// • Compiler-generated operations are correct
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Per-sector counters over the latest report of every target.
+///
+/// @par Thread Safety
+/// Not thread-safe.
+///
+/// @par Example
+/// @code
+/// SectorGrid grid{SectorConfig{}.with_sector_deg(0.5)};
+/// grid.update(t, now_ns);                       // on every accepted report
+/// const auto report = grid.report(area, now_ns);
+/// @endcode
+class SectorGrid {
+public:
+    // Rule of Six: All Default
+    SectorGrid() = default;
+    ~SectorGrid() = default;
+    SectorGrid(const SectorGrid&) = default;
+    SectorGrid& operator=(const SectorGrid&) = default;
+    SectorGrid(SectorGrid&&) noexcept = default;
+    SectorGrid& operator=(SectorGrid&&) noexcept = default;
+
+    explicit SectorGrid(const SectorConfig& cfg);
+
+    /// Count a report received at `now_ns` and move its target there.
+    void update(const TrackUpdate& t, std::int64_t now_ns);
+
+    /// Take a target out of its sector (its traffic stays in the window).
+    void remove(std::uint64_t target_id);
+
+    /// Sectors and heatmap for `area` as of `now_ns`.
+    [[nodiscard]] auto report(const lod::Viewport& area, std::int64_t now_ns) -> Report;
+
+    /// Forget sectors with no tracks and no traffic left in the window.
+    void prune(std::int64_t now_ns);
+
+    [[nodiscard]] auto stats() const noexcept -> SectorStats;
+    [[nodiscard]] auto config() const noexcept -> const SectorConfig& { return cfg_; }
+
+private:
+    struct Counters {
+        std::array<std::uint32_t, kClasses> tracks{};
+        std::array<std::uint32_t, kBuckets> buckets{};   ///< Ring indexed by bucket % kBuckets
+        std::uint32_t reports{0};                        ///< Sum of buckets
+        std::int64_t bucket{0};                          ///< Newest bucket rolled to
+    };
+
+    struct Held {
+        std::uint64_t key{0};
+        std::size_t cls{0};
+    };
+
+    [[nodiscard]] auto col_of(double lon) const noexcept -> std::uint32_t;
+    [[nodiscard]] auto row_of(double lat) const noexcept -> std::uint32_t;
+    [[nodiscard]] auto bucket_of(std::int64_t now_ns) const noexcept -> std::int64_t;
+    static void roll(Counters& c, std::int64_t bucket) noexcept;
+    [[nodiscard]] static auto make_sector(std::uint64_t key, const Counters& c) -> Sector;
+
+    SectorConfig cfg_;
+    std::uint32_t cols_{1};
+    std::uint32_t rows_{1};
+    std::int64_t bucket_ns_{1};
+    std::unordered_map<std::uint64_t, Counters> sectors_;
+    std::unordered_map<std::uint64_t, Held> tracks_;
+    SectorStats stats_;
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Codecs
+// ═══════════════════════════════════════════════════════════════════════════
+
+[[nodiscard]] inline auto encode_query(const Query& q) -> std::string {
+    wire::ByteWriter w{wire::FrameKind::SectorQuery, 0, wire::kHeaderSize + kQuerySize};
+    w.put_u8(static_cast<std::uint8_t>(q.mode));
+    w.put_f64(q.area.lat_min);
+    w.put_f64(q.area.lat_max);
+    w.put_f64(q.area.lon_min);
+    w.put_f64(q.area.lon_max);
+    return std::move(w).take();
+}
+
+/// Decode SectorQuery. Returns nullopt on malformed input, an unknown
+/// mode or an inverted area.
+[[nodiscard]] inline auto decode_query(std::string_view frame) -> std::optional<Query> {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    if (!header || header->kind != wire::FrameKind::SectorQuery) {
+        return std::nullopt;
+    }
+    Query q;
+    const auto mode = r.get_u8();
+    q.area.lat_min = r.get_f64();
+    q.area.lat_max = r.get_f64();
+    q.area.lon_min = r.get_f64();
+    q.area.lon_max = r.get_f64();
+    if (!r.ok() || mode > static_cast<std::uint8_t>(Mode::Unsubscribe)
+        || !(q.area.lat_min <= q.area.lat_max) || !(q.area.lon_min <= q.area.lon_max)) {
+        return std::nullopt;
+    }
+    q.mode = static_cast<Mode>(mode);
+    return q;
+}
+
+[[nodiscard]] inline auto encode_report(const Report& rep) -> std::string {
+    wire::ByteWriter w{wire::FrameKind::SectorReport, 0,
+                       wire::kHeaderSize + 8 + 4 + 4 + rep.sectors.size() * kSectorSize
+                           + 5 * 4 + rep.heat.cells.size() * 4};
+    w.put_f64(rep.sector_deg);
+    w.put_u32(static_cast<std::uint32_t>(rep.window.count()));
+    w.put_u32(static_cast<std::uint32_t>(rep.sectors.size()));
+    for (const auto& s : rep.sectors) {
+        w.put_u32(s.x);
+        w.put_u32(s.y);
+        for (const auto n : s.tracks) {
+            w.put_u32(n);
+        }
+        w.put_u32(s.reports);
+        for (const auto n : s.buckets) {
+            w.put_u32(n);
+        }
+    }
+    w.put_u32(rep.heat.stride);
+    w.put_u32(rep.heat.x0);
+    w.put_u32(rep.heat.y0);
+    w.put_u32(rep.heat.cols);
+    w.put_u32(rep.heat.rows);
+    for (const auto n : rep.heat.cells) {
+        w.put_u32(n);
+    }
+    return std::move(w).take();
+}
+
+/// Decode SectorReport. Returns nullopt on malformed input.
+[[nodiscard]] inline auto decode_report(std::string_view frame) -> std::optional<Report> {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    if (!header || header->kind != wire::FrameKind::SectorReport) {
+        return std::nullopt;
+    }
+    Report rep;
+    rep.sector_deg = r.get_f64();
+    rep.window = std::chrono::milliseconds{r.get_u32()};
+    const auto count = r.get_u32();
+    if (!r.ok() || r.remaining() < static_cast<std::size_t>(count) * kSectorSize) {
+        return std::nullopt;
+    }
+    rep.sectors.resize(count);
+    for (auto& s : rep.sectors) {
+        s.x = r.get_u32();
+        s.y = r.get_u32();
+        for (auto& n : s.tracks) {
+            n = r.get_u32();
+        }
+        s.reports = r.get_u32();
+        for (auto& n : s.buckets) {
+            n = r.get_u32();
+        }
+    }
+    rep.heat.stride = r.get_u32();
+    rep.heat.x0 = r.get_u32();
+    rep.heat.y0 = r.get_u32();
+    rep.heat.cols = r.get_u32();
+    rep.heat.rows = r.get_u32();
+    const auto cells = std::size_t{rep.heat.cols} * rep.heat.rows;
+    if (!r.ok() || cells > kMaxHeatCells || r.remaining() < cells * 4) {
+        return std::nullopt;
+    }
+    rep.heat.cells.resize(cells);
+    for (auto& n : rep.heat.cells) {
+        n = r.get_u32();
+    }
+    if (!r.ok()) {
+        return std::nullopt;
+    }
+    return rep;
+}
+
+}  // namespace protocol::sector
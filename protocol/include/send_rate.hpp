@@ -0,0 +1,231 @@
+#pragma once
+
+/// @file send_rate.hpp
+/// @brief Adaptive per-subscriber send-rate controller.
+///
+/// Demonstrates:
+/// - Throughput estimation from write completion times (EWMA)
+/// - Queue-depth feedback control with hysteresis
+/// - RTT inflation as an early congestion signal (bytes stuck in kernel buffers)
+/// - Per-target pacing ladder (1, 1/2, 1/5, 1/10 ...) that holds, never drops
+/// - Rule of Six for stateful value types
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+
+#include "protocol.hpp"
+
+namespace protocol::ratelimit {
+
+using namespace std::chrono_literals;
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Configuration
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Decimation ladder: a session at level k sends each target at most once
+/// per kRateDivisors[k] of that target's report intervals.
+constexpr std::array<std::uint32_t, 7> kRateDivisors{1, 2, 5, 10, 20, 50, 100};
+
+/// Send-rate controller tuning.
+struct SendRateConfig {
+    // Rule of Six: All Default (trivial aggregate)
+    SendRateConfig() = default;
+    ~SendRateConfig() = default;
+    SendRateConfig(const SendRateConfig&) = default;
+    SendRateConfig& operator=(const SendRateConfig&) = default;
+    SendRateConfig(SendRateConfig&&) noexcept = default;
+    SendRateConfig& operator=(SendRateConfig&&) noexcept = default;
+
+    /// Queue depth (pending targets) the controller steers towards.
+    std::size_t target_queue_depth{64};
+
+    /// Batch size bounds (track records per frame).
+    std::size_t min_batch{8};
+    std::size_t max_batch{256};
+
+    /// Control period.
+    std::chrono::milliseconds adjust_interval{250ms};
+
+    /// Consecutive healthy periods required before stepping back up.
+    std::uint32_t recover_intervals{4};
+
+    /// EWMA smoothing factor for throughput samples.
+    double ewma_alpha{0.2};
+
+    /// Smoothed RTT above rtt_inflation·min RTT (and by more than rtt_slack)
+    /// counts as congestion even while the application queue is short.
+    double rtt_inflation{3.0};
+    std::chrono::milliseconds rtt_slack{20ms};
+
+    [[nodiscard]] auto with_target_queue_depth(std::size_t n) && -> SendRateConfig {
+        target_queue_depth = n;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_batch_bounds(std::size_t lo, std::size_t hi) && -> SendRateConfig {
+        min_batch = lo;
+        max_batch = hi;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_adjust_interval(std::chrono::milliseconds d) && -> SendRateConfig {
+        adjust_interval = d;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_rtt_inflation(double factor, std::chrono::milliseconds slack) && -> SendRateConfig {
+        rtt_inflation = factor;
+        rtt_slack = slack;
+        return std::move(*this);
+    }
+};
+
+/// Point-in-time controller report.
+struct SendRateState {
+    std::uint32_t divisor{1};          ///< Send each target once per `divisor` report intervals
+    std::size_t batch_size{0};         ///< Records per frame
+    double throughput_bps{0.0};        ///< Estimated achievable bytes/second
+    double capacity_ups{0.0};          ///< Estimated achievable updates/second
+    double offered_ups{0.0};           ///< Updates/second sent last period
+    std::size_t queue_depth{0};        ///< Pending targets at last tick
+    bool rtt_inflated{false};          ///< Latest RTT feedback signalled congestion
+    std::uint64_t admitted{0};         ///< Updates sent (lifetime)
+    std::uint64_t decimated{0};        ///< Updates superseded before being sent (lifetime)
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SendRateController
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// CONTROL LOOP (every adjust_interval):
+//
+//   capacity = EWMA(bytes written / write time) / EWMA(bytes per update)
+//   offered  = updates sent during the period / period
+//
+//   congested  ⇔ depth > 1.5·target  ∨  (offered > 0.9·capacity ∧ depth > target/2)
+//                ∨ SRTT > max(rtt_inflation·min RTT, min RTT + rtt_slack)
+//   healthy    ⇔ depth < target/2  ∧  RTT not inflated
+//
+//   congested → step down the ladder, double batch size
+//   healthy for `recover_intervals` periods → step up, halve batch size
+//
+// PACING:
+// • Every update is coalesced latest-wins by the session; admit() only
+//   says when the target may go out next
+// • At divisor d a target is due d smoothed report intervals after it was
+//   last sent, so it is sent at most once per period and always with its
+//   newest state — a slow target is held, never starved
+// • RED updates and targets never sent before are due at once
+//
+// RULE OF SIX RATIONALE:
+// • Contains an unordered_map and PODs (all manage their own memory)
+// • Compiler-generated operations are correct
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Per-session egress controller.
+///
+/// @par Thread Safety
+/// Not thread-safe; owned by one session on one executor.
+class SendRateController {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: All Defaulted
+    // ───────────────────────────────────────────────────────────────────────
+
+    SendRateController() = default;
+    ~SendRateController() = default;
+    SendRateController(const SendRateController&) = default;
+    SendRateController& operator=(const SendRateController&) = default;
+    SendRateController(SendRateController&&) noexcept = default;
+    SendRateController& operator=(SendRateController&&) noexcept = default;
+
+    explicit SendRateController(SendRateConfig cfg, clock::time_point now = clock::now());
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Admission
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Offer an update for `key`.
+    ///
+    /// @return When the target may be sent next (at or before `now`: at once)
+    [[nodiscard]] auto admit(std::uint64_t key, Urgency urgency, clock::time_point now) -> clock::time_point;
+
+    /// Record that `key`'s newest state was written out.
+    void on_sent(std::uint64_t key, clock::time_point now);
+
+    /// Count an update replaced by a newer one before it was sent.
+    void on_superseded() noexcept { ++decimated_; }
+
+    /// Forget per-key pacing state (e.g. target dropped).
+    void forget(std::uint64_t key) { pace_.erase(key); }
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Feedback
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Record a completed write.
+    ///
+    /// @param bytes Bytes written
+    /// @param updates Track updates carried by the write
+    /// @param elapsed Time from write start to completion
+    void on_write(std::size_t bytes, std::size_t updates, clock::duration elapsed);
+
+    /// Record link RTT feedback (from ping/pong probing).
+    ///
+    /// Write completions only see the socket buffer; once it is full the
+    /// peer's pongs queue behind track data, so RTT rises before writes slow.
+    void on_rtt(clock::duration smoothed, clock::duration min_rtt);
+
+    /// Run the control loop if a period has elapsed.
+    ///
+    /// @return true when divisor or batch size changed
+    auto tick(std::size_t queue_depth, clock::time_point now) -> bool;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Accessors
+    // ───────────────────────────────────────────────────────────────────────
+
+    [[nodiscard]] auto divisor() const noexcept -> std::uint32_t { return kRateDivisors[level_]; }
+    [[nodiscard]] auto batch_size() const noexcept -> std::size_t { return batch_; }
+    [[nodiscard]] auto state() const noexcept -> SendRateState;
+    [[nodiscard]] auto config() const noexcept -> const SendRateConfig& { return cfg_; }
+
+private:
+    SendRateConfig cfg_;
+    std::size_t level_{0};
+    std::size_t batch_{8};
+
+    double ewma_bps_{0.0};
+    double ewma_update_bytes_{0.0};
+
+    std::uint64_t period_admitted_{0};
+    double last_offered_ups_{0.0};
+    std::size_t last_depth_{0};
+    std::uint32_t healthy_streak_{0};
+    bool rtt_inflated_{false};
+    clock::time_point period_start_{};
+
+    std::uint64_t admitted_{0};
+    std::uint64_t decimated_{0};
+
+    /// Per-key report cadence and last send.
+    struct Pace {
+        clock::time_point last_report{};
+        clock::time_point last_sent{};
+        clock::duration interval{};   ///< Smoothed time between reports
+        bool sent{false};
+    };
+    std::unordered_map<std::uint64_t, Pace> pace_;
+};
+
+}  // namespace protocol::ratelimit
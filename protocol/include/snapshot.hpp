@@ -0,0 +1,173 @@
+#pragma once
+
+/// @file snapshot.hpp
+/// @brief Point-in-time TrackStore snapshots for fast restart.
+///
+/// A snapshot records every stored track together with the journal
+/// sequence it covers. Restart loads the snapshot, then replays only the
+/// journal records after that sequence — the result is exactly the state
+/// the server had at its last journalled change.
+///
+/// @code
+///   header   magic u32 "TSNP" | version u16 | reserved u16
+///            | journal_seq u64 | taken_ns i64 | count u64
+///   record   origin u32 | origin_seq u64 | stored_ns i64 | TrackUpdate
+/// @endcode
+///
+/// Records are fixed-size, so a loader validates the file from its size
+/// and decodes straight out of a read-only mapping.
+///
+/// Demonstrates:
+/// - mmap-based bulk load
+/// - Atomic file replacement (temp file + fdatasync + rename)
+/// - Rule of Six: Non-copyable, non-movable background writer thread
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "track.hpp"
+#include "track_store.hpp"
+
+namespace protocol {
+
+/// Snapshot header size and identification.
+constexpr std::size_t kSnapshotHeaderSize = 32;
+constexpr std::uint32_t kSnapshotMagic = 0x504E5354;   // "TSNP" little-endian
+constexpr std::uint16_t kSnapshotVersion = 1;
+
+/// Encoded size of one stored track.
+constexpr std::size_t kSnapshotRecordSize = 4 + 8 + 8 + kTrackRecordSize;
+
+/// What a snapshot file holds (or held, once written).
+struct SnapshotInfo {
+    std::uint64_t journal_seq{0};          ///< Last journal record reflected
+    std::int64_t taken_ns{0};              ///< Wall time the state was copied
+    std::size_t tracks{0};
+    std::size_t bytes{0};
+    std::chrono::microseconds elapsed{0};  ///< Encode + write, or map + load
+};
+
+/// Encode a snapshot file image.
+[[nodiscard]] auto encode_snapshot(std::uint64_t journal_seq,
+                                   std::int64_t taken_ns,
+                                   std::span<const StoredTrack> tracks) -> std::string;
+
+/// Load a snapshot into `store` (restore(), no apply hook).
+///
+/// @return nullopt if `path` does not exist
+/// @throws std::system_error on I/O failure
+/// @throws std::runtime_error if the file is not a valid snapshot
+[[nodiscard]] auto load_snapshot(const std::filesystem::path& path, TrackStore& store)
+    -> std::optional<SnapshotInfo>;
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SnapshotConfig — Trivial Class Pattern with Builder Methods
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Snapshot placement and cadence. An empty path disables snapshots.
+struct SnapshotConfig {
+    // Rule of Six: All Default
+    SnapshotConfig() = default;
+    ~SnapshotConfig() = default;
+    SnapshotConfig(const SnapshotConfig&) = default;
+    SnapshotConfig& operator=(const SnapshotConfig&) = default;
+    SnapshotConfig(SnapshotConfig&&) noexcept = default;
+    SnapshotConfig& operator=(SnapshotConfig&&) noexcept = default;
+
+    /// Snapshot file (replaced atomically on each write).
+    std::filesystem::path path;
+
+    /// Interval between snapshots while the journal advances.
+    std::chrono::seconds interval{30};
+
+    [[nodiscard]] auto with_path(std::filesystem::path p) && -> SnapshotConfig {
+        path = std::move(p);
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_interval(std::chrono::seconds i) && -> SnapshotConfig {
+        interval = i;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto enabled() const noexcept -> bool { return !path.empty(); }
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SnapshotWriter — Background Encode and Write
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Owns a std::thread that references the mutex and condition variable
+// • Non-copyable, non-movable; the destructor finishes the pending
+//   snapshot and joins
+//
+// HAND-OFF:
+// The io thread copies the store (stored()) and submit()s it; encoding and
+// the fdatasync'd write happen on the writer thread. A submit while one is
+// pending replaces it — only the newest state is worth writing.
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Background snapshot writer.
+///
+/// @par Thread Safety
+/// submit(), last() and busy() may be called from any thread.
+class SnapshotWriter {
+public:
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: Non-copyable, Non-movable
+    // ───────────────────────────────────────────────────────────────────────
+
+    SnapshotWriter() = delete;
+    ~SnapshotWriter();
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+    SnapshotWriter(SnapshotWriter&&) = delete;
+    SnapshotWriter& operator=(SnapshotWriter&&) = delete;
+
+    explicit SnapshotWriter(SnapshotConfig cfg);
+
+    /// Queue a snapshot of `tracks` covering the journal through `journal_seq`.
+    void submit(std::uint64_t journal_seq, std::vector<StoredTrack> tracks);
+
+    /// Most recent snapshot written successfully.
+    [[nodiscard]] auto last() const -> std::optional<SnapshotInfo>;
+
+    /// True while a snapshot is pending or being written.
+    [[nodiscard]] auto busy() const -> bool;
+
+    [[nodiscard]] auto config() const noexcept -> const SnapshotConfig& { return cfg_; }
+
+private:
+    struct Job {
+        std::uint64_t journal_seq{0};
+        std::int64_t taken_ns{0};
+        std::vector<StoredTrack> tracks;
+    };
+
+    void run();
+
+    SnapshotConfig cfg_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::optional<Job> pending_;
+    std::optional<SnapshotInfo> last_;
+    bool writing_{false};
+    bool stopping_{false};
+    std::thread thread_;   // Last: starts after every member it uses
+};
+
+}  // namespace protocol
@@ -0,0 +1,317 @@
+#pragma once
+
+/// @file swarm.hpp
+/// @brief Incremental density clustering of tracks into swarms.
+///
+/// @code
+///   SwarmBatch  header | count u32 | count × Swarm | dissolved u32 | dissolved × id u64
+///     Swarm     id u64 | lat f64 | lon f64 | alt f32 | radius f32 | members u32
+///               | vn f32 | ve f32 | vu f32
+/// @endcode
+///
+/// Clusters follow DBSCAN: a track with at least min_tracks tracks
+/// (itself included) within eps_m is a core; cores within eps_m of each
+/// other share a cluster, and a non-core track within eps_m of a core
+/// joins that core's cluster as a border. Tracks that are neither are
+/// noise.
+///
+/// Positions live in a grid of eps_m cubes, so every neighbour of a track
+/// is in its own or the 26 surrounding cells. update() only moves a
+/// track between cells and notes the cells it touched. refresh() then
+/// recounts neighbours in the touched neighbourhoods, dissolves the
+/// clusters of the tracks found there, and floods them again from their
+/// cores. It works on the tracks that changed and the clusters they
+/// belong to, never on the whole picture. A rebuilt cluster keeps the id
+/// that most of its members had, so a swarm keeps its id as it moves,
+/// splits or merges.
+///
+/// Positions are placed on a sphere of the Earth's radius in Earth-centred
+/// coordinates, so there is no anchor, pole or date line to distort them;
+/// distances are chords, within millimetres of the surface distance at
+/// swarm scales. Reports that fail is_plausible() are ignored.
+///
+/// Demonstrates:
+/// - Uniform grid neighbourhoods for DBSCAN range queries
+/// - Dirty-region reclustering with stable cluster identity
+/// - Epoch marks instead of per-refresh sets
+/// - Trivial Class Pattern with Builder Methods for configuration
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "track.hpp"
+#include "wire.hpp"
+
+namespace protocol {
+
+using namespace std::chrono_literals;
+
+constexpr std::size_t kSwarmRecordSize = 8 + 8 + 8 + 4 + 4 + 4 + 4 + 4 + 4;
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SwarmConfig — Trivial Class Pattern with Builder Methods
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Density parameters and refresh cadence.
+struct SwarmConfig {
+    // Rule of Six: All Default
+    SwarmConfig() = default;
+    ~SwarmConfig() = default;
+    SwarmConfig(const SwarmConfig&) = default;
+    SwarmConfig& operator=(const SwarmConfig&) = default;
+    SwarmConfig(SwarmConfig&&) noexcept = default;
+    SwarmConfig& operator=(SwarmConfig&&) noexcept = default;
+
+    /// Neighbourhood radius (metres, horizontal).
+    double eps_m{150.0};
+
+    /// Tracks within eps_m (itself included) that make a track a core.
+    std::size_t min_tracks{5};
+
+    /// Tracks not updated for this long leave the picture.
+    std::chrono::milliseconds max_age{30s};
+
+    /// refresh() cadence when run by the server.
+    std::chrono::milliseconds interval{500ms};
+
+    [[nodiscard]] auto with_eps(double metres) && -> SwarmConfig {
+        eps_m = metres;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_min_tracks(std::size_t n) && -> SwarmConfig {
+        min_tracks = n;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_max_age(std::chrono::milliseconds a) && -> SwarmConfig {
+        max_age = a;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_interval(std::chrono::milliseconds i) && -> SwarmConfig {
+        interval = i;
+        return std::move(*this);
+    }
+};
+
+/// One swarm as a console renders it.
+struct SwarmSummary {
+    std::uint64_t id{0};
+    double lat{0.0};             ///< Centroid
+    double lon{0.0};
+    float alt{0.0F};
+    float radius_m{0.0F};        ///< Farthest member from the centroid (horizontal)
+    std::uint32_t members{0};
+    float vn{0.0F};              ///< Mean member velocity
+    float ve{0.0F};
+    float vu{0.0F};
+};
+
+/// What changed since the previous refresh().
+struct SwarmDelta {
+    std::vector<SwarmSummary> updated;     ///< New or changed swarms
+    std::vector<std::uint64_t> dissolved;  ///< Swarms that no longer exist
+
+    [[nodiscard]] auto empty() const noexcept -> bool { return updated.empty() && dissolved.empty(); }
+};
+
+/// Clustering counters.
+struct SwarmStats {
+    std::uint64_t updates{0};       ///< Reports fed in
+    std::uint64_t refreshes{0};
+    std::uint64_t reevaluated{0};   ///< Tracks whose neighbours were recounted
+    std::uint64_t reclustered{0};   ///< Tracks relabelled by cluster floods
+    std::size_t tracks{0};          ///< Currently held
+    std::size_t swarms{0};
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SwarmDetector — Incremental Grid DBSCAN
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Holds hash maps and vectors (value type)
+// • Compiler-generated operations are correct
+//
+// REFRESH:
+// 1. Expire tracks older than max_age (a min-heap with one entry per
+//    track; an entry found refreshed is pushed back with the newer time)
+// 2. Recount neighbours of every track in the 3×3×3 cells around each
+//    touched cell; this is where core status can have changed
+// 3. Dissolve the clusters of those tracks (and of expired ones) and
+//    flood them again from their cores. A flood that reaches a core of a
+//    cluster left standing dissolves that one too (a merge)
+// 4. Attach unlabelled non-cores to any neighbouring core as borders
+// 5. Name each rebuilt cluster after its members' majority previous id
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Swarm clustering over a stream of track reports.
+///
+/// @par Thread Safety
+/// Not thread-safe.
+///
+/// @par Example
+/// @code
+/// SwarmDetector swarms{SwarmConfig{}.with_eps(150.0).with_min_tracks(5)};
+/// for (const auto& t : batch) swarms.update(t);
+/// auto delta = swarms.refresh(now_ns);   // send delta to consoles
+/// @endcode
+class SwarmDetector {
+public:
+    // Rule of Six: All Default
+    SwarmDetector() = default;
+    ~SwarmDetector() = default;
+    SwarmDetector(const SwarmDetector&) = default;
+    SwarmDetector& operator=(const SwarmDetector&) = default;
+    SwarmDetector(SwarmDetector&&) noexcept = default;
+    SwarmDetector& operator=(SwarmDetector&&) noexcept = default;
+
+    explicit SwarmDetector(const SwarmConfig& cfg) : cfg_{cfg} {}
+
+    /// Record a report (older than the one held for its target: ignored).
+    /// Takes effect at the next refresh().
+    void update(const TrackUpdate& t);
+
+    /// Bring clusters up to date with every update() since the last call.
+    auto refresh(std::int64_t now_ns) -> SwarmDelta;
+
+    /// Every current swarm (e.g. for a console that just subscribed).
+    [[nodiscard]] auto summaries() const -> std::vector<SwarmSummary>;
+
+    /// Swarm a target belongs to, if any.
+    [[nodiscard]] auto swarm_of(std::uint64_t target_id) const -> std::optional<std::uint64_t>;
+
+    [[nodiscard]] auto stats() const noexcept -> SwarmStats;
+    [[nodiscard]] auto config() const noexcept -> const SwarmConfig& { return cfg_; }
+
+private:
+    struct Member {
+        double x{0.0};               ///< Earth-centred position on the sphere (metres)
+        double y{0.0};
+        double z{0.0};
+        float alt{0.0F};
+        float vn{0.0F};
+        float ve{0.0F};
+        float vu{0.0F};
+        std::int64_t time_ns{0};
+        std::uint64_t cell{0};
+        std::uint32_t neighbours{0}; ///< Within eps, itself included
+        std::uint64_t cluster{0};    ///< 0 = noise
+        std::uint64_t previous{0};   ///< Cluster before the current refresh dissolved it
+        std::uint64_t mark{0};       ///< Refresh epoch that last queued this track
+    };
+
+    [[nodiscard]] auto cell_of(double x, double y, double z) const noexcept -> std::uint64_t;
+    [[nodiscard]] auto is_core(const Member& m) const noexcept -> bool { return m.neighbours >= cfg_.min_tracks; }
+
+    /// Visit the ids in the 3×3×3 cells around `cell`.
+    template<typename F>
+    void for_each_near(std::uint64_t cell, F&& fn) const;
+
+    /// Visit the tracks within eps of `m` (itself included).
+    template<typename F>
+    void for_each_neighbour(const Member& m, F&& fn);
+
+    void remove_track(std::uint64_t id);
+    void dissolve(std::uint64_t cluster, std::vector<std::uint64_t>& pool);
+    [[nodiscard]] auto summarize(std::uint64_t id, const std::vector<std::uint64_t>& members) const
+        -> SwarmSummary;
+
+    SwarmConfig cfg_;
+
+    std::unordered_map<std::uint64_t, Member> tracks_;
+    std::unordered_map<std::uint64_t, std::vector<std::uint64_t>> cells_;
+    std::unordered_map<std::uint64_t, std::vector<std::uint64_t>> clusters_;
+
+    std::vector<std::uint64_t> touched_cells_;      ///< Since the last refresh
+    std::vector<std::uint64_t> orphaned_clusters_;  ///< Clusters of expired tracks
+    std::priority_queue<std::pair<std::int64_t, std::uint64_t>,
+                        std::vector<std::pair<std::int64_t, std::uint64_t>>,
+                        std::greater<>> expiry_;
+    std::uint64_t epoch_{0};
+    std::uint64_t next_id_{1};
+    SwarmStats stats_;
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Codecs
+// ═══════════════════════════════════════════════════════════════════════════
+
+[[nodiscard]] inline auto encode_swarm_batch(std::span<const SwarmSummary> swarms,
+                                             std::span<const std::uint64_t> dissolved) -> std::string
+{
+    wire::ByteWriter w{wire::FrameKind::SwarmBatch, 0,
+                       wire::kHeaderSize + 8 + swarms.size() * kSwarmRecordSize + dissolved.size() * 8};
+    w.put_u32(static_cast<std::uint32_t>(swarms.size()));
+    for (const auto& s : swarms) {
+        w.put_u64(s.id);
+        w.put_f64(s.lat);
+        w.put_f64(s.lon);
+        w.put_f32(s.alt);
+        w.put_f32(s.radius_m);
+        w.put_u32(s.members);
+        w.put_f32(s.vn);
+        w.put_f32(s.ve);
+        w.put_f32(s.vu);
+    }
+    w.put_u32(static_cast<std::uint32_t>(dissolved.size()));
+    for (const auto id : dissolved) {
+        w.put_u64(id);
+    }
+    return std::move(w).take();
+}
+
+/// Decode SwarmBatch. Returns nullopt on malformed input.
+[[nodiscard]] inline auto decode_swarm_batch(std::string_view frame) -> std::optional<SwarmDelta> {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    if (!header || header->kind != wire::FrameKind::SwarmBatch) {
+        return std::nullopt;
+    }
+    SwarmDelta out;
+    const auto count = r.get_u32();
+    if (!r.ok() || r.remaining() < static_cast<std::size_t>(count) * kSwarmRecordSize) {
+        return std::nullopt;
+    }
+    out.updated.resize(count);
+    for (auto& s : out.updated) {
+        s.id = r.get_u64();
+        s.lat = r.get_f64();
+        s.lon = r.get_f64();
+        s.alt = r.get_f32();
+        s.radius_m = r.get_f32();
+        s.members = r.get_u32();
+        s.vn = r.get_f32();
+        s.ve = r.get_f32();
+        s.vu = r.get_f32();
+    }
+    const auto gone = r.get_u32();
+    if (!r.ok() || r.remaining() < static_cast<std::size_t>(gone) * 8) {
+        return std::nullopt;
+    }
+    out.dissolved.resize(gone);
+    for (auto& id : out.dissolved) {
+        id = r.get_u64();
+    }
+    if (!r.ok()) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+}  // namespace protocol
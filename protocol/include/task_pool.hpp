@@ -0,0 +1,501 @@
+#pragma once
+
+/// @file task_pool.hpp
+/// @brief Work-stealing CPU pool for analytics kept off the I/O threads.
+///
+/// Demonstrates:
+/// - Chase-Lev lock-free work-stealing deques (one per worker)
+/// - Fork/join task groups with helping joins
+/// - Asio coroutine bridge: `co_await pool.run(fn)` resumes on the caller's executor
+/// - Rule of Six for thread-owning (non-copyable, non-movable) classes
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+namespace protocol::exec {
+
+namespace asio = boost::asio;
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ChaseLevDeque — Lock-Free Work-Stealing Deque
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Owner thread pushes and pops at the bottom (LIFO, cache-warm), thieves
+// steal from the top (FIFO, oldest and usually largest work first).
+// Memory orderings follow Lê, Pop, Cohen & Zappa Nardelli, "Correct and
+// Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+//
+// RULE OF SIX RATIONALE:
+// • Owns its ring buffers and is shared by address between threads
+// • Relocating it would invalidate concurrent thieves
+// • DECISION: Non-copyable, non-movable
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Single-producer, multi-consumer work-stealing deque.
+///
+/// @tparam T Trivially copyable element (normally a task pointer)
+template<typename T>
+class ChaseLevDeque {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "ChaseLevDeque elements must be trivially copyable");
+
+public:
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: Non-copyable, Non-movable
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Construct with initial capacity of 2^log_capacity slots.
+    explicit ChaseLevDeque(std::size_t log_capacity = 8)
+        : ring_{new Ring{std::int64_t{1} << log_capacity}}
+    {}
+
+    /// Destructor — releases live and retired rings.
+    ~ChaseLevDeque() {
+        delete ring_.load(std::memory_order_relaxed);
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+    ChaseLevDeque(ChaseLevDeque&&) = delete;
+    ChaseLevDeque& operator=(ChaseLevDeque&&) = delete;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Owner Operations
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Push at the bottom. Owner thread only.
+    void push(T item) {
+        const auto b = bottom_.load(std::memory_order_relaxed);
+        const auto t = top_.load(std::memory_order_acquire);
+        auto* ring = ring_.load(std::memory_order_relaxed);
+
+        if (b - t > ring->capacity - 1) {
+            ring = grow(ring, t, b);
+        }
+
+        ring->put(b, item);
+        // Release store (rather than fence + relaxed) publishes the slot to
+        // thieves; same codegen on x86 and visible to ThreadSanitizer.
+        bottom_.store(b + 1, std::memory_order_release);
+    }
+
+    /// Pop from the bottom. Owner thread only.
+    [[nodiscard]] auto pop() -> std::optional<T> {
+        const auto b = bottom_.load(std::memory_order_relaxed) - 1;
+        auto* ring = ring_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // Empty — restore bottom
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        std::optional<T> item{ring->get(b)};
+        if (t == b) {
+            // Last element — race against thieves for it
+            if (!top_.compare_exchange_strong(t, t + 1,
+                                              std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+                item.reset();
+            }
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Thief Operations
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Steal from the top. Any thread.
+    ///
+    /// Returns nullopt when empty or when the race for the element was lost;
+    /// callers simply move on to the next victim.
+    [[nodiscard]] auto steal() -> std::optional<T> {
+        auto t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const auto b = bottom_.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return std::nullopt;
+        }
+
+        auto* ring = ring_.load(std::memory_order_acquire);
+        T item = ring->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1,
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        return item;
+    }
+
+    /// Approximate number of queued elements (racy, for heuristics only).
+    [[nodiscard]] auto size_hint() const noexcept -> std::size_t {
+        const auto b = bottom_.load(std::memory_order_relaxed);
+        const auto t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<std::size_t>(b - t) : 0;
+    }
+
+private:
+    /// Circular buffer of atomic slots. Retired rings are chained so that
+    /// thieves still reading an old ring never touch freed memory.
+    struct Ring {
+        explicit Ring(std::int64_t cap)
+            : capacity{cap}
+            , mask{cap - 1}
+            , slots{std::make_unique<std::atomic<T>[]>(static_cast<std::size_t>(cap))}
+        {}
+
+        ~Ring() { delete previous; }
+
+        Ring(const Ring&) = delete;
+        Ring& operator=(const Ring&) = delete;
+        Ring(Ring&&) = delete;
+        Ring& operator=(Ring&&) = delete;
+
+        [[nodiscard]] auto get(std::int64_t i) const noexcept -> T {
+            return slots[static_cast<std::size_t>(i & mask)].load(std::memory_order_relaxed);
+        }
+
+        void put(std::int64_t i, T item) noexcept {
+            slots[static_cast<std::size_t>(i & mask)].store(item, std::memory_order_relaxed);
+        }
+
+        std::int64_t capacity;
+        std::int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+        Ring* previous{nullptr};
+    };
+
+    auto grow(Ring* old, std::int64_t t, std::int64_t b) -> Ring* {
+        auto* bigger = new Ring{old->capacity * 2};
+        for (auto i = t; i < b; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        bigger->previous = old;
+        ring_.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    alignas(64) std::atomic<std::int64_t> top_{0};
+    alignas(64) std::atomic<std::int64_t> bottom_{0};
+    alignas(64) std::atomic<Ring*> ring_;
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Pool Statistics
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Snapshot of pool counters.
+struct PoolStats {
+    std::size_t workers{0};       ///< Worker thread count
+    std::uint64_t submitted{0};   ///< Tasks submitted
+    std::uint64_t executed{0};    ///< Tasks executed
+    std::uint64_t stolen{0};      ///< Tasks taken from another worker's deque
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TaskPool — Work-Stealing Thread Pool
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+//
+// This class owns worker threads that capture `this`:
+// • Copying would duplicate threads with no meaningful semantics
+// • Moving would leave running workers pointing at a dead object
+//
+// DECISION: Non-copyable, non-movable (hold via unique_ptr/shared_ptr
+// when ownership needs to travel, e.g. into a move-only server).
+//
+// SCHEDULING:
+// • Tasks submitted from a worker go to that worker's own deque
+// • Tasks submitted from elsewhere (I/O threads) go to a shared inject queue
+// • Idle workers pop local → drain inject queue → steal from random victims
+// • Workers sleep on a condition variable only when nothing is pending
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Work-stealing pool for CPU-bound analytics.
+///
+/// @par Thread Safety
+/// All public member functions are thread-safe.
+///
+/// @par Example
+/// @code
+/// protocol::exec::TaskPool pool;
+///
+/// // From an io_context coroutine — resumes on the same executor
+/// auto clusters = co_await pool.run([&] { return cluster_tracks(snapshot); });
+///
+/// // Fork/join inside a pool task
+/// pool.parallel_for(std::size_t{0}, tracks.size(), std::size_t{1024},
+///                   [&](std::size_t begin, std::size_t end) { score(begin, end); });
+/// @endcode
+class TaskPool {
+public:
+    using Task = std::move_only_function<void()>;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: Non-copyable, Non-movable
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Start worker threads.
+    ///
+    /// @param threads Worker count; 0 selects hardware concurrency
+    explicit TaskPool(std::size_t threads = 0);
+
+    /// Destructor — stops and joins all workers. Unstarted tasks are discarded.
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+    TaskPool(TaskPool&&) = delete;
+    TaskPool& operator=(TaskPool&&) = delete;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Submission
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Submit fire-and-forget task. Exceptions escaping the task are logged.
+    void submit(Task task);
+
+    /// Run callable on the pool and resume the awaiting coroutine on its
+    /// original executor with the result (or the rethrown exception).
+    ///
+    /// @tparam F Nullary callable
+    /// @param fn Callable, moved onto the pool
+    /// @return Awaitable yielding fn's result
+    template<typename F>
+        requires std::invocable<F&>
+    [[nodiscard]] auto run(F fn) -> asio::awaitable<std::invoke_result_t<F&>> {
+        using R = std::invoke_result_t<F&>;
+
+        if constexpr (std::is_void_v<R>) {
+            co_await asio::async_initiate<const asio::use_awaitable_t<>&, void(std::exception_ptr)>(
+                [this, fn = std::move(fn)](auto handler) mutable {
+                    auto ex = asio::get_associated_executor(handler);
+                    submit([fn = std::move(fn), handler = std::move(handler), ex]() mutable {
+                        std::exception_ptr error;
+                        try {
+                            fn();
+                        } catch (...) {
+                            error = std::current_exception();
+                        }
+                        asio::post(ex, [handler = std::move(handler), error]() mutable {
+                            std::move(handler)(error);
+                        });
+                    });
+                },
+                asio::use_awaitable);
+        } else {
+            auto result = co_await asio::async_initiate<const asio::use_awaitable_t<>&,
+                                                        void(std::exception_ptr, std::optional<R>)>(
+                [this, fn = std::move(fn)](auto handler) mutable {
+                    auto ex = asio::get_associated_executor(handler);
+                    submit([fn = std::move(fn), handler = std::move(handler), ex]() mutable {
+                        std::exception_ptr error;
+                        std::optional<R> value;
+                        try {
+                            value.emplace(fn());
+                        } catch (...) {
+                            error = std::current_exception();
+                        }
+                        asio::post(ex, [handler = std::move(handler), error,
+                                        value = std::move(value)]() mutable {
+                            std::move(handler)(error, std::move(value));
+                        });
+                    });
+                },
+                asio::use_awaitable);
+            co_return std::move(*result);
+        }
+    }
+
+    /// Fork/join loop over [first, last) split into chunks of at most grain.
+    ///
+    /// Blocks until every chunk has run. When called from a worker the
+    /// calling thread executes pool tasks while it waits, so nested
+    /// parallel_for calls cannot deadlock the pool.
+    template<typename Index, typename F>
+        requires std::invocable<F&, Index, Index>
+    void parallel_for(Index first, Index last, Index grain, F&& body);
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Introspection
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Number of worker threads.
+    [[nodiscard]] auto size() const noexcept -> std::size_t {
+        return workers_.size();
+    }
+
+    /// True when the calling thread is one of this pool's workers.
+    [[nodiscard]] auto is_worker_thread() const noexcept -> bool {
+        return tl_pool_ == this;
+    }
+
+    /// Snapshot of pool counters.
+    [[nodiscard]] auto stats() const noexcept -> PoolStats;
+
+    /// Execute one pending task on the calling thread, if any.
+    ///
+    /// Used by joins to help instead of blocking a worker.
+    auto try_run_one() -> bool;
+
+private:
+    struct TaskNode {
+        Task fn;
+    };
+
+    struct Worker {
+        ChaseLevDeque<TaskNode*> deque;
+        std::thread thread;
+        std::uint64_t rng_state{0};
+    };
+
+    void worker_loop(std::size_t index);
+    auto find_task(std::size_t index) -> TaskNode*;
+    void execute(TaskNode* node) noexcept;
+    void notify_one();
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    std::mutex inject_mutex_;
+    std::deque<TaskNode*> inject_;
+
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    std::atomic<std::size_t> sleepers_{0};
+    std::atomic<std::size_t> pending_{0};
+    std::atomic<bool> stopping_{false};
+
+    std::atomic<std::uint64_t> submitted_{0};
+    std::atomic<std::uint64_t> executed_{0};
+    std::atomic<std::uint64_t> stolen_{0};
+
+    static thread_local TaskPool* tl_pool_;
+    static thread_local std::size_t tl_index_;
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TaskGroup — Fork/Join Scope
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Tracks outstanding children by address (children capture `this`)
+// • DECISION: Non-copyable, non-movable; destructor joins
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Group of forked tasks joined with wait().
+///
+/// The first exception thrown by a child is rethrown from wait().
+///
+/// @par Example
+/// @code
+/// TaskGroup group{pool};
+/// group.spawn([&] { left = solve(lhs); });
+/// group.spawn([&] { right = solve(rhs); });
+/// group.wait();
+/// @endcode
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskPool& pool) noexcept : pool_{pool} {}
+
+    /// Destructor — joins outstanding children (exceptions are discarded).
+    ~TaskGroup() {
+        try {
+            wait();
+        } catch (...) {
+        }
+    }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    TaskGroup(TaskGroup&&) = delete;
+    TaskGroup& operator=(TaskGroup&&) = delete;
+
+    /// Fork child task.
+    template<typename F>
+    void spawn(F&& fn) {
+        outstanding_.fetch_add(1, std::memory_order_relaxed);
+        pool_.submit([this, fn = std::forward<F>(fn)]() mutable {
+            try {
+                fn();
+            } catch (...) {
+                std::lock_guard lock{mutex_};
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+            }
+            finish_one();
+        });
+    }
+
+    /// Join all children, helping the pool while waiting.
+    void wait();
+
+private:
+    void finish_one();
+
+    TaskPool& pool_;
+    std::atomic<std::size_t> outstanding_{0};
+    std::mutex mutex_;
+    std::condition_variable done_cv_;
+    std::exception_ptr error_;
+};
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// parallel_for (recursive halving on top of TaskGroup)
+// ───────────────────────────────────────────────────────────────────────────
+
+template<typename Index, typename F>
+    requires std::invocable<F&, Index, Index>
+void TaskPool::parallel_for(Index first, Index last, Index grain, F&& body) {
+    if (first >= last) {
+        return;
+    }
+    if (grain < Index{1}) {
+        grain = Index{1};
+    }
+
+    TaskGroup group{*this};
+    auto split = [&](auto& self, Index lo, Index hi) -> void {
+        while (hi - lo > grain) {
+            const Index mid = lo + (hi - lo) / 2;
+            group.spawn([&self, mid, hi] { self(self, mid, hi); });
+            hi = mid;
+        }
+        body(lo, hi);
+    };
+    split(split, first, last);
+    group.wait();
+}
+
+}  // namespace protocol::exec
@@ -0,0 +1,178 @@
+#pragma once
+
+/// @file track.hpp
+/// @brief Target track update record and its binary batch codec.
+///
+/// Demonstrates:
+/// - Trivial aggregate value type (Rule of Zero via Rule of Six defaults)
+/// - Fixed-size little-endian records for cheap batch encode/decode
+/// - Optional latency-trace header extension on batches
+/// - Optional feed sequence so a mirroring client can detect gaps
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "latency.hpp"
+#include "protocol.hpp"
+#include "wire.hpp"
+
+namespace protocol {
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TrackUpdate — Kinematic Report for One Target
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Position/velocity report for a single target.
+///
+/// Times are nanoseconds since the Unix epoch (sensor clock). Positions are
+/// WGS-84 degrees; altitude and velocity are metres and metres/second in a
+/// local north-east-up frame.
+struct TrackUpdate {
+    std::uint64_t target_id{0};
+    std::int64_t time_ns{0};
+    double lat{0.0};
+    double lon{0.0};
+    float alt{0.0F};
+    float vn{0.0F};
+    float ve{0.0F};
+    float vu{0.0F};
+    Urgency urgency{Urgency::Green};
+};
+
+/// Fastest velocity component and highest altitude a report may claim
+/// and still be taken as a measurement; past them it is corrupt.
+constexpr float kMaxTrackSpeedMps = 10'000.0F;
+constexpr float kMaxTrackAltitudeM = 1'000'000.0F;
+
+/// True if the report is on the globe (lat in [-90, 90], lon in
+/// [-180, 180]) with finite altitude and velocity within the limits above.
+/// Everything that turns positions into grid indices relies on it.
+[[nodiscard]] inline auto is_plausible(const TrackUpdate& t) noexcept -> bool {
+    return t.lat >= -90.0 && t.lat <= 90.0
+        && t.lon >= -180.0 && t.lon <= 180.0
+        && std::abs(t.alt) <= kMaxTrackAltitudeM
+        && std::abs(t.vn) <= kMaxTrackSpeedMps
+        && std::abs(t.ve) <= kMaxTrackSpeedMps
+        && std::abs(t.vu) <= kMaxTrackSpeedMps;
+}
+
+/// Encoded size of one TrackUpdate record.
+constexpr std::size_t kTrackRecordSize = 8 + 8 + 8 + 8 + 4 + 4 + 4 + 4 + 1;
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// Record Codec
+// ───────────────────────────────────────────────────────────────────────────
+
+/// Append one record (no frame header).
+inline void encode_track(wire::ByteWriter& w, const TrackUpdate& t) {
+    w.put_u64(t.target_id);
+    w.put_i64(t.time_ns);
+    w.put_f64(t.lat);
+    w.put_f64(t.lon);
+    w.put_f32(t.alt);
+    w.put_f32(t.vn);
+    w.put_f32(t.ve);
+    w.put_f32(t.vu);
+    w.put_u8(static_cast<std::uint8_t>(t.urgency));
+}
+
+/// Read one record (no frame header). Check reader.ok() afterwards.
+[[nodiscard]] inline auto decode_track(wire::ByteReader& r) noexcept -> TrackUpdate {
+    TrackUpdate t;
+    t.target_id = r.get_u64();
+    t.time_ns = r.get_i64();
+    t.lat = r.get_f64();
+    t.lon = r.get_f64();
+    t.alt = r.get_f32();
+    t.vn = r.get_f32();
+    t.ve = r.get_f32();
+    t.vu = r.get_f32();
+    const auto u = r.get_u8();
+    t.urgency = u <= static_cast<std::uint8_t>(Urgency::Red)
+        ? static_cast<Urgency>(u)
+        : Urgency::Green;
+    return t;
+}
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// Batch Codec
+// ───────────────────────────────────────────────────────────────────────────
+
+/// Decoded TrackBatch frame.
+struct TrackBatch {
+    std::vector<TrackUpdate> tracks;
+    std::optional<LatencyTrace> trace;   ///< Present when the sender stamped one
+    std::optional<std::uint64_t> seq;    ///< Feed sequence, when the sender numbers its batches
+};
+
+/// Encode TrackBatch frame: header, [seq u64], [trace], u32 count, records.
+/// A `seq` of 0 means the batch is not numbered.
+[[nodiscard]] inline auto encode_track_batch(std::span<const TrackUpdate> tracks,
+                                             const LatencyTrace* trace = nullptr,
+                                             std::uint64_t seq = 0)
+    -> std::string
+{
+    const auto flags = static_cast<std::uint8_t>((trace ? wire::kFlagLatencyTrace : 0) | (seq != 0 ? wire::kFlagFeedSeq : 0));
+    wire::ByteWriter w{wire::FrameKind::TrackBatch, flags,
+                       wire::kHeaderSize + (seq != 0 ? 8 : 0) + (trace ? trace_size(*trace) : 0) +
+                       4 + tracks.size() * kTrackRecordSize};
+    if (seq != 0) {
+        w.put_u64(seq);
+    }
+    if (trace) {
+        encode_trace(w, *trace);
+    }
+    w.put_u32(static_cast<std::uint32_t>(tracks.size()));
+    for (const auto& t : tracks) {
+        encode_track(w, t);
+    }
+    return std::move(w).take();
+}
+
+/// Decode TrackBatch frame. Returns nullopt on malformed input, which
+/// includes any record that is not is_plausible().
+[[nodiscard]] inline auto decode_track_batch(std::string_view frame)
+    -> std::optional<TrackBatch>
+{
+    wire::ByteReader r{frame};
+    auto header = r.get_header();
+    if (!header || header->kind != wire::FrameKind::TrackBatch) {
+        return std::nullopt;
+    }
+
+    TrackBatch out;
+    if (header->flags & wire::kFlagFeedSeq) {
+        out.seq = r.get_u64();
+    }
+    if (header->flags & wire::kFlagLatencyTrace) {
+        out.trace = decode_trace(r);
+        if (!out.trace) {
+            return std::nullopt;
+        }
+    }
+
+    const auto count = r.get_u32();
+    if (!r.ok() || r.remaining() < static_cast<std::size_t>(count) * kTrackRecordSize) {
+        return std::nullopt;
+    }
+
+    out.tracks.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        out.tracks.push_back(decode_track(r));
+    }
+    if (!r.ok() || !std::all_of(out.tracks.begin(), out.tracks.end(), is_plausible)) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+}  // namespace protocol
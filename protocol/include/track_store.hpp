@@ -0,0 +1,107 @@
+#pragma once
+
+/// @file track_store.hpp
+/// @brief Latest-known state of every target, tagged with its origin node.
+///
+/// Demonstrates:
+/// - Last-writer-wins by sensor time (replicas converge regardless of order)
+/// - Origin tagging so a node replicates only what it ingested itself
+/// - Apply hook so every accepted change can be journalled
+/// - Rule of Six for container-backed value types
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "track.hpp"
+
+namespace protocol {
+
+/// One stored target.
+struct StoredTrack {
+    TrackUpdate update;
+    std::uint32_t origin_node{0};   ///< Node that ingested the update
+    std::uint64_t origin_seq{0};    ///< Origin's replication sequence (0 = local)
+    std::int64_t stored_ns{0};      ///< Local wall time the update was applied
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TrackStore — Target Id → Latest Update
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// CONFLICT RULE:
+// An update replaces the stored one unless it is older by sensor time
+// (time_ns). Equal times are accepted so a re-sent snapshot is idempotent.
+//
+// RULE OF SIX RATIONALE:
+// • Contains an unordered_map and a std::function (manage own memory)
+// • Compiler-generated operations are correct
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// In-memory track table.
+///
+/// @par Thread Safety
+/// Not thread-safe; owned by the server's io_context thread.
+class TrackStore {
+public:
+    // Rule of Six: All Default
+    TrackStore() = default;
+    ~TrackStore() = default;
+    TrackStore(const TrackStore&) = default;
+    TrackStore& operator=(const TrackStore&) = default;
+    TrackStore(TrackStore&&) noexcept = default;
+    TrackStore& operator=(TrackStore&&) noexcept = default;
+
+    /// Called after every accepted apply().
+    using ApplyHook = std::function<void(const StoredTrack&)>;
+
+    /// Install (or clear) the apply hook.
+    void set_on_apply(ApplyHook hook) { on_apply_ = std::move(hook); }
+
+    /// Apply an update. Returns false when it is older than the stored one.
+    auto apply(const TrackUpdate& update,
+               std::uint32_t origin_node,
+               std::uint64_t origin_seq,
+               std::int64_t now_ns) -> bool;
+
+    /// Insert a stored track as-is (snapshot load). Bypasses the conflict
+    /// rule and the apply hook.
+    void restore(const StoredTrack& track) { tracks_.insert_or_assign(track.update.target_id, track); }
+
+    /// Pre-size for `n` targets.
+    void reserve(std::size_t n) { tracks_.reserve(n); }
+
+    /// Remove a target.
+    auto erase(std::uint64_t target_id) -> bool { return tracks_.erase(target_id) > 0; }
+
+    [[nodiscard]] auto find(std::uint64_t target_id) const -> const StoredTrack*;
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return tracks_.size(); }
+    [[nodiscard]] auto empty() const noexcept -> bool { return tracks_.empty(); }
+
+    /// Copy out current updates, optionally only those from one origin.
+    [[nodiscard]] auto snapshot(std::optional<std::uint32_t> origin = std::nullopt) const
+        -> std::vector<TrackUpdate>;
+
+    /// Copy out every stored track with its origin metadata.
+    [[nodiscard]] auto stored() const -> std::vector<StoredTrack>;
+
+    /// Visit every stored track.
+    template<typename F>
+    void for_each(F&& fn) const {
+        for (const auto& [id, track] : tracks_) {
+            fn(track);
+        }
+    }
+
+private:
+    std::unordered_map<std::uint64_t, StoredTrack> tracks_;
+    ApplyHook on_apply_;
+};
+
+}  // namespace protocol
@@ -0,0 +1,220 @@
+#pragma once
+
+/// @file upload.hpp
+/// @brief Chunked, resumable bulk upload frames (mission logs, imagery).
+///
+/// @code
+///   UploadBegin  header | id u64 | size u64 | chunk_size u32 | file_hash u64 | name str
+///   UploadChunk  header | id u64 | offset u64 | hash u64 | data (rest of frame)
+///   UploadAck    header | id u64 | committed u64 | status u8
+/// @endcode
+///
+/// The client splits a file into fixed chunk_size chunks (the last may be
+/// short) and sends UploadBegin; the server answers with the offset it has
+/// already committed, so an upload interrupted by a disconnect continues
+/// from there instead of from zero. Chunks are then sent in order, up to a
+/// window ahead of the last ack. Each chunk carries content_hash() of its
+/// data; file_hash folds the chunk hashes in order (fold_chunk_hash), so
+/// the server verifies the whole file without reading it back.
+///
+/// `id` is chosen by the client and must be stable across reconnects
+/// (upload_id() derives it from name, size and file hash).
+///
+/// Demonstrates:
+/// - Positional resume (offset, not sequence) over an ordered stream
+/// - Fail-soft decoding via ByteReader
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "hash_ring.hpp"
+#include "wire.hpp"
+
+namespace protocol::upload {
+
+/// Largest chunk a server accepts.
+constexpr std::uint32_t kMaxChunkSize = 4U * 1024 * 1024;
+
+/// Longest file name in UploadBegin.
+constexpr std::size_t kMaxNameLength = 255;
+
+/// Outcome carried by UploadAck.
+enum class UploadStatus : std::uint8_t {
+    Resume    = 1,   ///< Reply to UploadBegin: continue from `committed`
+    Committed = 2,   ///< Chunk written; `committed` advanced
+    Corrupt   = 3,   ///< Chunk hash mismatch; resend from `committed`
+    Complete  = 4,   ///< Whole file verified and in place
+    Rejected  = 5    ///< Upload refused (bad request, limits, I/O error)
+};
+
+/// Decoded UploadBegin.
+struct UploadBegin {
+    std::uint64_t id{0};
+    std::uint64_t size{0};
+    std::uint32_t chunk_size{0};
+    std::uint64_t file_hash{0};
+    std::string name;
+};
+
+/// Decoded UploadChunk (data views the frame).
+struct UploadChunk {
+    std::uint64_t id{0};
+    std::uint64_t offset{0};
+    std::uint64_t hash{0};
+    std::string_view data;
+};
+
+/// Decoded UploadAck.
+struct UploadAck {
+    std::uint64_t id{0};
+    std::uint64_t committed{0};
+    UploadStatus status{UploadStatus::Rejected};
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Hashing
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// 64-bit content hash of a chunk: eight little-endian bytes per step
+/// through mix64.
+///
+/// Guards against truncation and corruption in the upload path, not
+/// against a malicious sender (TLS authenticates the transport).
+[[nodiscard]] inline auto content_hash(std::string_view data) noexcept -> std::uint64_t {
+    std::uint64_t h = mix64(data.size());
+    std::size_t i = 0;
+    for (; i + 8 <= data.size(); i += 8) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, data.data() + i, 8);
+        if constexpr (std::endian::native == std::endian::big) {
+            word = std::byteswap(word);
+        }
+        h = mix64(h ^ word);
+    }
+    if (i < data.size()) {
+        std::uint64_t word = 0;
+        for (std::size_t b = 0; i + b < data.size(); ++b) {
+            word |= std::uint64_t{static_cast<unsigned char>(data[i + b])} << (8 * b);
+        }
+        h = mix64(h ^ word);
+    }
+    return h;
+}
+
+/// Fold the next chunk hash into a running file hash (start: file_hash_seed).
+[[nodiscard]] constexpr auto fold_chunk_hash(std::uint64_t file_hash, std::uint64_t chunk_hash) noexcept
+    -> std::uint64_t
+{
+    return mix64(file_hash ^ chunk_hash);
+}
+
+/// Initial running file hash for a file of `size` bytes.
+[[nodiscard]] constexpr auto file_hash_seed(std::uint64_t size) noexcept -> std::uint64_t {
+    return mix64(~size);
+}
+
+/// Client-side upload id: stable for the same name, size and content.
+[[nodiscard]] inline auto upload_id(std::string_view name, std::uint64_t size, std::uint64_t file_hash) noexcept
+    -> std::uint64_t
+{
+    return mix64(content_hash(name) ^ mix64(size ^ file_hash));
+}
+
+/// Length of the chunk at `offset` (fixed size, the last may be short).
+[[nodiscard]] constexpr auto chunk_length(std::uint64_t size, std::uint32_t chunk_size, std::uint64_t offset) noexcept
+    -> std::uint64_t
+{
+    return offset >= size ? 0 : (size - offset < chunk_size ? size - offset : chunk_size);
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Codecs
+// ═══════════════════════════════════════════════════════════════════════════
+
+[[nodiscard]] inline auto encode_upload_begin(const UploadBegin& begin) -> std::string {
+    wire::ByteWriter w{wire::FrameKind::UploadBegin, 0, wire::kHeaderSize + 32 + begin.name.size()};
+    w.put_u64(begin.id);
+    w.put_u64(begin.size);
+    w.put_u32(begin.chunk_size);
+    w.put_u64(begin.file_hash);
+    w.put_string(begin.name);
+    return std::move(w).take();
+}
+
+[[nodiscard]] inline auto decode_upload_begin(std::string_view frame) -> std::optional<UploadBegin> {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    if (!header || header->kind != wire::FrameKind::UploadBegin) {
+        return std::nullopt;
+    }
+    UploadBegin out;
+    out.id = r.get_u64();
+    out.size = r.get_u64();
+    out.chunk_size = r.get_u32();
+    out.file_hash = r.get_u64();
+    const auto name = r.get_string();
+    if (!r.ok() || name.size() > kMaxNameLength) {
+        return std::nullopt;
+    }
+    out.name = name;
+    return out;
+}
+
+/// Encode a chunk frame; `data` is copied once, into the frame.
+[[nodiscard]] inline auto encode_upload_chunk(std::uint64_t id, std::uint64_t offset, std::string_view data)
+    -> std::string
+{
+    wire::ByteWriter w{wire::FrameKind::UploadChunk, 0, wire::kHeaderSize + 24 + data.size()};
+    w.put_u64(id);
+    w.put_u64(offset);
+    w.put_u64(content_hash(data));
+    w.put_bytes(data);
+    return std::move(w).take();
+}
+
+[[nodiscard]] inline auto decode_upload_chunk(std::string_view frame) noexcept -> std::optional<UploadChunk> {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    UploadChunk out;
+    out.id = r.get_u64();
+    out.offset = r.get_u64();
+    out.hash = r.get_u64();
+    if (!header || header->kind != wire::FrameKind::UploadChunk || !r.ok()) {
+        return std::nullopt;
+    }
+    out.data = r.get_bytes(r.remaining());
+    return out;
+}
+
+[[nodiscard]] inline auto encode_upload_ack(const UploadAck& ack) -> std::string {
+    wire::ByteWriter w{wire::FrameKind::UploadAck, 0, wire::kHeaderSize + 17};
+    w.put_u64(ack.id);
+    w.put_u64(ack.committed);
+    w.put_u8(static_cast<std::uint8_t>(ack.status));
+    return std::move(w).take();
+}
+
+[[nodiscard]] inline auto decode_upload_ack(std::string_view frame) noexcept -> std::optional<UploadAck> {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    UploadAck out;
+    out.id = r.get_u64();
+    out.committed = r.get_u64();
+    const auto status = r.get_u8();
+    if (!header || header->kind != wire::FrameKind::UploadAck || !r.ok()
+        || status < static_cast<std::uint8_t>(UploadStatus::Resume)
+        || status > static_cast<std::uint8_t>(UploadStatus::Rejected)) {
+        return std::nullopt;
+    }
+    out.status = static_cast<UploadStatus>(status);
+    return out;
+}
+
+}  // namespace protocol::upload
@@ -0,0 +1,273 @@
+#pragma once
+
+/// @file wire.hpp
+/// @brief Binary frame layout and little-endian byte codecs.
+///
+/// Every binary WebSocket message starts with a 4-byte frame header:
+///
+/// @code
+///   0        1         2       3
+///   +--------+---------+-------+-------+
+///   | magic  | version | kind  | flags |
+///   +--------+---------+-------+-------+
+/// @endcode
+///
+/// Text messages carry the legacy string protocol and have no header.
+///
+/// Demonstrates:
+/// - Bounds-checked readers that fail soft on malformed input
+/// - Rule of Six for buffer-owning value types
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace protocol::wire {
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Frame Header
+// ═══════════════════════════════════════════════════════════════════════════
+
+constexpr std::uint8_t kMagic = 0xD7;
+constexpr std::uint8_t kVersion = 1;
+constexpr std::size_t kHeaderSize = 4;
+
+/// Binary frame discriminator.
+enum class FrameKind : std::uint8_t {
+    TrackBatch   = 1,   ///< Batch of TrackUpdate records
+    Subscribe    = 2,   ///< Session opts in to the track feed
+    Probe        = 3,   ///< Ping/pong payload (never sent as a data frame)
+    PeerHello    = 4,   ///< Server-to-server link identifies its node
+    ReplicaBatch = 5,   ///< Replicated tracks with per-origin sequence
+    ReplicaAck   = 6,   ///< Receiver's acknowledgement of a ReplicaBatch
+    ForwardBatch = 7,   ///< Ingest forwarded to the target's owning node
+    StandbyHello = 8,   ///< Standby asks for the journal from a sequence
+    JournalBatch = 9,   ///< Shipped journal records
+    JournalAck   = 10,  ///< Standby has applied the journal up to a sequence
+    UploadBegin  = 11,  ///< Client announces (or resumes) a file upload
+    UploadChunk  = 12,  ///< One hashed chunk of an upload at an offset
+    UploadAck    = 13,  ///< Server's committed offset and status for an upload
+    RpcRequest   = 14,  ///< Correlated request to a named method
+    RpcResponse  = 15,  ///< Result of an RpcRequest (any order)
+    CpaAlert     = 16,  ///< Newly predicted or escalated close approaches
+    InterceptSubscribe = 17,  ///< Session registers shooters for intercept solutions
+    InterceptBatch     = 18,  ///< Intercept solutions streamed to a subscribed session
+    SwarmBatch         = 19,  ///< Swarm (track cluster) summaries for the console feed
+    LodSubscribe       = 20,  ///< Session asks for tile aggregates at a zoom and viewport
+    LodBatch           = 21,  ///< Tile aggregates streamed to a LOD subscriber
+    TrackDrop          = 22,  ///< Targets the server has expired
+    QuarantineBatch    = 23,  ///< Reports failing kinematic checks
+    SectorQuery        = 24,  ///< Session asks for (or subscribes to) sector statistics
+    SectorReport       = 25,  ///< Sector counts, traffic windows and heatmap for an area
+    TrackSnapshot      = 26   ///< Compressed full track table for a mirroring client
+};
+
+/// Header flag: a LatencyTrace extension follows the header (latency.hpp).
+constexpr std::uint8_t kFlagLatencyTrace = 0x01;
+
+/// Header flag: a u64 feed sequence follows the header (TrackBatch, mirror.hpp).
+constexpr std::uint8_t kFlagFeedSeq = 0x02;
+
+/// Decoded frame header.
+struct FrameHeader {
+    FrameKind kind{FrameKind::TrackBatch};
+    std::uint8_t flags{0};
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ByteWriter — Little-Endian Append Buffer
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Contains std::string (manages own memory)
+// • Compiler-generated operations are correct
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Append-only little-endian encoder backed by std::string.
+///
+/// std::string is used as the byte container because it feeds
+/// asio::buffer directly and is what Beast hands back on reads.
+class ByteWriter {
+public:
+    // Rule of Six: All Default
+    ByteWriter() = default;
+    ~ByteWriter() = default;
+    ByteWriter(const ByteWriter&) = default;
+    ByteWriter& operator=(const ByteWriter&) = default;
+    ByteWriter(ByteWriter&&) noexcept = default;
+    ByteWriter& operator=(ByteWriter&&) noexcept = default;
+
+    /// Start a frame with the standard header.
+    explicit ByteWriter(FrameKind kind, std::uint8_t flags = 0, std::size_t reserve = 64) {
+        buf_.reserve(reserve);
+        put_u8(kMagic);
+        put_u8(kVersion);
+        put_u8(static_cast<std::uint8_t>(kind));
+        put_u8(flags);
+    }
+
+    void put_u8(std::uint8_t v) { buf_.push_back(static_cast<char>(v)); }
+    void put_u16(std::uint16_t v) { put_le(v); }
+    void put_u32(std::uint32_t v) { put_le(v); }
+    void put_u64(std::uint64_t v) { put_le(v); }
+    void put_i64(std::int64_t v) { put_le(static_cast<std::uint64_t>(v)); }
+    void put_f32(float v) { put_le(std::bit_cast<std::uint32_t>(v)); }
+    void put_f64(double v) { put_le(std::bit_cast<std::uint64_t>(v)); }
+
+    void put_bytes(std::string_view bytes) { buf_.append(bytes); }
+
+    /// Length-prefixed (u32) byte string.
+    void put_string(std::string_view s) {
+        put_u32(static_cast<std::uint32_t>(s.size()));
+        buf_.append(s);
+    }
+
+    /// Overwrite a previously written u8 (e.g. patch flags after the fact).
+    void patch_u8(std::size_t offset, std::uint8_t v) {
+        buf_[offset] = static_cast<char>(v);
+    }
+
+    /// Pre-allocate for `n` bytes in total.
+    void reserve(std::size_t n) { buf_.reserve(n); }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return buf_.size(); }
+    [[nodiscard]] auto view() const noexcept -> std::string_view { return buf_; }
+
+    /// Release the encoded bytes.
+    [[nodiscard]] auto take() && -> std::string { return std::move(buf_); }
+
+private:
+    template<typename T>
+    void put_le(T v) {
+        static_assert(std::is_unsigned_v<T>);
+        if constexpr (std::endian::native == std::endian::big) {
+            v = std::byteswap(v);
+        }
+        char raw[sizeof(T)];
+        std::memcpy(raw, &v, sizeof(T));
+        buf_.append(raw, sizeof(T));
+    }
+
+    std::string buf_;
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ByteReader — Bounds-Checked Little-Endian Decoder
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Non-owning decoder over a received frame.
+///
+/// Reads past the end set a sticky failure flag and return zero, so a
+/// decoder can read a whole record and check ok() once.
+class ByteReader {
+public:
+    // Rule of Six: All Default (non-owning view)
+    ByteReader() = default;
+    ~ByteReader() = default;
+    ByteReader(const ByteReader&) = default;
+    ByteReader& operator=(const ByteReader&) = default;
+    ByteReader(ByteReader&&) noexcept = default;
+    ByteReader& operator=(ByteReader&&) noexcept = default;
+
+    explicit ByteReader(std::string_view data) noexcept : data_{data} {}
+
+    [[nodiscard]] auto get_u8() noexcept -> std::uint8_t { return get_le<std::uint8_t>(); }
+    [[nodiscard]] auto get_u16() noexcept -> std::uint16_t { return get_le<std::uint16_t>(); }
+    [[nodiscard]] auto get_u32() noexcept -> std::uint32_t { return get_le<std::uint32_t>(); }
+    [[nodiscard]] auto get_u64() noexcept -> std::uint64_t { return get_le<std::uint64_t>(); }
+    [[nodiscard]] auto get_i64() noexcept -> std::int64_t {
+        return static_cast<std::int64_t>(get_le<std::uint64_t>());
+    }
+    [[nodiscard]] auto get_f32() noexcept -> float {
+        return std::bit_cast<float>(get_le<std::uint32_t>());
+    }
+    [[nodiscard]] auto get_f64() noexcept -> double {
+        return std::bit_cast<double>(get_le<std::uint64_t>());
+    }
+
+    /// Raw bytes (view into the frame).
+    [[nodiscard]] auto get_bytes(std::size_t n) noexcept -> std::string_view {
+        if (!ok_ || remaining() < n) {
+            ok_ = false;
+            return {};
+        }
+        auto out = data_.substr(pos_, n);
+        pos_ += n;
+        return out;
+    }
+
+    /// Length-prefixed (u32) byte string.
+    [[nodiscard]] auto get_string() noexcept -> std::string_view {
+        const auto n = get_u32();
+        return get_bytes(n);
+    }
+
+    /// Consume and validate the standard frame header.
+    [[nodiscard]] auto get_header() noexcept -> std::optional<FrameHeader> {
+        const auto magic = get_u8();
+        const auto version = get_u8();
+        const auto kind = get_u8();
+        const auto flags = get_u8();
+        if (!ok_ || magic != kMagic || version != kVersion) {
+            ok_ = false;
+            return std::nullopt;
+        }
+        return FrameHeader{static_cast<FrameKind>(kind), flags};
+    }
+
+    [[nodiscard]] auto ok() const noexcept -> bool { return ok_; }
+    [[nodiscard]] auto remaining() const noexcept -> std::size_t { return data_.size() - pos_; }
+    [[nodiscard]] auto position() const noexcept -> std::size_t { return pos_; }
+
+private:
+    template<typename T>
+    [[nodiscard]] auto get_le() noexcept -> T {
+        if (!ok_ || remaining() < sizeof(T)) {
+            ok_ = false;
+            return T{};
+        }
+        T v;
+        std::memcpy(&v, data_.data() + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        if constexpr (sizeof(T) > 1 && std::endian::native == std::endian::big) {
+            v = std::byteswap(v);
+        }
+        return v;
+    }
+
+    std::string_view data_;
+    std::size_t pos_{0};
+    bool ok_{true};
+};
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// Helpers
+// ───────────────────────────────────────────────────────────────────────────
+
+/// Inspect a binary message's header without consuming it.
+[[nodiscard]] inline auto peek_header(std::string_view frame) noexcept
+    -> std::optional<FrameHeader>
+{
+    ByteReader reader{frame};
+    return reader.get_header();
+}
+
+/// Header-only frame (e.g. Subscribe).
+[[nodiscard]] inline auto make_control_frame(FrameKind kind, std::uint8_t flags = 0)
+    -> std::string
+{
+    return ByteWriter{kind, flags, kHeaderSize}.take();
+}
+
+}  // namespace protocol::wire
@@ -0,0 +1,108 @@
+#include "anomaly.hpp"
+
+#include <cmath>
+#include <numbers>
+
+namespace protocol {
+
+namespace {
+
+constexpr double kEarthRadiusM = 6'371'000.0;
+constexpr double kDegToRad = std::numbers::pi / 180.0;
+constexpr double kMetresPerDegLat = kEarthRadiusM * kDegToRad;
+
+/// Longitude scale is refreshed when the baseline drifts this far north/south.
+constexpr double kRescaleDeg = 0.25;
+
+[[nodiscard]] auto metres_per_deg_lon(double lat) noexcept -> float {
+    return static_cast<float>(kMetresPerDegLat * std::cos(lat * kDegToRad));
+}
+
+}  // namespace
+
+auto AnomalyDetector::check(std::span<const TrackUpdate> reports, std::vector<std::uint8_t>& flags) -> AnomalyCounts {
+    const auto n = reports.size();
+    AnomalyCounts counts;
+    counts.checked = n;
+    flags.assign(n, 0);
+    for (auto* v : {&dt_, &dx_, &dy_, &dz_, &dvn_, &dve_, &dvu_}) {
+        v->resize(n);
+    }
+    bits_.resize(n);
+    at_.resize(n);
+
+    // Gather: one lookup per report, deltas from its baseline into arrays.
+    // A new target becomes its own baseline (all deltas zero).
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto& r = reports[i];
+        auto [it, inserted] = baseline_.try_emplace(r.target_id);
+        auto& b = it->second;
+        if (inserted) {
+            b.state = r;
+            b.ref_lat = r.lat;
+            b.m_per_deg_lon = metres_per_deg_lon(r.lat);
+        }
+        at_[i] = &b;
+        const auto& p = b.state;
+        dt_[i] = std::fabs(static_cast<float>(r.time_ns - p.time_ns) * 1e-9F);
+        dy_[i] = static_cast<float>((r.lat - p.lat) * kMetresPerDegLat);
+        dx_[i] = static_cast<float>(r.lon - p.lon) * b.m_per_deg_lon;
+        dz_[i] = r.alt - p.alt;
+        dvn_[i] = r.vn - p.vn;
+        dve_[i] = r.ve - p.ve;
+        dvu_[i] = r.vu - p.vu;
+    }
+
+    // Check: straight-line arithmetic over the arrays into one flag word
+    // per report, no branches (vectorised)
+    const auto speed = cfg_.max_speed_mps, accel = cfg_.max_accel_mps2, climb = cfg_.max_climb_mps;
+    const auto slack_m = cfg_.slack_m, slack_mps = cfg_.slack_mps;
+    const float* dt = dt_.data();
+    const float* dx = dx_.data();
+    const float* dy = dy_.data();
+    const float* dz = dz_.data();
+    const float* dvn = dvn_.data();
+    const float* dve = dve_.data();
+    const float* dvu = dvu_.data();
+    std::uint32_t* bits = bits_.data();
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto reach = speed * dt[i] + slack_m;
+        const auto dv_reach = accel * dt[i] + slack_mps;
+        const auto rise = climb * dt[i] + slack_m;
+        const auto moved2 = dx[i] * dx[i] + dy[i] * dy[i];
+        const auto dv2 = dvn[i] * dvn[i] + dve[i] * dve[i] + dvu[i] * dvu[i];
+        bits[i] = static_cast<std::uint32_t>(moved2 > reach * reach)
+                | static_cast<std::uint32_t>(dv2 > dv_reach * dv_reach) << 1
+                | static_cast<std::uint32_t>(std::fabs(dz[i]) > rise) << 2;
+    }
+
+    // Advance baselines in report order: clean reports move them, suspects
+    // only after rebase_after in a row; never backwards in time
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto& r = reports[i];
+        auto& b = *at_[i];
+        const auto f = static_cast<std::uint8_t>(bits[i]);
+        flags[i] = f;
+        if (f != 0) {
+            ++counts.suspect;
+            counts.teleports += (f & kAnomalyTeleport) != 0;
+            counts.accelerations += (f & kAnomalyAcceleration) != 0;
+            counts.altitude += (f & kAnomalyAltitude) != 0;
+            if (++b.suspects < cfg_.rebase_after) {
+                continue;
+            }
+            ++counts.rebased;
+        } else if (r.time_ns < b.state.time_ns) {
+            continue;
+        }
+        b.state = r;
+        b.suspects = 0;
+        if (std::fabs(r.lat - b.ref_lat) > kRescaleDeg) {
+            b.ref_lat = r.lat;
+            b.m_per_deg_lon = metres_per_deg_lon(r.lat);
+        }
+    }
+    return counts;
+}
+
+}  // namespace protocol
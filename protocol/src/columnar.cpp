@@ -0,0 +1,536 @@
+#include "columnar.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+
+#include "journal.hpp"
+#include "journal_index.hpp"
+#include "wire.hpp"
+
+namespace protocol {
+
+namespace {
+
+/// Widest bit-packed value: a value starting at bit 7 of a byte must still
+/// fit in the 64-bit word loaded from that byte.
+constexpr unsigned kMaxPackWidth = 57;
+
+/// Zero bytes after packed data, so the last value's 64-bit load stays in bounds.
+constexpr std::size_t kPackPadding = 8;
+
+/// Per-chunk footer entry: encoding | offset | bytes | min | max.
+constexpr std::size_t kChunkEntrySize = 1 + 8 + 4 + 8 + 8;
+
+// ───────────────────────────────────────────────────────────────────────────
+// Bit Packing
+// ───────────────────────────────────────────────────────────────────────────
+
+[[nodiscard]] inline auto load_le64(const char* p) noexcept -> std::uint64_t {
+    return load_field<std::uint64_t>(p, 0);
+}
+
+inline void store_le64(char* p, std::uint64_t v) noexcept {
+    if constexpr (std::endian::native == std::endian::big) {
+        v = std::byteswap(v);
+    }
+    std::memcpy(p, &v, sizeof v);
+}
+
+[[nodiscard]] constexpr auto packed_bytes(std::size_t n, unsigned width) noexcept -> std::size_t {
+    return (n * width + 7) / 8 + kPackPadding;
+}
+
+/// Append `width` | values packed LSB-first, `width` bits each.
+void put_packed(wire::ByteWriter& w, const std::vector<std::uint64_t>& values, unsigned width) {
+    w.put_u8(static_cast<std::uint8_t>(width));
+    std::string buf(packed_bytes(values.size(), width), '\0');
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        const auto bit = i * width;
+        char* p = buf.data() + bit / 8;
+        store_le64(p, load_le64(p) | (values[i] << (bit % 8)));
+    }
+    w.put_bytes(buf);
+}
+
+/// Reads `width` | packed values and hands each to `sink(i, value)`.
+/// Branch-free: every value is one unaligned load, a shift and a mask.
+template<typename Sink>
+void get_packed(wire::ByteReader& r, std::size_t n, Sink&& sink) {
+    const auto width = r.get_u8();
+    if (!r.ok() || width > kMaxPackWidth) {
+        throw std::runtime_error{"columnar chunk has a bad pack width"};
+    }
+    const auto data = r.get_bytes(packed_bytes(n, width));
+    if (!r.ok()) {
+        throw std::runtime_error{"columnar chunk is truncated"};
+    }
+    const char* p = data.data();
+    const std::uint64_t mask = (std::uint64_t{1} << width) - 1;
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto bit = i * width;
+        sink(i, (load_le64(p + bit / 8) >> (bit % 8)) & mask);
+    }
+}
+
+[[nodiscard]] constexpr auto zigzag(std::int64_t v) noexcept -> std::uint64_t {
+    return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+[[nodiscard]] constexpr auto unzigzag(std::uint64_t v) noexcept -> std::int64_t {
+    return static_cast<std::int64_t>((v >> 1) ^ (~(v & 1) + 1));
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// Chunk Encoders (append to the group buffer, fill encoding and min/max)
+// ───────────────────────────────────────────────────────────────────────────
+
+void encode_time(wire::ByteWriter& w, const std::vector<std::int64_t>& v, ChunkInfo& chunk) {
+    const auto [lo, hi] = std::minmax_element(v.begin(), v.end());
+    chunk.min_bits = static_cast<std::uint64_t>(*lo);
+    chunk.max_bits = static_cast<std::uint64_t>(*hi);
+
+    std::vector<std::uint64_t> deltas(v.size());
+    std::uint64_t any = 0;
+    for (std::size_t i = 1; i < v.size(); ++i) {
+        // Wrapping difference: exact for any pair once zigzagged back
+        deltas[i] = zigzag(static_cast<std::int64_t>(static_cast<std::uint64_t>(v[i])
+                                                     - static_cast<std::uint64_t>(v[i - 1])));
+        any |= deltas[i];
+    }
+    const auto width = static_cast<unsigned>(std::bit_width(any));
+    if (width > kMaxPackWidth) {
+        chunk.encoding = ColumnEncoding::Plain;
+        for (const auto x : v) {
+            w.put_i64(x);
+        }
+        return;
+    }
+    chunk.encoding = ColumnEncoding::DeltaBitPack;
+    w.put_i64(v.front());
+    put_packed(w, deltas, width);
+}
+
+/// Frame-of-reference bit-packing, or plain when the range is too wide.
+void encode_unsigned(wire::ByteWriter& w, const std::vector<std::uint64_t>& v, ChunkInfo& chunk) {
+    const auto [lo, hi] = std::minmax_element(v.begin(), v.end());
+    chunk.min_bits = *lo;
+    chunk.max_bits = *hi;
+
+    const auto width = static_cast<unsigned>(std::bit_width(*hi - *lo));
+    if (width > kMaxPackWidth) {
+        chunk.encoding = ColumnEncoding::Plain;
+        for (const auto x : v) {
+            w.put_u64(x);
+        }
+        return;
+    }
+    chunk.encoding = ColumnEncoding::BitPack;
+    w.put_u64(*lo);
+    std::vector<std::uint64_t> offsets(v.size());
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        offsets[i] = v[i] - *lo;
+    }
+    put_packed(w, offsets, width);
+}
+
+/// Dictionary when it beats frame-of-reference (few targets, sparse ids).
+void encode_ids(wire::ByteWriter& w, const std::vector<std::uint64_t>& v, ChunkInfo& chunk) {
+    std::vector<std::uint64_t> dict{v};
+    std::sort(dict.begin(), dict.end());
+    dict.erase(std::unique(dict.begin(), dict.end()), dict.end());
+
+    const auto n = v.size();
+    const auto dict_width = static_cast<unsigned>(std::bit_width(dict.size() - 1));
+    const auto for_width = static_cast<unsigned>(std::bit_width(dict.back() - dict.front()));
+    const auto dict_bytes = 4 + dict.size() * 8 + packed_bytes(n, dict_width);
+    const auto for_bytes = for_width > kMaxPackWidth ? n * 8 : 8 + packed_bytes(n, for_width);
+    if (dict_bytes >= for_bytes) {
+        encode_unsigned(w, v, chunk);
+        return;
+    }
+
+    chunk.encoding = ColumnEncoding::Dictionary;
+    chunk.min_bits = dict.front();
+    chunk.max_bits = dict.back();
+    w.put_u32(static_cast<std::uint32_t>(dict.size()));
+    for (const auto id : dict) {
+        w.put_u64(id);
+    }
+    std::vector<std::uint64_t> indices(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        indices[i] = static_cast<std::uint64_t>(std::lower_bound(dict.begin(), dict.end(), v[i]) - dict.begin());
+    }
+    put_packed(w, indices, dict_width);
+}
+
+template<typename T>
+void encode_real(wire::ByteWriter& w, const std::vector<T>& v, ChunkInfo& chunk) {
+    const auto [lo, hi] = std::minmax_element(v.begin(), v.end());
+    chunk.encoding = ColumnEncoding::Plain;
+    chunk.min_bits = std::bit_cast<std::uint64_t>(static_cast<double>(*lo));
+    chunk.max_bits = std::bit_cast<std::uint64_t>(static_cast<double>(*hi));
+    for (const auto x : v) {
+        if constexpr (sizeof(T) == 8) {
+            w.put_f64(x);
+        } else {
+            w.put_f32(x);
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// Chunk Decoders (write `n` values to `out`)
+// ───────────────────────────────────────────────────────────────────────────
+
+[[noreturn]] void bad_chunk(Column c) {
+    throw std::runtime_error{"columnar " + std::string{to_string(c)} + " chunk is malformed"};
+}
+
+/// Plain little-endian values, loaded in a straight loop.
+template<typename T>
+void decode_plain(std::string_view bytes, std::size_t n, T* out, Column c) {
+    if (bytes.size() != n * sizeof(T)) {
+        bad_chunk(c);
+    }
+    const char* p = bytes.data();
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = load_field<T>(p, i * sizeof(T));
+    }
+}
+
+void decode_time(std::string_view bytes, const ChunkInfo& chunk, std::size_t n, std::int64_t* out) {
+    if (chunk.encoding == ColumnEncoding::Plain) {
+        decode_plain(bytes, n, out, Column::Time);
+        return;
+    }
+    if (chunk.encoding != ColumnEncoding::DeltaBitPack) {
+        bad_chunk(Column::Time);
+    }
+    wire::ByteReader r{bytes};
+    const auto base = r.get_i64();
+    get_packed(r, n, [&](std::size_t i, std::uint64_t v) { out[i] = unzigzag(v); });
+    auto acc = static_cast<std::uint64_t>(base);
+    for (std::size_t i = 0; i < n; ++i) {
+        acc += static_cast<std::uint64_t>(out[i]);
+        out[i] = static_cast<std::int64_t>(acc);
+    }
+}
+
+template<typename T>
+void decode_unsigned(std::string_view bytes, const ChunkInfo& chunk, std::size_t n, T* out, Column c) {
+    wire::ByteReader r{bytes};
+    switch (chunk.encoding) {
+        case ColumnEncoding::Plain:
+            if constexpr (sizeof(T) == 8) {
+                decode_plain(bytes, n, out, c);
+                return;
+            }
+            break;
+        case ColumnEncoding::BitPack: {
+            const auto base = r.get_u64();
+            get_packed(r, n, [&](std::size_t i, std::uint64_t v) { out[i] = static_cast<T>(base + v); });
+            return;
+        }
+        case ColumnEncoding::Dictionary: {
+            const auto entries = r.get_u32();
+            const auto dict = r.get_bytes(std::size_t{entries} * 8);
+            if (!r.ok() || entries == 0) {
+                break;
+            }
+            const char* d = dict.data();
+            get_packed(r, n, [&](std::size_t i, std::uint64_t v) {
+                out[i] = static_cast<T>(load_field<std::uint64_t>(d, std::min<std::uint64_t>(v, entries - 1) * 8));
+            });
+            return;
+        }
+        case ColumnEncoding::DeltaBitPack:
+            break;
+    }
+    bad_chunk(c);
+}
+
+template<typename T>
+void decode_real(std::string_view bytes, const ChunkInfo& chunk, std::size_t n, T* out, Column c) {
+    if (chunk.encoding != ColumnEncoding::Plain) {
+        bad_chunk(c);
+    }
+    decode_plain(bytes, n, out, c);
+}
+
+/// Grow `v` by `n` and return where the new values go.
+template<typename T>
+[[nodiscard]] auto extend(std::vector<T>& v, std::size_t n) -> T* {
+    const auto old = v.size();
+    v.resize(old + n);
+    return v.data() + old;
+}
+
+}  // namespace
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ColumnarWriter
+// ═══════════════════════════════════════════════════════════════════════════
+
+ColumnarWriter::ColumnarWriter(std::filesystem::path path, std::uint32_t group_rows, PosixFile file)
+    : path_{std::move(path)}
+    , tmp_{path_.string() + ".tmp"}
+    , group_rows_{group_rows}
+    , file_{std::move(file)}
+{}
+
+ColumnarWriter::~ColumnarWriter() {
+    if (file_.is_open()) {
+        file_.close();
+        std::error_code ec;
+        std::filesystem::remove(tmp_, ec);
+    }
+}
+
+auto ColumnarWriter::create(std::filesystem::path path, std::uint32_t group_rows) -> ColumnarWriter {
+    if (group_rows == 0) {
+        throw std::invalid_argument{"columnar row groups need at least one row"};
+    }
+    auto tmp = path;
+    tmp += ".tmp";
+    auto file = PosixFile::open_read_write(tmp);
+    file.truncate(0);
+
+    wire::ByteWriter w;
+    w.put_u32(kColumnarMagic);
+    w.put_u16(kColumnarVersion);
+    w.put_u16(static_cast<std::uint16_t>(kColumnCount));
+    w.put_u32(group_rows);
+    file.write_all(w.view());
+
+    ColumnarWriter out{std::move(path), group_rows, std::move(file)};
+    out.offset_ = kColumnarHeaderSize;
+    return out;
+}
+
+void ColumnarWriter::append(const TrackUpdate& t) {
+    pending_.time.push_back(t.time_ns);
+    pending_.id.push_back(t.target_id);
+    pending_.lat.push_back(t.lat);
+    pending_.lon.push_back(t.lon);
+    pending_.alt.push_back(t.alt);
+    pending_.urgency.push_back(static_cast<std::uint8_t>(t.urgency));
+    if (pending_.time.size() >= group_rows_) {
+        write_group();
+    }
+}
+
+void ColumnarWriter::write_group() {
+    const auto rows = pending_.time.size();
+    if (rows == 0) {
+        return;
+    }
+
+    RowGroupInfo group;
+    group.rows = static_cast<std::uint32_t>(rows);
+    const std::vector<std::uint64_t> urgency(pending_.urgency.begin(), pending_.urgency.end());
+
+    wire::ByteWriter w;
+    w.reserve(rows * kTrackRecordSize);
+    for (std::size_t c = 0; c < kColumnCount; ++c) {
+        auto& chunk = group.chunks[c];
+        const auto start = w.size();
+        switch (static_cast<Column>(c)) {
+            case Column::Time:    encode_time(w, pending_.time, chunk); break;
+            case Column::Id:      encode_ids(w, pending_.id, chunk); break;
+            case Column::Lat:     encode_real(w, pending_.lat, chunk); break;
+            case Column::Lon:     encode_real(w, pending_.lon, chunk); break;
+            case Column::Alt:     encode_real(w, pending_.alt, chunk); break;
+            case Column::Urgency: encode_unsigned(w, urgency, chunk); break;
+        }
+        chunk.offset = offset_ + start;
+        chunk.bytes = static_cast<std::uint32_t>(w.size() - start);
+        stats_.column_bytes[c] += chunk.bytes;
+    }
+    file_.write_all(w.view());
+    offset_ += w.size();
+
+    groups_.push_back(group);
+    stats_.rows += rows;
+    ++stats_.groups;
+    pending_ = ColumnData{};
+}
+
+auto ColumnarWriter::finish() -> ColumnarFileStats {
+    write_group();
+
+    wire::ByteWriter w;
+    w.reserve(4 + groups_.size() * (4 + kColumnCount * kChunkEntrySize) + kColumnarTrailerSize);
+    w.put_u32(static_cast<std::uint32_t>(groups_.size()));
+    for (const auto& group : groups_) {
+        w.put_u32(group.rows);
+        for (const auto& chunk : group.chunks) {
+            w.put_u8(static_cast<std::uint8_t>(chunk.encoding));
+            w.put_u64(chunk.offset);
+            w.put_u32(chunk.bytes);
+            w.put_u64(chunk.min_bits);
+            w.put_u64(chunk.max_bits);
+        }
+    }
+    w.put_u64(offset_);
+    w.put_u32(kColumnarMagic);
+    file_.write_all(w.view());
+    file_.sync();
+    file_.close();
+    std::filesystem::rename(tmp_, path_);
+
+    const auto dir = path_.has_parent_path() ? path_.parent_path() : std::filesystem::path{"."};
+    auto dir_fd = PosixFile::open_read(dir);
+    dir_fd.sync();
+
+    stats_.bytes = offset_ + w.size();
+    return stats_;
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ColumnarReader
+// ═══════════════════════════════════════════════════════════════════════════
+
+ColumnarReader::ColumnarReader(MappedFile file, std::vector<RowGroupInfo> groups, std::uint64_t rows)
+    : file_{std::move(file)}
+    , groups_{std::move(groups)}
+    , rows_{rows}
+{}
+
+auto ColumnarReader::open(const std::filesystem::path& path) -> ColumnarReader {
+    auto file = MappedFile::map_read(path);
+    const auto bytes = file.bytes();
+    const auto invalid = [&](std::string_view why) {
+        return std::runtime_error{path.string() + ": " + std::string{why}};
+    };
+    if (bytes.size() < kColumnarHeaderSize + kColumnarTrailerSize) {
+        throw invalid("too short for a columnar file");
+    }
+
+    wire::ByteReader header{bytes.substr(0, kColumnarHeaderSize)};
+    const auto magic = header.get_u32();
+    const auto version = header.get_u16();
+    const auto columns = header.get_u16();
+    if (magic != kColumnarMagic || version != kColumnarVersion || columns != kColumnCount) {
+        throw invalid("not a columnar track file");
+    }
+
+    wire::ByteReader trailer{bytes.substr(bytes.size() - kColumnarTrailerSize)};
+    const auto footer_offset = trailer.get_u64();
+    if (trailer.get_u32() != kColumnarMagic
+        || footer_offset < kColumnarHeaderSize
+        || footer_offset > bytes.size() - kColumnarTrailerSize) {
+        throw invalid("bad footer");
+    }
+
+    wire::ByteReader r{bytes.substr(footer_offset, bytes.size() - kColumnarTrailerSize - footer_offset)};
+    std::vector<RowGroupInfo> groups(r.get_u32());
+    if (!r.ok() || groups.size() > r.remaining() / (4 + kColumnCount * kChunkEntrySize)) {
+        throw invalid("bad footer");
+    }
+    std::uint64_t rows = 0;
+    for (auto& group : groups) {
+        group.rows = r.get_u32();
+        for (auto& chunk : group.chunks) {
+            chunk.encoding = static_cast<ColumnEncoding>(r.get_u8());
+            chunk.offset = r.get_u64();
+            chunk.bytes = r.get_u32();
+            chunk.min_bits = r.get_u64();
+            chunk.max_bits = r.get_u64();
+            if (chunk.offset < kColumnarHeaderSize || chunk.offset > footer_offset
+                || chunk.bytes > footer_offset - chunk.offset) {
+                throw invalid("chunk outside the data section");
+            }
+        }
+        rows += group.rows;
+    }
+    if (!r.ok() || r.remaining() != 0) {
+        throw invalid("bad footer");
+    }
+    return ColumnarReader{std::move(file), std::move(groups), rows};
+}
+
+void ColumnarReader::read_group(std::size_t g, ColumnMask columns, ColumnData& out) const {
+    const auto& group = groups_.at(g);
+    const std::size_t n = group.rows;
+    const auto chunk_bytes = [&](Column c) {
+        const auto& chunk = group.chunk(c);
+        return file_.bytes().substr(chunk.offset, chunk.bytes);
+    };
+    const auto wanted = [&](Column c) { return (columns & column_bit(c)) != 0; };
+
+    if (wanted(Column::Time)) {
+        decode_time(chunk_bytes(Column::Time), group.chunk(Column::Time), n, extend(out.time, n));
+    }
+    if (wanted(Column::Id)) {
+        decode_unsigned(chunk_bytes(Column::Id), group.chunk(Column::Id), n, extend(out.id, n), Column::Id);
+    }
+    if (wanted(Column::Lat)) {
+        decode_real(chunk_bytes(Column::Lat), group.chunk(Column::Lat), n, extend(out.lat, n), Column::Lat);
+    }
+    if (wanted(Column::Lon)) {
+        decode_real(chunk_bytes(Column::Lon), group.chunk(Column::Lon), n, extend(out.lon, n), Column::Lon);
+    }
+    if (wanted(Column::Alt)) {
+        decode_real(chunk_bytes(Column::Alt), group.chunk(Column::Alt), n, extend(out.alt, n), Column::Alt);
+    }
+    if (wanted(Column::Urgency)) {
+        decode_unsigned(chunk_bytes(Column::Urgency), group.chunk(Column::Urgency), n,
+                        extend(out.urgency, n), Column::Urgency);
+    }
+}
+
+auto ColumnarReader::read(ColumnMask columns) const -> ColumnData {
+    ColumnData out;
+    const auto reserve = [&](auto& v, Column c) {
+        if ((columns & column_bit(c)) != 0) {
+            v.reserve(rows_);
+        }
+    };
+    reserve(out.time, Column::Time);
+    reserve(out.id, Column::Id);
+    reserve(out.lat, Column::Lat);
+    reserve(out.lon, Column::Lon);
+    reserve(out.alt, Column::Alt);
+    reserve(out.urgency, Column::Urgency);
+    for (std::size_t g = 0; g < groups_.size(); ++g) {
+        read_group(g, columns, out);
+    }
+    return out;
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Journal Export
+// ═══════════════════════════════════════════════════════════════════════════
+
+auto export_journal_columnar(const std::filesystem::path& journal_dir,
+                             const std::filesystem::path& out,
+                             std::uint32_t group_rows) -> ColumnarFileStats
+{
+    auto writer = ColumnarWriter::create(out, group_rows);
+    for (const auto& seg : list_segments(journal_dir)) {
+        const auto map = MappedFile::map_read(seg.path);
+        const auto bytes = map.bytes();
+        if (bytes.size() <= kSegmentHeaderSize) {
+            continue;
+        }
+        const auto records = (bytes.size() - kSegmentHeaderSize) / kJournalRecordSize;
+        const char* base = bytes.data() + kSegmentHeaderSize;
+        for (std::uint64_t i = 0; i < records; ++i) {
+            if (load_field<std::uint64_t>(base + i * kJournalRecordSize, kRecordOriginSeqOffset) == kJournalDropSeq) {
+                continue;  // Drop records carry no new report
+            }
+            wire::ByteReader r{std::string_view{base + i * kJournalRecordSize + kRecordTargetOffset,
+                                                kTrackRecordSize}};
+            writer.append(decode_track(r));
+        }
+    }
+    return writer.finish();
+}
+
+}  // namespace protocol
@@ -0,0 +1,340 @@
+#include "cpa.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace protocol {
+
+namespace {
+
+constexpr double kEarthRadiusM = 6'371'000.0;
+constexpr double kDegToRad = std::numbers::pi / 180.0;
+
+/// Occupied cells per parallel task (each task keeps its own results).
+constexpr std::size_t kCellsPerTile = 64;
+
+/// Cells a swept box may span on either axis before its track is screened
+/// against every other track instead of binned, so one outlier cannot
+/// flood the grid.
+constexpr std::uint64_t kMaxSweptCells = 32;
+
+/// Largest row or column index; keeps row * cols + col inside 64 bits.
+constexpr double kMaxGridIndex = 2147483647.0;
+
+/// Longitude difference `a - b` in degrees, wrapped into [-180, 180).
+[[nodiscard]] auto lon_delta(double a, double b) noexcept -> double {
+    const auto d = std::fmod(a - b + 540.0, 360.0);
+    return (d < 0.0 ? d + 360.0 : d) - 180.0;
+}
+
+/// Screened tracks, structure-of-arrays, in metres and metres/second on the
+/// local plane at the screening instant.
+struct Swept {
+    std::vector<std::uint64_t> id;
+    std::vector<float> x, y, z, vx, vy, vz;
+    std::vector<float> x0, x1, y0, y1;   ///< Swept segment box, grown by distance / 2
+
+    void push(std::uint64_t target, float px, float py, float pz, float ux, float uy, float uz, float grow, float horizon_s) {
+        id.push_back(target);
+        x.push_back(px);
+        y.push_back(py);
+        z.push_back(pz);
+        vx.push_back(ux);
+        vy.push_back(uy);
+        vz.push_back(uz);
+        const auto ex = px + ux * horizon_s;
+        const auto ey = py + uy * horizon_s;
+        x0.push_back(std::min(px, ex) - grow);
+        x1.push_back(std::max(px, ex) + grow);
+        y0.push_back(std::min(py, ey) - grow);
+        y1.push_back(std::max(py, ey) + grow);
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return id.size(); }
+};
+
+/// Uniform grid over the plane; cells are keyed row-major.
+struct Grid {
+    double origin_x{0.0};
+    double origin_y{0.0};
+    double cell{1.0};
+    std::uint64_t cols{1};
+
+    [[nodiscard]] auto col(float x) const noexcept -> std::uint64_t { return index(x, origin_x); }
+    [[nodiscard]] auto row(float y) const noexcept -> std::uint64_t { return index(y, origin_y); }
+    [[nodiscard]] auto key(float x, float y) const noexcept -> std::uint64_t { return row(y) * cols + col(x); }
+
+    /// Clamped to [0, kMaxGridIndex]; NaN lands in 0.
+    [[nodiscard]] auto index(float v, double origin) const noexcept -> std::uint64_t {
+        const auto i = std::floor((static_cast<double>(v) - origin) / cell);
+        return i > 0.0 ? static_cast<std::uint64_t>(std::min(i, kMaxGridIndex)) : 0;
+    }
+};
+
+/// One (cell, track) binning.
+struct Entry {
+    std::uint64_t cell{0};
+    std::uint32_t track{0};
+
+    friend auto operator<(const Entry& a, const Entry& b) noexcept -> bool {
+        return a.cell != b.cell ? a.cell < b.cell : a.track < b.track;
+    }
+};
+
+/// Per-task scratch: one cell's members gathered contiguously, so the
+/// pair loop runs over unit-stride float arrays.
+struct CellScratch {
+    std::vector<std::uint32_t> track;
+    std::vector<float> x, y, z, vx, vy, vz;
+    std::vector<float> d2;
+
+    void gather(const Swept& s, std::span<const Entry> members) {
+        const auto m = members.size();
+        for (auto* v : {&x, &y, &z, &vx, &vy, &vz, &d2}) {
+            v->resize(m);
+        }
+        track.resize(m);
+        for (std::size_t k = 0; k < m; ++k) {
+            const auto i = members[k].track;
+            track[k] = i;
+            x[k] = s.x[i];
+            y[k] = s.y[i];
+            z[k] = s.z[i];
+            vx[k] = s.vx[i];
+            vy[k] = s.vy[i];
+            vz[k] = s.vz[i];
+        }
+    }
+};
+
+/// Time of closest approach of members `i` and `j`, clamped to [0, horizon].
+///
+/// No select on the closing speed: arithmetic under a condition could trap,
+/// which stops if-conversion (and vectorisation). With uu at the floor the
+/// pair barely moves relative to itself, so any clamped t is as good.
+inline auto approach_time(float dx, float dy, float dz, float ux, float uy, float uz, float horizon_s) noexcept
+    -> float
+{
+    const auto uu = ux * ux + uy * uy + uz * uz;
+    const auto du = dx * ux + dy * uy + dz * uz;
+    return std::min(std::max(-du / std::max(uu, 1e-6F), 0.0F), horizon_s);
+}
+
+/// Squared miss distance of member `i` to each of members (i, m) into d2[].
+/// Branch-free with a single output array so the loop vectorises.
+void approach_row(CellScratch& c, std::size_t i, std::size_t m, float horizon_s) {
+    const auto xi = c.x[i], yi = c.y[i], zi = c.z[i];
+    const auto vxi = c.vx[i], vyi = c.vy[i], vzi = c.vz[i];
+    const float* x = c.x.data();
+    const float* y = c.y.data();
+    const float* z = c.z.data();
+    const float* vx = c.vx.data();
+    const float* vy = c.vy.data();
+    const float* vz = c.vz.data();
+    float* d2 = c.d2.data();
+    for (std::size_t j = i + 1; j < m; ++j) {
+        const auto dx = x[j] - xi, dy = y[j] - yi, dz = z[j] - zi;
+        const auto ux = vx[j] - vxi, uy = vy[j] - vyi, uz = vz[j] - vzi;
+        const auto tj = approach_time(dx, dy, dz, ux, uy, uz, horizon_s);
+        const auto ex = dx + ux * tj, ey = dy + uy * tj, ez = dz + uz * tj;
+        d2[j] = ex * ex + ey * ey + ez * ez;
+    }
+}
+
+}  // namespace
+
+auto screen_cpa(std::span<const TrackUpdate> tracks,
+                std::int64_t now_ns,
+                const CpaConfig& cfg,
+                exec::TaskPool& pool) -> CpaResult
+{
+    const auto start = std::chrono::steady_clock::now();
+    CpaResult out;
+    const auto horizon_s = std::chrono::duration<float>(cfg.horizon).count();
+    const auto red_s = std::chrono::duration<float>(cfg.red_within).count();
+    const auto max_age_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(cfg.max_age).count();
+    const auto grow = static_cast<float>(cfg.distance_m / 2.0);
+    const auto limit2 = static_cast<float>(cfg.distance_m * cfg.distance_m);
+
+    // Project fresh tracks onto the plane around their centroid. Reports
+    // off the globe, too fast, or stamped more than max_age either side of
+    // now are skipped: propagating them would put boxes anywhere.
+    std::vector<std::uint32_t> fresh;
+    fresh.reserve(tracks.size());
+    double lat0 = 0.0;
+    double lon_x = 0.0;
+    double lon_y = 0.0;
+    for (std::size_t i = 0; i < tracks.size(); ++i) {
+        const auto& t = tracks[i];
+        if (is_plausible(t) && t.time_ns >= now_ns - max_age_ns && t.time_ns <= now_ns + max_age_ns) {
+            fresh.push_back(static_cast<std::uint32_t>(i));
+            lat0 += t.lat;
+            lon_x += std::cos(t.lon * kDegToRad);
+            lon_y += std::sin(t.lon * kDegToRad);
+        }
+    }
+    out.stats.tracks = fresh.size();
+    if (fresh.size() < 2) {
+        return out;
+    }
+    lat0 /= static_cast<double>(fresh.size());
+    const auto lon0 = std::atan2(lon_y, lon_x) / kDegToRad;   // Circular mean: no seam at ±180°
+    const auto m_per_deg_lat = kEarthRadiusM * kDegToRad;
+    const auto m_per_deg_lon = m_per_deg_lat * std::cos(lat0 * kDegToRad);
+
+    Swept swept;
+    double extent = 0.0;
+    for (const auto i : fresh) {
+        const auto& t = tracks[i];
+        const auto dt = static_cast<double>(now_ns - t.time_ns) * 1e-9;
+        swept.push(t.target_id,
+                   static_cast<float>(lon_delta(t.lon, lon0) * m_per_deg_lon + static_cast<double>(t.ve) * dt),
+                   static_cast<float>((t.lat - lat0) * m_per_deg_lat + static_cast<double>(t.vn) * dt),
+                   static_cast<float>(static_cast<double>(t.alt) + static_cast<double>(t.vu) * dt),
+                   t.ve, t.vn, t.vu, grow, horizon_s);
+        const auto k = swept.size() - 1;
+        extent += static_cast<double>(std::max(swept.x1[k] - swept.x0[k], swept.y1[k] - swept.y0[k]));
+    }
+    const auto n = swept.size();
+
+    // Broad phase: cells about the size of an average swept box, so most
+    // tracks land in at most four
+    Grid grid;
+    grid.cell = std::max({cfg.distance_m, extent / static_cast<double>(n), 1.0});
+    grid.origin_x = static_cast<double>(*std::min_element(swept.x0.begin(), swept.x0.end()));
+    grid.origin_y = static_cast<double>(*std::min_element(swept.y0.begin(), swept.y0.end()));
+    grid.cols = grid.col(*std::max_element(swept.x1.begin(), swept.x1.end())) + 1;
+    out.stats.cell_m = grid.cell;
+
+    std::vector<Entry> entries;
+    entries.reserve(n * 4);
+    std::vector<std::uint32_t> wide;
+    std::vector<char> is_wide(n, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto c0 = grid.col(swept.x0[i]), c1 = grid.col(swept.x1[i]);
+        const auto r0 = grid.row(swept.y0[i]), r1 = grid.row(swept.y1[i]);
+        if (c1 - c0 >= kMaxSweptCells || r1 - r0 >= kMaxSweptCells) {
+            wide.push_back(static_cast<std::uint32_t>(i));
+            is_wide[i] = 1;
+            continue;
+        }
+        for (auto r = r0; r <= r1; ++r) {
+            for (auto c = c0; c <= c1; ++c) {
+                entries.push_back(Entry{r * grid.cols + c, static_cast<std::uint32_t>(i)});
+            }
+        }
+    }
+    std::sort(entries.begin(), entries.end());
+
+    // Cells holding at least two tracks
+    std::vector<std::pair<std::size_t, std::size_t>> cells;
+    for (std::size_t b = 0; b < entries.size();) {
+        auto e = b + 1;
+        while (e < entries.size() && entries[e].cell == entries[b].cell) {
+            ++e;
+        }
+        if (e - b >= 2) {
+            cells.emplace_back(b, e);
+        }
+        b = e;
+    }
+    out.stats.cells = cells.size();
+
+    // Narrow phase, one tile of cells per task. A pair is reported only by
+    // the cell holding the lower corner of its boxes' overlap.
+    const auto tiles = (cells.size() + kCellsPerTile - 1) / kCellsPerTile;
+    std::vector<std::vector<CpaConflict>> found(tiles);
+    std::vector<std::uint64_t> candidates(tiles, 0);
+    pool.parallel_for(std::size_t{0}, tiles, std::size_t{1}, [&](std::size_t first, std::size_t last) {
+        CellScratch c;
+        for (auto tile = first; tile < last; ++tile) {
+            const auto cell_end = std::min(cells.size(), (tile + 1) * kCellsPerTile);
+            for (auto ci = tile * kCellsPerTile; ci < cell_end; ++ci) {
+                const auto [b, e] = cells[ci];
+                const auto key = entries[b].cell;
+                const auto m = e - b;
+                c.gather(swept, std::span<const Entry>{entries.data() + b, m});
+                candidates[tile] += m * (m - 1) / 2;
+
+                for (std::size_t i = 0; i + 1 < m; ++i) {
+                    approach_row(c, i, m, horizon_s);
+                    for (auto j = i + 1; j < m; ++j) {
+                        if (c.d2[j] > limit2) {
+                            continue;
+                        }
+                        const auto a = c.track[i];
+                        const auto o = c.track[j];
+                        if (grid.key(std::max(swept.x0[a], swept.x0[o]), std::max(swept.y0[a], swept.y0[o])) != key) {
+                            continue;
+                        }
+                        const auto t = approach_time(c.x[j] - c.x[i], c.y[j] - c.y[i], c.z[j] - c.z[i],
+                                                     c.vx[j] - c.vx[i], c.vy[j] - c.vy[i], c.vz[j] - c.vz[i],
+                                                     horizon_s);
+                        found[tile].push_back(CpaConflict{
+                            std::min(swept.id[a], swept.id[o]),
+                            std::max(swept.id[a], swept.id[o]),
+                            t,
+                            std::sqrt(c.d2[j]),
+                            t <= red_s ? Urgency::Red : Urgency::Yellow,
+                        });
+                    }
+                }
+            }
+        }
+    });
+
+    // Tracks too wide to bin, against every track whose box overlaps
+    // theirs; a pair of wide tracks is reported by its lower index
+    std::vector<std::vector<CpaConflict>> wide_found(wide.size());
+    std::vector<std::uint64_t> wide_candidates(wide.size(), 0);
+    pool.parallel_for(std::size_t{0}, wide.size(), std::size_t{1}, [&](std::size_t first, std::size_t last) {
+        for (auto w = first; w < last; ++w) {
+            const auto a = wide[w];
+            for (std::uint32_t o = 0; o < n; ++o) {
+                if (o == a || (is_wide[o] != 0 && o < a)
+                    || swept.x0[o] > swept.x1[a] || swept.x1[o] < swept.x0[a]
+                    || swept.y0[o] > swept.y1[a] || swept.y1[o] < swept.y0[a]) {
+                    continue;
+                }
+                ++wide_candidates[w];
+                const auto dx = swept.x[o] - swept.x[a], dy = swept.y[o] - swept.y[a], dz = swept.z[o] - swept.z[a];
+                const auto ux = swept.vx[o] - swept.vx[a], uy = swept.vy[o] - swept.vy[a], uz = swept.vz[o] - swept.vz[a];
+                const auto t = approach_time(dx, dy, dz, ux, uy, uz, horizon_s);
+                const auto ex = dx + ux * t, ey = dy + uy * t, ez = dz + uz * t;
+                const auto d2 = ex * ex + ey * ey + ez * ez;
+                if (d2 > limit2) {
+                    continue;
+                }
+                wide_found[w].push_back(CpaConflict{
+                    std::min(swept.id[a], swept.id[o]),
+                    std::max(swept.id[a], swept.id[o]),
+                    t,
+                    std::sqrt(d2),
+                    t <= red_s ? Urgency::Red : Urgency::Yellow,
+                });
+            }
+        }
+    });
+    out.stats.wide = wide.size();
+
+    for (std::size_t tile = 0; tile < tiles; ++tile) {
+        out.stats.candidate_pairs += candidates[tile];
+        out.conflicts.insert(out.conflicts.end(), found[tile].begin(), found[tile].end());
+    }
+    for (std::size_t w = 0; w < wide.size(); ++w) {
+        out.stats.candidate_pairs += wide_candidates[w];
+        out.conflicts.insert(out.conflicts.end(), wide_found[w].begin(), wide_found[w].end());
+    }
+    std::sort(out.conflicts.begin(), out.conflicts.end(), [](const CpaConflict& a, const CpaConflict& b) {
+        if (a.urgency != b.urgency) {
+            return a.urgency > b.urgency;
+        }
+        return a.t_cpa_s < b.t_cpa_s;
+    });
+    out.stats.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    return out;
+}
+
+}  // namespace protocol
@@ -0,0 +1,8 @@
+#include "endpoint_health.hpp"
+
+namespace protocol::health {
+
+// Explicit template instantiation for the production clock
+template class EndpointSelector<std::chrono::steady_clock>;
+
+}  // namespace protocol::health
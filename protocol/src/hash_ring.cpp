@@ -0,0 +1,52 @@
+#include "hash_ring.hpp"
+
+#include <algorithm>
+
+namespace protocol {
+
+auto HashRing::add(std::uint32_t node) -> bool {
+    if (contains(node)) {
+        return false;
+    }
+    points_.reserve(points_.size() + virtual_nodes_);
+    for (std::size_t i = 0; i < virtual_nodes_; ++i) {
+        points_.push_back(Point{point_hash(node, i), node});
+    }
+    std::sort(points_.begin(), points_.end());
+    return true;
+}
+
+auto HashRing::remove(std::uint32_t node) -> bool {
+    const auto removed = std::erase_if(points_, [node](const Point& p) { return p.node == node; });
+    return removed > 0;
+}
+
+auto HashRing::owner(std::uint64_t key) const noexcept -> std::optional<std::uint32_t> {
+    if (points_.empty()) {
+        return std::nullopt;
+    }
+    const auto h = mix64(key);
+    auto it = std::lower_bound(points_.begin(), points_.end(), h,
+                               [](const Point& p, std::uint64_t v) { return p.hash < v; });
+    if (it == points_.end()) {
+        it = points_.begin();  // Wrap around
+    }
+    return it->node;
+}
+
+auto HashRing::contains(std::uint32_t node) const noexcept -> bool {
+    return std::any_of(points_.begin(), points_.end(), [node](const Point& p) { return p.node == node; });
+}
+
+auto HashRing::nodes() const -> std::vector<std::uint32_t> {
+    std::vector<std::uint32_t> out;
+    for (const auto& p : points_) {
+        if (std::find(out.begin(), out.end(), p.node) == out.end()) {
+            out.push_back(p.node);
+        }
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+}  // namespace protocol
@@ -0,0 +1,152 @@
+#include "intercept.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+namespace protocol::intercept {
+
+namespace {
+
+constexpr double kEarthRadiusM = 6'371'000.0;
+constexpr double kDegToRad = std::numbers::pi / 180.0;
+constexpr double kMetresPerDegLat = kEarthRadiusM * kDegToRad;
+
+constexpr float kNoIntercept = std::numeric_limits<float>::infinity();
+
+}  // namespace
+
+Solver::Solver(std::span<const Shooter> shooters) {
+    const auto n = shooters.size();
+    id_.reserve(n);
+    lat_.reserve(n);
+    lon_.reserve(n);
+    for (auto* v : {&alt_, &m_per_deg_lon_, &speed_, &range_, &max_tof_}) {
+        v->reserve(n);
+    }
+    for (const auto& s : shooters) {
+        id_.push_back(s.id);
+        lat_.push_back(s.lat);
+        lon_.push_back(s.lon);
+        alt_.push_back(s.alt);
+        m_per_deg_lon_.push_back(static_cast<float>(kMetresPerDegLat * std::cos(s.lat * kDegToRad)));
+        speed_.push_back(s.speed_mps);
+        range_.push_back(s.max_range_m);
+        max_tof_.push_back(s.max_range_m / s.speed_mps);
+    }
+    for (auto* v : {&margin_, &cx_, &cy_, &cz_, &cd2_, &cspeed_, &ctof_, &tti_}) {
+        v->resize(n);
+    }
+    keep_.resize(n);
+}
+
+auto Solver::solve(std::span<const TrackUpdate> targets, std::int64_t now_ns, std::vector<Solution>& out)
+    -> SolveCounts
+{
+    SolveCounts counts;
+    const auto n = id_.size();
+    if (n == 0) {
+        return counts;
+    }
+
+    for (const auto& t : targets) {
+        counts.pairs += n;
+
+        // Target at the solve instant
+        const auto age_s = static_cast<double>(now_ns - t.time_ns) * 1e-9;
+        const auto cos_lat = std::cos(t.lat * kDegToRad);
+        const auto tlat = t.lat + static_cast<double>(t.vn) * age_s / kMetresPerDegLat;
+        const auto tlon = t.lon + static_cast<double>(t.ve) * age_s / (kMetresPerDegLat * cos_lat);
+        const auto talt = static_cast<float>(static_cast<double>(t.alt) + static_cast<double>(t.vu) * age_s);
+        const auto ve = t.ve, vn = t.vn, vu = t.vu;
+        const auto vt = std::sqrt(ve * ve + vn * vn + vu * vu);
+
+        // Gate: reachable only within max_range + target travel over the
+        // longest flight. One output array keeps the loop vectorisable.
+        const double* lat = lat_.data();
+        const double* lon = lon_.data();
+        const float* alt = alt_.data();
+        const float* mlon = m_per_deg_lon_.data();
+        const float* range = range_.data();
+        const float* tof = max_tof_.data();
+        float* margin = margin_.data();
+        for (std::size_t k = 0; k < n; ++k) {
+            const auto dx = static_cast<float>(tlon - lon[k]) * mlon[k];
+            const auto dy = static_cast<float>((tlat - lat[k]) * kMetresPerDegLat);
+            const auto dz = talt - alt[k];
+            const auto reach = range[k] + vt * tof[k];
+            margin[k] = dx * dx + dy * dy + dz * dz - reach * reach;
+        }
+
+        // Survivors contiguous, so the solve runs unit-stride
+        std::size_t m = 0;
+        for (std::size_t k = 0; k < n; ++k) {
+            if (margin[k] > 0.0F) {
+                continue;
+            }
+            keep_[m] = static_cast<std::uint32_t>(k);
+            cx_[m] = static_cast<float>(tlon - lon[k]) * mlon[k];
+            cy_[m] = static_cast<float>((tlat - lat[k]) * kMetresPerDegLat);
+            cz_[m] = talt - alt[k];
+            cd2_[m] = cx_[m] * cx_[m] + cy_[m] * cy_[m] + cz_[m] * cz_[m];
+            cspeed_[m] = speed_[k];
+            ctof_[m] = tof[k];
+            ++m;
+        }
+        counts.gated += n - m;
+
+        // Solve (v·v − s²)t² + 2(d·v)t + d·d = 0 for the smallest t > 0.
+        // Roots as 2c / (−b ∓ √disc): no division by the leading term, so
+        // equal speeds (a = 0) need no special case, and the loop is
+        // branch-free.
+        const float* cx = cx_.data();
+        const float* cy = cy_.data();
+        const float* cz = cz_.data();
+        const float* cd2 = cd2_.data();
+        const float* cs = cspeed_.data();
+        const float* ctof = ctof_.data();
+        float* out_tti = tti_.data();
+        for (std::size_t j = 0; j < m; ++j) {
+            const auto a = vt * vt - cs[j] * cs[j];
+            const auto b = 2.0F * (cx[j] * ve + cy[j] * vn + cz[j] * vu);
+            const auto c = cd2[j];
+            const auto disc = b * b - 4.0F * a * c;
+            const auto root = std::sqrt(std::max(disc, 0.0F));
+            const auto r1 = 2.0F * c / (-b - root);
+            const auto r2 = 2.0F * c / (-b + root);
+            const auto p1 = r1 > 0.0F ? r1 : kNoIntercept;
+            const auto p2 = r2 > 0.0F ? r2 : kNoIntercept;
+            const auto tti = disc >= 0.0F ? std::min(p1, p2) : kNoIntercept;
+            out_tti[j] = tti <= ctof[j] ? tti : kNoIntercept;
+        }
+
+        for (std::size_t j = 0; j < m; ++j) {
+            const auto tti = tti_[j];
+            if (tti == kNoIntercept) {
+                continue;
+            }
+            const auto k = keep_[j];
+            const auto east = cx[j] + ve * tti;
+            const auto north = cy[j] + vn * tti;
+            auto bearing = std::atan2(east, north) * static_cast<float>(180.0 / std::numbers::pi);
+            if (bearing < 0.0F) {
+                bearing += 360.0F;
+            }
+            out.push_back(Solution{
+                id_[k],
+                t.target_id,
+                tti,
+                tlat + static_cast<double>(vn * tti) / kMetresPerDegLat,
+                tlon + static_cast<double>(ve * tti) / (kMetresPerDegLat * cos_lat),
+                talt + vu * tti,
+                bearing,
+                std::sqrt(cd2[j]),
+            });
+            ++counts.solutions;
+        }
+    }
+    return counts;
+}
+
+}  // namespace protocol::intercept
@@ -0,0 +1,53 @@
+#include "jitter_buffer.hpp"
+
+namespace protocol {
+
+auto JitterBuffer::push(std::uint64_t origin,
+                        const TrackUpdate& update,
+                        std::int64_t arrival_ns,
+                        std::optional<std::chrono::nanoseconds> link_offset,
+                        std::shared_ptr<const LatencyTrace> trace) -> bool
+{
+    auto& clock = clocks_[origin];
+    clock.estimator.observe(update.time_ns, arrival_ns, cfg_.skew_window);
+    const auto corrected_ns = clock.estimator.offset().value_or(0);
+    clock.offset_ns = link_offset ? link_offset->count() : corrected_ns;
+    auto order_ns = update.time_ns + corrected_ns;
+
+    const auto mark = watermarks_.find(update.target_id);
+    if (mark != watermarks_.end() && order_ns < mark->second) {
+        if (cfg_.late == LatePolicy::Drop) {
+            ++stats_.late_dropped;
+            return false;
+        }
+        // Due at once, ahead of everything still held for the target
+        ++stats_.late_released;
+        order_ns = mark->second;
+    }
+
+    heap_.push_back(Entry{order_ns, next_arrival_++, origin, update, std::move(trace)});
+    std::push_heap(heap_.begin(), heap_.end(), Later{});
+    ++stats_.buffered;
+    return true;
+}
+
+auto JitterBuffer::clock_offset(std::uint64_t origin) const -> std::optional<std::chrono::nanoseconds> {
+    const auto it = clocks_.find(origin);
+    if (it == clocks_.end()) {
+        return std::nullopt;
+    }
+    return std::chrono::nanoseconds{it->second.offset_ns};
+}
+
+void JitterBuffer::sweep_watermarks(std::int64_t now_ns) {
+    if (now_ns < next_sweep_ns_) {
+        return;
+    }
+    const auto window_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(cfg_.skew_window).count();
+    const auto hold_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(cfg_.hold).count();
+    const auto horizon = now_ns - hold_ns - window_ns;
+    std::erase_if(watermarks_, [horizon](const auto& entry) { return entry.second < horizon; });
+    next_sweep_ns_ = now_ns + window_ns;
+}
+
+}  // namespace protocol
@@ -0,0 +1,272 @@
+#include "journal.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <string_view>
+
+#include <fmt/core.h>
+
+namespace protocol {
+
+namespace {
+
+constexpr std::string_view kSegmentPrefix = "journal-";
+constexpr std::string_view kSegmentSuffix = ".seg";
+
+auto encode_segment_header(std::uint64_t first_seq) -> std::string {
+    wire::ByteWriter w;
+    w.put_u32(kJournalMagic);
+    w.put_u16(kJournalVersion);
+    w.put_u16(0);
+    w.put_u64(first_seq);
+    return std::move(w).take();
+}
+
+}  // namespace
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SEGMENT FILES
+// ═══════════════════════════════════════════════════════════════════════════
+
+auto segment_path(const std::filesystem::path& dir, std::uint64_t first_seq) -> std::filesystem::path {
+    return dir / fmt::format("{}{:020}{}", kSegmentPrefix, first_seq, kSegmentSuffix);
+}
+
+auto list_segments(const std::filesystem::path& dir) -> std::vector<SegmentInfo> {
+    std::vector<SegmentInfo> out;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator{dir, ec}) {
+        const auto name = entry.path().filename().string();
+        const std::string_view sv{name};
+        if (!sv.starts_with(kSegmentPrefix) || !sv.ends_with(kSegmentSuffix)) {
+            continue;
+        }
+
+        const auto digits = sv.substr(kSegmentPrefix.size(),
+                                      sv.size() - kSegmentPrefix.size() - kSegmentSuffix.size());
+        std::uint64_t first = 0;
+        const auto [ptr, parse_ec] = std::from_chars(digits.data(), digits.data() + digits.size(), first);
+        if (parse_ec != std::errc{} || ptr != digits.data() + digits.size()) {
+            continue;
+        }
+
+        const auto bytes = entry.file_size(ec);
+        if (ec || bytes < kSegmentHeaderSize) {
+            continue;
+        }
+        out.push_back(SegmentInfo{entry.path(), first, (bytes - kSegmentHeaderSize) / kJournalRecordSize});
+    }
+    std::sort(out.begin(), out.end(),
+              [](const auto& a, const auto& b) { return a.first_seq < b.first_seq; });
+    return out;
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// JOURNAL
+// ═══════════════════════════════════════════════════════════════════════════
+
+Journal::~Journal() {
+    try {
+        flush();
+        write_index();
+    } catch (const std::exception& e) {
+        fmt::print(stderr, "[JOURNAL] Final flush failed: {}\n", e.what());
+    }
+}
+
+auto Journal::open(JournalConfig cfg) -> Journal {
+    Journal j{std::move(cfg)};
+    if (!j.cfg_.persistent()) {
+        return j;
+    }
+
+    std::filesystem::create_directories(j.cfg_.dir);
+    j.segments_ = list_segments(j.cfg_.dir);
+    if (j.segments_.empty()) {
+        return j;
+    }
+
+    // Drop a torn trailing record, then continue appending to the last segment
+    auto& last = j.segments_.back();
+    {
+        auto file = PosixFile::open_read_write(last.path);
+        const auto expected = kSegmentHeaderSize + last.records * kJournalRecordSize;
+        if (file.size() != expected) {
+            file.truncate(expected);
+        }
+    }
+    j.active_ = PosixFile::open_append(last.path);
+    j.next_seq_ = last.first_seq + last.records;
+
+    // Index segments sealed by a crash; the active one is rebuilt in memory
+    std::size_t indexed = 0;
+    for (std::size_t i = 0; i + 1 < j.segments_.size(); ++i) {
+        if (!load_segment_index(j.segments_[i])) {
+            write_segment_index(j.cfg_.dir, build_segment_index(j.segments_[i]));
+            ++indexed;
+        }
+    }
+    if (indexed > 0) {
+        fmt::print("[JOURNAL] Indexed {} unindexed segment(s)\n", indexed);
+    }
+    j.index_ = build_segment_index(last);
+
+    // Warm the in-memory tail so recent reads never touch disk
+    const auto want = std::min<std::uint64_t>(j.cfg_.tail_records, j.next_seq_ - j.segments_.front().first_seq);
+    std::vector<JournalRecord> recent;
+    j.read(j.next_seq_ - want, static_cast<std::size_t>(want), recent);
+    j.tail_.assign(recent.begin(), recent.end());
+    return j;
+}
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// Writing
+// ───────────────────────────────────────────────────────────────────────────
+
+auto Journal::append(std::int64_t ingest_ns,
+                     std::uint32_t origin,
+                     std::uint64_t origin_seq,
+                     const TrackUpdate& update) -> std::uint64_t {
+    const auto seq = next_seq_;
+    push(JournalRecord{seq, ingest_ns, origin, origin_seq, update});
+    return seq;
+}
+
+auto Journal::append(const JournalRecord& record) -> bool {
+    if (record.seq < next_seq_) {
+        return false;
+    }
+    push(record);
+    return true;
+}
+
+void Journal::push(const JournalRecord& record) {
+    if (cfg_.persistent()) {
+        const bool contiguous = !segments_.empty() && active_.is_open()
+            && record.seq == segments_.back().first_seq + segments_.back().records;
+        if (!contiguous || segments_.back().records >= cfg_.segment_records) {
+            roll(record.seq);
+        }
+        encode_journal_record(buffer_, record);
+        ++segments_.back().records;
+        index_.add(record.update.target_id, record.update.time_ns, record.update.lat, record.update.lon);
+        if (buffer_.size() >= cfg_.write_buffer) {
+            flush();
+        }
+    }
+
+    tail_.push_back(record);
+    while (tail_.size() > cfg_.tail_records) {
+        tail_.pop_front();
+    }
+    next_seq_ = record.seq + 1;
+}
+
+void Journal::roll(std::uint64_t first_seq) {
+    flush();
+    write_index();
+    active_.close();
+
+    auto path = segment_path(cfg_.dir, first_seq);
+    active_ = PosixFile::open_append(path);
+    active_.write_all(encode_segment_header(first_seq));
+    segments_.push_back(SegmentInfo{std::move(path), first_seq, 0});
+    index_ = SegmentIndex{first_seq};
+}
+
+void Journal::write_index() {
+    // Only a block that covers the whole segment may be used to prune
+    if (!active_.is_open() || segments_.empty() || index_.records() != segments_.back().records
+        || index_.first_seq() != segments_.back().first_seq) {
+        return;
+    }
+    write_segment_index(cfg_.dir, index_);
+}
+
+void Journal::flush() {
+    if (buffer_.size() == 0 || !active_.is_open()) {
+        return;
+    }
+    active_.write_all(buffer_.view());
+    buffer_ = wire::ByteWriter{};
+}
+
+void Journal::sync() {
+    flush();
+    if (active_.is_open()) {
+        active_.sync();
+    }
+}
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// Reading
+// ───────────────────────────────────────────────────────────────────────────
+
+auto Journal::first_seq() const noexcept -> std::uint64_t {
+    if (!segments_.empty()) {
+        return segments_.front().first_seq;
+    }
+    return tail_.empty() ? next_seq_ : tail_.front().seq;
+}
+
+auto Journal::read(std::uint64_t from_seq, std::size_t max, std::vector<JournalRecord>& out)
+    -> std::size_t
+{
+    from_seq = std::max(from_seq, first_seq());
+    std::size_t n = 0;
+
+    // Recent records: straight from memory
+    if (!tail_.empty() && from_seq >= tail_.front().seq) {
+        auto it = std::lower_bound(tail_.begin(), tail_.end(), from_seq,
+                                   [](const JournalRecord& r, std::uint64_t s) { return r.seq < s; });
+        for (; it != tail_.end() && n < max; ++it, ++n) {
+            out.push_back(*it);
+        }
+        return n;
+    }
+
+    // Older records: segment files
+    flush();
+    for (const auto& seg : segments_) {
+        if (n >= max) {
+            break;
+        }
+        if (seg.first_seq + seg.records <= from_seq) {
+            continue;
+        }
+        const auto got = read_segment(seg, std::max(from_seq, seg.first_seq), max - n, out);
+        n += got;
+        if (got > 0) {
+            from_seq = out.back().seq + 1;
+        }
+    }
+    return n;
+}
+
+auto Journal::read_segment(const SegmentInfo& seg, std::uint64_t from_seq, std::size_t max,
+                           std::vector<JournalRecord>& out) const -> std::size_t
+{
+    const auto index = from_seq - seg.first_seq;
+    const auto count = static_cast<std::size_t>(std::min<std::uint64_t>(max, seg.records - index));
+    if (count == 0) {
+        return 0;
+    }
+
+    const auto file = PosixFile::open_read(seg.path);
+    std::string bytes(count * kJournalRecordSize, '\0');
+    const auto got = file.pread_some(bytes, kSegmentHeaderSize + index * kJournalRecordSize);
+
+    wire::ByteReader r{std::string_view{bytes}.substr(0, got)};
+    std::size_t n = 0;
+    while (r.remaining() >= kJournalRecordSize) {
+        out.push_back(decode_journal_record(r));
+        ++n;
+    }
+    return n;
+}
+
+}  // namespace protocol
@@ -0,0 +1,107 @@
+#include "journal_index.hpp"
+
+#include <fmt/core.h>
+
+#include "journal.hpp"
+#include "posix_file.hpp"
+
+namespace protocol {
+
+static_assert(kRecordLonOffset + 8 <= kJournalRecordSize, "index fields lie inside a journal record");
+
+// ═══════════════════════════════════════════════════════════════════════════
+// BLOCK CODEC
+// ═══════════════════════════════════════════════════════════════════════════
+
+auto SegmentIndex::encode() const -> std::string {
+    wire::ByteWriter w;
+    w.reserve(kIndexHeaderSize + bloom_.size() * 8);
+    w.put_u32(kIndexMagic);
+    w.put_u16(kIndexVersion);
+    w.put_u16(kBloomLog2);
+    w.put_u64(first_seq_);
+    w.put_u64(records_);
+    w.put_i64(time_min_);
+    w.put_i64(time_max_);
+    w.put_f64(box_.lat_min);
+    w.put_f64(box_.lat_max);
+    w.put_f64(box_.lon_min);
+    w.put_f64(box_.lon_max);
+    for (const auto word : bloom_) {
+        w.put_u64(word);
+    }
+    return std::move(w).take();
+}
+
+auto SegmentIndex::decode(std::string_view bytes) -> std::optional<SegmentIndex> {
+    wire::ByteReader r{bytes};
+    const auto magic = r.get_u32();
+    const auto version = r.get_u16();
+    const auto bloom_log2 = r.get_u16();
+    if (!r.ok() || magic != kIndexMagic || version != kIndexVersion || bloom_log2 != kBloomLog2) {
+        return std::nullopt;
+    }
+
+    SegmentIndex out{r.get_u64()};
+    out.records_ = r.get_u64();
+    out.time_min_ = r.get_i64();
+    out.time_max_ = r.get_i64();
+    out.box_.lat_min = r.get_f64();
+    out.box_.lat_max = r.get_f64();
+    out.box_.lon_min = r.get_f64();
+    out.box_.lon_max = r.get_f64();
+    for (auto& word : out.bloom_) {
+        word = r.get_u64();
+    }
+    if (!r.ok() || r.remaining() != 0) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// INDEX FILES
+// ═══════════════════════════════════════════════════════════════════════════
+
+auto index_path(const std::filesystem::path& dir, std::uint64_t first_seq) -> std::filesystem::path {
+    return dir / fmt::format("journal-{:020}.idx", first_seq);
+}
+
+void write_segment_index(const std::filesystem::path& dir, const SegmentIndex& index) {
+    write_file_atomic(index_path(dir, index.first_seq()), index.encode());
+}
+
+auto load_segment_index(const SegmentInfo& seg) -> std::optional<SegmentIndex> {
+    const auto path = index_path(seg.path.parent_path(), seg.first_seq);
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) {
+        return std::nullopt;
+    }
+
+    const auto file = MappedFile::map_read(path);
+    auto index = SegmentIndex::decode(file.bytes());
+    if (!index || index->first_seq() != seg.first_seq || index->records() != seg.records) {
+        return std::nullopt;
+    }
+    return index;
+}
+
+auto build_segment_index(const SegmentInfo& seg) -> SegmentIndex {
+    SegmentIndex index{seg.first_seq};
+    const auto file = MappedFile::map_read(seg.path);
+    const auto bytes = file.bytes();
+    const auto records = std::min<std::uint64_t>(
+        seg.records, bytes.size() > kSegmentHeaderSize ? (bytes.size() - kSegmentHeaderSize) / kJournalRecordSize : 0);
+
+    const char* rec = bytes.data() + kSegmentHeaderSize;
+    for (std::uint64_t i = 0; i < records; ++i, rec += kJournalRecordSize) {
+        index.add(load_field<std::uint64_t>(rec, kRecordTargetOffset),
+                  load_field<std::int64_t>(rec, kRecordTimeOffset),
+                  load_field<double>(rec, kRecordLatOffset),
+                  load_field<double>(rec, kRecordLonOffset));
+    }
+    return index;
+}
+
+}  // namespace protocol
@@ -0,0 +1,171 @@
+#include "journal_query.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+
+#include "posix_file.hpp"
+#include "wire.hpp"
+
+namespace protocol {
+
+namespace {
+
+/// Records per scan task (~5 MB of segment).
+constexpr std::uint64_t kScanSliceRecords = 1U << 16;
+
+/// Query with derived fields, built once per call.
+struct Plan {
+    const JournalQuery& query;
+    bool has_area{false};
+    GeoBox bounds;                          ///< Polygon bounds (cheap reject)
+    std::vector<std::uint64_t> targets;     ///< Sorted for binary search
+
+    [[nodiscard]] auto segment_may_match(const SegmentIndex& index) const noexcept -> bool {
+        if (!index.overlaps_time(query.from_ns, query.to_ns)) {
+            return false;
+        }
+        if (has_area && !index.overlaps_box(bounds)) {
+            return false;
+        }
+        return targets.empty()
+            || std::any_of(targets.begin(), targets.end(),
+                           [&](std::uint64_t id) { return index.may_contain(id); });
+    }
+
+    /// Test an encoded record in place, cheapest field first.
+    [[nodiscard]] auto record_matches(const char* rec) const noexcept -> bool {
+        if (load_field<std::uint64_t>(rec, kRecordOriginSeqOffset) == kJournalDropSeq) {
+            return false;  // Drop records carry no new report
+        }
+        const auto time = load_field<std::int64_t>(rec, kRecordTimeOffset);
+        if (time < query.from_ns || time > query.to_ns) {
+            return false;
+        }
+        if (has_area) {
+            const auto lat = load_field<double>(rec, kRecordLatOffset);
+            const auto lon = load_field<double>(rec, kRecordLonOffset);
+            if (!bounds.contains(lat, lon) || !polygon_contains(query.polygon, lat, lon)) {
+                return false;
+            }
+        }
+        return targets.empty()
+            || std::binary_search(targets.begin(), targets.end(),
+                                  load_field<std::uint64_t>(rec, kRecordTargetOffset));
+    }
+};
+
+/// One scan task: records [begin, end) of a mapped segment.
+struct Slice {
+    const char* records{nullptr};
+    std::uint64_t begin{0};
+    std::uint64_t end{0};
+};
+
+}  // namespace
+
+auto polygon_contains(const std::vector<GeoPoint>& polygon, double lat, double lon) noexcept -> bool {
+    bool inside = false;
+    for (std::size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+        const auto& a = polygon[i];
+        const auto& b = polygon[j];
+        if ((a.lat > lat) != (b.lat > lat)
+            && lon < (b.lon - a.lon) * (lat - a.lat) / (b.lat - a.lat) + a.lon) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+auto query_journal(const std::filesystem::path& dir,
+                   const JournalQuery& query,
+                   exec::TaskPool& pool) -> JournalQueryResult
+{
+    const auto start = std::chrono::steady_clock::now();
+    if (!query.polygon.empty() && query.polygon.size() < 3) {
+        throw std::invalid_argument{"query polygon needs at least 3 vertices"};
+    }
+
+    Plan plan{query, !query.polygon.empty(), GeoBox{}, query.targets};
+    for (const auto& v : query.polygon) {
+        plan.bounds.extend(v.lat, v.lon);
+    }
+    std::sort(plan.targets.begin(), plan.targets.end());
+
+    // Prune on index blocks, map the survivors and cut them into slices
+    JournalQueryResult out;
+    auto& stats = out.stats;
+    const auto segments = list_segments(dir);
+    stats.segments = segments.size();
+
+    std::vector<MappedFile> maps;
+    std::vector<Slice> slices;
+    for (const auto& seg : segments) {
+        std::optional<SegmentIndex> index;
+        try {
+            index = load_segment_index(seg);
+        } catch (const std::exception&) {
+            // Unreadable block: scan the segment instead
+        }
+        if (index && !plan.segment_may_match(*index)) {
+            ++stats.pruned;
+            continue;
+        }
+        if (!index) {
+            ++stats.unindexed;
+        }
+
+        // The active segment may have grown since it was listed; the
+        // mapping decides how many whole records there are
+        auto map = MappedFile::map_read(seg.path);
+        const auto bytes = map.bytes();
+        if (bytes.size() <= kSegmentHeaderSize) {
+            continue;
+        }
+        const auto records = (bytes.size() - kSegmentHeaderSize) / kJournalRecordSize;
+        const char* base = bytes.data() + kSegmentHeaderSize;
+        for (std::uint64_t b = 0; b < records; b += kScanSliceRecords) {
+            slices.push_back(Slice{base, b, std::min<std::uint64_t>(b + kScanSliceRecords, records)});
+        }
+        maps.push_back(std::move(map));
+    }
+
+    // Scan slices in parallel; each keeps at most `limit` matches, which is
+    // enough for the earliest `limit` overall
+    std::vector<std::vector<JournalRecord>> found(slices.size());
+    std::vector<std::uint64_t> scanned(slices.size(), 0);
+    pool.parallel_for(std::size_t{0}, slices.size(), std::size_t{1}, [&](std::size_t first, std::size_t last) {
+        for (auto s = first; s < last; ++s) {
+            const auto& slice = slices[s];
+            auto& hits = found[s];
+            auto i = slice.begin;
+            for (; i < slice.end && hits.size() < query.limit; ++i) {
+                const char* rec = slice.records + i * kJournalRecordSize;
+                if (plan.record_matches(rec)) {
+                    wire::ByteReader r{std::string_view{rec, kJournalRecordSize}};
+                    hits.push_back(decode_journal_record(r));
+                }
+            }
+            scanned[s] = i - slice.begin;
+        }
+    });
+
+    for (std::size_t s = 0; s < slices.size(); ++s) {
+        stats.records_scanned += scanned[s];
+        stats.truncated = stats.truncated || scanned[s] < slices[s].end - slices[s].begin;
+    }
+    for (auto& hits : found) {
+        const auto take = std::min(hits.size(), query.limit - out.records.size());
+        stats.truncated = stats.truncated || take < hits.size();
+        std::move(hits.begin(), hits.begin() + static_cast<std::ptrdiff_t>(take), std::back_inserter(out.records));
+    }
+    stats.bytes_scanned = stats.records_scanned * kJournalRecordSize;
+    stats.matches = out.records.size();
+    stats.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    return out;
+}
+
+}  // namespace protocol
@@ -0,0 +1,127 @@
+#include "lifecycle.hpp"
+
+namespace protocol {
+
+void TimingWheel::schedule(std::uint64_t id, std::int64_t deadline_ns) {
+    // Never behind the cursor: a due id is visited on the next advance()
+    const auto tick = started_ ? std::max(deadline_ns / tick_ns_, current_) : deadline_ns / tick_ns_;
+    slots_[index(tick)].push_back(id);
+}
+
+auto TimingWheel::size() const noexcept -> std::size_t {
+    std::size_t n = 0;
+    for (const auto& slot : slots_) {
+        n += slot.size();
+    }
+    return n;
+}
+
+auto TrackLifecycle::deadline(std::size_t i) const noexcept -> std::int64_t {
+    const auto after = state_[i] == TrackState::Coasting ? cfg_.drop_after : cfg_.coast_after;
+    return last_ns_[i] + std::chrono::duration_cast<std::chrono::nanoseconds>(after).count();
+}
+
+void TrackLifecycle::add(std::uint64_t target_id, TrackState state, std::uint32_t updates, std::int64_t last_ns) {
+    index_.emplace(target_id, id_.size());
+    id_.push_back(target_id);
+    last_ns_.push_back(last_ns);
+    updates_.push_back(updates);
+    state_.push_back(state);
+    wheel_.schedule(target_id, deadline(id_.size() - 1));
+}
+
+void TrackLifecycle::remove(std::size_t i) {
+    // Swap-with-last keeps the arrays packed
+    const auto last = id_.size() - 1;
+    index_.erase(id_[i]);
+    if (i != last) {
+        id_[i] = id_[last];
+        last_ns_[i] = last_ns_[last];
+        updates_[i] = updates_[last];
+        state_[i] = state_[last];
+        index_[id_[i]] = i;
+    }
+    id_.pop_back();
+    last_ns_.pop_back();
+    updates_.pop_back();
+    state_.pop_back();
+}
+
+auto TrackLifecycle::observe(std::uint64_t target_id, std::int64_t now_ns) -> std::optional<Transition> {
+    const auto it = index_.find(target_id);
+    if (it == index_.end()) {
+        const auto state = cfg_.confirm_updates <= 1 ? TrackState::Confirmed : TrackState::Tentative;
+        add(target_id, state, 1, now_ns);
+        if (state == TrackState::Confirmed) {
+            ++stats_.confirmed;
+        }
+        return std::nullopt;
+    }
+    
+    // The wheel entry stays where it is; it re-arms itself when reached
+    const auto i = it->second;
+    last_ns_[i] = std::max(last_ns_[i], now_ns);
+    ++updates_[i];
+    const auto from = state_[i];
+    if ((from == TrackState::Tentative && updates_[i] >= cfg_.confirm_updates) || from == TrackState::Coasting) {
+        state_[i] = TrackState::Confirmed;
+        ++stats_.confirmed;
+        return Transition{target_id, from, TrackState::Confirmed};
+    }
+    return std::nullopt;
+}
+
+void TrackLifecycle::restore(std::uint64_t target_id, std::int64_t last_ns) {
+    if (!index_.contains(target_id)) {
+        add(target_id, TrackState::Confirmed, cfg_.confirm_updates, last_ns);
+    }
+}
+
+auto TrackLifecycle::advance(std::int64_t now_ns) -> std::vector<Transition> {
+    std::vector<Transition> out;
+    wheel_.advance(now_ns, [&](std::uint64_t id) {
+        ++stats_.fired;
+        const auto it = index_.find(id);
+        if (it == index_.end()) {
+            return;
+        }
+        const auto i = it->second;
+        if (const auto due = deadline(i); due > now_ns) {
+            ++stats_.rearmed;
+            wheel_.schedule(id, due);
+            return;
+        }
+        const auto from = state_[i];
+        if (from == TrackState::Confirmed) {
+            state_[i] = TrackState::Coasting;
+            ++stats_.coasted;
+            out.push_back(Transition{id, from, TrackState::Coasting});
+            wheel_.schedule(id, deadline(i));
+            return;
+        }
+        ++stats_.dropped;
+        out.push_back(Transition{id, from, TrackState::Dropped});
+        remove(i);
+    });
+    return out;
+}
+
+auto TrackLifecycle::state(std::uint64_t target_id) const -> std::optional<TrackState> {
+    const auto it = index_.find(target_id);
+    return it == index_.end() ? std::nullopt : std::optional{state_[it->second]};
+}
+
+auto TrackLifecycle::stats() const noexcept -> LifecycleStats {
+    auto out = stats_;
+    out.tentative_now = 0;
+    out.confirmed_now = 0;
+    out.coasting_now = 0;
+    for (const auto s : state_) {
+        out.tentative_now += s == TrackState::Tentative ? 1U : 0U;
+        out.confirmed_now += s == TrackState::Confirmed ? 1U : 0U;
+        out.coasting_now += s == TrackState::Coasting ? 1U : 0U;
+    }
+    return out;
+}
+
+}  // namespace protocol
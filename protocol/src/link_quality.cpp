@@ -0,0 +1,8 @@
+#include "link_quality.hpp"
+
+namespace protocol::link {
+
+// Explicit template instantiation for the production clock
+template class LinkMonitor<std::chrono::steady_clock>;
+
+}  // namespace protocol::link
@@ -0,0 +1,206 @@
+#include "lod.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace protocol::lod {
+
+namespace {
+
+[[nodiscard]] auto tiles_across(std::uint8_t zoom) noexcept -> double {
+    return std::ldexp(1.0, zoom);
+}
+
+/// Index of the tile holding `v` in [lo, lo + span), clamped to the grid
+/// (NaN lands in tile 0, never in the cast).
+[[nodiscard]] auto index_of(double v, double lo, double span, std::uint8_t zoom) noexcept -> std::uint32_t {
+    const auto n = tiles_across(zoom);
+    const auto i = std::floor((v - lo) / span * n);
+    return i > 0.0 ? static_cast<std::uint32_t>(std::min(i, n - 1.0)) : 0;
+}
+
+[[nodiscard]] auto class_of(Urgency u) noexcept -> std::size_t {
+    return std::min(static_cast<std::size_t>(u), kClasses - 1);
+}
+
+}  // namespace
+
+auto in_view(std::uint8_t zoom, const Tile& tile, const Viewport& view) noexcept -> bool {
+    return index_of(view.lon_min, -180.0, 360.0, zoom) <= tile.x && tile.x <= index_of(view.lon_max, -180.0, 360.0, zoom)
+        && index_of(view.lat_min, -90.0, 180.0, zoom) <= tile.y && tile.y <= index_of(view.lat_max, -90.0, 180.0, zoom);
+}
+
+LodIndex::LodIndex(const LodConfig& cfg) : cfg_{cfg} {
+    auto zooms = cfg.zooms;
+    for (auto& z : zooms) {
+        z = std::min(z, kMaxZoom);
+    }
+    std::sort(zooms.begin(), zooms.end());
+    zooms.erase(std::unique(zooms.begin(), zooms.end()), zooms.end());
+    levels_.resize(zooms.size());
+    for (std::size_t i = 0; i < zooms.size(); ++i) {
+        levels_[i].zoom = zooms[i];
+    }
+}
+
+auto LodIndex::key_of(std::uint8_t zoom, double lat, double lon) noexcept -> std::uint64_t {
+    return (std::uint64_t{index_of(lon, -180.0, 360.0, zoom)} << 32) | index_of(lat, -90.0, 180.0, zoom);
+}
+
+void LodIndex::mark(Level& level, std::uint64_t key, Aggregate& a) {
+    if (!a.dirty) {
+        a.dirty = true;
+        level.dirty.push_back(key);
+    }
+}
+
+void LodIndex::update(const TrackUpdate& t) {
+    ++stats_.updates;
+    const auto cls = class_of(t.urgency);
+    auto [it, inserted] = tracks_.try_emplace(t.target_id);
+    auto& held = it->second;
+    for (auto& level : levels_) {
+        const auto key = key_of(level.zoom, t.lat, t.lon);
+        if (!inserted) {
+            const auto old_key = key_of(level.zoom, held.lat, held.lon);
+            auto& old = level.tiles.find(old_key)->second;
+            if (old_key == key && held.cls == cls) {
+                // Same tile and class: only the centroid moves
+                old.lat[cls] += t.lat - held.lat;
+                old.lon[cls] += t.lon - held.lon;
+                mark(level, key, old);
+                continue;
+            }
+            --old.count[held.cls];
+            old.lat[held.cls] -= held.lat;
+            old.lon[held.cls] -= held.lon;
+            mark(level, old_key, old);
+            if (old_key != key) {
+                ++stats_.moves;
+            }
+        }
+        auto& now = level.tiles[key];
+        ++now.count[cls];
+        now.lat[cls] += t.lat;
+        now.lon[cls] += t.lon;
+        mark(level, key, now);
+    }
+    held = Held{t.lat, t.lon, cls};
+}
+
+void LodIndex::remove(std::uint64_t target_id) {
+    const auto it = tracks_.find(target_id);
+    if (it == tracks_.end()) {
+        return;
+    }
+    const auto& held = it->second;
+    for (auto& level : levels_) {
+        const auto key = key_of(level.zoom, held.lat, held.lon);
+        auto& a = level.tiles.find(key)->second;
+        --a.count[held.cls];
+        a.lat[held.cls] -= held.lat;
+        a.lon[held.cls] -= held.lon;
+        mark(level, key, a);
+    }
+    tracks_.erase(it);
+}
+
+auto LodIndex::make_tile(std::uint64_t key, const Aggregate& a) -> Tile {
+    Tile tile;
+    tile.x = static_cast<std::uint32_t>(key >> 32);
+    tile.y = static_cast<std::uint32_t>(key);
+    for (std::size_t c = 0; c < kClasses; ++c) {
+        if (a.count[c] == 0) {
+            continue;
+        }
+        const auto n = static_cast<double>(a.count[c]);
+        tile.total += a.count[c];
+        tile.max_urgency = static_cast<Urgency>(c);
+        tile.points.push_back(Point{static_cast<Urgency>(c), a.count[c], a.lat[c] / n, a.lon[c] / n});
+    }
+    return tile;
+}
+
+auto LodIndex::drain() -> std::vector<LevelDelta> {
+    std::vector<LevelDelta> out;
+    for (auto& level : levels_) {
+        if (level.dirty.empty()) {
+            continue;
+        }
+        LevelDelta delta;
+        delta.zoom = level.zoom;
+        delta.tiles.reserve(level.dirty.size());
+        for (const auto key : level.dirty) {
+            const auto it = level.tiles.find(key);
+            it->second.dirty = false;
+            delta.tiles.push_back(make_tile(key, it->second));
+            if (delta.tiles.back().total == 0) {
+                level.tiles.erase(it);  // Sent once with total 0, then forgotten
+            }
+        }
+        level.dirty.clear();
+        stats_.tiles_changed += delta.tiles.size();
+        out.push_back(std::move(delta));
+    }
+    ++stats_.deltas;
+    return out;
+}
+
+auto LodIndex::level_for(std::uint8_t zoom) const noexcept -> std::uint8_t {
+    if (levels_.empty()) {
+        return 0;
+    }
+    auto best = levels_.front().zoom;
+    for (const auto& level : levels_) {
+        if (level.zoom <= zoom) {
+            best = level.zoom;
+        }
+    }
+    return best;
+}
+
+auto LodIndex::tiles(std::uint8_t zoom, const Viewport& view) const -> std::vector<Tile> {
+    std::vector<Tile> out;
+    const auto level = std::find_if(levels_.begin(), levels_.end(),
+                                    [&](const Level& l) { return l.zoom == zoom; });
+    if (level == levels_.end()) {
+        return out;
+    }
+    // Probe the tiles under the viewport when there are fewer of them than
+    // occupied tiles, else scan the occupied ones
+    const auto x0 = index_of(view.lon_min, -180.0, 360.0, zoom), x1 = index_of(view.lon_max, -180.0, 360.0, zoom);
+    const auto y0 = index_of(view.lat_min, -90.0, 180.0, zoom), y1 = index_of(view.lat_max, -90.0, 180.0, zoom);
+    const auto covered = (std::uint64_t{x1} - x0 + 1) * (std::uint64_t{y1} - y0 + 1);
+    if (covered < level->tiles.size()) {
+        for (auto x = x0; x <= x1; ++x) {
+            for (auto y = y0; y <= y1; ++y) {
+                const auto key = (std::uint64_t{x} << 32) | y;
+                if (const auto it = level->tiles.find(key); it != level->tiles.end()) {
+                    if (auto tile = make_tile(key, it->second); tile.total > 0) {
+                        out.push_back(std::move(tile));
+                    }
+                }
+            }
+        }
+        return out;
+    }
+    for (const auto& [key, a] : level->tiles) {
+        auto tile = make_tile(key, a);
+        if (tile.total > 0 && in_view(zoom, tile, view)) {
+            out.push_back(std::move(tile));
+        }
+    }
+    return out;
+}
+
+auto LodIndex::stats() const noexcept -> LodStats {
+    auto out = stats_;
+    out.tracks = tracks_.size();
+    out.tiles = 0;
+    for (const auto& level : levels_) {
+        out.tiles += level.tiles.size();
+    }
+    return out;
+}
+
+}  // namespace protocol::lod
@@ -0,0 +1,271 @@
+#include "mirror.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace protocol::mirror {
+
+namespace {
+
+constexpr double kDegScale = 1e7;     // 1e-7°
+constexpr float kMetreScale = 100.0F; // cm, cm/s
+
+/// Longest LEB128 encoding of a u64.
+constexpr std::size_t kMaxVarint = 10;
+
+/// Smallest encoded record (every field one byte).
+constexpr std::size_t kMinRecord = 9;
+
+/// Most parts a snapshot may have (u16 part numbers).
+constexpr std::size_t kMaxParts = 0xFFFF;
+
+[[nodiscard]] constexpr auto zigzag(std::int64_t v) noexcept -> std::uint64_t {
+    return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+[[nodiscard]] constexpr auto unzigzag(std::uint64_t v) noexcept -> std::int64_t {
+    return static_cast<std::int64_t>((v >> 1) ^ (~(v & 1) + 1));
+}
+
+void put_varint(std::string& out, std::uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+/// Signed difference `v - prev`, wrapping so any pair round-trips.
+void put_delta(std::string& out, std::int64_t v, std::int64_t prev) {
+    put_varint(out, zigzag(static_cast<std::int64_t>(static_cast<std::uint64_t>(v) - static_cast<std::uint64_t>(prev))));
+}
+
+[[nodiscard]] auto quantise(double v, double scale) noexcept -> std::int64_t {
+    return std::llround(v * scale);
+}
+
+[[nodiscard]] auto quantise(float v) noexcept -> std::int64_t {
+    return std::llround(v * kMetreScale);
+}
+
+/// Sequential varint reader over the snapshot body; sticky failure.
+class VarintReader {
+public:
+    explicit VarintReader(std::string_view bytes) noexcept : bytes_{bytes} {}
+
+    [[nodiscard]] auto get() noexcept -> std::uint64_t {
+        std::uint64_t v = 0;
+        for (std::size_t i = 0; i < kMaxVarint; ++i) {
+            if (pos_ >= bytes_.size()) {
+                break;
+            }
+            const auto b = static_cast<std::uint8_t>(bytes_[pos_++]);
+            v |= std::uint64_t{b & 0x7FU} << (7 * i);
+            if ((b & 0x80) == 0) {
+                return v;
+            }
+        }
+        ok_ = false;
+        return 0;
+    }
+
+    [[nodiscard]] auto get_delta(std::int64_t prev) noexcept -> std::int64_t {
+        return static_cast<std::int64_t>(static_cast<std::uint64_t>(prev) + static_cast<std::uint64_t>(unzigzag(get())));
+    }
+
+    [[nodiscard]] auto get_u8() noexcept -> std::uint8_t {
+        if (pos_ >= bytes_.size()) {
+            ok_ = false;
+            return 0;
+        }
+        return static_cast<std::uint8_t>(bytes_[pos_++]);
+    }
+
+    [[nodiscard]] auto ok() const noexcept -> bool { return ok_; }
+    [[nodiscard]] auto done() const noexcept -> bool { return pos_ == bytes_.size(); }
+
+private:
+    std::string_view bytes_;
+    std::size_t pos_{0};
+    bool ok_{true};
+};
+
+}  // namespace
+
+auto encode_snapshot(std::span<const TrackUpdate> tracks, std::uint64_t seq, std::size_t chunk)
+    -> std::vector<std::string>
+{
+    std::vector<const TrackUpdate*> order;
+    order.reserve(tracks.size());
+    for (const auto& t : tracks) {
+        order.push_back(&t);
+    }
+    std::sort(order.begin(), order.end(), [](const TrackUpdate* a, const TrackUpdate* b) {
+        return a->target_id < b->target_id;
+    });
+
+    // Part numbers are u16
+    chunk = std::max({chunk, std::size_t{1}, (order.size() + kMaxParts - 1) / kMaxParts});
+    const auto parts = std::max<std::size_t>((order.size() + chunk - 1) / chunk, 1);
+
+    std::vector<std::string> frames;
+    frames.reserve(parts);
+    std::string body;
+    for (std::size_t part = 0; part < parts; ++part) {
+        const auto first = part * chunk;
+        const auto last = std::min(first + chunk, order.size());
+        body.clear();
+        std::uint64_t id = 0;
+        std::int64_t time_ns = 0, lat = 0, lon = 0, alt = 0;
+        for (auto i = first; i < last; ++i) {
+            const auto* t = order[i];
+            put_varint(body, t->target_id - id);
+            put_delta(body, t->time_ns, time_ns);
+            const auto q_lat = quantise(t->lat, kDegScale);
+            const auto q_lon = quantise(t->lon, kDegScale);
+            const auto q_alt = quantise(t->alt);
+            put_delta(body, q_lat, lat);
+            put_delta(body, q_lon, lon);
+            put_delta(body, q_alt, alt);
+            put_varint(body, zigzag(quantise(t->vn)));
+            put_varint(body, zigzag(quantise(t->ve)));
+            put_varint(body, zigzag(quantise(t->vu)));
+            body.push_back(static_cast<char>(t->urgency));
+            id = t->target_id;
+            time_ns = t->time_ns;
+            lat = q_lat;
+            lon = q_lon;
+            alt = q_alt;
+        }
+
+        wire::ByteWriter w{wire::FrameKind::TrackSnapshot, 0, wire::kHeaderSize + 8 + 2 + 2 + 4 + 4 + body.size()};
+        w.put_u64(seq);
+        w.put_u16(static_cast<std::uint16_t>(part));
+        w.put_u16(static_cast<std::uint16_t>(parts));
+        w.put_u32(static_cast<std::uint32_t>(last - first));
+        w.put_u32(static_cast<std::uint32_t>(body.size()));
+        w.put_bytes(body);
+        frames.push_back(std::move(w).take());
+    }
+    return frames;
+}
+
+auto decode_snapshot(std::string_view frame) -> std::optional<Snapshot> {
+    wire::ByteReader r{frame};
+    const auto header = r.get_header();
+    if (!header || header->kind != wire::FrameKind::TrackSnapshot) {
+        return std::nullopt;
+    }
+    Snapshot out;
+    out.seq = r.get_u64();
+    out.part = r.get_u16();
+    out.parts = r.get_u16();
+    const auto count = r.get_u32();
+    const auto size = r.get_u32();
+    const auto bytes = r.get_bytes(size);
+    if (!r.ok() || out.part >= out.parts || bytes.size() < static_cast<std::size_t>(count) * kMinRecord) {
+        return std::nullopt;
+    }
+
+    VarintReader v{bytes};
+    out.tracks.resize(count);
+    std::uint64_t id = 0;
+    std::int64_t time_ns = 0, lat = 0, lon = 0, alt = 0;
+    for (auto& t : out.tracks) {
+        id += v.get();
+        time_ns = v.get_delta(time_ns);
+        lat = v.get_delta(lat);
+        lon = v.get_delta(lon);
+        alt = v.get_delta(alt);
+        t.target_id = id;
+        t.time_ns = time_ns;
+        t.lat = static_cast<double>(lat) / kDegScale;
+        t.lon = static_cast<double>(lon) / kDegScale;
+        t.alt = static_cast<float>(alt) / kMetreScale;
+        t.vn = static_cast<float>(unzigzag(v.get())) / kMetreScale;
+        t.ve = static_cast<float>(unzigzag(v.get())) / kMetreScale;
+        t.vu = static_cast<float>(unzigzag(v.get())) / kMetreScale;
+        const auto u = v.get_u8();
+        t.urgency = u <= static_cast<std::uint8_t>(Urgency::Red)
+            ? static_cast<Urgency>(u)
+            : Urgency::Green;
+    }
+    if (!v.ok() || !v.done()) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SNAPSHOT CACHE
+// ═══════════════════════════════════════════════════════════════════════════
+
+void SnapshotCache::on_apply(std::uint64_t target_id) {
+    ++seq_;
+    if (!built_) {
+        return;
+    }
+    changed_.insert(target_id);
+    if (!dropped_.empty()) {
+        dropped_.erase(target_id);
+    }
+}
+
+void SnapshotCache::on_erase(std::uint64_t target_id) {
+    ++seq_;
+    if (!built_) {
+        return;
+    }
+    changed_.erase(target_id);
+    dropped_.insert(target_id);
+}
+
+auto SnapshotCache::take(const TrackStore& store, std::int64_t now_ns) -> CachedSnapshot {
+    const auto max_age_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(cfg_.max_age).count();
+    const auto changes = static_cast<double>(changed_.size() + dropped_.size());
+    if (!built_ || now_ns - built_ns_ >= max_age_ns
+        || changes > cfg_.max_changed * static_cast<double>(store.size())) {
+        rebuild(store, now_ns);
+    }
+
+    CachedSnapshot out;
+    out.seq = built_seq_;
+    out.frames = frames_;
+    out.changed.reserve(changed_.size());
+    for (const auto id : changed_) {
+        if (const auto* t = store.find(id)) {
+            out.changed.push_back(t->update);
+        }
+    }
+    out.dropped.assign(dropped_.begin(), dropped_.end());
+
+    ++stats_.served;
+    stats_.catch_up_tracks += out.changed.size();
+    stats_.catch_up_drops += out.dropped.size();
+    return out;
+}
+
+void SnapshotCache::rebuild(const TrackStore& store, std::int64_t now_ns) {
+    const auto tracks = store.snapshot();
+    auto encoded = encode_snapshot(tracks, seq_);
+
+    // Sessions still sending the previous frames keep them alive
+    frames_.clear();
+    stats_.bytes = 0;
+    for (auto& f : encoded) {
+        stats_.bytes += f.size();
+        frames_.push_back(std::make_shared<const std::string>(std::move(f)));
+    }
+    built_ = true;
+    built_ns_ = now_ns;
+    built_seq_ = seq_;
+    changed_.clear();
+    dropped_.clear();
+
+    ++stats_.builds;
+    stats_.tracks = tracks.size();
+    stats_.frames = frames_.size();
+}
+
+}  // namespace protocol::mirror
@@ -0,0 +1,154 @@
+#include "posix_file.hpp"
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace protocol {
+
+namespace {
+
+[[noreturn]] void throw_errno(const char* what) {
+    throw std::system_error{errno, std::generic_category(), what};
+}
+
+auto open_fd(const std::filesystem::path& path, int flags) -> int {
+    const int fd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::system_error{errno, std::generic_category(), "open " + path.string()};
+    }
+    return fd;
+}
+
+}  // namespace
+
+
+auto PosixFile::open_append(const std::filesystem::path& path) -> PosixFile {
+    return PosixFile{open_fd(path, O_WRONLY | O_CREAT | O_APPEND)};
+}
+
+auto PosixFile::open_read_write(const std::filesystem::path& path) -> PosixFile {
+    return PosixFile{open_fd(path, O_RDWR | O_CREAT)};
+}
+
+auto PosixFile::open_read(const std::filesystem::path& path) -> PosixFile {
+    return PosixFile{open_fd(path, O_RDONLY)};
+}
+
+void PosixFile::write_all(std::string_view data) {
+    while (!data.empty()) {
+        const auto n = ::write(fd_, data.data(), data.size());
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw_errno("write");
+        }
+        data.remove_prefix(static_cast<std::size_t>(n));
+    }
+}
+
+void PosixFile::pwrite_all(std::string_view data, std::uint64_t offset) {
+    while (!data.empty()) {
+        const auto n = ::pwrite(fd_, data.data(), data.size(), static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw_errno("pwrite");
+        }
+        data.remove_prefix(static_cast<std::size_t>(n));
+        offset += static_cast<std::uint64_t>(n);
+    }
+}
+
+auto PosixFile::pread_some(std::span<char> out, std::uint64_t offset) const -> std::size_t {
+    std::size_t total = 0;
+    while (total < out.size()) {
+        const auto n = ::pread(fd_, out.data() + total, out.size() - total,
+                               static_cast<off_t>(offset + total));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw_errno("pread");
+        }
+        if (n == 0) {
+            break;  // End of file
+        }
+        total += static_cast<std::size_t>(n);
+    }
+    return total;
+}
+
+auto PosixFile::size() const -> std::uint64_t {
+    struct stat st{};
+    if (::fstat(fd_, &st) != 0) {
+        throw_errno("fstat");
+    }
+    return static_cast<std::uint64_t>(st.st_size);
+}
+
+void PosixFile::truncate(std::uint64_t length) {
+    if (::ftruncate(fd_, static_cast<off_t>(length)) != 0) {
+        throw_errno("ftruncate");
+    }
+}
+
+void PosixFile::sync() {
+    if (::fdatasync(fd_) != 0) {
+        throw_errno("fdatasync");
+    }
+}
+
+void PosixFile::close() noexcept {
+    if (fd_ >= 0) {
+        ::close(std::exchange(fd_, -1));
+    }
+}
+
+
+auto MappedFile::map_read(const std::filesystem::path& path) -> MappedFile {
+    const auto file = PosixFile::open_read(path);
+    const auto size = static_cast<std::size_t>(file.size());
+    if (size == 0) {
+        return MappedFile{};
+    }
+
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file.fd(), 0);
+    if (data == MAP_FAILED) {
+        throw std::system_error{errno, std::generic_category(), "mmap " + path.string()};
+    }
+    ::madvise(data, size, MADV_SEQUENTIAL);
+    return MappedFile{data, size};  // The mapping outlives the descriptor
+}
+
+void MappedFile::unmap() noexcept {
+    if (data_) {
+        ::munmap(std::exchange(data_, nullptr), std::exchange(size_, 0));
+    }
+}
+
+
+void write_file_atomic(const std::filesystem::path& path, std::string_view data) {
+    auto tmp = path;
+    tmp += ".tmp";
+    {
+        auto file = PosixFile::open_read_write(tmp);
+        file.truncate(0);
+        file.pwrite_all(data, 0);
+        file.sync();
+    }
+    std::filesystem::rename(tmp, path);
+
+    const auto dir = path.has_parent_path() ? path.parent_path() : std::filesystem::path{"."};
+    auto dir_fd = PosixFile::open_read(dir);
+    dir_fd.sync();
+}
+
+}  // namespace protocol
@@ -0,0 +1,9 @@
+#include "rate_limit.hpp"
+
+namespace protocol::ratelimit {
+
+// Explicit template instantiations for the production clock
+template class TokenBucket<std::chrono::steady_clock>;
+template class IngestLimiter<std::chrono::steady_clock>;
+
+}  // namespace protocol::ratelimit
@@ -0,0 +1,179 @@
+#include "sector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace protocol::sector {
+
+namespace {
+
+constexpr double kMinSectorDeg = 1e-5;
+
+/// Sector holding `v`, clamped to [0, n); NaN lands in 0, never in the cast.
+[[nodiscard]] auto index_of(double v, double lo, double deg, std::uint32_t n) noexcept -> std::uint32_t {
+    const auto i = std::floor((v - lo) / deg);
+    return i > 0.0 ? static_cast<std::uint32_t>(std::min(i, static_cast<double>(n - 1))) : 0;
+}
+
+[[nodiscard]] auto class_of(Urgency u) noexcept -> std::size_t {
+    return std::min(static_cast<std::size_t>(u), kClasses - 1);
+}
+
+[[nodiscard]] auto idle(const std::array<std::uint32_t, kClasses>& tracks, std::uint32_t reports) noexcept -> bool {
+    return reports == 0 && std::all_of(tracks.begin(), tracks.end(), [](std::uint32_t n) { return n == 0; });
+}
+
+}  // namespace
+
+SectorGrid::SectorGrid(const SectorConfig& cfg) : cfg_{cfg} {
+    cfg_.sector_deg = std::clamp(cfg.sector_deg, kMinSectorDeg, 180.0);
+    cols_ = static_cast<std::uint32_t>(std::ceil(360.0 / cfg_.sector_deg));
+    rows_ = static_cast<std::uint32_t>(std::ceil(180.0 / cfg_.sector_deg));
+    const auto window_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(cfg.window).count();
+    bucket_ns_ = std::max<std::int64_t>(window_ns / static_cast<std::int64_t>(kBuckets), 1);
+}
+
+auto SectorGrid::col_of(double lon) const noexcept -> std::uint32_t {
+    return index_of(lon, -180.0, cfg_.sector_deg, cols_);
+}
+
+auto SectorGrid::row_of(double lat) const noexcept -> std::uint32_t {
+    return index_of(lat, -90.0, cfg_.sector_deg, rows_);
+}
+
+auto SectorGrid::bucket_of(std::int64_t now_ns) const noexcept -> std::int64_t {
+    return std::max<std::int64_t>(now_ns, 0) / bucket_ns_;
+}
+
+void SectorGrid::roll(Counters& c, std::int64_t bucket) noexcept {
+    if (bucket <= c.bucket) {
+        return;
+    }
+    // Buckets that fell out of the window leave the running sum
+    const auto steps = std::min(bucket - c.bucket, static_cast<std::int64_t>(kBuckets));
+    for (std::int64_t s = 1; s <= steps; ++s) {
+        auto& n = c.buckets[static_cast<std::size_t>(c.bucket + s) % kBuckets];
+        c.reports -= n;
+        n = 0;
+    }
+    c.bucket = bucket;
+}
+
+void SectorGrid::update(const TrackUpdate& t, std::int64_t now_ns) {
+    ++stats_.updates;
+    const auto key = (std::uint64_t{col_of(t.lon)} << 32) | row_of(t.lat);
+    const auto cls = class_of(t.urgency);
+    auto [it, inserted] = tracks_.try_emplace(t.target_id);
+    auto& held = it->second;
+    const auto changed = inserted || held.key != key || held.cls != cls;
+    if (!inserted && changed) {
+        // A sector holding tracks is never pruned
+        --sectors_.find(held.key)->second.tracks[held.cls];
+        if (held.key != key) {
+            ++stats_.moves;
+        }
+    }
+    auto& c = sectors_[key];
+    if (changed) {
+        ++c.tracks[cls];
+    }
+    // A report behind the sector's newest bucket counts in the newest
+    roll(c, bucket_of(now_ns));
+    ++c.buckets[static_cast<std::size_t>(c.bucket) % kBuckets];
+    ++c.reports;
+    held = Held{key, cls};
+}
+
+void SectorGrid::remove(std::uint64_t target_id) {
+    const auto it = tracks_.find(target_id);
+    if (it == tracks_.end()) {
+        return;
+    }
+    --sectors_.find(it->second.key)->second.tracks[it->second.cls];
+    tracks_.erase(it);
+}
+
+auto SectorGrid::make_sector(std::uint64_t key, const Counters& c) -> Sector {
+    Sector s;
+    s.x = static_cast<std::uint32_t>(key >> 32);
+    s.y = static_cast<std::uint32_t>(key);
+    s.tracks = c.tracks;
+    s.reports = c.reports;
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+        s.buckets[i] = c.buckets[(static_cast<std::size_t>(c.bucket) + kBuckets - i) % kBuckets];
+    }
+    return s;
+}
+
+auto SectorGrid::report(const lod::Viewport& area, std::int64_t now_ns) -> Report {
+    Report rep;
+    rep.sector_deg = cfg_.sector_deg;
+    rep.window = cfg_.window;
+    ++stats_.reports;
+
+    const auto x0 = col_of(area.lon_min), x1 = col_of(area.lon_max);
+    const auto y0 = row_of(area.lat_min), y1 = row_of(area.lat_max);
+    const auto cols = std::uint64_t{x1} - x0 + 1, rows = std::uint64_t{y1} - y0 + 1;
+
+    // Bin the raster until it fits kMaxHeatCells
+    auto& heat = rep.heat;
+    heat.stride = std::max<std::uint32_t>(1, static_cast<std::uint32_t>(std::sqrt(
+        static_cast<double>(cols * rows) / static_cast<double>(kMaxHeatCells))));
+    while (((cols + heat.stride - 1) / heat.stride) * ((rows + heat.stride - 1) / heat.stride) > kMaxHeatCells) {
+        ++heat.stride;
+    }
+    heat.x0 = x0;
+    heat.y0 = y0;
+    heat.cols = static_cast<std::uint32_t>((cols + heat.stride - 1) / heat.stride);
+    heat.rows = static_cast<std::uint32_t>((rows + heat.stride - 1) / heat.stride);
+    heat.cells.assign(std::size_t{heat.cols} * heat.rows, 0);
+
+    const auto bucket = bucket_of(now_ns);
+    const auto visit = [&](std::uint64_t key, Counters& c) {
+        roll(c, bucket);
+        if (idle(c.tracks, c.reports)) {
+            return;
+        }
+        rep.sectors.push_back(make_sector(key, c));
+        const auto& s = rep.sectors.back();
+        heat.cells[std::size_t{(s.y - y0) / heat.stride} * heat.cols + (s.x - x0) / heat.stride] += c.reports;
+    };
+    // Probe the sectors under the area when there are fewer of them than
+    // occupied sectors, else scan the occupied ones
+    if (cols * rows < sectors_.size()) {
+        for (auto y = y0; y <= y1; ++y) {
+            for (auto x = x0; x <= x1; ++x) {
+                const auto key = (std::uint64_t{x} << 32) | y;
+                if (const auto it = sectors_.find(key); it != sectors_.end()) {
+                    visit(key, it->second);
+                }
+            }
+        }
+        return rep;
+    }
+    for (auto& [key, c] : sectors_) {
+        const auto x = static_cast<std::uint32_t>(key >> 32), y = static_cast<std::uint32_t>(key);
+        if (x0 <= x && x <= x1 && y0 <= y && y <= y1) {
+            visit(key, c);
+        }
+    }
+    return rep;
+}
+
+void SectorGrid::prune(std::int64_t now_ns) {
+    const auto bucket = bucket_of(now_ns);
+    for (auto it = sectors_.begin(); it != sectors_.end();) {
+        roll(it->second, bucket);
+        it = idle(it->second.tracks, it->second.reports) ? sectors_.erase(it) : std::next(it);
+    }
+}
+
+auto SectorGrid::stats() const noexcept -> SectorStats {
+    auto out = stats_;
+    out.tracks = tracks_.size();
+    out.sectors = sectors_.size();
+    return out;
+}
+
+}  // namespace protocol::sector
@@ -0,0 +1,131 @@
+#include "send_rate.hpp"
+
+#include <algorithm>
+
+namespace protocol::ratelimit {
+
+SendRateController::SendRateController(SendRateConfig cfg, clock::time_point now)
+    : cfg_{std::move(cfg)}
+    , batch_{std::max<std::size_t>(cfg_.min_batch, 1)}
+    , period_start_{now}
+{}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ADMISSION
+// ═══════════════════════════════════════════════════════════════════════════
+
+auto SendRateController::admit(std::uint64_t key, Urgency urgency,
+                               clock::time_point now) -> clock::time_point {
+    auto& pace = pace_[key];
+    if (pace.last_report != clock::time_point{}) {
+        const auto gap = now - pace.last_report;
+        pace.interval = pace.interval == clock::duration::zero() ? gap : (pace.interval * 3 + gap) / 4;
+    }
+    pace.last_report = now;
+
+    // Full rate, critical or never sent — due at once
+    const auto div = divisor();
+    if (div == 1 || urgency == Urgency::Red || !pace.sent) {
+        return now;
+    }
+    return pace.last_sent + pace.interval * static_cast<clock::duration::rep>(div);
+}
+
+void SendRateController::on_sent(std::uint64_t key, clock::time_point now) {
+    auto& pace = pace_[key];
+    pace.last_sent = now;
+    pace.sent = true;
+    ++admitted_;
+    ++period_admitted_;
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FEEDBACK
+// ═══════════════════════════════════════════════════════════════════════════
+
+void SendRateController::on_write(std::size_t bytes, std::size_t updates,
+                                  clock::duration elapsed) {
+    const std::chrono::duration<double> secs = elapsed;
+    const double a = cfg_.ewma_alpha;
+
+    // Guard against sub-microsecond completions (kernel buffer had room)
+    const double sample_bps = static_cast<double>(bytes) / std::max(secs.count(), 1e-6);
+    ewma_bps_ = ewma_bps_ == 0.0 ? sample_bps : (1.0 - a) * ewma_bps_ + a * sample_bps;
+
+    if (updates > 0) {
+        const double per_update = static_cast<double>(bytes) / static_cast<double>(updates);
+        ewma_update_bytes_ = ewma_update_bytes_ == 0.0
+            ? per_update
+            : (1.0 - a) * ewma_update_bytes_ + a * per_update;
+    }
+}
+
+void SendRateController::on_rtt(clock::duration smoothed, clock::duration min_rtt) {
+    const auto scaled = std::chrono::duration_cast<clock::duration>(min_rtt * cfg_.rtt_inflation);
+    const auto threshold = std::max(scaled, min_rtt + cfg_.rtt_slack);
+    rtt_inflated_ = smoothed > threshold;
+}
+
+auto SendRateController::tick(std::size_t queue_depth, clock::time_point now) -> bool {
+    last_depth_ = queue_depth;
+
+    const auto elapsed = now - period_start_;
+    if (elapsed < cfg_.adjust_interval) {
+        return false;
+    }
+
+    const std::chrono::duration<double> secs = elapsed;
+    last_offered_ups_ = static_cast<double>(period_admitted_) / secs.count();
+    period_admitted_ = 0;
+    period_start_ = now;
+
+    const auto target = std::max<std::size_t>(cfg_.target_queue_depth, 2);
+    const double capacity = ewma_update_bytes_ > 0.0 ? ewma_bps_ / ewma_update_bytes_ : 0.0;
+
+    const bool over_depth = queue_depth > target + target / 2;
+    const bool over_capacity = capacity > 0.0 &&
+                               last_offered_ups_ > 0.9 * capacity &&
+                               queue_depth > target / 2;
+    const bool healthy = queue_depth < target / 2 && !rtt_inflated_;
+
+    const auto old_level = level_;
+    const auto old_batch = batch_;
+
+    if (over_depth || over_capacity || rtt_inflated_) {
+        healthy_streak_ = 0;
+        if (level_ + 1 < kRateDivisors.size()) {
+            ++level_;
+        }
+        batch_ = std::min(cfg_.max_batch, batch_ * 2);
+    } else if (healthy) {
+        if (++healthy_streak_ >= cfg_.recover_intervals) {
+            healthy_streak_ = 0;
+            if (level_ > 0) {
+                --level_;
+            }
+            batch_ = std::max(std::max<std::size_t>(cfg_.min_batch, 1), batch_ / 2);
+        }
+    } else {
+        healthy_streak_ = 0;
+    }
+
+    return level_ != old_level || batch_ != old_batch;
+}
+
+auto SendRateController::state() const noexcept -> SendRateState {
+    return SendRateState{
+        .divisor = divisor(),
+        .batch_size = batch_,
+        .throughput_bps = ewma_bps_,
+        .capacity_ups = ewma_update_bytes_ > 0.0 ? ewma_bps_ / ewma_update_bytes_ : 0.0,
+        .offered_ups = last_offered_ups_,
+        .queue_depth = last_depth_,
+        .rtt_inflated = rtt_inflated_,
+        .admitted = admitted_,
+        .decimated = decimated_,
+    };
+}
+
+}  // namespace protocol::ratelimit
@@ -0,0 +1,160 @@
+#include "snapshot.hpp"
+
+#include <exception>
+#include <stdexcept>
+#include <string_view>
+
+#include <fmt/core.h>
+
+#include "link_quality.hpp"
+#include "posix_file.hpp"
+#include "wire.hpp"
+
+namespace protocol {
+
+namespace {
+
+auto elapsed_since(std::chrono::steady_clock::time_point start) -> std::chrono::microseconds {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
+
+}  // namespace
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FILE FORMAT
+// ═══════════════════════════════════════════════════════════════════════════
+
+auto encode_snapshot(std::uint64_t journal_seq,
+                     std::int64_t taken_ns,
+                     std::span<const StoredTrack> tracks) -> std::string {
+    wire::ByteWriter w;
+    w.reserve(kSnapshotHeaderSize + tracks.size() * kSnapshotRecordSize);
+    w.put_u32(kSnapshotMagic);
+    w.put_u16(kSnapshotVersion);
+    w.put_u16(0);
+    w.put_u64(journal_seq);
+    w.put_i64(taken_ns);
+    w.put_u64(tracks.size());
+
+    for (const auto& t : tracks) {
+        w.put_u32(t.origin_node);
+        w.put_u64(t.origin_seq);
+        w.put_i64(t.stored_ns);
+        encode_track(w, t.update);
+    }
+    return std::move(w).take();
+}
+
+auto load_snapshot(const std::filesystem::path& path, TrackStore& store)
+    -> std::optional<SnapshotInfo>
+{
+    const auto start = std::chrono::steady_clock::now();
+    if (!std::filesystem::exists(path)) {
+        return std::nullopt;
+    }
+
+    const auto file = MappedFile::map_read(path);
+    wire::ByteReader r{file.bytes()};
+    const auto magic = r.get_u32();
+    const auto version = r.get_u16();
+    const auto reserved = r.get_bytes(2);
+
+    SnapshotInfo info;
+    info.journal_seq = r.get_u64();
+    info.taken_ns = r.get_i64();
+    const auto count = r.get_u64();
+    if (!r.ok() || magic != kSnapshotMagic || version != kSnapshotVersion || reserved.size() != 2) {
+        throw std::runtime_error{"snapshot " + path.string() + ": bad header"};
+    }
+    if (count > r.remaining() / kSnapshotRecordSize || r.remaining() != count * kSnapshotRecordSize) {
+        throw std::runtime_error{"snapshot " + path.string() + ": size does not match count"};
+    }
+
+    store.reserve(store.size() + static_cast<std::size_t>(count));
+    for (std::uint64_t i = 0; i < count; ++i) {
+        StoredTrack t;
+        t.origin_node = r.get_u32();
+        t.origin_seq = r.get_u64();
+        t.stored_ns = r.get_i64();
+        t.update = decode_track(r);
+        store.restore(t);
+    }
+
+    info.tracks = static_cast<std::size_t>(count);
+    info.bytes = file.size();
+    info.elapsed = elapsed_since(start);
+    return info;
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SNAPSHOT WRITER
+// ═══════════════════════════════════════════════════════════════════════════
+
+SnapshotWriter::SnapshotWriter(SnapshotConfig cfg)
+    : cfg_{std::move(cfg)}
+    , thread_{[this]() { run(); }}
+{}
+
+SnapshotWriter::~SnapshotWriter() {
+    {
+        std::lock_guard lock{mutex_};
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+}
+
+void SnapshotWriter::submit(std::uint64_t journal_seq, std::vector<StoredTrack> tracks) {
+    {
+        std::lock_guard lock{mutex_};
+        pending_ = Job{journal_seq, link::wall_clock_ns(), std::move(tracks)};
+    }
+    cv_.notify_one();
+}
+
+auto SnapshotWriter::last() const -> std::optional<SnapshotInfo> {
+    std::lock_guard lock{mutex_};
+    return last_;
+}
+
+auto SnapshotWriter::busy() const -> bool {
+    std::lock_guard lock{mutex_};
+    return writing_ || pending_.has_value();
+}
+
+void SnapshotWriter::run() {
+    std::unique_lock lock{mutex_};
+    for (;;) {
+        cv_.wait(lock, [this]() { return stopping_ || pending_.has_value(); });
+        if (!pending_) {
+            return;  // Stopping with nothing left to write
+        }
+
+        auto job = std::move(*pending_);
+        pending_.reset();
+        writing_ = true;
+        lock.unlock();
+
+        // Encode and write without holding the lock
+        std::optional<SnapshotInfo> written;
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            const auto image = encode_snapshot(job.journal_seq, job.taken_ns, job.tracks);
+            write_file_atomic(cfg_.path, image);
+            written = SnapshotInfo{job.journal_seq, job.taken_ns, job.tracks.size(),
+                                   image.size(), elapsed_since(start)};
+        } catch (const std::exception& e) {
+            fmt::print(stderr, "[SNAPSHOT] Write {} failed: {}\n", cfg_.path.string(), e.what());
+        }
+
+        lock.lock();
+        writing_ = false;
+        if (written) {
+            last_ = written;
+        }
+    }
+}
+
+}  // namespace protocol
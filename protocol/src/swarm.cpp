@@ -0,0 +1,423 @@
+#include "swarm.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace protocol {
+
+namespace {
+
+constexpr double kEarthRadiusM = 6'371'000.0;
+constexpr double kDegToRad = std::numbers::pi / 180.0;
+
+/// Cell index bits per axis; indices are offset by half the range.
+constexpr int kCellBits = 21;
+constexpr std::int64_t kCellRange = std::int64_t{1} << kCellBits;
+
+/// Smallest cell that still spans the sphere within kCellBits.
+constexpr double kMinCellM = 2.0 * kEarthRadiusM / static_cast<double>(kCellRange - 2);
+
+/// Labels of clusters being rebuilt by the current refresh (index in the
+/// high bit's range, never a published id).
+constexpr std::uint64_t kProvisional = std::uint64_t{1} << 63;
+
+[[nodiscard]] constexpr auto is_provisional(std::uint64_t cluster) noexcept -> bool {
+    return (cluster & kProvisional) != 0;
+}
+
+[[nodiscard]] constexpr auto cell_key(std::int64_t ix, std::int64_t iy, std::int64_t iz) noexcept -> std::uint64_t {
+    return (static_cast<std::uint64_t>(ix) << (2 * kCellBits))
+         | (static_cast<std::uint64_t>(iy) << kCellBits)
+         | static_cast<std::uint64_t>(iz);
+}
+
+[[nodiscard]] constexpr auto cell_axis(std::uint64_t cell, int shift) noexcept -> std::int64_t {
+    return static_cast<std::int64_t>((cell >> shift) & static_cast<std::uint64_t>(kCellRange - 1));
+}
+
+}  // namespace
+
+auto SwarmDetector::cell_of(double x, double y, double z) const noexcept -> std::uint64_t {
+    const auto edge = std::max(cfg_.eps_m, kMinCellM);
+    // Clamped into the index range; NaN lands in 0 rather than in the cast
+    const auto index = [edge](double v) {
+        const auto i = std::floor(v / edge) + static_cast<double>(kCellRange / 2);
+        return i > 0.0 ? static_cast<std::int64_t>(std::min(i, static_cast<double>(kCellRange - 1))) : 0;
+    };
+    return cell_key(index(x), index(y), index(z));
+}
+
+template<typename F>
+void SwarmDetector::for_each_near(std::uint64_t cell, F&& fn) const {
+    const auto ix = cell_axis(cell, 2 * kCellBits);
+    const auto iy = cell_axis(cell, kCellBits);
+    const auto iz = cell_axis(cell, 0);
+    const auto in_range = [](std::int64_t i) { return i >= 0 && i < kCellRange; };
+    for (std::int64_t dz = -1; dz <= 1; ++dz) {
+        for (std::int64_t dy = -1; dy <= 1; ++dy) {
+            for (std::int64_t dx = -1; dx <= 1; ++dx) {
+                if (!in_range(ix + dx) || !in_range(iy + dy) || !in_range(iz + dz)) {
+                    continue;
+                }
+                if (const auto it = cells_.find(cell_key(ix + dx, iy + dy, iz + dz)); it != cells_.end()) {
+                    for (const auto id : it->second) {
+                        fn(id);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template<typename F>
+void SwarmDetector::for_each_neighbour(const Member& m, F&& fn) {
+    const auto eps2 = cfg_.eps_m * cfg_.eps_m;
+    for_each_near(m.cell, [&](std::uint64_t id) {
+        auto& n = tracks_.find(id)->second;
+        const auto dx = n.x - m.x;
+        const auto dy = n.y - m.y;
+        const auto dz = n.z - m.z;
+        if (dx * dx + dy * dy + dz * dz <= eps2) {
+            fn(id, n);
+        }
+    });
+}
+
+void SwarmDetector::update(const TrackUpdate& t) {
+    if (!is_plausible(t)) {
+        return;
+    }
+    ++stats_.updates;
+    // On the sphere, Earth-centred: no anchor, pole or seam
+    const auto lat = t.lat * kDegToRad;
+    const auto lon = t.lon * kDegToRad;
+    const auto x = kEarthRadiusM * std::cos(lat) * std::cos(lon);
+    const auto y = kEarthRadiusM * std::cos(lat) * std::sin(lon);
+    const auto z = kEarthRadiusM * std::sin(lat);
+    const auto cell = cell_of(x, y, z);
+
+    auto [it, inserted] = tracks_.try_emplace(t.target_id);
+    auto& m = it->second;
+    if (inserted) {
+        cells_[cell].push_back(t.target_id);
+        expiry_.emplace(t.time_ns, t.target_id);
+    } else {
+        if (t.time_ns < m.time_ns) {
+            return;
+        }
+        touched_cells_.push_back(m.cell);
+        if (m.cell != cell) {
+            auto& old = cells_[m.cell];
+            std::erase(old, t.target_id);
+            if (old.empty()) {
+                cells_.erase(m.cell);
+            }
+            cells_[cell].push_back(t.target_id);
+        }
+    }
+    m.x = x;
+    m.y = y;
+    m.z = z;
+    m.alt = t.alt;
+    m.vn = t.vn;
+    m.ve = t.ve;
+    m.vu = t.vu;
+    m.time_ns = t.time_ns;
+    m.cell = cell;
+    touched_cells_.push_back(cell);
+}
+
+void SwarmDetector::remove_track(std::uint64_t id) {
+    const auto it = tracks_.find(id);
+    const auto& m = it->second;
+    touched_cells_.push_back(m.cell);
+    auto& cell = cells_[m.cell];
+    std::erase(cell, id);
+    if (cell.empty()) {
+        cells_.erase(m.cell);
+    }
+    if (m.cluster != 0) {
+        orphaned_clusters_.push_back(m.cluster);
+    }
+    tracks_.erase(it);
+}
+
+void SwarmDetector::dissolve(std::uint64_t cluster, std::vector<std::uint64_t>& pool) {
+    const auto it = clusters_.find(cluster);
+    if (it == clusters_.end()) {
+        return;
+    }
+    for (const auto id : it->second) {
+        // Members that expired since are gone from tracks_
+        if (auto t = tracks_.find(id); t != tracks_.end() && t->second.cluster == cluster) {
+            t->second.cluster = 0;
+            t->second.previous = cluster;
+            t->second.mark = epoch_;
+            pool.push_back(id);
+        }
+    }
+    clusters_.erase(it);
+}
+
+auto SwarmDetector::refresh(std::int64_t now_ns) -> SwarmDelta {
+    ++stats_.refreshes;
+    SwarmDelta delta;
+
+    // 1. Expire (one heap entry per track; a refreshed one goes back in)
+    const auto cutoff = now_ns - std::chrono::duration_cast<std::chrono::nanoseconds>(cfg_.max_age).count();
+    while (!expiry_.empty() && expiry_.top().first < cutoff) {
+        const auto id = expiry_.top().second;
+        expiry_.pop();
+        if (const auto it = tracks_.find(id); it != tracks_.end()) {
+            if (it->second.time_ns < cutoff) {
+                remove_track(id);
+            } else {
+                expiry_.emplace(it->second.time_ns, id);
+            }
+        }
+    }
+    if (touched_cells_.empty() && orphaned_clusters_.empty()) {
+        return delta;
+    }
+
+    // 2. Recount neighbours around every touched cell
+    std::sort(touched_cells_.begin(), touched_cells_.end());
+    touched_cells_.erase(std::unique(touched_cells_.begin(), touched_cells_.end()), touched_cells_.end());
+    std::vector<std::uint64_t> dirty;
+    ++epoch_;
+    for (const auto cell : touched_cells_) {
+        for_each_near(cell, [&](std::uint64_t id) {
+            auto& m = tracks_.find(id)->second;
+            if (m.mark != epoch_) {
+                m.mark = epoch_;
+                dirty.push_back(id);
+            }
+        });
+    }
+    touched_cells_.clear();
+    for (const auto id : dirty) {
+        auto& m = tracks_.find(id)->second;
+        std::uint32_t n = 0;
+        for_each_neighbour(m, [&](std::uint64_t, Member&) { ++n; });
+        m.neighbours = n;
+    }
+    stats_.reevaluated += dirty.size();
+
+    // 3. Dissolve every cluster that may have changed; its members and
+    //    the dirty noise tracks form the pool to relabel
+    std::vector<std::uint64_t> pool;
+    std::vector<std::uint64_t> gone;
+    ++epoch_;
+    const auto dissolve_into_pool = [&](std::uint64_t cluster) {
+        if (clusters_.contains(cluster)) {
+            gone.push_back(cluster);
+            dissolve(cluster, pool);
+        }
+    };
+    for (const auto cluster : orphaned_clusters_) {
+        dissolve_into_pool(cluster);
+    }
+    orphaned_clusters_.clear();
+    for (const auto id : dirty) {
+        if (const auto cluster = tracks_.find(id)->second.cluster; cluster != 0) {
+            dissolve_into_pool(cluster);
+        }
+    }
+    for (const auto id : dirty) {
+        auto& m = tracks_.find(id)->second;
+        if (m.mark != epoch_) {
+            m.mark = epoch_;
+            m.previous = 0;
+            pool.push_back(id);
+        }
+    }
+
+    // 4. Flood from the pool's cores. Reaching a core of a cluster still
+    //    standing means the two have merged: dissolve it into the flood.
+    std::vector<std::vector<std::uint64_t>> built;
+    std::vector<std::uint64_t> stack;
+    for (std::size_t i = 0; i < pool.size(); ++i) {
+        const auto seed_id = pool[i];
+        auto& seed = tracks_.find(seed_id)->second;
+        if (seed.cluster != 0 || !is_core(seed)) {
+            continue;
+        }
+        const auto label = kProvisional | built.size();
+        built.emplace_back();
+        auto& members = built.back();
+        seed.cluster = label;
+        members.push_back(seed_id);
+        stack.assign(1, seed_id);
+        while (!stack.empty()) {
+            const auto id = stack.back();
+            stack.pop_back();
+            for_each_neighbour(tracks_.find(id)->second, [&](std::uint64_t nid, Member& n) {
+                if (n.cluster == label) {
+                    return;
+                }
+                if (n.cluster != 0) {
+                    if (!is_core(n) || is_provisional(n.cluster)) {
+                        return;  // A border already claimed
+                    }
+                    gone.push_back(n.cluster);
+                    dissolve(n.cluster, pool);
+                }
+                n.cluster = label;
+                members.push_back(nid);
+                if (is_core(n)) {
+                    stack.push_back(nid);
+                }
+            });
+        }
+    }
+
+    // 5. Unclaimed non-cores next to a core become its borders
+    std::vector<std::uint64_t> grown;
+    for (const auto id : pool) {
+        auto& m = tracks_.find(id)->second;
+        if (m.cluster != 0 || is_core(m)) {
+            continue;
+        }
+        for_each_neighbour(m, [&](std::uint64_t, Member& n) {
+            if (m.cluster == 0 && n.cluster != 0 && is_core(n)) {
+                m.cluster = n.cluster;
+            }
+        });
+        if (m.cluster == 0) {
+            continue;
+        }
+        if (is_provisional(m.cluster)) {
+            built[m.cluster & ~kProvisional].push_back(id);
+        } else {
+            clusters_[m.cluster].push_back(id);
+            grown.push_back(m.cluster);
+        }
+    }
+
+    // 6. Name rebuilt clusters, largest first, after the dissolved cluster
+    //    most of their members came from
+    std::sort(gone.begin(), gone.end());
+    gone.erase(std::unique(gone.begin(), gone.end()), gone.end());
+    std::vector<bool> claimed(gone.size(), false);
+    std::vector<std::size_t> order(built.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return built[a].size() > built[b].size();
+    });
+    std::unordered_map<std::uint64_t, std::size_t> votes;
+    for (const auto b : order) {
+        auto& members = built[b];
+        votes.clear();
+        for (const auto id : members) {
+            const auto& m = tracks_.find(id)->second;
+            if (m.mark == epoch_ && m.previous != 0) {
+                ++votes[m.previous];
+            }
+        }
+        std::uint64_t id = 0;
+        std::size_t best = 0;
+        for (const auto& [previous, count] : votes) {
+            const auto g = std::lower_bound(gone.begin(), gone.end(), previous);
+            const auto slot = static_cast<std::size_t>(g - gone.begin());
+            if (g != gone.end() && *g == previous && !claimed[slot]
+                && (count > best || (count == best && previous < id))) {
+                id = previous;
+                best = count;
+            }
+        }
+        if (id != 0) {
+            claimed[static_cast<std::size_t>(
+                std::lower_bound(gone.begin(), gone.end(), id) - gone.begin())] = true;
+        } else {
+            id = next_id_++;
+        }
+        for (const auto member : members) {
+            tracks_.find(member)->second.cluster = id;
+        }
+        delta.updated.push_back(summarize(id, members));
+        clusters_.insert_or_assign(id, std::move(members));
+    }
+    stats_.reclustered += pool.size();
+
+    std::sort(grown.begin(), grown.end());
+    grown.erase(std::unique(grown.begin(), grown.end()), grown.end());
+    for (const auto id : grown) {
+        delta.updated.push_back(summarize(id, clusters_.at(id)));
+    }
+    for (std::size_t i = 0; i < gone.size(); ++i) {
+        if (!claimed[i]) {
+            delta.dissolved.push_back(gone[i]);
+        }
+    }
+    return delta;
+}
+
+auto SwarmDetector::summarize(std::uint64_t id, const std::vector<std::uint64_t>& members) const
+    -> SwarmSummary
+{
+    SwarmSummary s;
+    s.id = id;
+    double alt = 0.0, x = 0.0, y = 0.0, z = 0.0, vn = 0.0, ve = 0.0, vu = 0.0;
+    std::vector<const Member*> live;
+    live.reserve(members.size());
+    for (const auto member : members) {
+        if (const auto it = tracks_.find(member); it != tracks_.end() && it->second.cluster == id) {
+            const auto& m = it->second;
+            live.push_back(&m);
+            alt += static_cast<double>(m.alt);
+            x += m.x;
+            y += m.y;
+            z += m.z;
+            vn += static_cast<double>(m.vn);
+            ve += static_cast<double>(m.ve);
+            vu += static_cast<double>(m.vu);
+        }
+    }
+    if (live.empty()) {
+        return s;
+    }
+    const auto n = static_cast<double>(live.size());
+    s.members = static_cast<std::uint32_t>(live.size());
+    // Centroid back to degrees from the Earth-centred mean (no seam)
+    const auto cx = x / n;
+    const auto cy = y / n;
+    const auto cz = z / n;
+    s.lat = std::atan2(cz, std::hypot(cx, cy)) / kDegToRad;
+    s.lon = std::atan2(cy, cx) / kDegToRad;
+    s.alt = static_cast<float>(alt / n);
+    s.vn = static_cast<float>(vn / n);
+    s.ve = static_cast<float>(ve / n);
+    s.vu = static_cast<float>(vu / n);
+    for (const auto* m : live) {
+        s.radius_m = std::max(s.radius_m, static_cast<float>(std::hypot(m->x - cx, m->y - cy, m->z - cz)));
+    }
+    return s;
+}
+
+auto SwarmDetector::summaries() const -> std::vector<SwarmSummary> {
+    std::vector<SwarmSummary> out;
+    out.reserve(clusters_.size());
+    for (const auto& [id, members] : clusters_) {
+        out.push_back(summarize(id, members));
+    }
+    return out;
+}
+
+auto SwarmDetector::swarm_of(std::uint64_t target_id) const -> std::optional<std::uint64_t> {
+    if (const auto it = tracks_.find(target_id); it != tracks_.end() && it->second.cluster != 0) {
+        return it->second.cluster;
+    }
+    return std::nullopt;
+}
+
+auto SwarmDetector::stats() const noexcept -> SwarmStats {
+    auto out = stats_;
+    out.tracks = tracks_.size();
+    out.swarms = clusters_.size();
+    return out;
+}
+
+}  // namespace protocol
@@ -0,0 +1,254 @@
+#include "task_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include <fmt/core.h>
+
+namespace protocol::exec {
+
+// Explicit template instantiation for the deque used by the pool
+template class ChaseLevDeque<TaskPool::TaskNode*>;
+
+thread_local TaskPool* TaskPool::tl_pool_ = nullptr;
+thread_local std::size_t TaskPool::tl_index_ = 0;
+
+namespace {
+
+/// xorshift64 — cheap per-worker victim selection.
+auto next_random(std::uint64_t& state) noexcept -> std::uint64_t {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+}  // namespace
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TASK POOL LIFECYCLE
+// ═══════════════════════════════════════════════════════════════════════════
+
+TaskPool::TaskPool(std::size_t threads) {
+    if (threads == 0) {
+        threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    workers_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->rng_state = 0x9E3779B97F4A7C15ULL ^ (i + 1);
+        workers_.push_back(std::move(worker));
+    }
+
+    // Start threads only after every deque exists (thieves scan all workers)
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers_[i]->thread = std::thread([this, i] { worker_loop(i); });
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard lock{sleep_mutex_};
+        stopping_.store(true, std::memory_order_release);
+    }
+    sleep_cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+
+    // Discard tasks that never started
+    for (auto& worker : workers_) {
+        while (auto node = worker->deque.pop()) {
+            delete *node;
+        }
+    }
+    for (auto* node : inject_) {
+        delete node;
+    }
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SUBMISSION
+// ═══════════════════════════════════════════════════════════════════════════
+
+void TaskPool::submit(Task task) {
+    auto* node = new TaskNode{std::move(task)};
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+
+    // Count before publishing so a fast thief never drives pending_ below zero
+    pending_.fetch_add(1, std::memory_order_seq_cst);
+
+    if (tl_pool_ == this) {
+        // Worker-local fork — cheapest path, no shared lock
+        workers_[tl_index_]->deque.push(node);
+    } else {
+        std::lock_guard lock{inject_mutex_};
+        inject_.push_back(node);
+    }
+
+    notify_one();
+}
+
+void TaskPool::notify_one() {
+    // Pairs with the sleepers_ increment in worker_loop: either the sleeper
+    // observes pending_ > 0 or we observe the sleeper and wake it.
+    if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+        { std::lock_guard lock{sleep_mutex_}; }
+        sleep_cv_.notify_one();
+    }
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// WORKER LOOP
+// ═══════════════════════════════════════════════════════════════════════════
+
+void TaskPool::worker_loop(std::size_t index) {
+    tl_pool_ = this;
+    tl_index_ = index;
+
+    while (!stopping_.load(std::memory_order_acquire)) {
+        if (auto* node = find_task(index)) {
+            execute(node);
+            continue;
+        }
+
+        std::unique_lock lock{sleep_mutex_};
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        sleep_cv_.wait(lock, [this] {
+            return stopping_.load(std::memory_order_acquire) ||
+                   pending_.load(std::memory_order_seq_cst) > 0;
+        });
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    tl_pool_ = nullptr;
+}
+
+auto TaskPool::find_task(std::size_t index) -> TaskNode* {
+    auto& self = *workers_[index];
+
+    // 1. Own deque (LIFO — most recently forked, still in cache)
+    if (auto node = self.deque.pop()) {
+        return *node;
+    }
+
+    // 2. Inject queue (submissions from I/O threads)
+    {
+        std::lock_guard lock{inject_mutex_};
+        if (!inject_.empty()) {
+            auto* node = inject_.front();
+            inject_.pop_front();
+            return node;
+        }
+    }
+
+    // 3. Steal from a random victim, then sweep the rest
+    const auto n = workers_.size();
+    if (n > 1) {
+        const auto start = static_cast<std::size_t>(next_random(self.rng_state) % n);
+        for (std::size_t k = 0; k < n; ++k) {
+            const auto victim = (start + k) % n;
+            if (victim == index) {
+                continue;
+            }
+            if (auto node = workers_[victim]->deque.steal()) {
+                stolen_.fetch_add(1, std::memory_order_relaxed);
+                return *node;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+void TaskPool::execute(TaskNode* node) noexcept {
+    pending_.fetch_sub(1, std::memory_order_relaxed);
+
+    try {
+        node->fn();
+    } catch (const std::exception& e) {
+        fmt::print("[POOL] Task exception: {}\n", e.what());
+    } catch (...) {
+        fmt::print("[POOL] Task exception: unknown\n");
+    }
+
+    delete node;
+    executed_.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto TaskPool::try_run_one() -> bool {
+    TaskNode* node = nullptr;
+
+    if (tl_pool_ == this) {
+        node = find_task(tl_index_);
+    } else {
+        std::lock_guard lock{inject_mutex_};
+        if (!inject_.empty()) {
+            node = inject_.front();
+            inject_.pop_front();
+        }
+    }
+
+    if (node == nullptr) {
+        return false;
+    }
+    execute(node);
+    return true;
+}
+
+auto TaskPool::stats() const noexcept -> PoolStats {
+    return PoolStats{
+        .workers = workers_.size(),
+        .submitted = submitted_.load(std::memory_order_relaxed),
+        .executed = executed_.load(std::memory_order_relaxed),
+        .stolen = stolen_.load(std::memory_order_relaxed),
+    };
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TASK GROUP
+// ═══════════════════════════════════════════════════════════════════════════
+
+void TaskGroup::finish_one() {
+    // Decrement under the lock so wait() cannot return (and destroy the
+    // group) while this child still touches mutex_ or done_cv_.
+    std::lock_guard lock{mutex_};
+    if (outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        done_cv_.notify_all();
+    }
+}
+
+void TaskGroup::wait() {
+    if (pool_.is_worker_thread()) {
+        // Helping join — keep the worker busy instead of parking it
+        while (outstanding_.load(std::memory_order_acquire) > 0) {
+            if (!pool_.try_run_one()) {
+                std::this_thread::yield();
+            }
+        }
+    } else {
+        std::unique_lock lock{mutex_};
+        done_cv_.wait(lock, [this] {
+            return outstanding_.load(std::memory_order_acquire) == 0;
+        });
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard lock{mutex_};
+        error = std::exchange(error_, nullptr);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+}  // namespace protocol::exec
@@ -0,0 +1,45 @@
+#include "track_store.hpp"
+
+namespace protocol {
+
+auto TrackStore::apply(const TrackUpdate& update,
+                       std::uint32_t origin_node,
+                       std::uint64_t origin_seq,
+                       std::int64_t now_ns) -> bool {
+    auto [it, inserted] = tracks_.try_emplace(update.target_id);
+    if (!inserted && it->second.update.time_ns > update.time_ns) {
+        return false;  // Stale — a newer report already arrived
+    }
+    it->second = StoredTrack{update, origin_node, origin_seq, now_ns};
+    if (on_apply_) {
+        on_apply_(it->second);
+    }
+    return true;
+}
+
+auto TrackStore::find(std::uint64_t target_id) const -> const StoredTrack* {
+    const auto it = tracks_.find(target_id);
+    return it == tracks_.end() ? nullptr : &it->second;
+}
+
+auto TrackStore::snapshot(std::optional<std::uint32_t> origin) const -> std::vector<TrackUpdate> {
+    std::vector<TrackUpdate> out;
+    out.reserve(tracks_.size());
+    for (const auto& [id, track] : tracks_) {
+        if (!origin || track.origin_node == *origin) {
+            out.push_back(track.update);
+        }
+    }
+    return out;
+}
+
+auto TrackStore::stored() const -> std::vector<StoredTrack> {
+    std::vector<StoredTrack> out;
+    out.reserve(tracks_.size());
+    for (const auto& [id, track] : tracks_) {
+        out.push_back(track);
+    }
+    return out;
+}
+
+}  // namespace protocol
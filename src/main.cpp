@@ -11,6 +11,7 @@
 #include "ws_server.hpp"
 #include "ws_client.hpp"
 #include "svc_addr_config.hpp"
+#include "svc_cluster_config.hpp"
 
 namespace {
 
@@ -99,7 +100,7 @@ private:
         try {
             boost::asio::io_context ioc{1};
             
-            auto cfg = svckit::AddrConfig::from_env_defaults("0.0.0.0", 8443);
+            auto cfg = svckit::AddrConfig::from_env_defaults("0.0.0.0", svckit::env_port(8443));
             
             // Create server using factory (demonstrates perfect forwarding)
             auto server = ws::WSServer::create(ioc, cfg);
@@ -121,7 +122,7 @@ private:
         try {
             boost::asio::io_context ioc{1};
             
-            auto cfg = svckit::AddrConfig::from_env_defaults("localhost", 8443);
+            auto cfg = svckit::AddrConfig::from_env_defaults("localhost", svckit::env_port(8443));
             
             // Create client using factory
             auto client = ws::WSClient::create(ioc, cfg);
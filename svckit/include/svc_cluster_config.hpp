@@ -0,0 +1,165 @@
+#pragma once
+
+/// @file svc_cluster_config.hpp
+/// @brief Cluster membership configuration for multi-node server deployments.
+///
+/// Environment variables (all optional):
+/// - WS_PORT     — listen port (default supplied by caller)
+/// - WS_NODE_ID  — this node's id, unique within the cluster (default 1)
+/// - WS_PEERS    — comma-separated host:port list of the other nodes
+/// - WS_SHARDED  — 1 to shard targets by consistent hashing instead of
+///                 replicating every target to every node (default 0)
+/// - WS_VNODES   — virtual nodes per server on the hash ring (default 64)
+///
+/// @par Example (three nodes on loopback)
+/// @code
+/// WS_PORT=8443 WS_NODE_ID=1 WS_PEERS=localhost:8444,localhost:8445 ./ws-server
+/// WS_PORT=8444 WS_NODE_ID=2 WS_PEERS=localhost:8443,localhost:8445 ./ws-server
+/// WS_PORT=8445 WS_NODE_ID=3 WS_PEERS=localhost:8443,localhost:8444 ./ws-server
+/// @endcode
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "svc_addr_config.hpp"
+
+namespace svckit {
+
+// ───────────────────────────────────────────────────────────────────────────
+// Environment Helpers
+// ───────────────────────────────────────────────────────────────────────────
+
+/// Read an unsigned integer from the environment, or `fallback`.
+template<typename T>
+[[nodiscard]] inline auto env_unsigned(const char* name, T fallback) -> T {
+    const char* env = std::getenv(name);
+    if (!env || !*env) {
+        return fallback;
+    }
+    T value{};
+    const std::string_view sv{env};
+    const auto [ptr, ec] = std::from_chars(sv.data(), sv.data() + sv.size(), value);
+    return (ec == std::errc{} && ptr == sv.data() + sv.size()) ? value : fallback;
+}
+
+/// Listen/connect port from WS_PORT, or `fallback`.
+[[nodiscard]] inline auto env_port(std::uint16_t fallback) -> std::uint16_t {
+    return env_unsigned<std::uint16_t>("WS_PORT", fallback);
+}
+
+/// Parse "host:port,host:port" (malformed items skipped). TLS from the environment.
+[[nodiscard]] inline auto parse_addr_list(std::string_view list) -> std::vector<AddrConfig> {
+    std::vector<AddrConfig> out;
+    while (!list.empty()) {
+        const auto comma = list.find(',');
+        const auto item = list.substr(0, comma);
+        list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+
+        const auto colon = item.rfind(':');
+        if (colon == std::string_view::npos || colon == 0) {
+            continue;
+        }
+        std::uint16_t port = 0;
+        const auto port_sv = item.substr(colon + 1);
+        const auto [ptr, ec] = std::from_chars(port_sv.data(), port_sv.data() + port_sv.size(), port);
+        if (ec != std::errc{} || ptr != port_sv.data() + port_sv.size()) {
+            continue;
+        }
+        out.push_back(AddrConfig::from_env_defaults(std::string{item.substr(0, colon)}, port));
+    }
+    return out;
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ClusterConfig — Trivial Class Pattern with Builder Methods
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Contains a vector of AddrConfig (value types) and an integer id
+// • No unique resources — compiler-generated operations are correct
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// This node's identity and the peers it replicates to.
+class ClusterConfig {
+public:
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: All Defaulted
+    // ───────────────────────────────────────────────────────────────────────
+
+    ClusterConfig() = default;
+    ~ClusterConfig() = default;
+    ClusterConfig(const ClusterConfig&) = default;
+    ClusterConfig& operator=(const ClusterConfig&) = default;
+    ClusterConfig(ClusterConfig&&) noexcept = default;
+    ClusterConfig& operator=(ClusterConfig&&) noexcept = default;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Factory Methods
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Build from WS_NODE_ID / WS_PEERS. Peers use TlsConfig::from_env().
+    [[nodiscard]] static auto from_env() -> ClusterConfig {
+        ClusterConfig cfg;
+        cfg.node_id_ = env_unsigned<std::uint32_t>("WS_NODE_ID", 1);
+        cfg.sharded_ = env_unsigned<unsigned>("WS_SHARDED", 0) != 0;
+        cfg.virtual_nodes_ = env_unsigned<std::size_t>("WS_VNODES", cfg.virtual_nodes_);
+
+        const char* env = std::getenv("WS_PEERS");
+        cfg.peers_ = parse_addr_list(env ? env : "");
+        return cfg;
+    }
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Builder Methods
+    // ───────────────────────────────────────────────────────────────────────
+
+    [[nodiscard]] auto with_node_id(std::uint32_t id) && -> ClusterConfig {
+        node_id_ = id;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_peer(AddrConfig peer) && -> ClusterConfig {
+        peers_.push_back(std::move(peer));
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_sharding(bool on) && -> ClusterConfig {
+        sharded_ = on;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_virtual_nodes(std::size_t n) && -> ClusterConfig {
+        virtual_nodes_ = n;
+        return std::move(*this);
+    }
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Accessors
+    // ───────────────────────────────────────────────────────────────────────
+
+    [[nodiscard]] auto node_id() const noexcept -> std::uint32_t { return node_id_; }
+    [[nodiscard]] auto peers() const noexcept -> const std::vector<AddrConfig>& { return peers_; }
+
+    /// True when at least one peer is configured.
+    [[nodiscard]] auto clustered() const noexcept -> bool { return !peers_.empty(); }
+
+    /// True when targets are owned by one node each (consistent hashing).
+    [[nodiscard]] auto sharded() const noexcept -> bool { return sharded_; }
+    [[nodiscard]] auto virtual_nodes() const noexcept -> std::size_t { return virtual_nodes_; }
+
+private:
+    std::uint32_t node_id_{1};
+    bool sharded_{false};
+    std::size_t virtual_nodes_{64};
+    std::vector<AddrConfig> peers_;
+};
+
+}  // namespace svckit
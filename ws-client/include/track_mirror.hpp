@@ -0,0 +1,258 @@
+#pragma once
+
+/// @file track_mirror.hpp
+/// @brief Client-side copy of the server's track table (snapshot + deltas).
+///
+/// The client subscribes in mirror mode (mirror.hpp): it receives a
+/// TrackSnapshot frame set, then sequenced TrackBatch and TrackDrop frames, and
+/// applies each update in place — one hash lookup and one row write,
+/// however many targets are held.
+///
+/// Rows are stored as a structure of arrays (one column per field) so a
+/// UI pass over positions or urgencies streams through contiguous memory.
+/// Removal swaps the last row into the hole.
+///
+/// @par Left-Right Publication
+/// Two copies of the table are kept. Readers (any thread) use the front
+/// copy and announce themselves in that side's reader count; the I/O
+/// thread applies a frame's updates to the back copy, swaps, and replays
+/// them on the new back copy at the next publish. Readers never wait and
+/// never see a half-applied frame; the writer never waits either — when a
+/// reader is still on the back copy from before the last swap, the
+/// publish is deferred to the next frame.
+///
+/// @par Gaps
+/// Every sequenced batch must be the snapshot's sequence + 1, + 2, …. Any
+/// other sequence (a batch lost across a failover, or a server restart)
+/// marks the mirror stale: needs_resync() turns true, the client
+/// subscribes again, and batches are ignored until the new snapshot
+/// replaces the table. Batches without a sequence are applied unchecked.
+///
+/// Demonstrates:
+/// - Structure-of-arrays table with O(1) upsert and swap-remove
+/// - Left-right concurrency control (wait-free reads, non-blocking writer)
+/// - Snapshot + sequenced delta stream with gap detection
+/// - Rule of Six: Non-copyable, non-movable (atomics shared with readers)
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "mirror.hpp"
+#include "protocol.hpp"
+#include "track.hpp"
+
+namespace ws {
+
+// ═══════════════════════════════════════════════════════════════════════════
+// MirrorTable — Structure-of-Arrays Track Table
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Owns vectors and a hash index (value type)
+// • Compiler-generated operations are correct
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// One copy of the mirrored table. Row order is arbitrary.
+class MirrorTable {
+public:
+    // Rule of Six: All Default
+    MirrorTable() = default;
+    ~MirrorTable() = default;
+    MirrorTable(const MirrorTable&) = default;
+    MirrorTable& operator=(const MirrorTable&) = default;
+    MirrorTable(MirrorTable&&) noexcept = default;
+    MirrorTable& operator=(MirrorTable&&) noexcept = default;
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return id_.size(); }
+
+    [[nodiscard]] auto ids() const noexcept -> std::span<const std::uint64_t> { return id_; }
+    [[nodiscard]] auto times() const noexcept -> std::span<const std::int64_t> { return time_ns_; }
+    [[nodiscard]] auto lat() const noexcept -> std::span<const double> { return lat_; }
+    [[nodiscard]] auto lon() const noexcept -> std::span<const double> { return lon_; }
+    [[nodiscard]] auto alt() const noexcept -> std::span<const float> { return alt_; }
+    [[nodiscard]] auto vn() const noexcept -> std::span<const float> { return vn_; }
+    [[nodiscard]] auto ve() const noexcept -> std::span<const float> { return ve_; }
+    [[nodiscard]] auto vu() const noexcept -> std::span<const float> { return vu_; }
+    [[nodiscard]] auto urgency() const noexcept -> std::span<const protocol::Urgency> { return urgency_; }
+
+    /// Row `i` as a record.
+    [[nodiscard]] auto row(std::size_t i) const -> protocol::TrackUpdate;
+
+    /// Latest state of one target, if held.
+    [[nodiscard]] auto find(std::uint64_t target_id) const -> std::optional<protocol::TrackUpdate>;
+
+    /// Insert or refresh a target; returns its row.
+    auto upsert(const protocol::TrackUpdate& t) -> std::size_t;
+
+    /// Overwrite row `i`, known to hold `t.target_id` (no index lookup).
+    void assign(std::size_t i, const protocol::TrackUpdate& t) noexcept;
+
+    void erase(std::uint64_t target_id);
+    void clear() noexcept;
+
+private:
+    std::vector<std::uint64_t> id_;
+    std::vector<std::int64_t> time_ns_;
+    std::vector<double> lat_, lon_;
+    std::vector<float> alt_, vn_, ve_, vu_;
+    std::vector<protocol::Urgency> urgency_;
+
+    /// Target id → row.
+    std::unordered_map<std::uint64_t, std::size_t> index_;
+};
+
+
+/// Mirror counters (writer side).
+struct MirrorStats {
+    std::uint64_t snapshots{0};       ///< Complete snapshots applied
+    std::uint64_t batches{0};         ///< TrackBatch frames applied
+    std::uint64_t updates{0};         ///< Track updates applied
+    std::uint64_t drops{0};           ///< Targets removed by TrackDrop
+    std::uint64_t gaps{0};            ///< Sequence gaps detected
+    std::uint64_t stale{0};           ///< Frames ignored while resyncing
+    std::uint64_t publishes{0};
+    std::uint64_t deferred{0};        ///< Publishes put off by a lingering reader
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TrackMirror — Left-Right Published Mirror
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Readers on other threads hold the atomics and tables by reference
+// • Copy/move: DELETED — share through std::shared_ptr instead
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Track table kept in step with the server's feed.
+///
+/// @par Thread Safety
+/// One writer thread (apply_*, needs_resync, resync_requested, stats);
+/// read() may be called from any number of threads at any time.
+///
+/// @par Example
+/// @code
+/// // UI thread
+/// const auto hostile = mirror->read([](const MirrorTable& t) {
+///     return std::count(t.urgency().begin(), t.urgency().end(), protocol::Urgency::Red);
+/// });
+/// @endcode
+class TrackMirror {
+public:
+    TrackMirror() = default;
+    ~TrackMirror() = default;
+    TrackMirror(const TrackMirror&) = delete;
+    TrackMirror& operator=(const TrackMirror&) = delete;
+    TrackMirror(TrackMirror&&) = delete;
+    TrackMirror& operator=(TrackMirror&&) = delete;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Readers (any thread)
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Call `fn(const MirrorTable&)` on the current table and return its
+    /// result. The table does not change while `fn` runs; keep it short,
+    /// since a long read defers the writer's next publish.
+    template<typename F>
+    auto read(F&& fn) const -> decltype(std::forward<F>(fn)(std::declval<const MirrorTable&>())) {
+        for (;;) {
+            const auto side = front_.load();
+            readers_[side].count.fetch_add(1);
+            // Still the front after announcing: the writer cannot touch it
+            // until we leave
+            if (front_.load() == side) {
+                struct Leave {
+                    std::atomic<std::uint32_t>& count;
+                    ~Leave() { count.fetch_sub(1); }
+                } leave{readers_[side].count};
+                return std::forward<F>(fn)(tables_[side]);
+            }
+            readers_[side].count.fetch_sub(1);
+        }
+    }
+
+    /// Targets in the current table.
+    [[nodiscard]] auto size() const -> std::size_t {
+        return read([](const MirrorTable& t) { return t.size(); });
+    }
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Writer (I/O thread)
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Apply one part of a snapshot: part 0 replaces the table, and after
+    /// the last part batches continue from `snapshot.seq`. A part out of
+    /// order is treated as a gap.
+    void apply_snapshot(const protocol::mirror::Snapshot& snapshot);
+
+    /// Apply a feed batch, or detect a gap (see needs_resync()).
+    void apply_batch(const protocol::TrackBatch& batch);
+
+    /// Remove dropped targets.
+    void apply_drop(std::span<const std::uint64_t> target_ids);
+
+    /// A gap was seen and no new snapshot has been asked for yet.
+    [[nodiscard]] auto needs_resync() const noexcept -> bool { return sync_ == Sync::Gap; }
+
+    /// The client has re-subscribed; wait for the snapshot.
+    void resync_requested() noexcept { sync_ = Sync::Resyncing; }
+
+    /// True once a snapshot has been applied and no gap is outstanding.
+    [[nodiscard]] auto live() const noexcept -> bool { return sync_ == Sync::Live; }
+
+    [[nodiscard]] auto stats() const noexcept -> const MirrorStats& { return stats_; }
+
+private:
+    enum class Sync : std::uint8_t {
+        Waiting,      ///< No snapshot yet
+        Loading,      ///< Between the parts of a snapshot
+        Live,
+        Gap,
+        Resyncing
+    };
+
+    struct Op {
+        enum Kind : std::uint8_t { Upsert, Erase, Clear };
+        Kind kind{Upsert};
+        protocol::TrackUpdate track;  ///< Erase uses track.target_id only
+
+        /// Row an Upsert landed on in the first table. Both tables see the
+        /// same ops from the same start, so it is the row in the other too.
+        std::size_t row{kNoRow};
+    };
+
+    static constexpr std::size_t kNoRow = static_cast<std::size_t>(-1);
+
+    /// A reader count on its own cache line.
+    struct alignas(64) Readers {
+        mutable std::atomic<std::uint32_t> count{0};
+    };
+
+    static void apply(MirrorTable& table, std::span<Op> ops);
+
+    /// Bring the back table up to date and make it the front.
+    void publish();
+
+    std::array<MirrorTable, 2> tables_;
+    std::atomic<std::uint32_t> front_{0};
+    std::array<Readers, 2> readers_;
+
+    std::vector<Op> pending_;         ///< In neither table yet
+    std::vector<Op> lag_;             ///< In the front table, not the back
+
+    Sync sync_{Sync::Waiting};
+    std::uint64_t expected_seq_{0};   ///< Sequence the next batch must carry
+    std::uint16_t next_part_{0};      ///< While Loading
+    MirrorStats stats_;
+};
+
+}  // namespace ws
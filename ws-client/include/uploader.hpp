@@ -0,0 +1,174 @@
+#pragma once
+
+/// @file uploader.hpp
+/// @brief Client side of chunked, resumable uploads over a WSClient link.
+///
+/// Demonstrates:
+/// - Ack-windowed chunk streaming with offset-based resume
+/// - Positional reads (pread) so a file is never held in memory
+/// - Rule of Six: Non-copyable, non-movable (references its WSClient)
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "posix_file.hpp"
+#include "upload.hpp"
+#include "ws_client.hpp"
+
+namespace ws {
+
+// ═══════════════════════════════════════════════════════════════════════════
+// UploadConfig — Trivial Class Pattern with Builder Methods
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Chunking and flow-control parameters.
+struct UploadConfig {
+    // Rule of Six: All Default
+    UploadConfig() = default;
+    ~UploadConfig() = default;
+    UploadConfig(const UploadConfig&) = default;
+    UploadConfig& operator=(const UploadConfig&) = default;
+    UploadConfig(UploadConfig&&) noexcept = default;
+    UploadConfig& operator=(UploadConfig&&) noexcept = default;
+
+    /// Bytes per chunk (≤ protocol::upload::kMaxChunkSize).
+    std::uint32_t chunk_size{256 * 1024};
+
+    /// Chunks sent ahead of the server's committed offset.
+    std::size_t window{8};
+
+    [[nodiscard]] auto with_chunk_size(std::uint32_t bytes) && -> UploadConfig {
+        chunk_size = bytes;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_window(std::size_t chunks) && -> UploadConfig {
+        window = chunks;
+        return std::move(*this);
+    }
+};
+
+/// State of one queued or finished upload.
+struct UploadProgress {
+    std::uint64_t id{0};
+    std::string name;
+    std::uint64_t size{0};
+    std::uint64_t committed{0};          ///< Bytes the server has written
+    std::uint64_t chunks_sent{0};
+    std::uint64_t chunks_resent{0};      ///< Sent again after a disconnect or Corrupt ack
+    std::uint32_t resumes{0};            ///< Reconnects that continued past offset 0
+    bool done{false};
+    bool failed{false};
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Uploader — Chunk Streaming over a Link
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Holds a reference to the WSClient it sends through and open files
+// • Non-copyable, non-movable; the link handlers capture `this`
+//
+// FLOW:
+// • enqueue() hashes the file chunk by chunk and queues it; uploads run
+//   one at a time, in order
+// • On every (re)connect the head upload is announced with UploadBegin;
+//   chunks flow only after the server's Resume names the offset to
+//   continue from
+// • Up to `window` chunks are in flight; every ack opens the window
+// • A Corrupt ack rewinds to the committed offset
+//
+// Wire the link as:
+//   on_connected → uploader.on_connected(), on_binary → uploader.on_frame()
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Resumable file uploads through a link-mode WSClient.
+///
+/// @par Thread Safety
+/// Not thread-safe; use on the client's io_context thread.
+class Uploader {
+public:
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: Non-copyable, Non-movable
+    // ───────────────────────────────────────────────────────────────────────
+
+    Uploader() = delete;
+    ~Uploader() = default;
+    Uploader(const Uploader&) = delete;
+    Uploader& operator=(const Uploader&) = delete;
+    Uploader(Uploader&&) = delete;
+    Uploader& operator=(Uploader&&) = delete;
+
+    /// @throws std::invalid_argument if cfg.chunk_size or cfg.window is out of range
+    explicit Uploader(WSClient& client, UploadConfig cfg = {});
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Operations
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Hash `path` and queue it for upload as `name` (default: its file name).
+    ///
+    /// @return Upload id
+    /// @throws std::system_error if the file cannot be read
+    auto enqueue(const std::filesystem::path& path, std::string name = {}) -> std::uint64_t;
+
+    /// Link (re)connected: announce the head upload.
+    void on_connected();
+
+    /// Offer a received binary frame; true if it was an UploadAck.
+    auto on_frame(std::string_view frame) -> bool;
+
+    /// Called as each upload completes or fails.
+    void set_on_finished(std::function<void(const UploadProgress&)> cb) {
+        on_finished_ = std::move(cb);
+    }
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Accessors
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// True when nothing is queued.
+    [[nodiscard]] auto idle() const noexcept -> bool { return queue_.empty(); }
+
+    /// Finished uploads, then queued ones (head first).
+    [[nodiscard]] auto progress() const -> std::vector<UploadProgress>;
+
+private:
+    struct Job {
+        UploadProgress progress;
+        protocol::PosixFile file;
+        std::uint64_t file_hash{0};
+        std::uint64_t next{0};      ///< Next offset to send
+    };
+
+    /// Send UploadBegin for the head upload.
+    void announce();
+
+    /// Send chunks while the window has room.
+    void pump();
+
+    /// Retire the head upload and announce the next.
+    void finish_head(bool ok);
+
+    /// Chunks between `from` and the head's next offset.
+    [[nodiscard]] auto chunks_after(std::uint64_t from) const noexcept -> std::uint64_t;
+
+    WSClient& client_;
+    UploadConfig cfg_;
+    std::deque<Job> queue_;
+    std::vector<UploadProgress> finished_;
+    bool resumed_{false};       ///< Head upload has its Resume on this connection
+    std::string scratch_;       ///< Chunk read buffer
+    std::function<void(const UploadProgress&)> on_finished_;
+};
+
+}  // namespace ws
@@ -8,12 +8,26 @@
 /// - Perfect forwarding factory method
 /// - Retry mechanism integration
 /// - Asio awaitable coroutines (no Cobalt)
+/// - Ping/pong RTT probing and stall detection
+/// - Sensor-to-screen latency breakdown from frame latency traces
+/// - Persistent binary link mode (reconnecting, queued writes) for peers
+/// - Health-scored failover across redundant server endpoints
+/// - Pipelined RPC calls matched to responses by correlation id
+/// - Local track mirror (snapshot + sequenced deltas) readable from any thread
 
 #include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <boost/asio.hpp>
 #include <boost/asio/awaitable.hpp>
@@ -23,9 +37,15 @@
 #include <boost/beast/websocket.hpp>
 #include <boost/beast/websocket/ssl.hpp>
 
+#include "endpoint_health.hpp"
+#include "latency.hpp"
+#include "link_quality.hpp"
 #include "protocol.hpp"
+#include "rpc.hpp"
 #include "retry.hpp"
 #include "svc_addr_config.hpp"
+#include "track.hpp"
+#include "track_mirror.hpp"
 
 namespace ws {
 
@@ -36,6 +56,45 @@ namespace websocket = beast::websocket;
 using tcp = asio::ip::tcp;
 
 
+/// Bound on TCP connect + TLS handshake to one endpoint.
+constexpr std::chrono::seconds kConnectTimeout{3};
+
+/// A link that drops sooner than this pays the reconnect pause.
+constexpr std::chrono::seconds kMinLinkLifetime{1};
+
+/// Default wait for an RPC response.
+constexpr std::chrono::milliseconds kRpcTimeout{5000};
+
+
+/// Reconnect timing across endpoints.
+struct FailoverStats {
+    std::uint64_t reconnects{0};             ///< Connections re-established after a loss
+    std::uint64_t failovers{0};              ///< Reconnects that landed on another endpoint
+    std::chrono::milliseconds last{0};       ///< Loss → reconnected, most recent
+    std::chrono::milliseconds max{0};
+};
+
+/// Health of one configured endpoint.
+struct EndpointStatus {
+    std::string url;
+    bool current{false};
+    protocol::health::EndpointReport health;
+};
+
+
+/// Callbacks for a persistent binary link (see WSClient::start_link).
+struct LinkHandlers {
+    /// Called after every (re)connect, before any queued frame is written.
+    std::function<void()> on_connected;
+    
+    /// Called for each binary frame received from the server.
+    std::function<void(std::string_view)> on_binary;
+    
+    /// Called when a connection that reached on_connected is lost.
+    std::function<void()> on_disconnected;
+};
+
+
 // ═══════════════════════════════════════════════════════════════════════════
 // WSClient — Move-Only Resource Class with Retry Support
 // ═══════════════════════════════════════════════════════════════════════════
@@ -64,6 +123,49 @@ using tcp = asio::ip::tcp;
 /// Connection attempts are retried using exponential backoff.
 /// Configure via RetryConfig at construction time.
 ///
+/// @par Link Mode
+/// start_link() keeps a binary connection up indefinitely: when the retry
+/// executor gives up, it waits one maximum backoff and starts over. Frames
+/// queued with send_binary() are written in order by a single writer;
+/// frames queued while disconnected are rejected, since the caller's
+/// on_connected handler is expected to resynchronise the peer.
+///
+/// @par Link Quality
+/// While connected, the client probes the server with timestamped pings
+/// and tracks RTT, jitter and pong loss (see link_stats()). A link with no
+/// pong for stall_timeout is torn down and the session ends with
+/// protocol::link::LinkStalledError, which retry predicates can match via
+/// protocol::link::is_link_stall().
+///
+/// @par Endpoint Failover
+/// A client created with several endpoints (create_with_endpoints) ranks
+/// them by health score — smoothed handshake/pong RTT weighted by recent
+/// failure rate. Every connection attempt sweeps the ranking, so a dead
+/// endpoint costs one bounded connect (kConnectTimeout) and the next one
+/// is tried at once; failed endpoints cool down exponentially. A dropped
+/// link counts against its endpoint and reconnects without the backoff
+/// pause. In link mode, endpoints that failed earlier are probed in the
+/// background once out of cooldown. See failover_stats() and
+/// endpoint_report().
+///
+/// @par RPC
+/// In link mode, call() sends an RpcRequest under a fresh correlation id
+/// and suspends until the matching RpcResponse arrives. Any number of
+/// calls may be outstanding; the server answers them in completion order.
+/// A call that outlives its timeout returns TimedOut, and every pending
+/// call returns Disconnected when the link drops or stop() is called.
+/// Responses are consumed before LinkHandlers::on_binary sees them.
+///
+/// @par Latency
+/// The client subscribes to the track feed. Batches carrying a latency
+/// trace are rebased onto the local clock (probe-derived server offset)
+/// and recorded per segment: uplink, per-hop residence and link, total.
+///
+/// @par Track Mirror
+/// The subscription is in mirror mode: the feed keeps mirror() — a copy of
+/// the server's track table — current, and any thread may read it without
+/// locking. A sequence gap re-subscribes for a fresh snapshot.
+///
 /// @par Example
 /// @code
 /// auto client = WSClient::create(ioc, config);
@@ -117,6 +219,17 @@ public:
         const protocol::retry::RetryConfig& retry_cfg
     ) -> std::unique_ptr<WSClient>;
     
+    /// Create client over redundant endpoints (first = preferred on ties).
+    ///
+    /// All endpoints must share the first endpoint's CA.
+    /// @throws std::invalid_argument if `endpoints` is empty
+    [[nodiscard]] static auto create_with_endpoints(
+        asio::io_context& ioc,
+        std::vector<svckit::AddrConfig> endpoints,
+        const protocol::retry::RetryConfig& retry_cfg = {},
+        const protocol::health::EndpointHealthConfig& health_cfg = {}
+    ) -> std::unique_ptr<WSClient>;
+    
     // ───────────────────────────────────────────────────────────────────────
     // Client Operations
     // ───────────────────────────────────────────────────────────────────────
@@ -127,6 +240,27 @@ public:
     /// @param initial_message First message to send after connecting
     void start(const std::string& initial_message);
     
+    /// Start a persistent binary link (no initial message, no subscription).
+    ///
+    /// Reconnects until stop(). Non-blocking — returns immediately.
+    void start_link(LinkHandlers handlers);
+    
+    /// Queue a binary frame on the current link.
+    ///
+    /// @return false when not connected (frame dropped)
+    auto send_binary(std::string frame) -> bool;
+    
+    /// Call a server method on the current link.
+    ///
+    /// Never throws for call failures; inspect Response::status. Returns
+    /// Disconnected at once when no link is up.
+    auto call(std::string_view method, protocol::Packet body,
+              std::chrono::milliseconds timeout = kRpcTimeout)
+        -> asio::awaitable<protocol::rpc::Response>;
+    
+    /// Calls awaiting a response.
+    [[nodiscard]] auto calls_pending() const noexcept -> std::size_t { return calls_.size(); }
+    
     /// Stop client operations.
     void stop();
     
@@ -135,6 +269,37 @@ public:
         return running_.load(std::memory_order_acquire);
     }
     
+    /// True while a link-mode connection is open.
+    [[nodiscard]] auto is_connected() const noexcept -> bool {
+        return stream_ && stream_->is_open();
+    }
+    
+    /// Frames queued but not yet written on the current link.
+    [[nodiscard]] auto outbox_depth() const noexcept -> std::size_t {
+        return outbox_.size();
+    }
+    
+    /// Link quality of the current (or last) connection.
+    [[nodiscard]] auto link_stats() const -> protocol::link::LinkStats {
+        return link_.stats(std::chrono::steady_clock::now());
+    }
+    
+    /// One-way latency percentiles per segment (sensor to this client).
+    [[nodiscard]] auto latency_report() const -> std::vector<protocol::SegmentLatency> {
+        return latency_.report();
+    }
+    
+    /// Local copy of the server's track table (start() sessions).
+    ///
+    /// Shared so a UI thread may keep reading it; see TrackMirror::read().
+    [[nodiscard]] auto mirror() const noexcept -> std::shared_ptr<const TrackMirror> { return mirror_; }
+    
+    /// Reconnect and failover timing.
+    [[nodiscard]] auto failover_stats() const noexcept -> const FailoverStats& { return failover_; }
+    
+    /// Health of every configured endpoint.
+    [[nodiscard]] auto endpoint_report() const -> std::vector<EndpointStatus>;
+    
     // ───────────────────────────────────────────────────────────────────────
     // IPacketHandler Implementation (Strategy Pattern)
     // ───────────────────────────────────────────────────────────────────────
@@ -155,15 +320,64 @@ private:
              const svckit::AddrConfig& cfg,
              const protocol::retry::RetryConfig& retry_cfg);
     
+    /// Construct client over several endpoints.
+    WSClient(asio::io_context& ioc,
+             std::vector<svckit::AddrConfig> endpoints,
+             const protocol::retry::RetryConfig& retry_cfg,
+             const protocol::health::EndpointHealthConfig& health_cfg);
+    
     // ───────────────────────────────────────────────────────────────────────
     // Coroutine Handlers
     // ───────────────────────────────────────────────────────────────────────
     
+    using Stream = websocket::stream<ssl::stream<tcp::socket>>;
+    
     /// Main session coroutine.
     auto run_session(std::string initial) -> asio::awaitable<void>;
     
-    /// Connection with retry wrapper.
-    auto connect_with_retry() -> asio::awaitable<void>;
+    /// Persistent link coroutine (reconnect loop).
+    auto run_link(LinkHandlers handlers) -> asio::awaitable<void>;
+    
+    /// Drain outbox_ onto one link connection.
+    auto run_writer(std::shared_ptr<Stream> ws) -> asio::awaitable<void>;
+    
+    /// Probe pinger; shares ownership of the stream it pings.
+    auto run_pinger(std::shared_ptr<Stream> ws) -> asio::awaitable<void>;
+    
+    /// Handle a binary frame read at receipt_ns (wall clock).
+    void on_binary_frame(std::string_view frame, std::int64_t receipt_ns);
+    
+    /// Print the swarms a SwarmBatch reports.
+    void on_swarm_batch(std::string_view frame);
+    
+    /// Connect to the healthiest reachable endpoint, with retry.
+    ///
+    /// @throws the last attempt's error once the retry policy gives up
+    auto connect() -> asio::awaitable<std::shared_ptr<Stream>>;
+    
+    /// Resolve, connect, TLS and WebSocket handshakes to one endpoint.
+    auto handshake(const svckit::AddrConfig& endpoint) -> asio::awaitable<std::shared_ptr<Stream>>;
+    
+    /// Make endpoint `index` current and record reconnect timing.
+    void on_connected_to(std::size_t index);
+    
+    /// Background probes of failed endpoints while the link is up.
+    auto run_prober() -> asio::awaitable<void>;
+    
+    /// Reset link probing and start the pinger for a fresh connection.
+    void attach_link_monitor(const std::shared_ptr<Stream>& ws);
+    
+    /// One outstanding call(), owned by its coroutine frame.
+    struct PendingCall {
+        asio::steady_timer timer;                          ///< Timeout; cancelled on completion
+        std::optional<protocol::rpc::Response> response;
+    };
+    
+    /// Complete the call an RpcResponse frame answers; false for other frames.
+    auto complete_call(std::string_view frame) -> bool;
+    
+    /// Complete every pending call locally with `status`.
+    void fail_calls(protocol::rpc::RpcStatus status);
     
     // ───────────────────────────────────────────────────────────────────────
     // Member Data
@@ -175,15 +389,60 @@ private:
     /// SSL context (owned via unique_ptr).
     std::unique_ptr<ssl::context> ssl_ctx_;
     
-    /// Client configuration (value type, copyable).
+    /// Current endpoint configuration (value type, copyable).
     svckit::AddrConfig cfg_;
     
+    /// Every configured endpoint (cfg_ is a copy of the current one).
+    std::vector<svckit::AddrConfig> endpoints_;
+    
+    /// Health scores and cooldowns per endpoint.
+    protocol::health::SteadyEndpointSelector selector_;
+    
+    /// Index of cfg_ in endpoints_ once connected.
+    std::optional<std::size_t> current_;
+    
+    /// When the last established connection was lost (until reconnected).
+    std::optional<std::chrono::steady_clock::time_point> lost_at_;
+    
+    /// Reconnect and failover timing.
+    FailoverStats failover_;
+    
     /// Retry executor for connection attempts.
     protocol::retry::DefaultRetryExecutor retry_executor_;
     
     /// Protocol API for packet handling.
     protocol::ProtocolAPI api_;
     
+    /// Ping/pong probing parameters.
+    protocol::link::LinkQualityConfig link_cfg_;
+    
+    /// Probe state for the current connection.
+    protocol::link::SteadyLinkMonitor link_;
+    
+    /// Sensor-to-screen latency histograms.
+    protocol::LatencyBreakdown latency_;
+    
+    /// Track table fed by the subscription (written on the I/O thread only).
+    std::shared_ptr<TrackMirror> mirror_;
+    
+    /// Current link-mode connection (null while disconnected).
+    std::shared_ptr<Stream> stream_;
+    
+    /// Frames waiting for the link writer.
+    std::deque<std::string> outbox_;
+    
+    /// Wakes the link writer when outbox_ gains a frame.
+    asio::steady_timer wake_;
+    
+    /// Paces background endpoint probes (cancelled by stop()).
+    asio::steady_timer probe_timer_;
+    
+    /// Correlation id for the next call().
+    std::uint64_t next_call_id_{1};
+    
+    /// Outstanding calls by correlation id.
+    std::unordered_map<std::uint64_t, PendingCall*> calls_;
+    
     /// Running state flag.
     std::atomic<bool> running_{false};
 };
@@ -1,13 +1,31 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <csignal>
+#include <cstdio>
 #include <cstdlib>
 #include <exception>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <boost/asio.hpp>
 #include <fmt/core.h>
 
+#include "intercept.hpp"
+#include "lod.hpp"
+#include "rpc.hpp"
+#include "sector.hpp"
+#include "track.hpp"
+#include "uploader.hpp"
 #include "ws_client.hpp"
 #include "svc_addr_config.hpp"
+#include "svc_cluster_config.hpp"
 
 namespace {
 
@@ -20,15 +38,114 @@ void signal_handler(int sig) {
     }
 }
 
+/// WS_QUERY_AREA=lat_min,lat_max,lon_min,lon_max
+auto parse_area(const char* env) -> std::optional<protocol::rpc::AreaQuery> {
+    protocol::rpc::AreaQuery q;
+    if (!env || std::sscanf(env, "%lf,%lf,%lf,%lf", &q.lat_min, &q.lat_max, &q.lon_min, &q.lon_max) != 4) {
+        return std::nullopt;
+    }
+    return q;
+}
+
+/// WS_LOD=zoom,lat_min,lat_max,lon_min,lon_max
+auto parse_lod(const char* env) -> std::optional<protocol::lod::Subscription> {
+    protocol::lod::Subscription s;
+    unsigned zoom = 0;
+    if (!env || std::sscanf(env, "%u,%lf,%lf,%lf,%lf", &zoom, &s.view.lat_min, &s.view.lat_max,
+                            &s.view.lon_min, &s.view.lon_max) != 5 || zoom > protocol::lod::kMaxZoom) {
+        return std::nullopt;
+    }
+    s.zoom = static_cast<std::uint8_t>(zoom);
+    return s;
+}
+
+/// WS_SECTORS=lat_min,lat_max,lon_min,lon_max
+auto parse_sectors(const char* env) -> std::optional<protocol::sector::Query> {
+    protocol::sector::Query q;
+    q.mode = protocol::sector::Mode::Subscribe;
+    if (!env || std::sscanf(env, "%lf,%lf,%lf,%lf", &q.area.lat_min, &q.area.lat_max,
+                            &q.area.lon_min, &q.area.lon_max) != 4) {
+        return std::nullopt;
+    }
+    return q;
+}
+
+/// WS_SHOOTERS=lat,lon,alt,speed_mps,range_m;... (ids numbered from 1)
+auto parse_shooters(const char* env) -> std::vector<protocol::intercept::Shooter> {
+    std::vector<protocol::intercept::Shooter> out;
+    for (std::string_view list{env ? env : ""}; !list.empty();) {
+        const auto semi = list.find(';');
+        const std::string item{list.substr(0, semi)};
+        list = semi == std::string_view::npos ? std::string_view{} : list.substr(semi + 1);
+        protocol::intercept::Shooter s;
+        if (std::sscanf(item.c_str(), "%lf,%lf,%f,%f,%f",
+                        &s.lat, &s.lon, &s.alt, &s.speed_mps, &s.max_range_m) == 5) {
+            s.id = out.size() + 1;
+            out.push_back(s);
+        }
+    }
+    return out;
+}
+
+/// One pipelined query; stops the client when the last one lands.
+auto run_query(ws::WSClient& client, std::string_view method, protocol::Packet body,
+               std::size_t& remaining) -> boost::asio::awaitable<void> {
+    const auto started = std::chrono::steady_clock::now();
+    const auto res = co_await client.call(method, std::move(body));
+    const auto took = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started);
+    
+    if (!res.ok()) {
+        fmt::print("[MAIN] {} failed: {} after {}us\n", method, protocol::rpc::to_string(res.status), took.count());
+    } else {
+        const auto bytes = res.body.payload_view();
+        const auto batch = protocol::decode_track_batch({reinterpret_cast<const char*>(bytes.data()), bytes.size()});
+        fmt::print("[MAIN] {}: {} tracks in {}us\n", method, batch ? batch->tracks.size() : 0, took.count());
+    }
+    if (--remaining == 0) {
+        client.stop();
+    }
+}
+
 }  // namespace
 
 int main() {
     try {
         // Configuration
-        auto cfg = svckit::AddrConfig::from_env_defaults("localhost", 8443);
+        auto cfg = svckit::AddrConfig::from_env_defaults("localhost", svckit::env_port(8443));
+        
+        // Redundant servers: WS_SERVERS=host:port,host:port (first preferred)
+        const char* servers = std::getenv("WS_SERVERS");
+        auto endpoints = svckit::parse_addr_list(servers ? servers : "");
+        
+        // Mission data: WS_UPLOAD=path,path uploads the files, then exits
+        const char* uploads = std::getenv("WS_UPLOAD");
+        const auto upload_cfg = ws::UploadConfig{}
+            .with_chunk_size(svckit::env_unsigned<std::uint32_t>("WS_UPLOAD_CHUNK_KB", 256) * 1024)
+            .with_window(svckit::env_unsigned<std::size_t>("WS_UPLOAD_WINDOW", 8));
+        
+        // Track queries: WS_QUERY_AREA=lat_min,lat_max,lon_min,lon_max pipelines
+        // a snapshot, an area search and the area's journal history over RPC,
+        // then exits
+        const auto area = parse_area(std::getenv("WS_QUERY_AREA"));
+        
+        // Firing platforms: WS_SHOOTERS streams intercept solutions for
+        // every hostile (Red) track until interrupted
+        const auto shooters = parse_shooters(std::getenv("WS_SHOOTERS"));
+        const auto lod = parse_lod(std::getenv("WS_LOD"));
+        const auto sectors = parse_sectors(std::getenv("WS_SECTORS"));
+        
+        // Console view: WS_MIRROR_WATCH_MS=n reads the track mirror from its
+        // own thread every n ms, as a UI would
+        const auto watch_ms = svckit::env_unsigned<unsigned>("WS_MIRROR_WATCH_MS", 0);
         
         fmt::print("[MAIN] Starting WebSocket client\n");
-        fmt::print("[MAIN] Target: {}\n", cfg.ws_url());
+        if (endpoints.empty()) {
+            fmt::print("[MAIN] Target: {}\n", cfg.ws_url());
+        }
+        for (const auto& ep : endpoints) {
+            fmt::print("[MAIN] Endpoint: {}\n", ep.ws_url());
+        }
         
         // IO context
         boost::asio::io_context ioc{1};
@@ -39,19 +156,164 @@ int main() {
         std::signal(SIGTERM, signal_handler);
         
         // Create client using factory method
-        auto client = ws::WSClient::create(ioc, cfg);
+        auto client = endpoints.empty()
+            ? ws::WSClient::create(ioc, cfg)
+            : ws::WSClient::create_with_endpoints(ioc, std::move(endpoints));
         
-        // Start with initial message
-        client->start("HELLO FROM CLIENT");
+        std::unique_ptr<ws::Uploader> uploader;
+        std::size_t remaining = 0;
+        std::optional<std::jthread> watcher;
+        if (uploads && *uploads) {
+            // Link mode: chunks resume from the server's offset after a reconnect
+            uploader = std::make_unique<ws::Uploader>(*client, upload_cfg);
+            for (std::string_view list{uploads}; !list.empty();) {
+                const auto comma = list.find(',');
+                const auto path = list.substr(0, comma);
+                list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+                if (!path.empty()) {
+                    uploader->enqueue(std::string{path});
+                }
+            }
+            uploader->set_on_finished([&](const ws::UploadProgress&) {
+                if (uploader->idle()) {
+                    client->stop();
+                }
+            });
+            client->start_link(ws::LinkHandlers{
+                [&] { uploader->on_connected(); },
+                [&](std::string_view frame) { (void)uploader->on_frame(frame); },
+                {}
+            });
+        } else if (area) {
+            client->start_link(ws::LinkHandlers{
+                [&] {
+                    // All requests leave before any answer is back
+                    remaining = 3;
+                    boost::asio::co_spawn(ioc, run_query(*client, protocol::rpc::kMethodSnapshot, {}, remaining),
+                                          boost::asio::detached);
+                    boost::asio::co_spawn(ioc, run_query(*client, protocol::rpc::kMethodArea,
+                                                         protocol::rpc::make_area_query(*area), remaining),
+                                          boost::asio::detached);
+                    const auto history = protocol::JournalQuery{}.with_box(
+                        {area->lat_min, area->lat_max, area->lon_min, area->lon_max});
+                    boost::asio::co_spawn(ioc, run_query(*client, protocol::rpc::kMethodJournal,
+                                                         protocol::rpc::make_journal_query(history), remaining),
+                                          boost::asio::detached);
+                },
+                {},
+                {}
+            });
+        } else if (!shooters.empty()) {
+            client->start_link(ws::LinkHandlers{
+                [&] { (void)client->send_binary(protocol::intercept::encode_subscribe(shooters)); },
+                [&](std::string_view frame) {
+                    const auto batch = protocol::intercept::decode_solutions(frame);
+                    if (!batch) {
+                        return;
+                    }
+                    fmt::print("[MAIN] {} intercept solution(s)\n", batch->solutions.size());
+                    for (const auto& s : batch->solutions) {
+                        fmt::print("[MAIN]   shooter {} -> target {}: {:.1f}s, bearing {:.1f}, aim {:.5f},{:.5f} alt {:.0f}m\n",
+                                   s.shooter_id, s.target_id, s.tti_s, s.bearing_deg,
+                                   s.aim_lat, s.aim_lon, s.aim_alt);
+                    }
+                },
+                {}
+            });
+        } else if (lod) {
+            client->start_link(ws::LinkHandlers{
+                [&] { (void)client->send_binary(protocol::lod::encode_subscribe(*lod)); },
+                [&](std::string_view frame) {
+                    const auto batch = protocol::lod::decode_tiles(frame);
+                    if (!batch) {
+                        return;
+                    }
+                    fmt::print("[MAIN] LOD zoom {}: {} tile(s)\n",
+                               static_cast<unsigned>(batch->zoom), batch->tiles.size());
+                    for (const auto& t : batch->tiles) {
+                        fmt::print("[MAIN]   tile {},{}: {} tracks, max {}, {} point(s)\n",
+                                   t.x, t.y, t.total, protocol::to_string(t.max_urgency), t.points.size());
+                    }
+                },
+                {}
+            });
+        } else if (sectors) {
+            client->start_link(ws::LinkHandlers{
+                [&] { (void)client->send_binary(protocol::sector::encode_query(*sectors)); },
+                [&](std::string_view frame) {
+                    const auto rep = protocol::sector::decode_report(frame);
+                    if (!rep) {
+                        return;
+                    }
+                    std::array<std::uint32_t, protocol::sector::kClasses> tracks{};
+                    std::uint64_t reports = 0;
+                    for (const auto& s : rep->sectors) {
+                        for (std::size_t c = 0; c < protocol::sector::kClasses; ++c) {
+                            tracks[c] += s.tracks[c];
+                        }
+                        reports += s.reports;
+                    }
+                    fmt::print("[MAIN] Sectors: {} occupied, {} green / {} yellow / {} red tracks, "
+                               "{} reports in {}s; heatmap {}x{} (stride {})\n",
+                               rep->sectors.size(), tracks[0], tracks[1], tracks[2], reports,
+                               rep->window.count() / 1000, rep->heat.cols, rep->heat.rows, rep->heat.stride);
+                },
+                {}
+            });
+        } else {
+            // Start with initial message
+            client->start("HELLO FROM CLIENT");
+            if (watch_ms > 0) {
+                watcher.emplace([mirror = client->mirror(), watch_ms](std::stop_token stop) {
+                    while (!stop.stop_requested()) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds{watch_ms});
+                        const auto [tracks, hostile] = mirror->read([](const ws::MirrorTable& t) {
+                            const auto u = t.urgency();
+                            return std::pair{t.size(), std::count(u.begin(), u.end(), protocol::Urgency::Red)};
+                        });
+                        fmt::print("[UI] Mirror: {} tracks, {} hostile\n", tracks, hostile);
+                    }
+                });
+            }
+        }
         
         // Run event loop
         ioc.run();
         
         // Cleanup
+        watcher.reset();
         client->stop();
         
+        if (const auto& ms = client->mirror()->stats(); ms.snapshots > 0) {
+            fmt::print("[MAIN] Mirror: {} tracks; {} snapshot(s), {} batches, {} updates, {} drops, "
+                       "{} gap(s), {} stale frames; {} publishes ({} deferred)\n",
+                       client->mirror()->size(), ms.snapshots, ms.batches, ms.updates, ms.drops,
+                       ms.gaps, ms.stale, ms.publishes, ms.deferred);
+        }
+        
+        if (client->endpoint_report().size() > 1) {
+            for (const auto& ep : client->endpoint_report()) {
+                fmt::print("[MAIN] {} {}: score {:.0f} rtt {}us failures {}/{} drops {}{}\n",
+                           ep.current ? "*" : " ", ep.url, ep.health.score,
+                           ep.health.rtt.count(), ep.health.failures, ep.health.attempts,
+                           ep.health.drops, ep.health.cooling ? " (cooling)" : "");
+            }
+            const auto& fo = client->failover_stats();
+            fmt::print("[MAIN] Reconnects {} failovers {} last {}ms max {}ms\n",
+                       fo.reconnects, fo.failovers, fo.last.count(), fo.max.count());
+        }
+        
+        bool uploaded = true;
+        if (uploader) {
+            for (const auto& up : uploader->progress()) {
+                fmt::print("[MAIN] Upload {}: {}/{} bytes{}\n", up.name, up.committed, up.size,
+                           up.done ? "" : up.failed ? " (rejected)" : " (incomplete)");
+                uploaded = uploaded && up.done;
+            }
+        }
+        
         fmt::print("[MAIN] Client shutdown complete\n");
-        return EXIT_SUCCESS;
+        return uploaded ? EXIT_SUCCESS : EXIT_FAILURE;
         
     } catch (const std::exception& e) {
         fmt::print(stderr, "[MAIN] Fatal error: {}\n", e.what());
@@ -0,0 +1,205 @@
+#include "track_mirror.hpp"
+
+namespace ws {
+
+// ═══════════════════════════════════════════════════════════════════════════
+// MIRROR TABLE
+// ═══════════════════════════════════════════════════════════════════════════
+
+auto MirrorTable::row(std::size_t i) const -> protocol::TrackUpdate {
+    return protocol::TrackUpdate{id_[i], time_ns_[i], lat_[i], lon_[i],
+                                 alt_[i], vn_[i], ve_[i], vu_[i], urgency_[i]};
+}
+
+auto MirrorTable::find(std::uint64_t target_id) const -> std::optional<protocol::TrackUpdate> {
+    const auto it = index_.find(target_id);
+    if (it == index_.end()) {
+        return std::nullopt;
+    }
+    return row(it->second);
+}
+
+auto MirrorTable::upsert(const protocol::TrackUpdate& t) -> std::size_t {
+    auto [it, inserted] = index_.try_emplace(t.target_id, id_.size());
+    if (inserted) {
+        id_.push_back(t.target_id);
+        time_ns_.push_back(t.time_ns);
+        lat_.push_back(t.lat);
+        lon_.push_back(t.lon);
+        alt_.push_back(t.alt);
+        vn_.push_back(t.vn);
+        ve_.push_back(t.ve);
+        vu_.push_back(t.vu);
+        urgency_.push_back(t.urgency);
+        return it->second;
+    }
+    assign(it->second, t);
+    return it->second;
+}
+
+void MirrorTable::assign(std::size_t i, const protocol::TrackUpdate& t) noexcept {
+    time_ns_[i] = t.time_ns;
+    lat_[i] = t.lat;
+    lon_[i] = t.lon;
+    alt_[i] = t.alt;
+    vn_[i] = t.vn;
+    ve_[i] = t.ve;
+    vu_[i] = t.vu;
+    urgency_[i] = t.urgency;
+}
+
+void MirrorTable::erase(std::uint64_t target_id) {
+    const auto it = index_.find(target_id);
+    if (it == index_.end()) {
+        return;
+    }
+    // Swap-remove: the last row fills the hole
+    const auto i = it->second;
+    const auto last = id_.size() - 1;
+    index_.erase(it);
+    if (i != last) {
+        id_[i] = id_[last];
+        time_ns_[i] = time_ns_[last];
+        lat_[i] = lat_[last];
+        lon_[i] = lon_[last];
+        alt_[i] = alt_[last];
+        vn_[i] = vn_[last];
+        ve_[i] = ve_[last];
+        vu_[i] = vu_[last];
+        urgency_[i] = urgency_[last];
+        index_[id_[i]] = i;
+    }
+    id_.pop_back();
+    time_ns_.pop_back();
+    lat_.pop_back();
+    lon_.pop_back();
+    alt_.pop_back();
+    vn_.pop_back();
+    ve_.pop_back();
+    vu_.pop_back();
+    urgency_.pop_back();
+}
+
+void MirrorTable::clear() noexcept {
+    id_.clear();
+    time_ns_.clear();
+    lat_.clear();
+    lon_.clear();
+    alt_.clear();
+    vn_.clear();
+    ve_.clear();
+    vu_.clear();
+    urgency_.clear();
+    index_.clear();
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// WRITER
+// ═══════════════════════════════════════════════════════════════════════════
+
+void TrackMirror::apply_snapshot(const protocol::mirror::Snapshot& snapshot) {
+    if (snapshot.part == 0) {
+        // Whatever either table is missing is superseded
+        lag_.clear();
+        pending_.clear();
+        pending_.push_back(Op{Op::Clear, {}});
+    } else if (sync_ == Sync::Resyncing) {
+        ++stats_.stale;
+        return;
+    } else if (sync_ != Sync::Loading || snapshot.part != next_part_ || snapshot.seq != expected_seq_) {
+        ++stats_.gaps;
+        sync_ = Sync::Gap;
+        return;
+    }
+    for (const auto& t : snapshot.tracks) {
+        pending_.push_back(Op{Op::Upsert, t});
+    }
+    stats_.updates += snapshot.tracks.size();
+    if (snapshot.part + 1 < snapshot.parts) {
+        // Readers keep the previous table until the last part
+        sync_ = Sync::Loading;
+        next_part_ = static_cast<std::uint16_t>(snapshot.part + 1);
+        expected_seq_ = snapshot.seq;
+        return;
+    }
+    sync_ = Sync::Live;
+    expected_seq_ = snapshot.seq + 1;
+    ++stats_.snapshots;
+    publish();
+}
+
+void TrackMirror::apply_batch(const protocol::TrackBatch& batch) {
+    if (batch.seq) {
+        if (sync_ != Sync::Live) {
+            // Before the first snapshot, or already behind a gap
+            ++stats_.stale;
+            return;
+        }
+        if (*batch.seq != expected_seq_) {
+            ++stats_.gaps;
+            ++stats_.stale;
+            sync_ = Sync::Gap;
+            return;
+        }
+        ++expected_seq_;
+    }
+    for (const auto& t : batch.tracks) {
+        pending_.push_back(Op{Op::Upsert, t});
+    }
+    ++stats_.batches;
+    stats_.updates += batch.tracks.size();
+    publish();
+}
+
+void TrackMirror::apply_drop(std::span<const std::uint64_t> target_ids) {
+    for (const auto id : target_ids) {
+        protocol::TrackUpdate t;
+        t.target_id = id;
+        pending_.push_back(Op{Op::Erase, t});
+    }
+    stats_.drops += target_ids.size();
+    publish();
+}
+
+void TrackMirror::apply(MirrorTable& table, std::span<Op> ops) {
+    for (auto& op : ops) {
+        switch (op.kind) {
+            case Op::Upsert:
+                // A refresh replayed on the second table skips the lookup;
+                // an insert still goes through the index
+                if (op.row < table.size()) {
+                    table.assign(op.row, op.track);
+                } else {
+                    op.row = table.upsert(op.track);
+                }
+                break;
+            case Op::Erase:
+                table.erase(op.track.target_id);
+                break;
+            case Op::Clear:
+                table.clear();
+                break;
+        }
+    }
+}
+
+void TrackMirror::publish() {
+    const auto front = front_.load();
+    const auto back = 1 - front;
+    // A reader that entered the back table before the last swap is still
+    // in it; try again on the next frame rather than wait
+    if (readers_[back].count.load() != 0) {
+        ++stats_.deferred;
+        return;
+    }
+    apply(tables_[back], lag_);
+    apply(tables_[back], pending_);
+    front_.store(back);
+    // The old front misses exactly what was pending
+    lag_.swap(pending_);
+    pending_.clear();
+    ++stats_.publishes;
+}
+
+}  // namespace ws
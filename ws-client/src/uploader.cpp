@@ -0,0 +1,168 @@
+#include "uploader.hpp"
+
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+
+#include <fmt/core.h>
+
+namespace ws {
+
+namespace upload = protocol::upload;
+
+Uploader::Uploader(WSClient& client, UploadConfig cfg)
+    : client_{client}
+    , cfg_{std::move(cfg)}
+{
+    if (cfg_.chunk_size == 0 || cfg_.chunk_size > upload::kMaxChunkSize) {
+        throw std::invalid_argument{fmt::format("upload chunk size {} out of range", cfg_.chunk_size)};
+    }
+    if (cfg_.window == 0) {
+        throw std::invalid_argument{"upload window must be at least one chunk"};
+    }
+}
+
+auto Uploader::enqueue(const std::filesystem::path& path, std::string name) -> std::uint64_t {
+    Job job;
+    job.file = protocol::PosixFile::open_read(path);
+    job.progress.name = name.empty() ? path.filename().string() : std::move(name);
+    job.progress.size = job.file.size();
+
+    // One sequential pass for the chunk hashes the server will check
+    job.file_hash = upload::file_hash_seed(job.progress.size);
+    for (std::uint64_t offset = 0; offset < job.progress.size; offset += cfg_.chunk_size) {
+        scratch_.resize(upload::chunk_length(job.progress.size, cfg_.chunk_size, offset));
+        if (job.file.pread_some(std::span<char>{scratch_}, offset) != scratch_.size()) {
+            throw std::system_error{std::make_error_code(std::errc::io_error),
+                                    path.string() + " shrank while hashing"};
+        }
+        job.file_hash = upload::fold_chunk_hash(job.file_hash, upload::content_hash(scratch_));
+    }
+    job.progress.id = upload::upload_id(job.progress.name, job.progress.size, job.file_hash);
+
+    const auto id = job.progress.id;
+    queue_.push_back(std::move(job));
+    if (queue_.size() == 1 && client_.is_connected()) {
+        announce();
+    }
+    return id;
+}
+
+void Uploader::on_connected() {
+    resumed_ = false;
+    if (!queue_.empty()) {
+        announce();
+    }
+}
+
+auto Uploader::on_frame(std::string_view frame) -> bool {
+    const auto ack = upload::decode_upload_ack(frame);
+    if (!ack) {
+        return false;
+    }
+    if (queue_.empty() || ack->id != queue_.front().progress.id) {
+        return true;  // Late ack for an upload already retired
+    }
+
+    auto& job = queue_.front();
+    auto& p = job.progress;
+    switch (ack->status) {
+        case upload::UploadStatus::Resume:
+            if (ack->committed > 0) {
+                ++p.resumes;
+                fmt::print("[CLIENT] Upload {} resumes at {}/{} bytes\n", p.name, ack->committed, p.size);
+            }
+            p.chunks_resent += chunks_after(ack->committed);
+            p.committed = ack->committed;
+            job.next = ack->committed;
+            resumed_ = true;
+            pump();
+            break;
+
+        case upload::UploadStatus::Committed:
+            p.committed = std::max(p.committed, ack->committed);
+            pump();
+            break;
+
+        case upload::UploadStatus::Corrupt:
+            fmt::print("[CLIENT] Upload {} chunk at {} corrupt, resending\n", p.name, ack->committed);
+            p.chunks_resent += chunks_after(ack->committed);
+            p.committed = ack->committed;
+            job.next = ack->committed;
+            pump();
+            break;
+
+        case upload::UploadStatus::Complete:
+            p.committed = p.size;
+            finish_head(true);
+            break;
+
+        case upload::UploadStatus::Rejected:
+            finish_head(false);
+            break;
+    }
+    return true;
+}
+
+auto Uploader::progress() const -> std::vector<UploadProgress> {
+    auto out = finished_;
+    for (const auto& job : queue_) {
+        out.push_back(job.progress);
+    }
+    return out;
+}
+
+void Uploader::announce() {
+    const auto& job = queue_.front();
+    client_.send_binary(upload::encode_upload_begin(upload::UploadBegin{
+        job.progress.id, job.progress.size, cfg_.chunk_size, job.file_hash, job.progress.name
+    }));
+}
+
+void Uploader::pump() {
+    if (!resumed_ || queue_.empty()) {
+        return;
+    }
+
+    auto& job = queue_.front();
+    const auto window_bytes = static_cast<std::uint64_t>(cfg_.window) * cfg_.chunk_size;
+    while (job.next < job.progress.size && job.next - job.progress.committed < window_bytes) {
+        scratch_.resize(upload::chunk_length(job.progress.size, cfg_.chunk_size, job.next));
+        if (job.file.pread_some(std::span<char>{scratch_}, job.next) != scratch_.size()) {
+            fmt::print("[CLIENT] Upload {} source truncated at {}\n", job.progress.name, job.next);
+            finish_head(false);
+            return;
+        }
+        if (!client_.send_binary(upload::encode_upload_chunk(job.progress.id, job.next, scratch_))) {
+            return;  // Link down; on_connected() resumes
+        }
+        job.next += scratch_.size();
+        ++job.progress.chunks_sent;
+    }
+}
+
+void Uploader::finish_head(bool ok) {
+    auto p = std::move(queue_.front().progress);
+    queue_.pop_front();
+    p.done = ok;
+    p.failed = !ok;
+    fmt::print("[CLIENT] Upload {} {} ({} bytes, {} chunks, {} resent, {} resumes)\n",
+               p.name, ok ? "complete" : "rejected", p.size, p.chunks_sent, p.chunks_resent, p.resumes);
+    finished_.push_back(p);
+
+    resumed_ = false;
+    if (!queue_.empty() && client_.is_connected()) {
+        announce();
+    }
+    if (on_finished_) {
+        on_finished_(p);
+    }
+}
+
+auto Uploader::chunks_after(std::uint64_t from) const noexcept -> std::uint64_t {
+    const auto next = queue_.front().next;
+    return next > from ? (next - from + cfg_.chunk_size - 1) / cfg_.chunk_size : 0;
+}
+
+}  // namespace ws
@@ -1,9 +1,20 @@
 #include "ws_client.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <exception>
+#include <stdexcept>
+#include <string_view>
 
 #include <fmt/core.h>
 
+#include "anomaly.hpp"
+#include "cpa.hpp"
+#include "lifecycle.hpp"
+#include "mirror.hpp"
+#include "swarm.hpp"
+
 namespace ws {
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -18,7 +29,12 @@ WSClient::WSClient(asio::io_context& ioc, const svckit::AddrConfig& cfg)
     : ioc_{ioc}
     , ssl_ctx_{std::make_unique<ssl::context>(ssl::context::tlsv12_client)}
     , cfg_{cfg}
+    , endpoints_{cfg}
+    , selector_{1}
     , retry_executor_{ioc.get_executor(), protocol::retry::ExponentialBackoffPolicy{}}
+    , mirror_{std::make_shared<TrackMirror>()}
+    , wake_{ioc}
+    , probe_timer_{ioc}
 {
     // Configure SSL context for client
     ssl_ctx_->set_verify_mode(ssl::verify_peer);
@@ -31,8 +47,34 @@ WSClient::WSClient(asio::io_context& ioc,
     : ioc_{ioc}
     , ssl_ctx_{std::make_unique<ssl::context>(ssl::context::tlsv12_client)}
     , cfg_{cfg}
+    , endpoints_{cfg}
+    , selector_{1}
+    , retry_executor_{ioc.get_executor(), protocol::retry::ExponentialBackoffPolicy{retry_cfg}}
+    , mirror_{std::make_shared<TrackMirror>()}
+    , wake_{ioc}
+    , probe_timer_{ioc}
+{
+    ssl_ctx_->set_verify_mode(ssl::verify_peer);
+    ssl_ctx_->load_verify_file(cfg_.tls().ca_file.string());
+}
+
+WSClient::WSClient(asio::io_context& ioc,
+                   std::vector<svckit::AddrConfig> endpoints,
+                   const protocol::retry::RetryConfig& retry_cfg,
+                   const protocol::health::EndpointHealthConfig& health_cfg)
+    : ioc_{ioc}
+    , ssl_ctx_{std::make_unique<ssl::context>(ssl::context::tlsv12_client)}
+    , cfg_{endpoints.empty() ? svckit::AddrConfig{} : endpoints.front()}
+    , endpoints_{std::move(endpoints)}
+    , selector_{endpoints_.size(), health_cfg}
     , retry_executor_{ioc.get_executor(), protocol::retry::ExponentialBackoffPolicy{retry_cfg}}
+    , mirror_{std::make_shared<TrackMirror>()}
+    , wake_{ioc}
+    , probe_timer_{ioc}
 {
+    if (endpoints_.empty()) {
+        throw std::invalid_argument{"WSClient needs at least one endpoint"};
+    }
     ssl_ctx_->set_verify_mode(ssl::verify_peer);
     ssl_ctx_->load_verify_file(cfg_.tls().ca_file.string());
 }
@@ -49,6 +91,15 @@ auto WSClient::create_with_retry(
     return std::unique_ptr<WSClient>(new WSClient(ioc, cfg, retry_cfg));
 }
 
+auto WSClient::create_with_endpoints(
+    asio::io_context& ioc,
+    std::vector<svckit::AddrConfig> endpoints,
+    const protocol::retry::RetryConfig& retry_cfg,
+    const protocol::health::EndpointHealthConfig& health_cfg
+) -> std::unique_ptr<WSClient> {
+    return std::unique_ptr<WSClient>(new WSClient(ioc, std::move(endpoints), retry_cfg, health_cfg));
+}
+
 // ───────────────────────────────────────────────────────────────────────────
 // Destructor
 // ───────────────────────────────────────────────────────────────────────────
@@ -82,8 +133,23 @@ WSClient::WSClient(WSClient&& other) noexcept
     : ioc_{other.ioc_}
     , ssl_ctx_{std::exchange(other.ssl_ctx_, nullptr)}
     , cfg_{std::move(other.cfg_)}
+    , endpoints_{std::move(other.endpoints_)}
+    , selector_{std::move(other.selector_)}
+    , current_{std::exchange(other.current_, std::nullopt)}
+    , lost_at_{std::exchange(other.lost_at_, std::nullopt)}
+    , failover_{other.failover_}
     , retry_executor_{std::move(other.retry_executor_)}
     , api_{std::move(other.api_)}
+    , link_cfg_{other.link_cfg_}
+    , link_{std::move(other.link_)}
+    , latency_{std::move(other.latency_)}
+    , mirror_{std::move(other.mirror_)}
+    , stream_{std::move(other.stream_)}
+    , outbox_{std::move(other.outbox_)}
+    , wake_{std::move(other.wake_)}
+    , probe_timer_{std::move(other.probe_timer_)}
+    , next_call_id_{std::exchange(other.next_call_id_, 1)}
+    , calls_{std::move(other.calls_)}
     , running_{other.running_.exchange(false)}
 {}
 
@@ -112,8 +178,23 @@ WSClient& WSClient::operator=(WSClient&& other) noexcept {
         
         ssl_ctx_ = std::exchange(other.ssl_ctx_, nullptr);
         cfg_ = std::move(other.cfg_);
+        endpoints_ = std::move(other.endpoints_);
+        selector_ = std::move(other.selector_);
+        current_ = std::exchange(other.current_, std::nullopt);
+        lost_at_ = std::exchange(other.lost_at_, std::nullopt);
+        failover_ = other.failover_;
         retry_executor_ = std::move(other.retry_executor_);
         api_ = std::move(other.api_);
+        link_cfg_ = other.link_cfg_;
+        link_ = std::move(other.link_);
+        latency_ = std::move(other.latency_);
+        mirror_ = std::move(other.mirror_);
+        stream_ = std::move(other.stream_);
+        outbox_ = std::move(other.outbox_);
+        wake_ = std::move(other.wake_);
+        probe_timer_ = std::move(other.probe_timer_);
+        next_call_id_ = std::exchange(other.next_call_id_, 1);
+        calls_ = std::move(other.calls_);
         running_.store(other.running_.exchange(false), std::memory_order_release);
     }
     return *this;
@@ -126,16 +207,93 @@ WSClient& WSClient::operator=(WSClient&& other) noexcept {
 
 void WSClient::start(const std::string& initial_message) {
     running_.store(true, std::memory_order_release);
-    fmt::print("[CLIENT] Starting connection to {}:{}\n", cfg_.host(), cfg_.port());
+    fmt::print("[CLIENT] Starting connection to {}:{}{}\n", cfg_.host(), cfg_.port(),
+               endpoints_.size() > 1 ? fmt::format(" (+{} fallback)", endpoints_.size() - 1) : "");
     
     asio::co_spawn(ioc_, run_session(initial_message), asio::detached);
 }
 
+void WSClient::start_link(LinkHandlers handlers) {
+    running_.store(true, std::memory_order_release);
+    fmt::print("[CLIENT] Starting link to {}:{}\n", cfg_.host(), cfg_.port());
+    
+    asio::co_spawn(ioc_, run_link(std::move(handlers)), asio::detached);
+    if (endpoints_.size() > 1) {
+        asio::co_spawn(ioc_, run_prober(), asio::detached);
+    }
+}
+
+auto WSClient::send_binary(std::string frame) -> bool {
+    if (!is_connected()) {
+        return false;
+    }
+    outbox_.push_back(std::move(frame));
+    wake_.cancel();
+    return true;
+}
+
 void WSClient::stop() {
     running_.store(false, std::memory_order_release);
+    
+    // Unblock a link-mode read; run_link sees running_ == false and exits
+    if (stream_) {
+        beast::error_code ec;
+        beast::get_lowest_layer(*stream_).close(ec);
+    }
+    wake_.cancel();
+    probe_timer_.cancel();
+    fail_calls(protocol::rpc::RpcStatus::Disconnected);
     fmt::print("[CLIENT] Stopped\n");
 }
 
+auto WSClient::call(std::string_view method, protocol::Packet body, std::chrono::milliseconds timeout)
+    -> asio::awaitable<protocol::rpc::Response>
+{
+    const auto id = next_call_id_++;
+    if (!send_binary(protocol::rpc::encode_request(id, method, body))) {
+        co_return protocol::rpc::Response{id, protocol::rpc::RpcStatus::Disconnected, {}};
+    }
+    
+    // Registered before the first suspension, so no response can be missed
+    PendingCall pending{asio::steady_timer{ioc_}, std::nullopt};
+    pending.timer.expires_after(timeout);
+    calls_.emplace(id, &pending);
+    co_await pending.timer.async_wait(asio::as_tuple(asio::use_awaitable));
+    calls_.erase(id);
+    
+    if (pending.response) {
+        co_return std::move(*pending.response);
+    }
+    co_return protocol::rpc::Response{id, protocol::rpc::RpcStatus::TimedOut, {}};
+}
+
+auto WSClient::complete_call(std::string_view frame) -> bool {
+    const auto header = protocol::wire::peek_header(frame);
+    if (!header || header->kind != protocol::wire::FrameKind::RpcResponse) {
+        return false;
+    }
+    auto response = protocol::rpc::decode_response(frame);
+    if (!response) {
+        fmt::print("[CLIENT] Malformed RPC response dropped\n");
+        return true;
+    }
+    // A late response for a call that already timed out finds nothing
+    if (auto it = calls_.find(response->id); it != calls_.end() && !it->second->response) {
+        it->second->response = std::move(*response);
+        it->second->timer.cancel();
+    }
+    return true;
+}
+
+void WSClient::fail_calls(protocol::rpc::RpcStatus status) {
+    for (auto& [id, pending] : calls_) {
+        if (!pending->response) {
+            pending->response = protocol::rpc::Response{id, status, {}};
+            pending->timer.cancel();
+        }
+    }
+}
+
 
 // ═══════════════════════════════════════════════════════════════════════════
 // COROUTINE HANDLERS
@@ -143,60 +301,32 @@ void WSClient::stop() {
 
 auto WSClient::run_session(std::string initial) -> asio::awaitable<void> {
     try {
-        // Resolve host
-        tcp::resolver resolver{ioc_};
-        auto results = co_await resolver.async_resolve(
-            cfg_.host(),
-            std::to_string(cfg_.port()),
-            asio::use_awaitable
-        );
-        
-        // Create SSL stream
-        ssl::stream<tcp::socket> ssl_stream{ioc_, *ssl_ctx_};
-        
-        // Connect TCP
-        co_await beast::get_lowest_layer(ssl_stream).async_connect(
-            *results.begin(),
-            asio::use_awaitable
-        );
-        
-        // SSL handshake
-        co_await ssl_stream.async_handshake(
-            ssl::stream_base::client,
-            asio::use_awaitable
-        );
-        
-        // Create WebSocket stream
-        websocket::stream<ssl::stream<tcp::socket>> ws{std::move(ssl_stream)};
-        
-        // Configure WebSocket
-        ws.set_option(websocket::stream_base::timeout::suggested(
-            beast::role_type::client
-        ));
-        
-        // WebSocket handshake
-        co_await ws.async_handshake(
-            cfg_.host(),
-            cfg_.endpoint(),
-            asio::use_awaitable
-        );
-        
-        fmt::print("[CLIENT] Connected to {}\n", cfg_.ws_url());
+        auto ws = co_await connect();
+        attach_link_monitor(ws);
         
         // Send initial message
         auto pkt = api_.make_packet(initial, protocol::Urgency::Green);
-        co_await ws.async_write(
+        co_await ws->async_write(
             asio::buffer(pkt.payload()),
             asio::use_awaitable
         );
         
         fmt::print("[CLIENT] Sent: {}\n", initial);
         
+        // Join the track feed as a mirror
+        const auto subscribe = protocol::mirror::encode_subscribe(protocol::mirror::kModeMirror);
+        ws->binary(true);
+        co_await ws->async_write(
+            asio::buffer(subscribe),
+            asio::use_awaitable
+        );
+        ws->binary(false);
+        
         // Read loop
         while (running_.load(std::memory_order_acquire)) {
             beast::flat_buffer buffer;
             
-            auto [ec, bytes] = co_await ws.async_read(
+            auto [ec, bytes] = co_await ws->async_read(
                 buffer,
                 asio::as_tuple(asio::use_awaitable)
             );
@@ -210,61 +340,449 @@ auto WSClient::run_session(std::string initial) -> asio::awaitable<void> {
             
             // Process response
             std::string msg = beast::buffers_to_string(buffer.data());
+            if (ws->got_binary()) {
+                on_binary_frame(msg, protocol::link::wall_clock_ns());
+                if (mirror_->needs_resync()) {
+                    // The feed skipped a batch: subscribing again brings a
+                    // fresh snapshot that the sequence continues from
+                    fmt::print("[CLIENT] Track feed gap, resyncing mirror\n");
+                    mirror_->resync_requested();
+                    ws->binary(true);
+                    co_await ws->async_write(
+                        asio::buffer(subscribe),
+                        asio::use_awaitable
+                    );
+                    ws->binary(false);
+                }
+                continue;
+            }
             auto rx_pkt = api_.make_packet(msg, protocol::Urgency::Green);
             api_.dispatch(rx_pkt, *this);
         }
         
         // Graceful close
         fmt::print("[CLIENT] Closing connection\n");
-        co_await ws.async_close(
+        co_await ws->async_close(
             websocket::close_code::normal,
             asio::as_tuple(asio::use_awaitable)
         );
         
+        const auto link = link_stats();
+        if (link.pongs_received > 0) {
+            fmt::print("[CLIENT] Link rtt p50 {}us p99 {}us jitter {}us loss {:.1f}%\n",
+                       link.rtt_p50.count(), link.rtt_p99.count(),
+                       link.jitter.count(), link.loss_ratio * 100.0);
+        }
+        for (const auto& seg : latency_.report()) {
+            fmt::print("[CLIENT] Latency {} p50 {}us p99 {}us ({} samples)\n",
+                       seg.name, seg.p50.count(), seg.p99.count(), seg.samples);
+        }
+        if (link.stalled) {
+            throw protocol::link::LinkStalledError{"link stalled: no pong received"};
+        }
+        
     } catch (const std::exception& e) {
         fmt::print("[CLIENT] Session exception: {}\n", e.what());
     }
 }
 
-auto WSClient::connect_with_retry() -> asio::awaitable<void> {
-    // Example of using retry executor for connection
-    // This wraps the connection logic with exponential backoff
+void WSClient::on_binary_frame(std::string_view frame, std::int64_t receipt_ns) {
+    const auto header = protocol::wire::peek_header(frame);
+    if (header && header->kind == protocol::wire::FrameKind::SwarmBatch) {
+        on_swarm_batch(frame);
+        return;
+    }
+    if (header && header->kind == protocol::wire::FrameKind::TrackDrop) {
+        if (const auto ids = protocol::decode_track_drop(frame)) {
+            mirror_->apply_drop(*ids);
+            fmt::print("[CLIENT] {} track(s) dropped by the server\n", ids->size());
+        }
+        return;
+    }
+    if (header && header->kind == protocol::wire::FrameKind::TrackSnapshot) {
+        const auto snapshot = protocol::mirror::decode_snapshot(frame);
+        if (!snapshot) {
+            fmt::print("[CLIENT] Malformed track snapshot ({} bytes)\n", frame.size());
+            return;
+        }
+        mirror_->apply_snapshot(*snapshot);
+        fmt::print("[CLIENT] Mirror snapshot {}/{}: {} tracks at seq {} ({} bytes)\n",
+                   snapshot->part + 1, snapshot->parts, snapshot->tracks.size(), snapshot->seq, frame.size());
+        return;
+    }
+    if (header && header->kind == protocol::wire::FrameKind::CpaAlert) {
+        if (const auto alerts = protocol::decode_cpa_alerts(frame)) {
+            for (const auto& a : *alerts) {
+                fmt::print("[CLIENT] CPA {}: targets {} and {} pass {:.0f}m apart in {:.1f}s\n",
+                           protocol::to_string(a.urgency), a.target_a, a.target_b,
+                           static_cast<double>(a.miss_m), static_cast<double>(a.t_cpa_s));
+            }
+        }
+        return;
+    }
+    if (header && header->kind == protocol::wire::FrameKind::QuarantineBatch) {
+        if (const auto suspects = protocol::decode_quarantine(frame)) {
+            for (const auto& q : *suspects) {
+                fmt::print("[CLIENT] Quarantined report for target {}:{}{}{}\n", q.report.target_id,
+                           (q.flags & protocol::kAnomalyTeleport) ? " teleport" : "",
+                           (q.flags & protocol::kAnomalyAcceleration) ? " acceleration" : "",
+                           (q.flags & protocol::kAnomalyAltitude) ? " altitude" : "");
+            }
+        }
+        return;
+    }
+    
+    auto batch = protocol::decode_track_batch(frame);
+    if (!batch) {
+        fmt::print("[CLIENT] Malformed binary frame ({} bytes)\n", frame.size());
+        return;
+    }
+    
+    if (batch->trace) {
+        // Server stamps are on the server clock; move them onto ours
+        batch->trace->rebase(link_.clock_offset().value_or(std::chrono::nanoseconds{0}));
+        latency_.record(*batch->trace, receipt_ns);
+    }
+    mirror_->apply_batch(*batch);
+}
+
+void WSClient::on_swarm_batch(std::string_view frame) {
+    const auto delta = protocol::decode_swarm_batch(frame);
+    if (!delta) {
+        fmt::print("[CLIENT] Malformed swarm batch ({} bytes)\n", frame.size());
+        return;
+    }
+    for (const auto& s : delta->updated) {
+        fmt::print("[CLIENT] Swarm {}: {} tracks at {:.5f},{:.5f} r {:.0f}m, {:.0f}m/s\n",
+                   s.id, s.members, s.lat, s.lon, s.radius_m, std::hypot(s.vn, s.ve));
+    }
+    for (const auto id : delta->dissolved) {
+        fmt::print("[CLIENT] Swarm {} dissolved\n", id);
+    }
+}
+
+auto WSClient::run_pinger(std::shared_ptr<Stream> ws) -> asio::awaitable<void> {
+    asio::steady_timer timer{ioc_};
     
-    auto result = co_await retry_executor_.execute([this]() -> asio::awaitable<void> {
-        tcp::resolver resolver{ioc_};
-        auto results = co_await resolver.async_resolve(
-            cfg_.host(),
-            std::to_string(cfg_.port()),
-            asio::use_awaitable
-        );
-        
-        ssl::stream<tcp::socket> ssl_stream{ioc_, *ssl_ctx_};
+    while (running_.load(std::memory_order_acquire) && ws->is_open()) {
+        timer.expires_after(link_cfg_.ping_interval);
+        co_await timer.async_wait(asio::as_tuple(asio::use_awaitable));
+        if (!ws->is_open()) {
+            break;
+        }
         
-        co_await beast::get_lowest_layer(ssl_stream).async_connect(
-            *results.begin(),
-            asio::use_awaitable
-        );
+        const auto now = std::chrono::steady_clock::now();
+        link_.expire(now);
+        if (link_.stalled(now)) {
+            // Drop the socket so the blocked read fails now rather than
+            // after the idle timeout; run_session reports the stall
+            fmt::print("[CLIENT] Link stalled (no pong for {}ms), dropping connection\n",
+                       link_cfg_.stall_timeout.count());
+            beast::error_code ec;
+            beast::get_lowest_layer(*ws).close(ec);
+            break;
+        }
         
-        co_await ssl_stream.async_handshake(
-            ssl::stream_base::client,
-            asio::use_awaitable
+        const auto payload = link_.make_ping(now);
+        auto [ec] = co_await ws->async_ping(
+            websocket::ping_data{payload.data(), payload.size()},
+            asio::as_tuple(asio::use_awaitable)
         );
-        
-        fmt::print("[CLIENT] Connected (with retry)\n");
+        if (ec) {
+            break;
+        }
+    }
+}
+
+auto WSClient::connect() -> asio::awaitable<std::shared_ptr<Stream>> {
+    auto result = co_await retry_executor_.execute([this]() -> asio::awaitable<std::shared_ptr<Stream>> {
+        // One attempt sweeps every endpoint, healthiest first, so a dead
+        // endpoint costs a bounded connect rather than a backoff step
+        std::exception_ptr last_error;
+        for (const auto i : selector_.ranked(std::chrono::steady_clock::now())) {
+            const auto started = std::chrono::steady_clock::now();
+            std::shared_ptr<Stream> ws;
+            try {
+                ws = co_await handshake(endpoints_[i]);
+            } catch (...) {
+                last_error = std::current_exception();
+            }
+            
+            const auto now = std::chrono::steady_clock::now();
+            if (!ws) {
+                selector_.on_failure(i, now);
+                if (endpoints_.size() > 1) {
+                    fmt::print("[CLIENT] {} unreachable, trying next endpoint\n", endpoints_[i].ws_url());
+                }
+                continue;
+            }
+            selector_.on_success(i, now - started);
+            on_connected_to(i);
+            co_return ws;
+        }
+        std::rethrow_exception(last_error);
     });
     
     if (result.failed()) {
         fmt::print("[CLIENT] Connection failed after {} attempts, total delay: {}ms\n",
                    result.attempts,
                    result.total_delay.count());
-                   
-        if (result.last_error) {
-            try {
-                std::rethrow_exception(result.last_error);
-            } catch (const std::exception& e) {
-                fmt::print("[CLIENT] Last error: {}\n", e.what());
+        std::rethrow_exception(result.last_error);
+    }
+    
+    fmt::print("[CLIENT] Connected to {} (attempt {})\n", cfg_.ws_url(), result.attempts);
+    co_return std::move(*result.value);
+}
+
+auto WSClient::handshake(const svckit::AddrConfig& endpoint) -> asio::awaitable<std::shared_ptr<Stream>> {
+    // Resolve host
+    tcp::resolver resolver{ioc_};
+    auto results = co_await resolver.async_resolve(
+        endpoint.host(),
+        std::to_string(endpoint.port()),
+        asio::use_awaitable
+    );
+    
+    // Create SSL stream
+    ssl::stream<tcp::socket> ssl_stream{ioc_, *ssl_ctx_};
+    
+    // Bound connect + TLS: a blackholed endpoint must not stall failover
+    asio::steady_timer deadline{ioc_};
+    deadline.expires_after(kConnectTimeout);
+    deadline.async_wait([&socket = beast::get_lowest_layer(ssl_stream)](beast::error_code ec) {
+        if (!ec) {
+            beast::error_code ignored;
+            socket.close(ignored);
+        }
+    });
+    
+    // Connect TCP
+    co_await beast::get_lowest_layer(ssl_stream).async_connect(
+        *results.begin(),
+        asio::use_awaitable
+    );
+    
+    // SSL handshake
+    co_await ssl_stream.async_handshake(
+        ssl::stream_base::client,
+        asio::use_awaitable
+    );
+    deadline.cancel();
+    
+    // Create WebSocket stream (shared with the pinger coroutine)
+    auto ws = std::make_shared<Stream>(std::move(ssl_stream));
+    
+    // Configure WebSocket
+    ws->set_option(websocket::stream_base::timeout::suggested(
+        beast::role_type::client
+    ));
+    
+    // WebSocket handshake
+    co_await ws->async_handshake(
+        endpoint.host(),
+        endpoint.endpoint(),
+        asio::use_awaitable
+    );
+    
+    co_return ws;
+}
+
+void WSClient::on_connected_to(std::size_t index) {
+    const auto previous = current_;
+    cfg_ = endpoints_[index];
+    current_ = index;
+    if (!lost_at_) {
+        return;
+    }
+    
+    const auto took = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - *lost_at_);
+    lost_at_.reset();
+    ++failover_.reconnects;
+    failover_.last = took;
+    failover_.max = std::max(failover_.max, took);
+    if (previous != current_) {
+        ++failover_.failovers;
+        fmt::print("[CLIENT] Failed over to {} in {}ms\n", cfg_.ws_url(), took.count());
+    } else {
+        fmt::print("[CLIENT] Reconnected to {} in {}ms\n", cfg_.ws_url(), took.count());
+    }
+}
+
+auto WSClient::run_prober() -> asio::awaitable<void> {
+    while (running_.load(std::memory_order_acquire)) {
+        probe_timer_.expires_after(selector_.config().probe_interval);
+        co_await probe_timer_.async_wait(asio::as_tuple(asio::use_awaitable));
+        if (!running_.load(std::memory_order_acquire) || !stream_) {
+            continue;   // Reconnect sweeps cover every endpoint anyway
+        }
+        
+        const auto candidate = selector_.probe_candidate(current_, std::chrono::steady_clock::now());
+        if (!candidate) {
+            continue;
+        }
+        
+        const auto started = std::chrono::steady_clock::now();
+        std::shared_ptr<Stream> ws;
+        try {
+            ws = co_await handshake(endpoints_[*candidate]);
+        } catch (const std::exception&) {
+            // Counted below
+        }
+        
+        const auto now = std::chrono::steady_clock::now();
+        if (!ws) {
+            selector_.on_failure(*candidate, now);
+            continue;
+        }
+        selector_.on_success(*candidate, now - started);
+        fmt::print("[CLIENT] Probe: {} is back\n", endpoints_[*candidate].ws_url());
+        co_await ws->async_close(
+            websocket::close_code::normal,
+            asio::as_tuple(asio::use_awaitable)
+        );
+    }
+}
+
+auto WSClient::endpoint_report() const -> std::vector<EndpointStatus> {
+    const auto health = selector_.report(std::chrono::steady_clock::now());
+    std::vector<EndpointStatus> out;
+    out.reserve(endpoints_.size());
+    for (std::size_t i = 0; i < endpoints_.size(); ++i) {
+        out.push_back(EndpointStatus{endpoints_[i].ws_url(), i == current_, health[i]});
+    }
+    return out;
+}
+
+void WSClient::attach_link_monitor(const std::shared_ptr<Stream>& ws) {
+    // Link probing — pongs are delivered to the callback during reads
+    link_ = protocol::link::SteadyLinkMonitor{link_cfg_};
+    ws->control_callback([this](websocket::frame_type kind, beast::string_view payload) {
+        const std::string_view data{payload.data(), payload.size()};
+        if (kind == websocket::frame_type::ping) {
+            link_.on_peer_ping(data, protocol::link::wall_clock_ns());
+        } else if (kind == websocket::frame_type::pong) {
+            const auto rtt = link_.on_pong(data, std::chrono::steady_clock::now());
+            if (rtt && current_) {
+                selector_.on_rtt(*current_, std::chrono::duration_cast<std::chrono::microseconds>(*rtt));
+            }
+        }
+    });
+    asio::co_spawn(ioc_, run_pinger(ws), asio::detached);
+}
+
+auto WSClient::run_link(LinkHandlers handlers) -> asio::awaitable<void> {
+    asio::steady_timer backoff{ioc_};
+    
+    while (running_.load(std::memory_order_acquire)) {
+        bool linked = false;
+        auto linked_at = std::chrono::steady_clock::now();
+        try {
+            auto ws = co_await connect();
+            if (!running_.load(std::memory_order_acquire)) {
+                // stop() landed while a reconnect was in flight
+                co_await ws->async_close(
+                    websocket::close_code::normal,
+                    asio::as_tuple(asio::use_awaitable)
+                );
+                break;
+            }
+            attach_link_monitor(ws);
+            ws->binary(true);
+            
+            // Anything queued for the previous connection is stale
+            outbox_.clear();
+            stream_ = ws;
+            linked = true;
+            linked_at = std::chrono::steady_clock::now();
+            if (handlers.on_connected) {
+                handlers.on_connected();
+            }
+            asio::co_spawn(ioc_, run_writer(ws), asio::detached);
+            
+            while (running_.load(std::memory_order_acquire)) {
+                beast::flat_buffer buffer;
+                auto [ec, bytes] = co_await ws->async_read(
+                    buffer,
+                    asio::as_tuple(asio::use_awaitable)
+                );
+                if (ec) {
+                    if (ec != websocket::error::closed) {
+                        fmt::print("[CLIENT] Link to {} lost: {}\n", cfg_.ws_url(), ec.message());
+                    }
+                    break;
+                }
+                if (!ws->got_binary()) {
+                    continue;
+                }
+                const auto data = buffer.data();
+                const std::string_view frame{static_cast<const char*>(data.data()), data.size()};
+                if (!complete_call(frame) && handlers.on_binary) {
+                    handlers.on_binary(frame);
+                }
+            }
+            
+            stream_.reset();
+            wake_.cancel();
+            co_await ws->async_close(
+                websocket::close_code::normal,
+                asio::as_tuple(asio::use_awaitable)
+            );
+        } catch (const std::exception& e) {
+            stream_.reset();
+            fmt::print("[CLIENT] Link to {} down: {}\n", cfg_.ws_url(), e.what());
+        }
+        
+        if (linked) {
+            // Requests on the dead connection will never be answered
+            fail_calls(protocol::rpc::RpcStatus::Disconnected);
+            if (handlers.on_disconnected) {
+                handlers.on_disconnected();
+            }
+        }
+        
+        if (!running_.load(std::memory_order_acquire)) {
+            break;
+        }
+        
+        if (linked) {
+            // The dropped endpoint cools down, so the sweep goes elsewhere
+            const auto now = std::chrono::steady_clock::now();
+            lost_at_ = now;
+            selector_.on_drop(*current_, now);
+            if (now - linked_at >= kMinLinkLifetime) {
+                continue;   // Fail over at once; a flapping link still pauses
             }
         }
+        
+        // The executor already backed off per attempt; pause one more
+        // maximum step before starting a fresh round
+        const auto& policy = retry_executor_.policy();
+        backoff.expires_after(policy.delay_for(policy.max_attempts()));
+        co_await backoff.async_wait(asio::as_tuple(asio::use_awaitable));
+    }
+}
+
+auto WSClient::run_writer(std::shared_ptr<Stream> ws) -> asio::awaitable<void> {
+    while (ws->is_open() && stream_ == ws) {
+        if (outbox_.empty()) {
+            wake_.expires_at(asio::steady_timer::time_point::max());
+            co_await wake_.async_wait(asio::as_tuple(asio::use_awaitable));
+            continue;
+        }
+        
+        const auto frame = std::move(outbox_.front());
+        outbox_.pop_front();
+        auto [ec, bytes] = co_await ws->async_write(
+            asio::buffer(frame),
+            asio::as_tuple(asio::use_awaitable)
+        );
+        if (ec) {
+            // Fail the read side too so run_link reconnects
+            beast::error_code ignored;
+            beast::get_lowest_layer(*ws).close(ignored);
+            break;
+        }
     }
 }
 
@@ -0,0 +1,320 @@
+#pragma once
+
+/// @file cluster.hpp
+/// @brief Multi-node track replication between WebSocket servers.
+///
+/// Demonstrates:
+/// - Rule of Six: Non-copyable, non-movable coroutine owners
+/// - WSClient link mode reused as the server-to-server transport
+/// - Latest-wins coalescing with bounded in-flight frames per peer
+/// - Per-origin sequence tracking and replication lag telemetry
+/// - Consistent-hash target ownership with ingest forwarding (sharded mode)
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/asio/awaitable.hpp>
+
+#include "hash_ring.hpp"
+#include "replication.hpp"
+#include "session.hpp"
+#include "svc_cluster_config.hpp"
+#include "track.hpp"
+#include "track_store.hpp"
+#include "ws_client.hpp"
+
+namespace ws {
+
+namespace asio = boost::asio;
+
+/// Interval between replication flushes to a peer.
+constexpr std::chrono::milliseconds kReplicaFlushInterval{20};
+
+/// Maximum tracks per ReplicaBatch frame.
+constexpr std::size_t kReplicaBatchMax = 512;
+
+/// Frames queued on a peer link before the flusher holds back.
+constexpr std::size_t kReplicaMaxInflight = 4;
+
+/// Interval between "[CLUSTER]" log reports.
+constexpr std::chrono::seconds kClusterReportInterval{5};
+
+
+/// Outbound replication state for one peer.
+struct PeerReport {
+    std::string peer;
+    std::optional<std::uint32_t> node;     ///< Learned from the peer's PeerHello
+    bool connected{false};
+    std::uint64_t sent_seq{0};             ///< Last batch sequence sent
+    std::uint64_t acked_seq{0};            ///< Last batch sequence acknowledged
+    std::chrono::milliseconds lag{0};      ///< Ingest → peer ack, last acked batch
+    std::size_t pending{0};                ///< Targets waiting for the next flush
+    std::uint64_t forwarded{0};            ///< Updates forwarded to this owner
+};
+
+/// Inbound replication state for one origin node.
+struct OriginReport {
+    std::uint32_t origin{0};
+    std::uint64_t last_seq{0};             ///< Last batch sequence applied
+    std::uint64_t applied{0};              ///< Updates applied to the store
+    std::uint64_t gaps{0};                 ///< Batches missing from the sequence
+    std::chrono::milliseconds lag{0};      ///< Smoothed origin ingest → local apply
+    std::chrono::milliseconds max_lag{0};
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PeerLink — One Outbound Replication Stream
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Owns a WSClient whose callbacks and flusher coroutine capture `this`
+// • Must stay at a fixed address — non-copyable, non-movable
+//
+// FLOW:
+// • offer() (replicas) and forward() (ingest for targets the peer owns)
+//   coalesce latest-wins per target in separate queues
+// • Every kReplicaFlushInterval the flusher packs up to kReplicaBatchMax
+//   targets per frame while fewer than kReplicaMaxInflight frames are
+//   queued, forwards first
+// • Each (re)connect sends PeerHello (and Subscribe if set_interest()); the
+//   peer answers with its own PeerHello, which reports the link up to the
+//   Cluster; the batch sequence restarts at 1
+// • The peer acks every batch; lag = ack time − oldest ingest in the batch
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Replication link to one peer node.
+///
+/// @par Thread Safety
+/// Not thread-safe; runs on the server's io_context thread.
+class PeerLink {
+public:
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: Non-copyable, Non-movable
+    // ───────────────────────────────────────────────────────────────────────
+
+    PeerLink() = delete;
+    ~PeerLink() = default;
+    PeerLink(const PeerLink&) = delete;
+    PeerLink& operator=(const PeerLink&) = delete;
+    PeerLink(PeerLink&&) = delete;
+    PeerLink& operator=(PeerLink&&) = delete;
+
+    /// Called with true once the peer has identified itself, false on loss.
+    using MembershipFn = std::function<void(PeerLink&, bool up)>;
+
+    PeerLink(asio::io_context& ioc,
+             const svckit::AddrConfig& peer,
+             std::uint32_t self,
+             MembershipFn on_membership);
+
+    /// Connect (and keep reconnecting) and start flushing.
+    void start();
+
+    /// Stop the link and the flusher.
+    void stop();
+
+    /// Queue a local update ingested at ingest_ns (dropped while disconnected).
+    void offer(const protocol::TrackUpdate& update, std::int64_t ingest_ns);
+
+    /// Queue ingest for a target this peer owns (dropped while disconnected).
+    void forward(const protocol::TrackUpdate& update, std::int64_t ingest_ns);
+
+    /// Ask the peer to replicate its owned targets to us (sharded mode).
+    void set_interest(bool on);
+
+    /// Peer's node id once its PeerHello has arrived.
+    [[nodiscard]] auto node() const noexcept -> std::optional<std::uint32_t> { return node_; }
+
+    /// True while connected and identified.
+    [[nodiscard]] auto up() const noexcept -> bool { return up_ && client_->is_connected(); }
+
+    [[nodiscard]] auto report() const -> PeerReport;
+
+private:
+    struct PendingReplica {
+        protocol::TrackUpdate update;
+        std::int64_t ingest_ns{0};   ///< Oldest ingest coalesced into this entry
+    };
+
+    using PendingMap = std::unordered_map<std::uint64_t, PendingReplica>;
+
+    void on_connected();
+    void on_disconnected();
+    void on_binary(std::string_view frame);
+    void queue(PendingMap& map, const protocol::TrackUpdate& update, std::int64_t ingest_ns);
+    void drain(PendingMap& map, bool forwarded);
+    void flush();
+    auto run_flusher() -> asio::awaitable<void>;
+
+    asio::io_context& ioc_;
+    std::string peer_;
+    std::uint32_t self_;
+    MembershipFn on_membership_;
+    std::unique_ptr<WSClient> client_;
+    asio::steady_timer flush_timer_;
+
+    PendingMap pending_;
+    PendingMap forward_;
+    std::optional<std::uint32_t> node_;
+    std::uint64_t sent_seq_{0};
+    std::uint64_t acked_seq_{0};
+    std::uint64_t forwarded_{0};
+    std::chrono::milliseconds lag_{0};
+    bool interested_{false};
+    bool up_{false};
+    bool running_{false};
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Cluster — Membership, Outbound Links, Inbound Apply
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// TOPOLOGY:
+// Full mesh — every node lists every other node in WS_PEERS and replicates
+// only the tracks it ingested itself. Replicas are never forwarded, so a
+// node missing from a peer's list is missing from that peer's picture.
+//
+// INBOUND:
+// A peer's link is an ordinary Session that sent PeerHello. Its batches
+// are applied to the TrackStore (stale updates by sensor time are skipped),
+// acked on the same session, and the accepted updates are returned for
+// fan-out to local subscribers.
+//
+// SHARDED MODE (ClusterConfig::sharded()):
+// • Each target is owned by one node on a consistent-hash ring of this
+//   node plus every identified, connected peer
+// • route() keeps ingest for owned targets and forwards the rest to their
+//   owner, which processes it as its own ingest (ForwardBatch)
+// • Owners replicate only to peers that subscribed over their link — a
+//   node subscribes to every peer once it has a local console
+// • A ring change moves only the targets whose owner changed; targets this
+//   node gave up are handed to their new owner
+//
+// RULE OF SIX RATIONALE:
+// • Owns PeerLinks and a reporter coroutine capturing `this`
+// • Single owner (WSServer) via unique_ptr — non-copyable, non-movable
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Replication hub for one server node.
+///
+/// @par Thread Safety
+/// Not thread-safe; runs on the server's io_context thread.
+class Cluster {
+public:
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: Non-copyable, Non-movable
+    // ───────────────────────────────────────────────────────────────────────
+
+    Cluster() = delete;
+    ~Cluster() = default;
+    Cluster(const Cluster&) = delete;
+    Cluster& operator=(const Cluster&) = delete;
+    Cluster(Cluster&&) = delete;
+    Cluster& operator=(Cluster&&) = delete;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Factory Methods
+    // ───────────────────────────────────────────────────────────────────────
+
+    template<typename... Args>
+    [[nodiscard]] static auto create(Args&&... args) -> std::unique_ptr<Cluster> {
+        return std::unique_ptr<Cluster>(new Cluster(std::forward<Args>(args)...));
+    }
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Operations
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Start peer links and the periodic reporter (no-op without peers).
+    void start();
+
+    /// Stop peer links and the reporter.
+    void stop();
+
+    /// Split local ingest by owner: forward non-owned targets, return owned.
+    ///
+    /// Without sharding every target is owned locally.
+    auto route(std::span<const protocol::TrackUpdate> tracks, std::int64_t ingest_ns)
+        -> std::vector<protocol::TrackUpdate>;
+
+    /// Replicate owned updates to every peer (sharded: interested peers).
+    void replicate(std::span<const protocol::TrackUpdate> tracks, std::int64_t ingest_ns);
+
+    /// Outcome of applying one ReplicaBatch or ForwardBatch.
+    struct Applied {
+        std::vector<protocol::TrackUpdate> tracks;  ///< Updates that changed the store
+        std::string ack;                             ///< ReplicaAck frame for the sender
+        bool forwarded{false};                       ///< We own these; caller replicates
+        std::int64_t ingest_ns{0};                   ///< Origin ingest on our clock
+    };
+
+    /// Owner-side screening of forwarded reports; removes what it rejects.
+    using ScreenFn = std::function<void(std::vector<protocol::TrackUpdate>&)>;
+
+    /// Apply a batch received on `from`. Returns nullopt if malformed.
+    ///
+    /// @param screen Run on forwarded batches (ingest we now own) before
+    ///        they reach the store; replicas were screened by their owner
+    auto apply_replica(const Session& from, std::string_view frame, const ScreenFn& screen = {})
+        -> std::optional<Applied>;
+
+    /// A peer subscribed (or its link closed) over its inbound session.
+    void set_peer_interest(std::uint32_t node, bool on);
+
+    /// A local console subscribed; pull owned targets from every peer.
+    void set_local_interest();
+
+    /// Owning node of a target (self when not sharded).
+    [[nodiscard]] auto owner(std::uint64_t target_id) const noexcept -> std::uint32_t;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Accessors / Telemetry
+    // ───────────────────────────────────────────────────────────────────────
+
+    [[nodiscard]] auto self() const noexcept -> std::uint32_t { return cfg_.node_id(); }
+    [[nodiscard]] auto clustered() const noexcept -> bool { return cfg_.clustered(); }
+
+    [[nodiscard]] auto peer_report() const -> std::vector<PeerReport>;
+    [[nodiscard]] auto origin_report() const -> std::vector<OriginReport>;
+
+private:
+    Cluster(asio::io_context& ioc,
+            svckit::ClusterConfig cfg,
+            std::shared_ptr<protocol::TrackStore> store);
+
+    void on_membership(PeerLink& link, bool up);
+    void rebalance(const protocol::HashRing& before);
+    void send_owned(PeerLink& link);
+    [[nodiscard]] auto link_for(std::uint32_t node) noexcept -> PeerLink*;
+
+    auto run_reporter() -> asio::awaitable<void>;
+
+    asio::io_context& ioc_;
+    svckit::ClusterConfig cfg_;
+    std::shared_ptr<protocol::TrackStore> store_;
+    std::vector<std::unique_ptr<PeerLink>> peers_;
+    std::unordered_map<std::uint32_t, OriginReport> origins_;
+    protocol::HashRing ring_;
+    std::unordered_set<std::uint32_t> interested_peers_;
+    asio::steady_timer report_timer_;
+    bool local_interest_{false};
+    bool running_{false};
+};
+
+}  // namespace ws
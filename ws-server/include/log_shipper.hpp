@@ -0,0 +1,124 @@
+#pragma once
+
+/// @file log_shipper.hpp
+/// @brief Streams the primary's ingest journal to a warm standby.
+///
+/// Demonstrates:
+/// - Rule of Six: Non-copyable, non-movable coroutine owner
+/// - Ack-windowed streaming over an existing Session
+/// - Heartbeat batches so the standby can tell idle from dead
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <boost/asio.hpp>
+#include <boost/asio/awaitable.hpp>
+
+#include "journal.hpp"
+#include "session.hpp"
+
+namespace ws {
+
+namespace asio = boost::asio;
+
+/// Maximum records per JournalBatch frame.
+constexpr std::size_t kShipBatchRecords = 512;
+
+/// Records sent but not yet acked before the shipper holds back.
+constexpr std::uint64_t kShipWindowRecords = 8 * kShipBatchRecords;
+
+/// Poll interval while the standby is caught up.
+constexpr std::chrono::milliseconds kShipIdleInterval{10};
+
+/// An empty batch is sent after this long without records.
+constexpr std::chrono::milliseconds kShipHeartbeatInterval{250};
+
+
+/// Shipping state for one attached standby.
+struct StandbyReport {
+    std::uint64_t session{0};
+    std::string source;
+    std::uint64_t sent_seq{0};     ///< Last journal sequence sent
+    std::uint64_t acked_seq{0};    ///< Last journal sequence the standby applied
+    std::uint64_t behind{0};       ///< Journal head − acked
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// LogShipper — One Standby Stream
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • run() captures `this` for the life of the standby's session
+// • Shared between WSServer (acks, reports) and its coroutine —
+//   non-copyable, non-movable, held by shared_ptr
+//
+// FLOW:
+// • Starts at the sequence named in the standby's StandbyHello (older
+//   records are read back from segment files)
+// • Sends up to kShipBatchRecords per frame while fewer than
+//   kShipWindowRecords are unacked; JournalAck opens the window
+// • Sends an empty batch every kShipHeartbeatInterval when idle
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Journal stream to one standby session.
+///
+/// @par Thread Safety
+/// Not thread-safe; runs on the server's io_context thread.
+class LogShipper {
+public:
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: Non-copyable, Non-movable
+    // ───────────────────────────────────────────────────────────────────────
+
+    LogShipper() = delete;
+    ~LogShipper() = default;
+    LogShipper(const LogShipper&) = delete;
+    LogShipper& operator=(const LogShipper&) = delete;
+    LogShipper(LogShipper&&) = delete;
+    LogShipper& operator=(LogShipper&&) = delete;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Factory Methods
+    // ───────────────────────────────────────────────────────────────────────
+
+    template<typename... Args>
+    [[nodiscard]] static auto create(Args&&... args) -> std::shared_ptr<LogShipper> {
+        return std::shared_ptr<LogShipper>(new LogShipper(std::forward<Args>(args)...));
+    }
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Operations
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Stream until stop() or the session closes.
+    auto run() -> asio::awaitable<void>;
+
+    /// The standby applied everything up to `seq`.
+    void on_ack(std::uint64_t seq) noexcept;
+
+    /// End the stream at the next wake-up.
+    void stop();
+
+    [[nodiscard]] auto report() const -> StandbyReport;
+
+private:
+    LogShipper(asio::io_context& ioc,
+               std::shared_ptr<Session> session,
+               std::shared_ptr<protocol::Journal> journal,
+               std::uint64_t next_seq);
+
+    asio::steady_timer timer_;
+    std::shared_ptr<Session> session_;
+    std::shared_ptr<protocol::Journal> journal_;
+    std::uint64_t next_seq_;
+    std::uint64_t acked_seq_;
+    bool running_{true};
+};
+
+}  // namespace ws
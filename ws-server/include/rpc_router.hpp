@@ -0,0 +1,127 @@
+#pragma once
+
+/// @file rpc_router.hpp
+/// @brief Named RPC methods executed on a worker pool (see rpc.hpp).
+///
+/// Demonstrates:
+/// - Handlers off the I/O thread via TaskPool::run (resumes on the caller)
+/// - Immutable shared state handed to concurrent handlers
+/// - Per-session admission to bound outstanding calls
+/// - Rule of Six: Non-copyable, non-movable (owns worker threads)
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/asio/awaitable.hpp>
+
+#include "protocol.hpp"
+#include "rpc.hpp"
+#include "task_pool.hpp"
+#include "track.hpp"
+
+namespace ws {
+
+namespace asio = boost::asio;
+
+/// Calls one session may have outstanding before it is answered Busy.
+constexpr std::size_t kRpcMaxInFlight = 64;
+
+/// Store contents as of one journal sequence, shared read-only by handlers.
+using TrackView = std::vector<protocol::TrackUpdate>;
+
+/// Method implementation; runs on a worker thread.
+///
+/// Throw protocol::rpc::BadRequestError for an unparseable payload; any
+/// other exception answers Failed with its message.
+using RpcHandler = std::function<protocol::Packet(const protocol::Packet& request, const TrackView& tracks)>;
+
+/// RPC counters.
+struct RpcStats {
+    std::uint64_t calls{0};
+    std::uint64_t errors{0};       ///< Answered with a non-Ok status
+    std::uint64_t busy{0};         ///< Refused by admission
+    std::size_t in_flight{0};
+    std::size_t workers{0};
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// RpcRouter — Method Table and Worker Pool
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Owns a TaskPool (worker threads capturing the pool)
+// • Non-copyable, non-movable; held by unique_ptr in WSServer
+//
+// FLOW:
+// • The server decodes a request, admit()s it for the session and spawns
+//   one coroutine per call, so a slow call never holds up the next one
+// • call() looks the method up on the I/O thread, runs the handler on the
+//   pool and resumes on the I/O thread with the response, which is sent
+//   as soon as it is ready — responses leave in completion order
+//
+// Built in: kMethodSnapshot, kMethodTarget, kMethodArea; kMethodJournal
+// once add_journal_query() names a journal directory.
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// RPC dispatch for one server.
+///
+/// @par Thread Safety
+/// add(), admit(), release(), call() and stats() on the server's
+/// io_context thread only; handlers run on the pool's workers. Register
+/// methods before the server runs.
+class RpcRouter {
+public:
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: Non-copyable, Non-movable
+    // ───────────────────────────────────────────────────────────────────────
+
+    RpcRouter() = delete;
+    ~RpcRouter() = default;
+    RpcRouter(const RpcRouter&) = delete;
+    RpcRouter& operator=(const RpcRouter&) = delete;
+    RpcRouter(RpcRouter&&) = delete;
+    RpcRouter& operator=(RpcRouter&&) = delete;
+
+    /// Start `workers` pool threads (0 = hardware concurrency) and register
+    /// the built-in track queries.
+    explicit RpcRouter(std::size_t workers);
+
+    /// Register (or replace) a method.
+    void add(std::string method, RpcHandler handler);
+
+    /// Register kMethodJournal over the segments in `dir`. Results are
+    /// capped at protocol::kJournalQueryLimit records per call.
+    void add_journal_query(std::filesystem::path dir);
+
+    /// Reserve an in-flight slot for `session`; false when it is at the cap.
+    [[nodiscard]] auto admit(std::uint64_t session) -> bool;
+
+    /// Return the slot taken by admit().
+    void release(std::uint64_t session);
+
+    /// Execute a request on the pool. Never throws; failures are statuses.
+    auto call(protocol::rpc::Request request, std::shared_ptr<const TrackView> tracks)
+        -> asio::awaitable<protocol::rpc::Response>;
+
+    [[nodiscard]] auto stats() const noexcept -> RpcStats;
+
+    /// Worker pool, shared with other CPU-bound server work.
+    [[nodiscard]] auto pool() noexcept -> protocol::exec::TaskPool& { return pool_; }
+
+private:
+    protocol::exec::TaskPool pool_;
+    std::unordered_map<std::string, RpcHandler> methods_;
+    std::unordered_map<std::uint64_t, std::size_t> in_flight_;
+    RpcStats stats_;
+};
+
+}  // namespace ws
@@ -0,0 +1,126 @@
+#pragma once
+
+/// @file server_state.hpp
+/// @brief Track store plus ingest journal — the state a server can hand over.
+///
+/// A primary builds its ServerState from its latest snapshot plus the
+/// journal records after it; a warm standby keeps one current by applying
+/// shipped journal records and, on failover, passes it to the WSServer it
+/// promotes.
+///
+/// Demonstrates:
+/// - Value bundle of shared resources (copy shares, never duplicates)
+/// - Snapshot load + journal tail replay on start-up
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "journal.hpp"
+#include "snapshot.hpp"
+#include "track_store.hpp"
+#include "upload_sink.hpp"
+
+namespace ws {
+
+/// Records read per journal replay step.
+constexpr std::size_t kReplayChunk = 4096;
+
+/// Apply one journal record to `store`; a drop record erases its target.
+inline void apply_journal_record(protocol::TrackStore& store, const protocol::JournalRecord& rec) {
+    if (rec.is_drop()) {
+        store.erase(rec.update.target_id);
+        return;
+    }
+    store.apply(rec.update, rec.origin, rec.origin_seq, rec.ingest_ns);
+}
+
+/// Apply journal records from `from_seq` onward to `store`.
+///
+/// @return Number of records replayed
+inline auto replay_journal(protocol::Journal& journal,
+                           protocol::TrackStore& store,
+                           std::uint64_t from_seq = 0) -> std::uint64_t {
+    std::uint64_t replayed = 0;
+    std::vector<protocol::JournalRecord> chunk;
+    chunk.reserve(kReplayChunk);
+
+    from_seq = std::max(from_seq, journal.first_seq());
+    while (from_seq < journal.next_seq()) {
+        chunk.clear();
+        if (journal.read(from_seq, kReplayChunk, chunk) == 0) {
+            break;
+        }
+        for (const auto& rec : chunk) {
+            apply_journal_record(store, rec);
+        }
+        replayed += chunk.size();
+        from_seq = chunk.back().seq + 1;
+    }
+    return replayed;
+}
+
+
+/// Shared server state (RULE OF SIX: all defaulted — copies share).
+struct ServerState {
+    std::shared_ptr<protocol::TrackStore> store;
+    std::shared_ptr<protocol::Journal> journal;
+
+    /// Background snapshot writer (null when snapshots are disabled).
+    std::shared_ptr<protocol::SnapshotWriter> snapshots;
+
+    /// Receiver for chunked uploads (null when uploads are disabled).
+    std::shared_ptr<UploadSink> uploads;
+
+    /// How the store was rebuilt: the snapshot loaded, then records replayed.
+    std::optional<protocol::SnapshotInfo> restored;
+    std::uint64_t replayed{0};
+
+    /// Empty store with a memory-only journal.
+    [[nodiscard]] static auto in_memory() -> ServerState {
+        ServerState state;
+        state.store = std::make_shared<protocol::TrackStore>();
+        state.journal = std::make_shared<protocol::Journal>(protocol::Journal::open(protocol::JournalConfig{}));
+        return state;
+    }
+
+    /// Open the journal in cfg.dir and rebuild the store: load the snapshot
+    /// (if enabled and present), then replay the journal records after it.
+    ///
+    /// An unreadable snapshot is reported and ignored (full replay).
+    ///
+    /// @throws std::system_error on journal I/O failure
+    [[nodiscard]] static auto open(protocol::JournalConfig cfg,
+                                   protocol::SnapshotConfig snap = {}) -> ServerState {
+        ServerState state;
+        state.store = std::make_shared<protocol::TrackStore>();
+        state.journal = std::make_shared<protocol::Journal>(protocol::Journal::open(std::move(cfg)));
+
+        std::uint64_t from_seq = 0;
+        if (snap.enabled()) {
+            try {
+                state.restored = protocol::load_snapshot(snap.path, *state.store);
+            } catch (const std::exception& e) {
+                fmt::print(stderr, "[MAIN] Ignoring snapshot: {}\n", e.what());
+                *state.store = protocol::TrackStore{};
+            }
+            if (state.restored) {
+                from_seq = state.restored->journal_seq + 1;
+                state.journal->skip_to(from_seq);
+            }
+            state.snapshots = std::make_shared<protocol::SnapshotWriter>(std::move(snap));
+        }
+
+        state.replayed = replay_journal(*state.journal, *state.store, from_seq);
+        return state;
+    }
+};
+
+}  // namespace ws
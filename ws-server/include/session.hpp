@@ -0,0 +1,246 @@
+#pragma once
+
+/// @file session.hpp
+/// @brief Server-side WebSocket session with an adaptive outbound queue.
+///
+/// Demonstrates:
+/// - Rule of Six: Non-copyable, non-movable shared object
+/// - Single-writer coroutine draining a prioritised queue
+/// - Latest-wins coalescing of per-target track updates
+/// - Adaptive egress via SendRateController
+/// - Ping/pong RTT probing through Beast's control callback
+/// - Latency-trace egress stamping
+/// - Feed sequence numbers for snapshot + delta mirrors
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+
+#include "latency.hpp"
+#include "link_quality.hpp"
+#include "mirror.hpp"
+#include "protocol.hpp"
+#include "send_rate.hpp"
+#include "track.hpp"
+
+namespace ws {
+
+namespace asio = boost::asio;
+namespace beast = boost::beast;
+namespace ssl = asio::ssl;
+namespace websocket = beast::websocket;
+using tcp = asio::ip::tcp;
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Session — Non-Copyable, Non-Movable Shared Object
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+//
+// A session is referenced concurrently by its read loop, its writer
+// coroutine and the server's fan-out registry. All three hold shared_ptr;
+// the object itself must stay at a fixed address while coroutines run.
+//
+// DECISION: Non-copyable, non-movable, shared via std::shared_ptr
+// • Default ctor: Deleted (requires a connected stream)
+// • Destructor: Defaulted (stream closes its own socket)
+// • Copy/Move: DELETED
+//
+// OUTBOUND QUEUE:
+// • Control/echo frames — FIFO, always delivered, written first
+// • Track updates — coalesced latest-wins per target, then paced by
+//   SendRateController: a target not yet due is held (with its newest
+//   state) until it is; the writer packs up to batch_size() ready targets
+//   into one TrackBatch frame
+// • Each pending target keeps the latency trace of the batch it arrived
+//   in; an outgoing batch carries the stalest one, egress-stamped
+//
+// LINK PROBING:
+// • A pinger coroutine sends a timestamped Probe ping every ping_interval
+// • The control callback feeds pongs to a LinkMonitor (RTT, jitter, loss)
+// • Smoothed RTT is fed to the SendRateController
+// • The peer's own probe pings yield its wall-clock offset (latency traces)
+// • No pong for stall_timeout aborts the socket, long before the idle timeout
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// One accepted WebSocket connection.
+///
+/// @par Thread Safety
+/// Not thread-safe. All calls must run on the server's io_context thread.
+class Session : public std::enable_shared_from_this<Session> {
+public:
+    using Stream = websocket::stream<ssl::stream<tcp::socket>>;
+    using clock = std::chrono::steady_clock;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: Non-copyable, Non-movable
+    // ───────────────────────────────────────────────────────────────────────
+
+    Session() = delete;
+    ~Session() = default;
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+    Session(Session&&) = delete;
+    Session& operator=(Session&&) = delete;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Factory Methods
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Create shared session with perfect forwarding.
+    template<typename... Args>
+    [[nodiscard]] static auto create(Args&&... args) -> std::shared_ptr<Session> {
+        return std::shared_ptr<Session>(new Session(std::forward<Args>(args)...));
+    }
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Outbound
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Queue a frame for unconditional delivery.
+    void send_frame(std::string frame, bool binary);
+
+    /// Offer a track update; coalesced with any pending one and held
+    /// until the target is due at the current send rate.
+    ///
+    /// @param trace Ingress-stamped trace of the batch carrying the update
+    void send_track(const protocol::TrackUpdate& update,
+                    std::shared_ptr<const protocol::LatencyTrace> trace = nullptr);
+
+    /// Discard pacing and any pending update for a dropped target.
+    void forget_track(std::uint64_t target_id);
+
+    /// Queue a TrackSnapshot frame set in place of any pending track
+    /// updates. The frames are shared, not copied; the feed sequence
+    /// continues from the snapshot's `seq`, as a mirroring client expects.
+    ///
+    /// @param catch_up Targets changed since the frames were built; queued
+    ///        right behind them as sequenced TrackBatch frames, never paced
+    void send_snapshot(std::span<const protocol::mirror::SharedFrame> frames, std::uint64_t seq,
+                       std::span<const protocol::TrackUpdate> catch_up = {});
+
+    /// Writer coroutine. Spawn once per session.
+    auto run_writer() -> asio::awaitable<void>;
+
+    /// Probe pinger coroutine. Spawn once per session.
+    auto run_pinger() -> asio::awaitable<void>;
+
+    /// Stop the writer and pinger; queued data is discarded.
+    void close();
+
+    /// close() and drop the TCP connection so a blocked read fails now.
+    void abort();
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Accessors
+    // ───────────────────────────────────────────────────────────────────────
+
+    [[nodiscard]] auto stream() noexcept -> Stream& { return ws_; }
+    [[nodiscard]] auto id() const noexcept -> std::uint64_t { return id_; }
+    [[nodiscard]] auto source() const noexcept -> const std::string& { return source_; }
+    [[nodiscard]] auto is_open() const noexcept -> bool { return !closed_; }
+
+    [[nodiscard]] auto subscribed() const noexcept -> bool { return subscribed_; }
+    void set_subscribed(bool on) noexcept { subscribed_ = on; }
+
+    /// Cluster node id when the remote end is a peer server (PeerHello).
+    [[nodiscard]] auto peer_node() const noexcept -> std::optional<std::uint32_t> { return peer_node_; }
+    void set_peer_node(std::uint32_t node) noexcept { peer_node_ = node; }
+
+    /// Track targets ready to send (the controller's queue-depth signal).
+    /// Targets held back by pacing are not counted.
+    [[nodiscard]] auto queue_depth() const noexcept -> std::size_t { return track_order_.size(); }
+
+    /// Current send-rate report.
+    [[nodiscard]] auto rate_state() const noexcept -> protocol::ratelimit::SendRateState {
+        return rate_.state();
+    }
+
+    /// Current link quality report.
+    [[nodiscard]] auto link_stats() const -> protocol::link::LinkStats {
+        return link_.stats(clock::now());
+    }
+
+    /// Estimated local − peer wall-clock offset (see LinkMonitor).
+    [[nodiscard]] auto clock_offset() const -> std::optional<std::chrono::nanoseconds> {
+        return link_.clock_offset();
+    }
+
+private:
+    Session(std::uint64_t id,
+            std::string source,
+            Stream ws,
+            const protocol::ratelimit::SendRateConfig& rate_cfg,
+            const protocol::link::LinkQualityConfig& link_cfg);
+
+    struct OutFrame {
+        std::string data;
+        bool binary{true};
+        protocol::mirror::SharedFrame shared{};   ///< Sent instead of data when set
+    };
+
+    struct PendingTrack {
+        protocol::TrackUpdate update;
+        std::shared_ptr<const protocol::LatencyTrace> trace;
+        clock::time_point due{};   ///< Release time while held
+        bool held{false};
+    };
+
+    /// Held target keyed by release time; stale entries are skipped.
+    using HeldTrack = std::pair<clock::time_point, std::uint64_t>;
+
+    void wake();
+    void release_held(clock::time_point now);
+    void on_control(websocket::frame_type kind, std::string_view payload);
+    void tick_rate(clock::time_point now);
+    auto take_track_batch() -> std::string;
+
+    std::uint64_t id_;
+    std::string source_;
+    Stream ws_;
+
+    /// Parks the writer while both queues are empty.
+    asio::steady_timer wake_;
+
+    std::deque<OutFrame> frames_;
+    std::deque<std::uint64_t> track_order_;
+    std::unordered_map<std::uint64_t, PendingTrack> pending_tracks_;
+    std::priority_queue<HeldTrack, std::vector<HeldTrack>, std::greater<>> held_;
+
+    /// Sequence of the last TrackBatch taken (stamped on every batch).
+    /// A snapshot resets it to the snapshot's sequence.
+    std::uint64_t feed_seq_{0};
+
+    protocol::ratelimit::SendRateController rate_;
+
+    /// Probe state and the timer pacing pings.
+    protocol::link::SteadyLinkMonitor link_;
+    asio::steady_timer ping_timer_;
+
+    std::optional<std::uint32_t> peer_node_;
+    bool subscribed_{false};
+    bool closed_{false};
+};
+
+}  // namespace ws
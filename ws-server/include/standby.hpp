@@ -0,0 +1,194 @@
+#pragma once
+
+/// @file standby.hpp
+/// @brief Warm standby: mirrors a primary's journal and takes over its port.
+///
+/// Demonstrates:
+/// - Rule of Six: Non-copyable, non-movable coroutine owner
+/// - WSClient link mode as the log-shipping receiver
+/// - Heartbeat-silence failure detection
+/// - Promotion by constructing a WSServer over already-warm state
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include <boost/asio.hpp>
+#include <boost/asio/awaitable.hpp>
+
+#include "server_state.hpp"
+#include "svc_addr_config.hpp"
+#include "svc_cluster_config.hpp"
+#include "ws_client.hpp"
+#include "ws_server.hpp"
+
+namespace ws {
+
+namespace asio = boost::asio;
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// StandbyConfig — Trivial Class Pattern with Builder Methods
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Failure detection and takeover timing.
+struct StandbyConfig {
+    // Rule of Six: All Default
+    StandbyConfig() = default;
+    ~StandbyConfig() = default;
+    StandbyConfig(const StandbyConfig&) = default;
+    StandbyConfig& operator=(const StandbyConfig&) = default;
+    StandbyConfig(StandbyConfig&&) noexcept = default;
+    StandbyConfig& operator=(StandbyConfig&&) noexcept = default;
+
+    /// Primary silence (no batch or heartbeat) that triggers promotion.
+    std::chrono::milliseconds failover_after{1000};
+
+    /// Watchdog tick; bounds detection slack.
+    std::chrono::milliseconds check_interval{50};
+
+    /// Delay between bind attempts while the primary still holds the port.
+    std::chrono::milliseconds bind_retry{100};
+
+    [[nodiscard]] auto with_failover_after(std::chrono::milliseconds d) && -> StandbyConfig {
+        failover_after = d;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_bind_retry(std::chrono::milliseconds d) && -> StandbyConfig {
+        bind_retry = d;
+        return std::move(*this);
+    }
+};
+
+/// Timing of a completed promotion.
+struct RecoveryReport {
+    std::chrono::milliseconds detect{0};     ///< Last primary contact → failure declared
+    std::chrono::milliseconds takeover{0};   ///< Failure declared → listening
+    std::chrono::milliseconds total{0};      ///< Last primary contact → listening
+    std::uint64_t last_seq{0};               ///< Journal head at promotion
+    std::size_t tracks{0};                   ///< Targets served from the warm store
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Standby — Warm Replica of One Primary
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Link callbacks and the watchdog coroutine capture `this`
+// • Single owner (main) via unique_ptr — non-copyable, non-movable
+//
+// FLOW:
+// • Connects to the primary and sends StandbyHello with its journal's
+//   next_seq(), so a restarted standby resumes where its journal ends
+// • Each JournalBatch is appended to the local journal (keeping primary
+//   sequence numbers) and applied to the local TrackStore, then acked
+// • The primary sends a heartbeat batch every kShipHeartbeatInterval;
+//   failover_after of silence (crash, hang or partition) declares it dead
+// • Promotion stops the link and builds a WSServer on the listen address
+//   over the warm ServerState, retrying the bind while the port is held
+//
+// A standby that never reached its primary does not promote. Consoles and
+// sensors reconnect through their own retry; a console's Subscribe is then
+// answered from the warm store. Run the standby with the primary's
+// WS_NODE_ID and WS_PEERS so it takes the primary's place in a cluster.
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Warm standby for one primary server.
+///
+/// @par Thread Safety
+/// Not thread-safe; runs on one io_context thread.
+class Standby {
+public:
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: Non-copyable, Non-movable
+    // ───────────────────────────────────────────────────────────────────────
+
+    Standby() = delete;
+    ~Standby() = default;
+    Standby(const Standby&) = delete;
+    Standby& operator=(const Standby&) = delete;
+    Standby(Standby&&) = delete;
+    Standby& operator=(Standby&&) = delete;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Factory Methods
+    // ───────────────────────────────────────────────────────────────────────
+
+    template<typename... Args>
+    [[nodiscard]] static auto create(Args&&... args) -> std::unique_ptr<Standby> {
+        return std::unique_ptr<Standby>(new Standby(std::forward<Args>(args)...));
+    }
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Operations
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Connect to the primary and start the failure watchdog.
+    void start();
+
+    /// Stop mirroring, or stop the promoted server.
+    void stop();
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Accessors / Telemetry
+    // ───────────────────────────────────────────────────────────────────────
+
+    [[nodiscard]] auto promoted() const noexcept -> bool { return server_ != nullptr; }
+
+    /// Promoted server (nullptr while standing by).
+    [[nodiscard]] auto server() noexcept -> WSServer* { return server_.get(); }
+
+    /// Promotion timing once promoted.
+    [[nodiscard]] auto recovery() const noexcept -> const std::optional<RecoveryReport>& {
+        return recovery_;
+    }
+
+    /// Last journal sequence applied locally.
+    [[nodiscard]] auto applied_seq() const noexcept -> std::uint64_t { return state_.journal->last_seq(); }
+
+    /// Records the primary had that are not applied here yet.
+    [[nodiscard]] auto behind() const noexcept -> std::uint64_t {
+        return primary_last_seq_ > applied_seq() ? primary_last_seq_ - applied_seq() : 0;
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    Standby(asio::io_context& ioc,
+            svckit::AddrConfig primary,
+            svckit::AddrConfig listen,
+            ServerState state,
+            svckit::ClusterConfig cluster,
+            StandbyConfig cfg);
+
+    void on_connected();
+    void on_binary(std::string_view frame);
+    auto run_watchdog() -> asio::awaitable<void>;
+    auto promote(clock::time_point detected) -> asio::awaitable<void>;
+
+    asio::io_context& ioc_;
+    svckit::AddrConfig primary_;
+    svckit::AddrConfig listen_;
+    ServerState state_;
+    svckit::ClusterConfig cluster_;
+    StandbyConfig cfg_;
+    std::unique_ptr<WSClient> client_;
+    asio::steady_timer timer_;
+    std::unique_ptr<WSServer> server_;
+
+    clock::time_point last_heard_{};
+    std::uint64_t primary_last_seq_{0};
+    std::uint64_t gaps_{0};
+    bool contacted_{false};
+    bool running_{false};
+    std::optional<RecoveryReport> recovery_;
+};
+
+}  // namespace ws
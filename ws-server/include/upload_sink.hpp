@@ -0,0 +1,195 @@
+#pragma once
+
+/// @file upload_sink.hpp
+/// @brief Server side of chunked, resumable uploads (see upload.hpp).
+///
+/// Demonstrates:
+/// - Positional writes (pwrite) straight from the received frame
+/// - Per-upload resume state keyed by a client-chosen id
+/// - Rule of Six: Non-copyable, non-movable owner of open files
+/// - Idle expiry and bounded completion memory
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "posix_file.hpp"
+#include "upload.hpp"
+
+namespace ws {
+
+using namespace std::chrono_literals;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// UploadSinkConfig — Trivial Class Pattern with Builder Methods
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Upload placement and limits. An empty directory disables uploads.
+struct UploadSinkConfig {
+    // Rule of Six: All Default
+    UploadSinkConfig() = default;
+    ~UploadSinkConfig() = default;
+    UploadSinkConfig(const UploadSinkConfig&) = default;
+    UploadSinkConfig& operator=(const UploadSinkConfig&) = default;
+    UploadSinkConfig(UploadSinkConfig&&) noexcept = default;
+    UploadSinkConfig& operator=(UploadSinkConfig&&) noexcept = default;
+
+    /// Completed files land here; partial ones as `<id>.part`.
+    std::filesystem::path dir;
+
+    /// Unfinished uploads held open at once.
+    std::size_t max_active{64};
+
+    /// An unfinished upload with no chunk for this long is dropped with
+    /// its part file, freeing its slot.
+    std::chrono::seconds idle_timeout{600s};
+
+    /// Finished upload ids remembered (oldest forgotten first).
+    std::size_t max_completed{1024};
+
+    [[nodiscard]] auto with_dir(std::filesystem::path d) && -> UploadSinkConfig {
+        dir = std::move(d);
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_max_active(std::size_t n) && -> UploadSinkConfig {
+        max_active = n;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_idle_timeout(std::chrono::seconds d) && -> UploadSinkConfig {
+        idle_timeout = d;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto with_max_completed(std::size_t n) && -> UploadSinkConfig {
+        max_completed = n;
+        return std::move(*this);
+    }
+
+    [[nodiscard]] auto enabled() const noexcept -> bool { return !dir.empty(); }
+};
+
+/// Upload counters.
+struct UploadStats {
+    std::uint64_t started{0};
+    std::uint64_t resumed{0};          ///< UploadBegin for an upload already in progress
+    std::uint64_t completed{0};
+    std::uint64_t rejected{0};
+    std::uint64_t expired{0};          ///< Abandoned uploads dropped after idle_timeout
+    std::uint64_t corrupt_chunks{0};   ///< Chunk hash mismatches (resent by the client)
+    std::uint64_t bytes{0};            ///< Chunk bytes written
+    std::size_t active{0};
+};
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// UploadSink — Chunk Verification and Positional Writes
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// RULE OF SIX RATIONALE:
+// • Owns one open PosixFile per unfinished upload
+// • Shared by the WSServer through ServerState — non-copyable,
+//   non-movable, held by shared_ptr
+//
+// FLOW:
+// • begin(): a new id opens `<dir>/<id>.part`; a known id answers Resume
+//   with its committed offset, whichever session it arrives on
+// • chunk(): accepted only at the committed offset with the expected
+//   length and hash, then pwrite()n from the frame — nothing is buffered
+// • A chunk that fails its hash is answered once with Corrupt; chunks
+//   still in flight behind it arrive at the wrong offset and are dropped
+//   silently until the client rewinds
+// • The last chunk checks the folded file hash, fdatasyncs and links
+//   the part file to its name — never over an existing file
+// • A name already on disk or claimed by another upload is rejected
+// • Uploads idle for idle_timeout are dropped with their part files,
+//   swept whenever upload frames arrive
+// • The last max_completed finished ids are remembered for lost acks
+//
+// Resume state lives in memory: a server restart starts uploads over.
+//
+// ═══════════════════════════════════════════════════════════════════════════
+
+/// Receives uploads into a directory.
+///
+/// @par Thread Safety
+/// Not thread-safe; used on the server's io_context thread.
+class UploadSink {
+public:
+    using Ack = protocol::upload::UploadAck;
+    using clock = std::chrono::steady_clock;
+
+    // ───────────────────────────────────────────────────────────────────────
+    // RULE OF SIX: Non-copyable, Non-movable
+    // ───────────────────────────────────────────────────────────────────────
+
+    UploadSink() = delete;
+    ~UploadSink() = default;
+    UploadSink(const UploadSink&) = delete;
+    UploadSink& operator=(const UploadSink&) = delete;
+    UploadSink(UploadSink&&) = delete;
+    UploadSink& operator=(UploadSink&&) = delete;
+
+    /// @throws std::filesystem::filesystem_error if cfg.dir cannot be created
+    explicit UploadSink(UploadSinkConfig cfg);
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Frames
+    // ───────────────────────────────────────────────────────────────────────
+
+    /// Handle UploadBegin; the reply is Resume, Complete or Rejected.
+    [[nodiscard]] auto begin(const protocol::upload::UploadBegin& begin) -> Ack;
+
+    /// Handle UploadChunk; nullopt means drop silently (stale in-flight chunk).
+    [[nodiscard]] auto chunk(const protocol::upload::UploadChunk& chunk) -> std::optional<Ack>;
+
+    /// Drop uploads idle since before `now - idle_timeout`.
+    void expire(clock::time_point now);
+
+    // ───────────────────────────────────────────────────────────────────────
+    // Accessors
+    // ───────────────────────────────────────────────────────────────────────
+
+    [[nodiscard]] auto stats() const noexcept -> UploadStats {
+        auto out = stats_;
+        out.active = active_.size();
+        return out;
+    }
+
+    [[nodiscard]] auto config() const noexcept -> const UploadSinkConfig& { return cfg_; }
+
+private:
+    struct Active {
+        protocol::upload::UploadBegin meta;
+        std::filesystem::path part;
+        protocol::PosixFile file;
+        std::uint64_t committed{0};
+        std::uint64_t running_hash{0};
+        clock::time_point last_activity{};
+    };
+
+    /// Verify, sync and move a fully committed upload into place.
+    auto finish(std::unordered_map<std::uint64_t, Active>::iterator it) -> Ack;
+
+    /// Drop an upload and its part file.
+    auto reject(std::uint64_t id, const std::string& why) -> Ack;
+
+    /// Remember a finished id, forgetting the oldest past max_completed.
+    void remember_completed(std::uint64_t id);
+
+    UploadSinkConfig cfg_;
+    std::unordered_map<std::uint64_t, Active> active_;
+    std::unordered_set<std::uint64_t> completed_;   // Answers a Begin whose Complete ack was lost
+    std::deque<std::uint64_t> completed_order_;     // Oldest first
+    UploadStats stats_;
+};
+
+}  // namespace ws
@@ -8,12 +8,37 @@
 /// - Perfect forwarding factory method
 /// - Policy-based packet dispatch
 /// - Asio awaitable coroutines (no Cobalt)
+/// - Token-bucket ingest limiting with TCP backpressure
+/// - Track fan-out through adaptive per-session send queues
+/// - Per-session ping/pong RTT and link quality telemetry
+/// - Latency-trace ingress/egress stamping for sensor-to-screen breakdown
+/// - Multi-node clustering with track replication between servers
+/// - Ingest journal with log shipping to a warm standby
+/// - Periodic background snapshots for fast restart
+/// - Chunked, resumable uploads written with positional I/O
+/// - Correlated RPC answered from a worker pool, out of order
+/// - Windowed duplicate suppression ahead of dispatch
+/// - Timestamp-ordered jitter buffer with per-sensor clock offsets
+/// - Periodic parallel CPA screening streamed to consoles as alert frames
+/// - Intercept solutions streamed to subscribers on every Red update
+/// - Incremental swarm clustering summarised to subscribed consoles
+/// - Level-of-detail tile streams sized by viewport, not track count
+/// - Track lifecycle with timing-wheel expiry and drop events
+/// - Kinematic anomaly screening with a quarantine side stream
+/// - Running per-sector statistics and heatmaps, queried or streamed
 
 #include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <boost/asio.hpp>
 #include <boost/asio/awaitable.hpp>
@@ -23,9 +48,31 @@
 #include <boost/beast/websocket.hpp>
 #include <boost/beast/websocket/ssl.hpp>
 
+#include "anomaly.hpp"
+#include "cluster.hpp"
+#include "cpa.hpp"
+#include "intercept.hpp"
+#include "dedup.hpp"
+#include "jitter_buffer.hpp"
+#include "lifecycle.hpp"
+#include "journal.hpp"
+#include "lod.hpp"
+#include "log_shipper.hpp"
+#include "mirror.hpp"
 #include "protocol.hpp"
+#include "rate_limit.hpp"
 #include "retry.hpp"
+#include "sector.hpp"
+#include "rpc_router.hpp"
+#include "server_state.hpp"
+#include "session.hpp"
+#include "snapshot.hpp"
 #include "svc_addr_config.hpp"
+#include "svc_cluster_config.hpp"
+#include "swarm.hpp"
+#include "track.hpp"
+#include "track_store.hpp"
+#include "upload_sink.hpp"
 
 namespace ws {
 
@@ -35,6 +82,12 @@ namespace ssl = asio::ssl;
 namespace websocket = beast::websocket;
 using tcp = asio::ip::tcp;
 
+/// Interval between journal flushes to the segment files.
+constexpr std::chrono::milliseconds kJournalFlushInterval{100};
+
+/// Most new or escalated CPA conflicts sent per screening pass.
+constexpr std::size_t kCpaMaxAlerts = 16;
+
 
 // ═══════════════════════════════════════════════════════════════════════════
 // WSServer — Move-Only Resource Class
@@ -69,6 +122,163 @@ using tcp = asio::ip::tcp;
 /// @par Thread Safety
 /// Not thread-safe. Run from single thread or strand.
 ///
+/// @par Ingest Limiting
+/// Each session and each source address is guarded by message and byte
+/// token buckets. When a bucket is in debt the session stops reading until
+/// it recovers, so TCP flow control throttles the sender. Frames are never
+/// dropped. A track batch's message cost is split across its records, and
+/// by default RED records are exempt from their share only. RED does not
+/// bypass the byte budget: bytes are always charged, so a flood marked
+/// urgent is still bounded by bytes_per_sec. A source's limiter
+/// outlives its sessions until its buckets have refilled, so reconnecting
+/// does not reset the budget. A session that sent PeerHello is charged
+/// to its own peer budget (IngestLimitConfig::peer_bytes_per_sec) from
+/// then on instead, so replication between nodes is not paused at a
+/// single console's rate.
+///
+/// @par Duplicate Suppression
+/// Every report in a TrackBatch is checked against a fixed-memory filter
+/// of the reports ingested in the last DedupConfig::window (keyed by
+/// content, across all sessions); copies are dropped before they reach the
+/// store, the cluster or any subscriber, and counted per source address
+/// (dedup_report()).
+///
+/// @par Reordering
+/// With a reorder hold set (set_reorder()), sensor reports are held in a
+/// JitterBuffer and applied in measurement order, each sensor's reports
+/// mapped onto the server clock by their min-delay-corrected time.
+/// Released reports go through the same routing, store and fan-out as
+/// direct ingest, with the latency trace their batch arrived with, so the
+/// hold is part of the traced ingress-to-egress time. A report behind what
+/// was already released for its target is late and follows
+/// JitterConfig::late.
+///
+/// @par Track Fan-Out
+/// Binary TrackBatch frames are fanned out to every session that sent a
+/// Subscribe frame. Each subscriber has its own SendRateController, so a
+/// console on a degraded link receives every target at a reduced rate
+/// instead of an ever-growing backlog.
+///
+/// @par Link Quality
+/// Every session sends a timestamped probe ping each second and records
+/// pong RTT, jitter and loss (see link_report()). Rising RTT throttles the
+/// session's send rate; a link with no pong for stall_timeout is dropped
+/// instead of waiting out the WebSocket idle timeout.
+///
+/// @par Latency Tracing
+/// A TrackBatch carrying a latency trace is rebased onto the server clock
+/// (using the sender's probe-derived clock offset) and ingress-stamped;
+/// fan-out batches carry the trace egress-stamped at write time.
+///
+/// @par Clustering
+/// With peers configured (svckit::ClusterConfig), every locally ingested
+/// update is also replicated to each peer over a persistent WSClient link,
+/// and replicas received from peers are applied to the local TrackStore and
+/// fanned out like local tracks. A new subscriber first receives the whole
+/// store, so a console attached to any node sees the global picture.
+///
+/// In a sharded cluster each target has one owner on a consistent-hash
+/// ring; ingest for other targets is forwarded to the owner, and owners
+/// replicate only to nodes that have consoles subscribed.
+///
+/// @par Journal and Standby
+/// Every change to the TrackStore is appended to the ingest journal
+/// (ServerState), flushed to its segment files every
+/// kJournalFlushInterval. A session that sends StandbyHello becomes a warm
+/// standby: a LogShipper streams it the journal from the sequence it asked
+/// for (see Standby).
+///
+/// @par Snapshots
+/// With snapshots enabled (ServerState::snapshots) the store is copied
+/// every SnapshotConfig::interval while the journal advances, and once more
+/// on stop(); a background thread encodes and writes it. Restart loads the
+/// snapshot and replays only the journal records after it.
+///
+/// @par Uploads
+/// With an UploadSink in its ServerState, the server accepts chunked
+/// uploads (upload.hpp): each verified chunk is pwrite()n at its offset
+/// from the received frame and acked, and a client that reconnects
+/// resumes from the committed offset. Uploads share the session's ingest
+/// limits, so a bulk upload cannot starve track ingest.
+///
+/// @par RPC
+/// RpcRequest frames (rpc.hpp) are dispatched through rpc(): each call
+/// runs on a worker pool against an immutable copy of the store, rebuilt
+/// only when the journal has advanced, and its RpcResponse is sent as soon
+/// as it completes — a client may pipeline many calls on one connection
+/// and match the answers by id. Beyond kRpcMaxInFlight outstanding calls a
+/// session is answered Busy. With a persistent journal, journal.query
+/// answers time/area/target questions from the segments on disk.
+///
+/// @par CPA Screening
+/// With screening enabled (set_cpa()), the store is screened every
+/// CpaConfig::interval on the RPC worker pool for pairs of tracks
+/// predicted to pass within CpaConfig::distance_m within the horizon
+/// (cpa.hpp). Each newly predicted conflict is sent once to subscribed
+/// consoles in a CpaAlert frame, up to kCpaMaxAlerts per pass; it is sent
+/// again when it escalates (Yellow to Red) or after it has cleared.
+///
+/// @par Intercept Solutions
+/// A session that sends InterceptSubscribe with its shooters (intercept.hpp)
+/// is answered with solutions against every Red track held. From then on,
+/// each accepted Red report is solved against every subscriber's shooters
+/// on the I/O thread, before the report is fanned out or replicated. Each
+/// subscriber then gets an InterceptBatch with its own solutions.
+/// intercept_stats() records the time from report ingress to batch send.
+///
+/// @par Swarm Detection
+/// With detection enabled (set_swarm()), every accepted report, local or
+/// replicated, is fed to a SwarmDetector (swarm.hpp). Every
+/// SwarmConfig::interval the detector catches up on what moved and the
+/// swarms that appeared, changed or dissolved go out as one SwarmBatch to
+/// every subscribed session. A session gets every current swarm when it
+/// subscribes.
+///
+/// @par Level of Detail
+/// With LOD enabled (set_lod()), accepted reports also maintain per-tile
+/// aggregates at each configured zoom (lod.hpp). A session that sends
+/// LodSubscribe gets the in-view tiles of the matching level, then every
+/// LodConfig::interval only the in-view tiles that changed. Changed tiles
+/// are built once per interval and filtered per viewport, so a console's
+/// egress follows the tiles on its screen rather than the track count.
+/// LOD subscribers do not need the per-track feed.
+///
+/// @par Track Lifecycle
+/// With a lifecycle set (set_lifecycle()), every accepted report, local or
+/// replicated, counts towards confirming its target and restarts its
+/// silence timer (lifecycle.hpp). Timeouts are applied every
+/// LifecycleConfig::tick. A dropped target is journalled as a drop record
+/// (so replay and a standby erase it too), erased from the store and the
+/// LOD tiles, and a TrackDrop frame goes to every subscribed session so
+/// its mirror can evict it too. Tracks restored at startup begin
+/// Confirmed from their stored time. Each node expires what it holds on
+/// its own clock.
+///
+/// @par Anomaly Screening
+/// With screening enabled (set_anomaly()), each batch of reports this node
+/// owns, ingested here or forwarded by a peer, is checked against the last
+/// accepted state of every target before it reaches the store
+/// (anomaly.hpp). Reports that teleport, accelerate
+/// or climb beyond physical limits are taken out of the batch: they are
+/// not stored, fanned out or replicated, but go raised to Red in one
+/// QuarantineBatch to every subscribed session for review. Replicated
+/// reports were screened by their owner and are trusted.
+///
+/// @par Sector Statistics
+/// With sectors enabled (set_sectors()), every accepted report, local or
+/// replicated, also updates the running counters of its sector
+/// (sector.hpp): tracks per urgency and reports per time bucket. A
+/// session's SectorQuery is answered from those counters at once; a
+/// subscription is answered again every SectorConfig::interval. No
+/// answer scans the store. Dropped targets leave their sector.
+///
+/// @par Mirror Subscribers
+/// A session subscribing in mirror mode is sent the cached TrackSnapshot
+/// frames (mirror.hpp), shared with every other such session, then the
+/// targets changed or dropped since the cache was built, then the feed.
+/// A burst of reconnecting consoles costs at most one encode per
+/// SnapshotCacheConfig::max_age rather than one each.
+///
 /// @par Example
 /// @code
 /// auto server = WSServer::create(ioc, config);
@@ -141,11 +351,160 @@ public:
     /// Closes acceptor. Existing sessions continue until complete.
     void stop();
     
+    /// Enable (or, with a zero hold, disable) the reorder stage. Call before run().
+    void set_reorder(const protocol::JitterConfig& cfg) { reorder_ = protocol::JitterBuffer{cfg}; }
+    
+    /// Enable periodic CPA screening. Call before run().
+    void set_cpa(const protocol::CpaConfig& cfg) { cpa_cfg_ = cfg; }
+    
+    /// Enable swarm detection. Call before run().
+    void set_swarm(const protocol::SwarmConfig& cfg) { swarm_.emplace(cfg); }
+    
+    /// Enable level-of-detail tile streams. Call before run().
+    void set_lod(const protocol::lod::LodConfig& cfg) { lod_.emplace(cfg); }
+    
+    /// Enable track lifecycle and expiry. Call before run().
+    void set_lifecycle(const protocol::LifecycleConfig& cfg) { lifecycle_.emplace(cfg); }
+    
+    /// Enable kinematic anomaly screening. Call before run().
+    void set_anomaly(const protocol::AnomalyConfig& cfg) { anomaly_.emplace(cfg); }
+    
+    /// Enable per-sector statistics. Call before run().
+    void set_sectors(const protocol::sector::SectorConfig& cfg) { sectors_.emplace(cfg); }
+    
+    /// Tune when the mirror snapshot cache is rebuilt. Call before run().
+    void set_snapshot_cache(const protocol::mirror::SnapshotCacheConfig& cfg) {
+        *snapshot_cache_ = protocol::mirror::SnapshotCache{cfg};
+    }
+    
     /// Check if server is running.
     [[nodiscard]] auto is_running() const noexcept -> bool {
         return running_.load(std::memory_order_acquire);
     }
     
+    // ───────────────────────────────────────────────────────────────────────
+    // Telemetry
+    // ───────────────────────────────────────────────────────────────────────
+    
+    /// Link quality of one live session.
+    struct SessionLink {
+        std::uint64_t id{0};
+        std::string source;
+        protocol::link::LinkStats link;
+        protocol::ratelimit::SendRateState rate;
+    };
+    
+    /// Snapshot link quality and send rate of every live session.
+    [[nodiscard]] auto link_report() const -> std::vector<SessionLink>;
+    
+    /// Duplicate reports dropped from one source address.
+    struct DedupReport {
+        std::string source;
+        protocol::DedupCounts counts;
+    };
+    
+    /// Duplicate suppression per source address since start.
+    [[nodiscard]] auto dedup_report() const -> std::vector<DedupReport>;
+    
+    /// Intercept solver work and ingress-to-solution latency.
+    struct InterceptStats {
+        protocol::intercept::SolveCounts counts;
+        std::uint64_t batches{0};               ///< InterceptBatch frames sent on Red updates
+        protocol::link::RttHistogram latency;   ///< Report ingress to batch queued
+    };
+    
+    [[nodiscard]] auto intercept_stats() const noexcept -> const InterceptStats& { return intercept_stats_; }
+    
+    /// Cost and outcome of the last CPA screening pass.
+    [[nodiscard]] auto cpa_stats() const noexcept -> const protocol::CpaStats& { return cpa_stats_; }
+    
+    /// Swarm clustering counters (nullopt when detection is off).
+    [[nodiscard]] auto swarm_stats() const -> std::optional<protocol::SwarmStats> {
+        return swarm_ ? std::optional{swarm_->stats()} : std::nullopt;
+    }
+    
+    /// Tile aggregation and the LOD egress it saved.
+    struct LodFeedStats {
+        protocol::lod::LodStats index;
+        std::uint64_t batches{0};       ///< LodBatch frames sent
+        std::uint64_t tiles_sent{0};
+        std::size_t subscribers{0};
+    };
+    
+    /// LOD feed counters (nullopt when LOD is off).
+    [[nodiscard]] auto lod_stats() const -> std::optional<LodFeedStats>;
+    
+    /// Lifecycle counters (nullopt when expiry is off).
+    [[nodiscard]] auto lifecycle_stats() const -> std::optional<protocol::LifecycleStats> {
+        return lifecycle_ ? std::optional{lifecycle_->stats()} : std::nullopt;
+    }
+    
+    /// Sector counters and what they served.
+    struct SectorFeedStats {
+        protocol::sector::SectorStats grid;
+        std::uint64_t reports_sent{0};  ///< SectorReport frames (queries and stream)
+        std::size_t subscribers{0};
+    };
+    
+    /// Sector statistics counters (nullopt when sectors are off).
+    [[nodiscard]] auto sector_stats() const -> std::optional<SectorFeedStats>;
+    
+    /// Reports screened and quarantined.
+    struct AnomalyFeedStats {
+        protocol::AnomalyCounts counts;
+        std::size_t targets{0};         ///< Baselines held
+        std::uint64_t batches{0};       ///< QuarantineBatch frames sent
+    };
+    
+    /// Screening counters (nullopt when screening is off).
+    [[nodiscard]] auto anomaly_stats() const -> std::optional<AnomalyFeedStats> {
+        return anomaly_ ? std::optional{AnomalyFeedStats{anomaly_counts_, anomaly_->size(), quarantine_batches_}}
+                        : std::nullopt;
+    }
+    
+    /// Cached snapshot builds and the mirror subscribers they served.
+    [[nodiscard]] auto snapshot_cache_stats() const noexcept -> const protocol::mirror::SnapshotCacheStats& {
+        return snapshot_cache_->stats();
+    }
+    
+    /// Conflicts currently predicted by CPA screening.
+    [[nodiscard]] auto cpa_conflicts() const noexcept -> std::size_t { return cpa_active_.size(); }
+    
+    /// Reorder stage counters.
+    [[nodiscard]] auto reorder_stats() const noexcept -> const protocol::JitterStats& {
+        return reorder_.stats();
+    }
+    
+    /// Duplicate filter totals and evictions.
+    [[nodiscard]] auto dedup() const noexcept -> const protocol::DedupFilter& { return dedup_; }
+    
+    /// Outbound replication state per peer (empty when not clustered).
+    [[nodiscard]] auto peer_report() const -> std::vector<PeerReport> {
+        return cluster_->peer_report();
+    }
+    
+    /// Inbound replication state per origin node.
+    [[nodiscard]] auto origin_report() const -> std::vector<OriginReport> {
+        return cluster_->origin_report();
+    }
+    
+    /// Journal shipping state per attached standby.
+    [[nodiscard]] auto standby_report() const -> std::vector<StandbyReport>;
+    
+    /// Upload counters (all zero when uploads are disabled).
+    [[nodiscard]] auto upload_stats() const noexcept -> UploadStats {
+        return uploads_ ? uploads_->stats() : UploadStats{};
+    }
+    
+    /// RPC counters.
+    [[nodiscard]] auto rpc_stats() const noexcept -> RpcStats { return rpc_->stats(); }
+    
+    /// Method table; register custom methods before run().
+    [[nodiscard]] auto rpc() noexcept -> RpcRouter& { return *rpc_; }
+    
+    /// Ingest journal (shared with standby shippers).
+    [[nodiscard]] auto journal() const noexcept -> const protocol::Journal& { return *journal_; }
+    
     // ───────────────────────────────────────────────────────────────────────
     // IPacketHandler Implementation (Strategy Pattern)
     // ───────────────────────────────────────────────────────────────────────
@@ -166,6 +525,35 @@ private:
     /// @throws boost::system::system_error if bind/listen fails
     explicit WSServer(asio::io_context& ioc, const svckit::AddrConfig& cfg);
     
+    /// Construct server with custom ingest limits.
+    WSServer(asio::io_context& ioc,
+             const svckit::AddrConfig& cfg,
+             const protocol::ratelimit::IngestLimitConfig& limits);
+    
+    /// Construct a cluster node (peers from cluster.peers()).
+    WSServer(asio::io_context& ioc,
+             const svckit::AddrConfig& cfg,
+             svckit::ClusterConfig cluster);
+    
+    /// Construct a cluster node with custom ingest limits.
+    WSServer(asio::io_context& ioc,
+             const svckit::AddrConfig& cfg,
+             const protocol::ratelimit::IngestLimitConfig& limits,
+             svckit::ClusterConfig cluster);
+    
+    /// Construct a node over existing state (recovered journal, promoted standby).
+    WSServer(asio::io_context& ioc,
+             const svckit::AddrConfig& cfg,
+             svckit::ClusterConfig cluster,
+             ServerState state);
+    
+    /// Construct a node over existing state with custom ingest limits.
+    WSServer(asio::io_context& ioc,
+             const svckit::AddrConfig& cfg,
+             const protocol::ratelimit::IngestLimitConfig& limits,
+             svckit::ClusterConfig cluster,
+             ServerState state);
+    
     // ───────────────────────────────────────────────────────────────────────
     // Coroutine Handlers
     // ───────────────────────────────────────────────────────────────────────
@@ -176,6 +564,95 @@ private:
     /// Handle single WebSocket session.
     auto handle_session(tcp::socket socket) -> asio::awaitable<void>;
     
+    /// Periodically hand buffered journal records to the OS.
+    auto run_journal_flusher() -> asio::awaitable<void>;
+    
+    /// Periodically snapshot the store while the journal advances.
+    auto run_snapshotter() -> asio::awaitable<void>;
+    
+    /// Copy the store and queue it on the snapshot writer.
+    void take_snapshot();
+    
+    /// Release due reports from the reorder stage every tick.
+    auto run_reorder() -> asio::awaitable<void>;
+    
+    /// Ingest every held report due by `now_ns`, in order.
+    void release_reordered(std::int64_t now_ns);
+    
+    /// Screen the store for close approaches every CpaConfig::interval.
+    auto run_cpa() -> asio::awaitable<void>;
+    
+    /// Dispatch newly predicted conflicts and forget cleared ones.
+    void raise_conflicts(const std::vector<protocol::CpaConflict>& conflicts);
+    
+    /// Bring swarms up to date every SwarmConfig::interval and send what
+    /// changed to subscribed sessions.
+    auto run_swarm() -> asio::awaitable<void>;
+    
+    /// Send every LOD subscriber the in-view tiles that changed, every
+    /// LodConfig::interval.
+    auto run_lod() -> asio::awaitable<void>;
+    
+    /// Send every sector subscriber a report for its area, every
+    /// SectorConfig::interval.
+    auto run_sectors() -> asio::awaitable<void>;
+    
+    /// Apply lifecycle timeouts every tick; erase and announce drops.
+    auto run_lifecycle() -> asio::awaitable<void>;
+    
+    // ───────────────────────────────────────────────────────────────────────
+    // RPC
+    // ───────────────────────────────────────────────────────────────────────
+    
+    /// Store contents for handlers; recopied only after the journal moves.
+    auto track_view() -> std::shared_ptr<const TrackView>;
+    
+    /// Run one admitted call and send its response to `session`.
+    auto serve_call(std::shared_ptr<Session> session, protocol::rpc::Request request)
+        -> asio::awaitable<void>;
+    
+    // ───────────────────────────────────────────────────────────────────────
+    // Ingest Limiting
+    // ───────────────────────────────────────────────────────────────────────
+    
+    using SourceLimiter = std::shared_ptr<protocol::ratelimit::SteadyIngestLimiter>;
+    
+    /// Shared limiter for all sessions from one remote address.
+    auto acquire_source_limiter(const std::string& source) -> SourceLimiter;
+    
+    /// Release a session's hold on its source limiter.
+    void release_source_limiter(const std::string& source, SourceLimiter& limiter);
+
+    /// Forget source limiters with no sessions whose buckets have refilled.
+    void prune_source_limiters(std::chrono::steady_clock::time_point now);
+    
+    // ───────────────────────────────────────────────────────────────────────
+    // Binary Frames
+    // ───────────────────────────────────────────────────────────────────────
+    
+    /// Route a binary frame; returns its message-token cost for ingest
+    /// accounting (per record for track batches, control cost otherwise).
+    auto on_binary_frame(Session& from, std::string_view frame) -> double;
+    
+    /// Route, store, fan out and replicate reports from one session.
+    void ingest_tracks(std::uint64_t from_session,
+                       std::span<const protocol::TrackUpdate> tracks,
+                       const std::shared_ptr<const protocol::LatencyTrace>& trace,
+                       std::int64_t ingest_ns);
+    
+    /// Take implausible reports out of `reports` and send them, raised to
+    /// Red, to subscribed sessions.
+    void quarantine_tracks(std::vector<protocol::TrackUpdate>& reports);
+    
+    /// Solve accepted Red reports for every intercept subscriber and send
+    /// each its solutions.
+    void solve_intercepts(std::span<const protocol::TrackUpdate> tracks, std::int64_t ingress_ns);
+    
+    /// Fan track updates out to subscribed sessions (except the sender).
+    void publish_tracks(std::uint64_t from_session,
+                        std::span<const protocol::TrackUpdate> tracks,
+                        const std::shared_ptr<const protocol::LatencyTrace>& trace);
+    
     // ───────────────────────────────────────────────────────────────────────
     // Member Data
     // ───────────────────────────────────────────────────────────────────────
@@ -195,6 +672,114 @@ private:
     /// Protocol API for packet handling.
     protocol::ProtocolAPI api_;
     
+    /// Ingest rate limits (value type, copyable).
+    protocol::ratelimit::IngestLimitConfig ingest_cfg_;
+    
+    /// Per-source limiters keyed by remote address.
+    std::unordered_map<std::string, SourceLimiter> source_limiters_;
+    
+    /// Egress controller tuning applied to new sessions.
+    protocol::ratelimit::SendRateConfig send_rate_cfg_;
+    
+    /// Ping/pong probing parameters applied to new sessions.
+    protocol::link::LinkQualityConfig link_cfg_;
+    
+    /// Recently ingested report keys, shared by all sessions.
+    protocol::DedupFilter dedup_;
+    
+    /// Duplicate counts keyed by remote address.
+    std::unordered_map<std::string, protocol::DedupCounts> dedup_origins_;
+    
+    /// Reorder stage keyed by session id (disabled by default).
+    protocol::JitterBuffer reorder_;
+    
+    /// CPA screening parameters (disabled when empty).
+    std::optional<protocol::CpaConfig> cpa_cfg_;
+    
+    /// Conflicts raised and still predicted, (target_a, target_b) → the
+    /// urgency last raised.
+    std::map<std::pair<std::uint64_t, std::uint64_t>, protocol::Urgency> cpa_active_;
+    
+    /// Last screening pass.
+    protocol::CpaStats cpa_stats_;
+    
+    /// Intercept subscribers' shooters keyed by session id.
+    std::unordered_map<std::uint64_t, protocol::intercept::Solver> interceptors_;
+    
+    InterceptStats intercept_stats_;
+    
+    /// Swarm clustering of accepted reports (disabled when empty).
+    std::optional<protocol::SwarmDetector> swarm_;
+    
+    /// Tile aggregates of accepted reports (disabled when empty).
+    std::optional<protocol::lod::LodIndex> lod_;
+    
+    /// LOD subscribers' level and viewport keyed by session id.
+    std::unordered_map<std::uint64_t, protocol::lod::Subscription> lod_views_;
+    
+    std::uint64_t lod_batches_{0};
+    std::uint64_t lod_tiles_sent_{0};
+    
+    /// Per-target lifecycle and expiry (disabled when empty).
+    std::optional<protocol::TrackLifecycle> lifecycle_;
+    
+    /// Kinematic screening of owned reports (disabled when empty).
+    std::optional<protocol::AnomalyDetector> anomaly_;
+    
+    /// Running per-sector counters (disabled when empty).
+    std::optional<protocol::sector::SectorGrid> sectors_;
+    
+    /// Sector subscribers' areas keyed by session id.
+    std::unordered_map<std::uint64_t, protocol::lod::Viewport> sector_views_;
+    
+    std::uint64_t sector_reports_sent_{0};
+    
+    /// Per-batch anomaly flags (reused).
+    std::vector<std::uint8_t> anomaly_flags_;
+    
+    protocol::AnomalyCounts anomaly_counts_;
+    std::uint64_t quarantine_batches_{0};
+    
+    /// Live sessions keyed by id (shared with their coroutines).
+    std::unordered_map<std::uint64_t, std::shared_ptr<Session>> sessions_;
+    
+    /// Next session id.
+    std::uint64_t next_session_id_{1};
+    
+    /// Cluster node id; also the relay identity stamped into latency traces.
+    std::uint32_t node_id_{1};
+    
+    /// Latest state of every known target (shared with peer links).
+    std::shared_ptr<protocol::TrackStore> store_;
+    
+    /// Replication to and from peer nodes.
+    std::unique_ptr<Cluster> cluster_;
+    
+    /// Ingest journal fed by every store change (shared with shippers).
+    std::shared_ptr<protocol::Journal> journal_;
+    
+    /// Encoded snapshot shared by mirror subscribers (fed by the store hook).
+    std::shared_ptr<protocol::mirror::SnapshotCache> snapshot_cache_;
+    
+    /// Journal streams to attached standbys, keyed by session id.
+    std::unordered_map<std::uint64_t, std::shared_ptr<LogShipper>> shippers_;
+    
+    /// Background snapshot writer (null when disabled).
+    std::shared_ptr<protocol::SnapshotWriter> snapshots_;
+    
+    /// Journal sequence covered by the last snapshot submitted.
+    std::uint64_t snapshot_seq_{0};
+    
+    /// Receiver for chunked uploads (null when disabled).
+    std::shared_ptr<UploadSink> uploads_;
+    
+    /// RPC methods and their worker pool.
+    std::unique_ptr<RpcRouter> rpc_;
+    
+    /// Store copy shared by in-flight calls, and the journal seq it reflects.
+    std::shared_ptr<const TrackView> track_view_;
+    std::uint64_t track_view_seq_{0};
+    
     /// Running state flag (atomic for thread-safe reads).
     std::atomic<bool> running_{false};
 };
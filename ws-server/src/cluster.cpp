@@ -0,0 +1,479 @@
+#include "cluster.hpp"
+
+#include <algorithm>
+#include <exception>
+
+#include <fmt/core.h>
+
+#include "link_quality.hpp"
+
+namespace ws {
+
+namespace {
+
+/// Peer links retry quickly at first, then settle at a few seconds.
+auto peer_retry_config() -> protocol::retry::RetryConfig {
+    return protocol::retry::RetryConfig{}
+        .with_max_attempts(5)
+        .with_initial_delay(std::chrono::milliseconds{200})
+        .with_max_delay(std::chrono::seconds{5});
+}
+
+auto to_ms(std::int64_t ns) -> std::chrono::milliseconds {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::nanoseconds{std::max<std::int64_t>(ns, 0)});
+}
+
+}  // namespace
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PEER LINK
+// ═══════════════════════════════════════════════════════════════════════════
+
+PeerLink::PeerLink(asio::io_context& ioc,
+                   const svckit::AddrConfig& peer,
+                   std::uint32_t self,
+                   MembershipFn on_membership)
+    : ioc_{ioc}
+    , peer_{peer.addr()}
+    , self_{self}
+    , on_membership_{std::move(on_membership)}
+    , client_{WSClient::create_with_retry(ioc, peer, peer_retry_config())}
+    , flush_timer_{ioc}
+{}
+
+void PeerLink::start() {
+    running_ = true;
+    client_->start_link(LinkHandlers{
+        [this]() { on_connected(); },
+        [this](std::string_view frame) { on_binary(frame); },
+        [this]() { on_disconnected(); }
+    });
+    asio::co_spawn(ioc_, run_flusher(), asio::detached);
+}
+
+void PeerLink::stop() {
+    running_ = false;
+    client_->stop();
+    flush_timer_.cancel();
+}
+
+void PeerLink::offer(const protocol::TrackUpdate& update, std::int64_t ingest_ns) {
+    queue(pending_, update, ingest_ns);
+}
+
+void PeerLink::forward(const protocol::TrackUpdate& update, std::int64_t ingest_ns) {
+    queue(forward_, update, ingest_ns);
+}
+
+void PeerLink::set_interest(bool on) {
+    const bool changed = on && !interested_;
+    interested_ = on;
+    if (changed && client_->is_connected()) {
+        client_->send_binary(protocol::wire::make_control_frame(protocol::wire::FrameKind::Subscribe));
+    }
+}
+
+auto PeerLink::report() const -> PeerReport {
+    return PeerReport{peer_, node_, client_->is_connected(), sent_seq_, acked_seq_, lag_,
+                      pending_.size() + forward_.size(), forwarded_};
+}
+
+void PeerLink::on_connected() {
+    pending_.clear();
+    forward_.clear();
+    sent_seq_ = 0;
+    acked_seq_ = 0;
+
+    client_->send_binary(protocol::replication::encode_peer_hello(self_));
+    if (interested_) {
+        client_->send_binary(protocol::wire::make_control_frame(protocol::wire::FrameKind::Subscribe));
+    }
+}
+
+void PeerLink::on_disconnected() {
+    pending_.clear();
+    forward_.clear();
+    if (std::exchange(up_, false)) {
+        on_membership_(*this, false);
+    }
+}
+
+void PeerLink::on_binary(std::string_view frame) {
+    const auto header = protocol::wire::peek_header(frame);
+    if (!header) {
+        return;
+    }
+
+    if (header->kind == protocol::wire::FrameKind::PeerHello) {
+        // The peer identified itself; the link now counts as a member
+        const auto node = protocol::replication::decode_peer_hello(frame);
+        if (node && !up_) {
+            node_ = *node;
+            up_ = true;
+            fmt::print("[CLUSTER] Linked to peer {} (node {})\n", peer_, *node);
+            on_membership_(*this, true);
+        }
+        return;
+    }
+
+    const auto ack = protocol::replication::decode_replica_ack(frame);
+    if (!ack || ack->origin != self_) {
+        return;
+    }
+    acked_seq_ = std::max(acked_seq_, ack->seq);
+    lag_ = to_ms(protocol::link::wall_clock_ns() - ack->ingest_ns);
+}
+
+void PeerLink::queue(PendingMap& map, const protocol::TrackUpdate& update, std::int64_t ingest_ns) {
+    if (!client_->is_connected()) {
+        return;  // The reconnect resync will carry it
+    }
+    auto [it, inserted] = map.try_emplace(update.target_id, PendingReplica{update, ingest_ns});
+    if (!inserted) {
+        it->second.update = update;
+    }
+}
+
+void PeerLink::drain(PendingMap& map, bool forwarded) {
+    std::vector<protocol::TrackUpdate> batch;
+    while (!map.empty() && client_->outbox_depth() < kReplicaMaxInflight) {
+        batch.clear();
+        batch.reserve(std::min(kReplicaBatchMax, map.size()));
+
+        std::int64_t oldest = protocol::link::wall_clock_ns();
+        auto it = map.begin();
+        while (it != map.end() && batch.size() < kReplicaBatchMax) {
+            batch.push_back(it->second.update);
+            oldest = std::min(oldest, it->second.ingest_ns);
+            it = map.erase(it);
+        }
+        if (forwarded) {
+            forwarded_ += batch.size();
+        }
+        client_->send_binary(protocol::replication::encode_replica_batch(
+            self_, ++sent_seq_, oldest, batch, forwarded));
+    }
+}
+
+void PeerLink::flush() {
+    // Forwarded ingest first — the owner cannot publish what it has not seen
+    drain(forward_, true);
+    drain(pending_, false);
+}
+
+auto PeerLink::run_flusher() -> asio::awaitable<void> {
+    while (running_) {
+        flush_timer_.expires_after(kReplicaFlushInterval);
+        co_await flush_timer_.async_wait(asio::as_tuple(asio::use_awaitable));
+        if (running_ && client_->is_connected()) {
+            flush();
+        }
+    }
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// CLUSTER
+// ═══════════════════════════════════════════════════════════════════════════
+
+Cluster::Cluster(asio::io_context& ioc,
+                 svckit::ClusterConfig cfg,
+                 std::shared_ptr<protocol::TrackStore> store)
+    : ioc_{ioc}
+    , cfg_{std::move(cfg)}
+    , store_{std::move(store)}
+    , ring_{cfg_.virtual_nodes()}
+    , report_timer_{ioc}
+{
+    ring_.add(cfg_.node_id());
+
+    peers_.reserve(cfg_.peers().size());
+    for (const auto& peer : cfg_.peers()) {
+        peers_.push_back(std::make_unique<PeerLink>(ioc_, peer, cfg_.node_id(),
+            [this](PeerLink& link, bool up) { on_membership(link, up); }));
+    }
+}
+
+void Cluster::start() {
+    if (!cfg_.clustered()) {
+        return;
+    }
+    running_ = true;
+    fmt::print("[CLUSTER] Node {} {} with {} peer(s)\n", cfg_.node_id(),
+               cfg_.sharded() ? "sharding" : "replicating", peers_.size());
+
+    for (auto& peer : peers_) {
+        peer->start();
+    }
+    asio::co_spawn(ioc_, run_reporter(), asio::detached);
+}
+
+void Cluster::stop() {
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+    for (auto& peer : peers_) {
+        peer->stop();
+    }
+    report_timer_.cancel();
+}
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// Outbound
+// ───────────────────────────────────────────────────────────────────────────
+
+auto Cluster::owner(std::uint64_t target_id) const noexcept -> std::uint32_t {
+    if (!cfg_.sharded()) {
+        return cfg_.node_id();
+    }
+    return ring_.owner(target_id).value_or(cfg_.node_id());
+}
+
+auto Cluster::route(std::span<const protocol::TrackUpdate> tracks, std::int64_t ingest_ns)
+    -> std::vector<protocol::TrackUpdate>
+{
+    if (!cfg_.sharded()) {
+        return {tracks.begin(), tracks.end()};
+    }
+
+    std::vector<protocol::TrackUpdate> owned;
+    owned.reserve(tracks.size());
+    for (const auto& t : tracks) {
+        const auto node = owner(t.target_id);
+        auto* link = node == cfg_.node_id() ? nullptr : link_for(node);
+        if (link && link->up()) {
+            link->forward(t, ingest_ns);
+        } else {
+            owned.push_back(t);
+        }
+    }
+    return owned;
+}
+
+void Cluster::replicate(std::span<const protocol::TrackUpdate> tracks, std::int64_t ingest_ns) {
+    for (auto& peer : peers_) {
+        const auto node = peer->node();
+        if (cfg_.sharded() && !(node && interested_peers_.contains(*node))) {
+            continue;
+        }
+        for (const auto& t : tracks) {
+            peer->offer(t, ingest_ns);
+        }
+    }
+}
+
+void Cluster::send_owned(PeerLink& link) {
+    const auto now_ns = protocol::link::wall_clock_ns();
+    std::size_t sent = 0;
+    store_->for_each([&](const protocol::StoredTrack& t) {
+        const bool mine = cfg_.sharded() ? owner(t.update.target_id) == cfg_.node_id()
+                                         : t.origin_node == cfg_.node_id();
+        if (mine) {
+            link.offer(t.update, now_ns);
+            ++sent;
+        }
+    });
+    if (sent > 0) {
+        fmt::print("[CLUSTER] Resending {} tracks to node {}\n", sent, link.node().value_or(0));
+    }
+}
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// Inbound
+// ───────────────────────────────────────────────────────────────────────────
+
+auto Cluster::apply_replica(const Session& from, std::string_view frame, const ScreenFn& screen)
+    -> std::optional<Applied>
+{
+    auto batch = protocol::replication::decode_replica_batch(frame);
+    if (!batch || batch->origin == cfg_.node_id()) {
+        return std::nullopt;
+    }
+
+    const auto now_ns = protocol::link::wall_clock_ns();
+    auto& origin = origins_[batch->origin];
+    origin.origin = batch->origin;
+
+    // A sequence that does not advance means the origin reconnected
+    if (batch->seq > origin.last_seq + 1) {
+        origin.gaps += batch->seq - origin.last_seq - 1;
+    }
+    origin.last_seq = batch->seq;
+
+    // Origin ingest time on our clock (peer probes give the offset)
+    const auto offset = from.clock_offset().value_or(std::chrono::nanoseconds{0});
+    const auto ingest_ns = batch->ingest_ns + offset.count();
+    const auto lag = to_ms(now_ns - ingest_ns);
+    origin.lag = origin.applied == 0 ? lag : (origin.lag * 7 + lag) / 8;
+    origin.max_lag = std::max(origin.max_lag, lag);
+
+    // Forwarded ingest becomes ours: we own those targets, so we screen it
+    const auto stored_origin = batch->forwarded ? cfg_.node_id() : batch->origin;
+    if (batch->forwarded && screen) {
+        screen(batch->tracks);
+    }
+
+    Applied out;
+    out.forwarded = batch->forwarded;
+    out.ingest_ns = ingest_ns;
+    out.tracks.reserve(batch->tracks.size());
+    for (const auto& t : batch->tracks) {
+        if (store_->apply(t, stored_origin, batch->seq, now_ns)) {
+            out.tracks.push_back(t);
+        }
+    }
+    origin.applied += out.tracks.size();
+
+    out.ack = protocol::replication::encode_replica_ack({batch->origin, batch->seq, batch->ingest_ns});
+    return out;
+}
+
+void Cluster::set_peer_interest(std::uint32_t node, bool on) {
+    if (!cfg_.sharded()) {
+        return;  // Full replication already sends everything
+    }
+    if (!on) {
+        interested_peers_.erase(node);
+        return;
+    }
+    if (interested_peers_.insert(node).second) {
+        if (auto* link = link_for(node); link && link->up()) {
+            send_owned(*link);
+        }
+    }
+}
+
+void Cluster::set_local_interest() {
+    if (!cfg_.sharded() || std::exchange(local_interest_, true)) {
+        return;
+    }
+    for (auto& peer : peers_) {
+        peer->set_interest(true);
+    }
+}
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// Membership
+// ───────────────────────────────────────────────────────────────────────────
+
+void Cluster::on_membership(PeerLink& link, bool up) {
+    const auto node = link.node();
+    if (!node) {
+        return;
+    }
+
+    if (!cfg_.sharded()) {
+        if (up) {
+            send_owned(link);  // Resync after every reconnect
+        }
+        return;
+    }
+
+    const auto before = ring_;
+    const bool changed = up ? ring_.add(*node) : ring_.remove(*node);
+    if (changed) {
+        rebalance(before);
+    }
+    if (up && interested_peers_.contains(*node)) {
+        send_owned(link);
+    }
+}
+
+void Cluster::rebalance(const protocol::HashRing& before) {
+    const auto self = cfg_.node_id();
+    const auto now_ns = protocol::link::wall_clock_ns();
+    std::size_t moved = 0;
+    std::size_t handed_over = 0;
+
+    store_->for_each([&](const protocol::StoredTrack& t) {
+        const auto id = t.update.target_id;
+        const auto was = before.owner(id).value_or(self);
+        const auto now = ring_.owner(id).value_or(self);
+        if (was == now) {
+            return;
+        }
+        ++moved;
+
+        // Hand our state for a target we no longer own to its new owner
+        if (was == self) {
+            if (auto* link = link_for(now); link && link->up()) {
+                link->forward(t.update, now_ns);
+                ++handed_over;
+            }
+        }
+    });
+
+    fmt::print("[CLUSTER] Ring now {} node(s): {} of {} stored targets changed owner, {} handed over\n",
+               ring_.size(), moved, store_->size(), handed_over);
+}
+
+auto Cluster::link_for(std::uint32_t node) noexcept -> PeerLink* {
+    for (auto& peer : peers_) {
+        if (peer->node() == node) {
+            return peer.get();
+        }
+    }
+    return nullptr;
+}
+
+
+// ───────────────────────────────────────────────────────────────────────────
+// Telemetry
+// ───────────────────────────────────────────────────────────────────────────
+
+auto Cluster::peer_report() const -> std::vector<PeerReport> {
+    std::vector<PeerReport> out;
+    out.reserve(peers_.size());
+    for (const auto& peer : peers_) {
+        out.push_back(peer->report());
+    }
+    return out;
+}
+
+auto Cluster::origin_report() const -> std::vector<OriginReport> {
+    std::vector<OriginReport> out;
+    out.reserve(origins_.size());
+    for (const auto& [id, origin] : origins_) {
+        out.push_back(origin);
+    }
+    std::sort(out.begin(), out.end(), [](const auto& a, const auto& b) { return a.origin < b.origin; });
+    return out;
+}
+
+auto Cluster::run_reporter() -> asio::awaitable<void> {
+    while (running_) {
+        report_timer_.expires_after(kClusterReportInterval);
+        co_await report_timer_.async_wait(asio::as_tuple(asio::use_awaitable));
+        if (!running_) {
+            break;
+        }
+
+        fmt::print("[CLUSTER] Node {} holds {} tracks\n", cfg_.node_id(), store_->size());
+        if (cfg_.sharded()) {
+            std::size_t owned = 0;
+            store_->for_each([&](const protocol::StoredTrack& t) {
+                if (owner(t.update.target_id) == cfg_.node_id()) {
+                    ++owned;
+                }
+            });
+            fmt::print("[CLUSTER]   ring {} node(s), owns {}\n", ring_.size(), owned);
+        }
+        for (const auto& p : peer_report()) {
+            fmt::print("[CLUSTER]   -> {} {} seq {}/{} lag {}ms pending {} forwarded {}\n",
+                       p.peer, p.connected ? "up" : "down",
+                       p.acked_seq, p.sent_seq, p.lag.count(), p.pending, p.forwarded);
+        }
+        for (const auto& o : origin_report()) {
+            fmt::print("[CLUSTER]   <- node {} seq {} applied {} gaps {} lag {}ms (max {}ms)\n",
+                       o.origin, o.last_seq, o.applied, o.gaps, o.lag.count(), o.max_lag.count());
+        }
+    }
+}
+
+}  // namespace ws
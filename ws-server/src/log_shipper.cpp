@@ -0,0 +1,73 @@
+#include "log_shipper.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "log_shipping.hpp"
+
+namespace ws {
+
+LogShipper::LogShipper(asio::io_context& ioc,
+                       std::shared_ptr<Session> session,
+                       std::shared_ptr<protocol::Journal> journal,
+                       std::uint64_t next_seq)
+    : timer_{ioc}
+    , session_{std::move(session)}
+    , journal_{std::move(journal)}
+    , next_seq_{std::max<std::uint64_t>(next_seq, 1)}
+    , acked_seq_{next_seq_ - 1}
+{}
+
+auto LogShipper::run() -> asio::awaitable<void> {
+    if (next_seq_ < journal_->first_seq()) {
+        fmt::print("[SERVER] Standby {} wants seq {}, journal starts at {} — gap\n",
+                   session_->id(), next_seq_, journal_->first_seq());
+    }
+
+    std::vector<protocol::JournalRecord> batch;
+    batch.reserve(kShipBatchRecords);
+    auto last_send = std::chrono::steady_clock::now();
+
+    while (running_ && session_->is_open()) {
+        const auto now = std::chrono::steady_clock::now();
+        const bool window_open = next_seq_ - 1 - acked_seq_ < kShipWindowRecords;
+
+        batch.clear();
+        if (window_open) {
+            journal_->read(next_seq_, kShipBatchRecords, batch);
+        }
+
+        if (!batch.empty() || now - last_send >= kShipHeartbeatInterval) {
+            session_->send_frame(protocol::shipping::encode_journal_batch(journal_->last_seq(), batch), true);
+            if (!batch.empty()) {
+                next_seq_ = batch.back().seq + 1;
+            }
+            last_send = now;
+            if (batch.size() == kShipBatchRecords) {
+                continue;  // More records are waiting
+            }
+        }
+
+        timer_.expires_after(kShipIdleInterval);
+        co_await timer_.async_wait(asio::as_tuple(asio::use_awaitable));
+    }
+}
+
+void LogShipper::on_ack(std::uint64_t seq) noexcept {
+    acked_seq_ = std::max(acked_seq_, std::min(seq, next_seq_ - 1));
+}
+
+void LogShipper::stop() {
+    running_ = false;
+    timer_.cancel();
+}
+
+auto LogShipper::report() const -> StandbyReport {
+    const auto head = journal_->last_seq();
+    return StandbyReport{session_->id(), session_->source(), next_seq_ - 1, acked_seq_,
+                         head > acked_seq_ ? head - acked_seq_ : 0};
+}
+
+}  // namespace ws
@@ -1,13 +1,28 @@
 #include <csignal>
 #include <cstdlib>
+#include <chrono>
 #include <exception>
+#include <filesystem>
 #include <iostream>
+#include <memory>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include <boost/asio.hpp>
 #include <fmt/core.h>
 
+#include "columnar.hpp"
+#include "journal.hpp"
+#include "server_state.hpp"
+#include "snapshot.hpp"
+#include "standby.hpp"
+#include "upload_sink.hpp"
 #include "ws_server.hpp"
 #include "svc_addr_config.hpp"
+#include "svc_cluster_config.hpp"
 
 namespace {
 
@@ -20,16 +35,97 @@ void signal_handler(int sig) {
     }
 }
 
+/// WS_LOD_ZOOMS=4,7,10 (malformed or out-of-range items skipped)
+auto parse_zooms(const char* env) -> std::vector<std::uint8_t> {
+    std::vector<std::uint8_t> out;
+    for (std::string_view list{env ? env : ""}; !list.empty();) {
+        const auto comma = list.find(',');
+        const std::string item{list.substr(0, comma)};
+        list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+        unsigned zoom = 0;
+        if (std::sscanf(item.c_str(), "%u", &zoom) == 1 && zoom <= protocol::lod::kMaxZoom) {
+            out.push_back(static_cast<std::uint8_t>(zoom));
+        }
+    }
+    return out;
+}
+
 }  // namespace
 
 int main() {
     try {
         // Configuration
-        auto cfg = svckit::AddrConfig::from_env_defaults("0.0.0.0", 8443);
+        auto cfg = svckit::AddrConfig::from_env_defaults("0.0.0.0", svckit::env_port(8443));
+        auto cluster = svckit::ClusterConfig::from_env();
+        
+        const char* journal_dir = std::getenv("WS_JOURNAL_DIR");
+        const char* snapshot_env = std::getenv("WS_SNAPSHOT");
+        const char* upload_dir = std::getenv("WS_UPLOAD_DIR");
+        const char* role = std::getenv("WS_ROLE");
+        const char* primary_env = std::getenv("WS_PRIMARY");
+        const bool standby = role && std::string_view{role} == "standby";
+        const auto primaries = svckit::parse_addr_list(primary_env ? primary_env : "");
+        if (standby && primaries.empty()) {
+            fmt::print(stderr, "[MAIN] WS_ROLE=standby requires WS_PRIMARY=host:port\n");
+            return EXIT_FAILURE;
+        }
+        
+        // Offline export: convert the journal to a columnar file and exit
+        const char* export_env = std::getenv("WS_EXPORT_COLUMNAR");
+        if (export_env && *export_env) {
+            if (!journal_dir || !*journal_dir) {
+                fmt::print(stderr, "[MAIN] WS_EXPORT_COLUMNAR requires WS_JOURNAL_DIR\n");
+                return EXIT_FAILURE;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            const auto stats = protocol::export_journal_columnar(journal_dir, export_env);
+            const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+            fmt::print("[MAIN] Exported {} rows in {} row group(s) to {}: {} bytes ({:.1f}% of the journal) in {}ms\n",
+                       stats.rows, stats.groups, export_env, stats.bytes,
+                       stats.rows > 0 ? 100.0 * static_cast<double>(stats.bytes)
+                                            / static_cast<double>(stats.rows * protocol::kJournalRecordSize)
+                                      : 0.0,
+                       elapsed.count());
+            for (std::size_t c = 0; c < protocol::kColumnCount; ++c) {
+                fmt::print("[MAIN]   {:<8} {} bytes\n",
+                           protocol::to_string(static_cast<protocol::Column>(c)), stats.column_bytes[c]);
+            }
+            return EXIT_SUCCESS;
+        }
         
         fmt::print("[MAIN] Starting WebSocket server\n");
         fmt::print("[MAIN] URL: {}\n", cfg.ws_url());
         fmt::print("[MAIN] Cert: {}\n", cfg.tls().cert_file.string());
+        fmt::print("[MAIN] Node {} with {} peer(s)\n", cluster.node_id(), cluster.peers().size());
+        fmt::print("[MAIN] Journal: {}\n", journal_dir ? journal_dir : "(memory)");
+        
+        // Snapshots default to the journal directory
+        auto snapshot = protocol::SnapshotConfig{}.with_interval(
+            std::chrono::seconds{svckit::env_unsigned<unsigned>("WS_SNAPSHOT_SECS", 30)});
+        if (snapshot_env && *snapshot_env) {
+            snapshot = std::move(snapshot).with_path(snapshot_env);
+        } else if (journal_dir && *journal_dir) {
+            snapshot = std::move(snapshot).with_path(std::filesystem::path{journal_dir} / "snapshot.bin");
+        }
+        
+        // Recover the store: snapshot, then the journal after it (a standby
+        // resumes shipping from where its journal ends)
+        auto state = ws::ServerState::open(protocol::JournalConfig{}.with_dir(journal_dir ? journal_dir : ""),
+                                           std::move(snapshot));
+        if (state.restored) {
+            fmt::print("[MAIN] Snapshot: {} tracks at seq {} loaded in {}ms\n",
+                       state.restored->tracks, state.restored->journal_seq,
+                       state.restored->elapsed.count() / 1000);
+        }
+        if (state.journal->last_seq() > 0) {
+            fmt::print("[MAIN] Recovered {} tracks at journal seq {} ({} records replayed)\n",
+                       state.store->size(), state.journal->last_seq(), state.replayed);
+        }
+        if (upload_dir && *upload_dir) {
+            state.uploads = std::make_shared<ws::UploadSink>(ws::UploadSinkConfig{}.with_dir(upload_dir));
+            fmt::print("[MAIN] Uploads: {}\n", upload_dir);
+        }
         
         // IO context
         boost::asio::io_context ioc{1};
@@ -39,8 +135,62 @@ int main() {
         std::signal(SIGINT, signal_handler);
         std::signal(SIGTERM, signal_handler);
         
+        if (standby) {
+            auto failover = svckit::env_unsigned<unsigned>("WS_FAILOVER_MS", 1000);
+            auto node = ws::Standby::create(ioc, primaries.front(), cfg, std::move(state), std::move(cluster),
+                ws::StandbyConfig{}.with_failover_after(std::chrono::milliseconds{failover}));
+            node->start();
+            ioc.run();
+            node->stop();
+            fmt::print("[MAIN] Standby shutdown complete\n");
+            return EXIT_SUCCESS;
+        }
+        
         // Create and run server using factory method
-        auto server = ws::WSServer::create(ioc, cfg);
+        auto server = ws::WSServer::create(ioc, cfg, std::move(cluster), std::move(state));
+        if (const auto hold = svckit::env_unsigned<unsigned>("WS_REORDER_MS", 0); hold > 0) {
+            const char* late = std::getenv("WS_REORDER_LATE");
+            server->set_reorder(protocol::JitterConfig{}
+                .with_hold(std::chrono::milliseconds{hold})
+                .with_late_policy(late && std::string_view{late} == "release" ? protocol::LatePolicy::Release
+                                                                               : protocol::LatePolicy::Drop));
+        }
+        if (const auto cpa_m = svckit::env_unsigned<unsigned>("WS_CPA_M", 0); cpa_m > 0) {
+            server->set_cpa(protocol::CpaConfig{}
+                .with_distance(static_cast<double>(cpa_m))
+                .with_horizon(std::chrono::seconds{svckit::env_unsigned<unsigned>("WS_CPA_SECS", 60)}));
+        }
+        if (const auto swarm_m = svckit::env_unsigned<unsigned>("WS_SWARM_M", 0); swarm_m > 0) {
+            server->set_swarm(protocol::SwarmConfig{}
+                .with_eps(static_cast<double>(swarm_m))
+                .with_min_tracks(svckit::env_unsigned<std::size_t>("WS_SWARM_MIN", 5)));
+        }
+        if (const auto drop_s = svckit::env_unsigned<unsigned>("WS_DROP_SECS", 0); drop_s > 0) {
+            server->set_lifecycle(protocol::LifecycleConfig{}
+                .with_coast_after(std::chrono::seconds{svckit::env_unsigned<unsigned>("WS_COAST_SECS", 5)})
+                .with_drop_after(std::chrono::seconds{drop_s}));
+        }
+        if (const char* deg = std::getenv("WS_SECTOR_DEG"); deg && *deg) {
+            double sector_deg = 0.0;
+            if (std::sscanf(deg, "%lf", &sector_deg) == 1 && sector_deg > 0.0) {
+                server->set_sectors(protocol::sector::SectorConfig{}
+                    .with_sector_deg(sector_deg)
+                    .with_window(std::chrono::seconds{svckit::env_unsigned<unsigned>("WS_SECTOR_WINDOW_SECS", 60)}));
+            }
+        }
+        if (const auto ms = svckit::env_unsigned<unsigned>("WS_MIRROR_CACHE_MS", 0); ms > 0) {
+            server->set_snapshot_cache(protocol::mirror::SnapshotCacheConfig{}
+                .with_max_age(std::chrono::milliseconds{ms}));
+        }
+        if (const auto speed = svckit::env_unsigned<unsigned>("WS_MAX_SPEED_MPS", 0); speed > 0) {
+            server->set_anomaly(protocol::AnomalyConfig{}
+                .with_max_speed(static_cast<float>(speed))
+                .with_max_accel(static_cast<float>(svckit::env_unsigned<unsigned>("WS_MAX_ACCEL_MPS2", 150)))
+                .with_max_climb(static_cast<float>(svckit::env_unsigned<unsigned>("WS_MAX_CLIMB_MPS", 400))));
+        }
+        if (auto zooms = parse_zooms(std::getenv("WS_LOD_ZOOMS")); !zooms.empty()) {
+            server->set_lod(protocol::lod::LodConfig{}.with_zooms(std::move(zooms)));
+        }
         server->run();
         
         // Run event loop
@@ -49,6 +199,87 @@ int main() {
         // Cleanup
         server->stop();
         
+        if (const auto up = server->upload_stats(); up.started > 0) {
+            fmt::print("[MAIN] Uploads: {} completed, {} resumed, {} rejected, {} expired, {} corrupt chunks, {} active\n",
+                       up.completed, up.resumed, up.rejected, up.expired, up.corrupt_chunks, up.active);
+        }
+        
+        if (const auto& ro = server->reorder_stats(); ro.buffered > 0) {
+            fmt::print("[MAIN] Reorder: {} held, {} late dropped, {} late released, {} released early\n",
+                       ro.buffered, ro.late_dropped, ro.late_released, ro.overflow);
+        }
+        
+        for (const auto& d : server->dedup_report()) {
+            if (d.counts.duplicates > 0) {
+                fmt::print("[MAIN] Duplicates from {}: {} of {} reports ({:.1f}%)\n",
+                           d.source, d.counts.duplicates, d.counts.reports,
+                           d.counts.duplicate_ratio() * 100.0);
+            }
+        }
+        if (const auto evicted = server->dedup().evictions(); evicted > 0) {
+            fmt::print("[MAIN] Dedup filter evicted {} live entries; consider a larger capacity\n", evicted);
+        }
+        
+        if (const auto& ic = server->intercept_stats(); ic.counts.pairs > 0) {
+            fmt::print("[MAIN] Intercepts: {} solutions from {} pairs ({} out of range), {} batches, "
+                       "update to solution p50 {}us p99 {}us\n",
+                       ic.counts.solutions, ic.counts.pairs, ic.counts.gated, ic.batches,
+                       ic.latency.percentile(50.0).count(), ic.latency.percentile(99.0).count());
+        }
+        
+        if (const auto& cpa = server->cpa_stats(); cpa.tracks > 0) {
+            fmt::print("[MAIN] CPA: last pass screened {} tracks ({} pairs in {} cells of {:.0f}m, {} unbinned) "
+                       "in {}us, {} conflict(s) active\n",
+                       cpa.tracks, cpa.candidate_pairs, cpa.cells, cpa.cell_m, cpa.wide, cpa.elapsed.count(),
+                       server->cpa_conflicts());
+        }
+        
+        if (const auto sw = server->swarm_stats(); sw && sw->refreshes > 0) {
+            fmt::print("[MAIN] Swarms: {} from {} tracks; {} reports, {} refreshes, "
+                       "{} neighbour recounts, {} relabels\n",
+                       sw->swarms, sw->tracks, sw->updates, sw->refreshes, sw->reevaluated, sw->reclustered);
+        }
+        
+        if (const auto lc = server->lifecycle_stats(); lc && lc->fired > 0) {
+            fmt::print("[MAIN] Lifecycle: {} tentative, {} confirmed, {} coasting; {} coasted, {} dropped "
+                       "({} timer entries reached, {} re-armed)\n",
+                       lc->tentative_now, lc->confirmed_now, lc->coasting_now, lc->coasted, lc->dropped,
+                       lc->fired, lc->rearmed);
+        }
+        
+        if (const auto sc = server->sector_stats(); sc && sc->grid.updates > 0) {
+            fmt::print("[MAIN] Sectors: {} tracks in {} sectors; {} reports counted, {} sector moves, "
+                       "{} reports sent to {} subscriber(s)\n",
+                       sc->grid.tracks, sc->grid.sectors, sc->grid.updates, sc->grid.moves,
+                       sc->reports_sent, sc->subscribers);
+        }
+        
+        if (const auto& sc = server->snapshot_cache_stats(); sc.served > 0) {
+            fmt::print("[MAIN] Snapshot cache: {} mirror subscriber(s) from {} build(s) "
+                       "(last {} tracks in {} frame(s), {} bytes); catch-up {} tracks, {} drops\n",
+                       sc.served, sc.builds, sc.tracks, sc.frames, sc.bytes,
+                       sc.catch_up_tracks, sc.catch_up_drops);
+        }
+        
+        if (const auto an = server->anomaly_stats(); an && an->counts.checked > 0) {
+            fmt::print("[MAIN] Anomalies: {} of {} reports quarantined ({} teleport, {} acceleration, "
+                       "{} altitude) in {} batches, {} rebased; {} targets\n",
+                       an->counts.suspect, an->counts.checked, an->counts.teleports, an->counts.accelerations,
+                       an->counts.altitude, an->batches, an->counts.rebased, an->targets);
+        }
+        
+        if (const auto lod = server->lod_stats(); lod && lod->index.updates > 0) {
+            fmt::print("[MAIN] LOD: {} tracks in {} tiles; {} reports, {} tile moves, "
+                       "{} tiles sent in {} batches\n",
+                       lod->index.tracks, lod->index.tiles, lod->index.updates, lod->index.moves,
+                       lod->tiles_sent, lod->batches);
+        }
+        
+        if (const auto rpc = server->rpc_stats(); rpc.calls > 0 || rpc.busy > 0) {
+            fmt::print("[MAIN] RPC: {} calls, {} errors, {} busy on {} workers\n",
+                       rpc.calls, rpc.errors, rpc.busy, rpc.workers);
+        }
+        
         fmt::print("[MAIN] Server shutdown complete\n");
         return EXIT_SUCCESS;
         
@@ -0,0 +1,146 @@
+#include "rpc_router.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include <fmt/core.h>
+
+#include "journal_query.hpp"
+
+namespace ws {
+
+namespace rpc = protocol::rpc;
+
+namespace {
+
+auto batch_packet(const std::vector<protocol::TrackUpdate>& tracks) -> protocol::Packet {
+    return protocol::Packet::from_string(protocol::encode_track_batch(tracks));
+}
+
+}  // namespace
+
+RpcRouter::RpcRouter(std::size_t workers)
+    : pool_{workers}
+{
+    add(std::string{rpc::kMethodSnapshot}, [](const protocol::Packet&, const TrackView& tracks) {
+        return batch_packet(tracks);
+    });
+
+    add(std::string{rpc::kMethodTarget}, [](const protocol::Packet& req, const TrackView& tracks) {
+        const auto id = rpc::parse_target_query(req);
+        if (!id) {
+            throw rpc::BadRequestError{"expected target id u64"};
+        }
+        std::vector<protocol::TrackUpdate> out;
+        for (const auto& t : tracks) {
+            if (t.target_id == *id) {
+                out.push_back(t);
+                break;
+            }
+        }
+        return batch_packet(out);
+    });
+
+    add(std::string{rpc::kMethodArea}, [](const protocol::Packet& req, const TrackView& tracks) {
+        const auto area = rpc::parse_area_query(req);
+        if (!area) {
+            throw rpc::BadRequestError{"expected lat_min, lat_max, lon_min, lon_max f64"};
+        }
+        std::vector<protocol::TrackUpdate> out;
+        for (const auto& t : tracks) {
+            if (area->contains(t.lat, t.lon)) {
+                out.push_back(t);
+            }
+        }
+        return batch_packet(out);
+    });
+}
+
+void RpcRouter::add(std::string method, RpcHandler handler) {
+    methods_.insert_or_assign(std::move(method), std::move(handler));
+}
+
+void RpcRouter::add_journal_query(std::filesystem::path dir) {
+    // Runs on a pool worker; the scan's parallel_for joins by helping
+    add(std::string{rpc::kMethodJournal}, [this, dir = std::move(dir)](const protocol::Packet& req, const TrackView&) {
+        auto query = rpc::parse_journal_query(req);
+        if (!query) {
+            throw rpc::BadRequestError{"expected JournalQuery"};
+        }
+        query->limit = std::min(query->limit, protocol::kJournalQueryLimit);
+
+        const auto result = protocol::query_journal(dir, *query, pool_);
+        const auto& st = result.stats;
+        fmt::print("[SERVER] Journal query: {} matches, {}/{} segments pruned, {} MB scanned in {}ms ({:.1f} GB/s)\n",
+                   st.matches, st.pruned, st.segments, st.bytes_scanned >> 20, st.elapsed.count() / 1000,
+                   st.bytes_per_second() / 1e9);
+
+        std::vector<protocol::TrackUpdate> tracks;
+        tracks.reserve(result.records.size());
+        for (const auto& r : result.records) {
+            tracks.push_back(r.update);
+        }
+        return batch_packet(tracks);
+    });
+}
+
+auto RpcRouter::admit(std::uint64_t session) -> bool {
+    auto& n = in_flight_[session];
+    if (n >= kRpcMaxInFlight) {
+        ++stats_.busy;
+        return false;
+    }
+    ++n;
+    ++stats_.in_flight;
+    return true;
+}
+
+void RpcRouter::release(std::uint64_t session) {
+    if (auto it = in_flight_.find(session); it != in_flight_.end()) {
+        --stats_.in_flight;
+        if (--it->second == 0) {
+            in_flight_.erase(it);
+        }
+    }
+}
+
+auto RpcRouter::call(rpc::Request request, std::shared_ptr<const TrackView> tracks)
+    -> asio::awaitable<rpc::Response>
+{
+    ++stats_.calls;
+    rpc::Response res{request.id, rpc::RpcStatus::Ok, {}};
+
+    const auto it = methods_.find(request.method);
+    if (it == methods_.end()) {
+        ++stats_.errors;
+        res.status = rpc::RpcStatus::UnknownMethod;
+        res.body = protocol::Packet::from_string(request.method);
+        co_return res;
+    }
+
+    // The job borrows from this frame, which outlives the await; copying
+    // the handler keeps it valid if the method is replaced meanwhile
+    const auto handler = it->second;
+    try {
+        res.body = co_await pool_.run([&] { return handler(request.body, *tracks); });
+    } catch (const rpc::BadRequestError& e) {
+        res.status = rpc::RpcStatus::BadRequest;
+        res.body = protocol::Packet::from_string(e.what());
+    } catch (const std::exception& e) {
+        res.status = rpc::RpcStatus::Failed;
+        res.body = protocol::Packet::from_string(e.what());
+    }
+    if (!res.ok()) {
+        ++stats_.errors;
+    }
+    co_return res;
+}
+
+auto RpcRouter::stats() const noexcept -> RpcStats {
+    auto out = stats_;
+    out.workers = pool_.size();
+    return out;
+}
+
+}  // namespace ws
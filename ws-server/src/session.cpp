@@ -0,0 +1,287 @@
+#include "session.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include <fmt/core.h>
+
+namespace ws {
+
+// ═══════════════════════════════════════════════════════════════════════════
+// CONSTRUCTION
+// ═══════════════════════════════════════════════════════════════════════════
+
+Session::Session(std::uint64_t id,
+                 std::string source,
+                 Stream ws,
+                 const protocol::ratelimit::SendRateConfig& rate_cfg,
+                 const protocol::link::LinkQualityConfig& link_cfg)
+    : id_{id}
+    , source_{std::move(source)}
+    , ws_{std::move(ws)}
+    , wake_{ws_.get_executor()}
+    , rate_{rate_cfg}
+    , link_{link_cfg}
+    , ping_timer_{ws_.get_executor()}
+{
+    // Invoked from inside async_read; the read loop keeps us alive
+    ws_.control_callback([this](websocket::frame_type kind, beast::string_view payload) {
+        on_control(kind, std::string_view{payload.data(), payload.size()});
+    });
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// OUTBOUND QUEUE
+// ═══════════════════════════════════════════════════════════════════════════
+
+void Session::send_frame(std::string frame, bool binary) {
+    if (closed_) {
+        return;
+    }
+    frames_.push_back(OutFrame{std::move(frame), binary});
+    wake();
+}
+
+void Session::send_track(const protocol::TrackUpdate& update,
+                         std::shared_ptr<const protocol::LatencyTrace> trace) {
+    if (closed_) {
+        return;
+    }
+
+    // Latest-wins: a target already queued is refreshed in place and keeps
+    // its position (or its hold), so queue depth is bounded by distinct
+    // targets and whatever goes out is the newest state.
+    const auto now = clock::now();
+    const auto due = rate_.admit(update.target_id, update.urgency, now);
+    auto [it, inserted] = pending_tracks_.try_emplace(update.target_id);
+    auto& pending = it->second;
+    if (!inserted) {
+        rate_.on_superseded();
+    }
+    pending.update = update;
+    pending.trace = std::move(trace);
+
+    if (inserted || (pending.held && due <= now)) {
+        if (due <= now) {
+            pending.held = false;
+            track_order_.push_back(update.target_id);
+            wake();
+        } else {
+            pending.held = true;
+            pending.due = due;
+            held_.emplace(due, update.target_id);
+        }
+    }
+
+    tick_rate(now);
+}
+
+void Session::forget_track(std::uint64_t target_id) {
+    rate_.forget(target_id);
+    pending_tracks_.erase(target_id);
+}
+
+void Session::send_snapshot(std::span<const protocol::mirror::SharedFrame> frames, std::uint64_t seq,
+                            std::span<const protocol::TrackUpdate> catch_up) {
+    if (closed_) {
+        return;
+    }
+    // Everything pending is in the snapshot or its catch-up; control
+    // frames keep their order. A batch already being written predates
+    // the snapshot and is ignored by the mirror.
+    track_order_.clear();
+    pending_tracks_.clear();
+    held_ = {};
+    for (const auto& f : frames) {
+        frames_.push_back(OutFrame{{}, true, f});
+    }
+    feed_seq_ = seq;
+
+    // The catch-up completes the snapshot, so it skips pacing: a mirror
+    // must not start from a decimated table
+    for (std::size_t i = 0; i < catch_up.size(); i += protocol::mirror::kSnapshotChunk) {
+        const auto part = catch_up.subspan(i, std::min(protocol::mirror::kSnapshotChunk, catch_up.size() - i));
+        frames_.push_back(OutFrame{protocol::encode_track_batch(part, nullptr, ++feed_seq_), true});
+    }
+    wake();
+}
+
+void Session::close() {
+    closed_ = true;
+    frames_.clear();
+    track_order_.clear();
+    pending_tracks_.clear();
+    held_ = {};
+    wake_.cancel();
+    ping_timer_.cancel();
+}
+
+void Session::abort() {
+    close();
+    beast::error_code ec;
+    beast::get_lowest_layer(ws_).close(ec);
+}
+
+void Session::wake() {
+    wake_.cancel();
+}
+
+void Session::release_held(clock::time_point now) {
+    while (!held_.empty() && held_.top().first <= now) {
+        const auto [due, key] = held_.top();
+        held_.pop();
+        auto it = pending_tracks_.find(key);
+        if (it != pending_tracks_.end() && it->second.held && it->second.due == due) {
+            it->second.held = false;
+            track_order_.push_back(key);
+        }
+    }
+}
+
+void Session::on_control(websocket::frame_type kind, std::string_view payload) {
+    if (kind == websocket::frame_type::ping) {
+        link_.on_peer_ping(payload, protocol::link::wall_clock_ns());
+    } else if (kind == websocket::frame_type::pong) {
+        if (link_.on_pong(payload, clock::now())) {
+            rate_.on_rtt(link_.smoothed_rtt(), link_.min_rtt());
+        }
+    }
+}
+
+void Session::tick_rate(clock::time_point now) {
+    const auto divisor = rate_.divisor();
+    if (rate_.tick(queue_depth(), now)) {
+        if (rate_.divisor() != divisor) {
+            // Holds were timed for the old rate — let them all go now
+            release_held(clock::time_point::max());
+            wake();
+        }
+        const auto st = rate_.state();
+        fmt::print("[SERVER] Session {} send rate 1/{} batch {} (queue {}, ~{:.0f} kB/s)\n",
+                   id_, st.divisor, st.batch_size, st.queue_depth,
+                   st.throughput_bps / 1024.0);
+    }
+}
+
+auto Session::take_track_batch() -> std::string {
+    const auto n = std::min(rate_.batch_size(), track_order_.size());
+
+    std::vector<protocol::TrackUpdate> batch;
+    batch.reserve(n);
+    std::shared_ptr<const protocol::LatencyTrace> stalest;
+    const auto now = clock::now();
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto key = track_order_.front();
+        track_order_.pop_front();
+
+        auto it = pending_tracks_.find(key);
+        if (it != pending_tracks_.end()) {
+            batch.push_back(it->second.update);
+            const auto& t = it->second.trace;
+            if (t && (!stalest || t->origin_ns < stalest->origin_ns)) {
+                stalest = t;
+            }
+            pending_tracks_.erase(it);
+            rate_.on_sent(key, now);
+        }
+    }
+
+    ++feed_seq_;
+    if (!stalest) {
+        return protocol::encode_track_batch(batch, nullptr, feed_seq_);
+    }
+    auto trace = *stalest;
+    trace.stamp_egress(protocol::link::wall_clock_ns());
+    return protocol::encode_track_batch(batch, &trace, feed_seq_);
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// WRITER COROUTINE
+// ═══════════════════════════════════════════════════════════════════════════
+
+auto Session::run_writer() -> asio::awaitable<void> {
+    while (!closed_) {
+        release_held(clock::now());
+        if (frames_.empty() && track_order_.empty()) {
+            // Sleep until woken, or until the next held target is due
+            wake_.expires_at(held_.empty() ? asio::steady_timer::time_point::max() : held_.top().first);
+            co_await wake_.async_wait(asio::as_tuple(asio::use_awaitable));
+            continue;
+        }
+
+        std::string out;
+        protocol::mirror::SharedFrame shared;
+        bool binary = true;
+        std::size_t updates = 0;
+
+        if (!frames_.empty()) {
+            out = std::move(frames_.front().data);
+            shared = std::move(frames_.front().shared);
+            binary = frames_.front().binary;
+            frames_.pop_front();
+        } else {
+            updates = std::min(rate_.batch_size(), track_order_.size());
+            out = take_track_batch();
+        }
+
+        ws_.binary(binary);
+        const auto started = clock::now();
+        auto [ec, written] = co_await ws_.async_write(
+            asio::buffer(shared ? *shared : out),
+            asio::as_tuple(asio::use_awaitable)
+        );
+
+        if (ec) {
+            if (ec != websocket::error::closed && ec != asio::error::operation_aborted) {
+                fmt::print("[SERVER] Session {} write error: {}\n", id_, ec.message());
+            }
+            closed_ = true;
+            break;
+        }
+
+        const auto finished = clock::now();
+        rate_.on_write(written, updates, finished - started);
+        tick_rate(finished);
+    }
+}
+
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PINGER COROUTINE
+// ═══════════════════════════════════════════════════════════════════════════
+
+auto Session::run_pinger() -> asio::awaitable<void> {
+    const auto interval = link_.config().ping_interval;
+
+    while (!closed_) {
+        ping_timer_.expires_after(interval);
+        co_await ping_timer_.async_wait(asio::as_tuple(asio::use_awaitable));
+        if (closed_) {
+            break;
+        }
+
+        const auto now = clock::now();
+        link_.expire(now);
+        if (link_.stalled(now)) {
+            fmt::print("[SERVER] Session {} link stalled (no pong for {}ms), dropping\n",
+                       id_, link_.config().stall_timeout.count());
+            abort();
+            break;
+        }
+
+        const auto payload = link_.make_ping(now);
+        auto [ec] = co_await ws_.async_ping(
+            websocket::ping_data{payload.data(), payload.size()},
+            asio::as_tuple(asio::use_awaitable)
+        );
+        if (ec) {
+            break;
+        }
+    }
+}
+
+}  // namespace ws
@@ -0,0 +1,171 @@
+#include "standby.hpp"
+
+#include <exception>
+
+#include <fmt/core.h>
+
+#include "log_shipping.hpp"
+
+namespace ws {
+
+namespace {
+
+/// The standby link retries fast — the primary is usually one hop away.
+auto standby_retry_config() -> protocol::retry::RetryConfig {
+    return protocol::retry::RetryConfig{}
+        .with_max_attempts(5)
+        .with_initial_delay(std::chrono::milliseconds{100})
+        .with_max_delay(std::chrono::seconds{1});
+}
+
+/// Interval between "[STANDBY]" status lines.
+constexpr std::chrono::seconds kStandbyReportInterval{5};
+
+auto to_ms(std::chrono::steady_clock::duration d) -> std::chrono::milliseconds {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(d);
+}
+
+}  // namespace
+
+
+Standby::Standby(asio::io_context& ioc,
+                 svckit::AddrConfig primary,
+                 svckit::AddrConfig listen,
+                 ServerState state,
+                 svckit::ClusterConfig cluster,
+                 StandbyConfig cfg)
+    : ioc_{ioc}
+    , primary_{std::move(primary)}
+    , listen_{std::move(listen)}
+    , state_{std::move(state)}
+    , cluster_{std::move(cluster)}
+    , cfg_{std::move(cfg)}
+    , client_{WSClient::create_with_retry(ioc, primary_, standby_retry_config())}
+    , timer_{ioc}
+{}
+
+void Standby::start() {
+    running_ = true;
+    fmt::print("[STANDBY] Mirroring {} from seq {} ({} tracks warm)\n",
+               primary_.addr(), state_.journal->next_seq(), state_.store->size());
+
+    client_->start_link(LinkHandlers{
+        [this]() { on_connected(); },
+        [this](std::string_view frame) { on_binary(frame); },
+        [this]() { fmt::print("[STANDBY] Lost link to primary {}\n", primary_.addr()); }
+    });
+    asio::co_spawn(ioc_, run_watchdog(), asio::detached);
+}
+
+void Standby::stop() {
+    running_ = false;
+    timer_.cancel();
+    if (server_) {
+        server_->stop();
+        return;
+    }
+    client_->stop();
+    state_.journal->sync();
+}
+
+void Standby::on_connected() {
+    contacted_ = true;
+    last_heard_ = clock::now();
+    client_->send_binary(protocol::shipping::encode_standby_hello(state_.journal->next_seq()));
+}
+
+void Standby::on_binary(std::string_view frame) {
+    const auto batch = protocol::shipping::decode_journal_batch(frame);
+    if (!batch) {
+        return;
+    }
+    last_heard_ = clock::now();
+    primary_last_seq_ = batch->primary_last_seq;
+    if (batch->records.empty()) {
+        return;  // Heartbeat
+    }
+
+    auto& journal = *state_.journal;
+    for (const auto& rec : batch->records) {
+        if (rec.seq > journal.next_seq()) {
+            ++gaps_;
+            fmt::print("[STANDBY] Journal gap {}..{} (primary discarded it)\n",
+                       journal.next_seq(), rec.seq - 1);
+        }
+        if (journal.append(rec)) {
+            apply_journal_record(*state_.store, rec);
+        }
+    }
+    client_->send_binary(protocol::shipping::encode_journal_ack(journal.last_seq()));
+}
+
+auto Standby::run_watchdog() -> asio::awaitable<void> {
+    auto next_report = clock::now() + kStandbyReportInterval;
+
+    while (running_) {
+        timer_.expires_after(cfg_.check_interval);
+        co_await timer_.async_wait(asio::as_tuple(asio::use_awaitable));
+        if (!running_) {
+            break;
+        }
+
+        const auto now = clock::now();
+        if (contacted_ && now - last_heard_ >= cfg_.failover_after) {
+            co_await promote(now);
+            co_return;
+        }
+
+        if (now >= next_report) {
+            next_report = now + kStandbyReportInterval;
+            try {
+                state_.journal->flush();
+            } catch (const std::exception& e) {
+                fmt::print("[STANDBY] Journal flush failed: {}\n", e.what());
+            }
+            fmt::print("[STANDBY] {} seq {} behind {} tracks {} gaps {}\n",
+                       client_->is_connected() ? "linked" : "waiting",
+                       applied_seq(), behind(), state_.store->size(), gaps_);
+        }
+    }
+}
+
+auto Standby::promote(clock::time_point detected) -> asio::awaitable<void> {
+    fmt::print("[STANDBY] Primary {} silent for {}ms — promoting\n",
+               primary_.addr(), to_ms(detected - last_heard_).count());
+    client_->stop();
+
+    while (running_ && !server_) {
+        std::unique_ptr<WSServer> server;
+        try {
+            server = WSServer::create(ioc_, listen_, cluster_, state_);
+        } catch (const std::exception& e) {
+            // The old primary may still hold the port (hung, not dead)
+            fmt::print("[STANDBY] Bind {} failed: {}\n", listen_.addr(), e.what());
+        }
+
+        if (server) {
+            server_ = std::move(server);
+            break;
+        }
+        timer_.expires_after(cfg_.bind_retry);
+        co_await timer_.async_wait(asio::as_tuple(asio::use_awaitable));
+    }
+    if (!server_) {
+        co_return;
+    }
+
+    server_->run();
+    const auto listening = clock::now();
+    recovery_ = RecoveryReport{
+        to_ms(detected - last_heard_),
+        to_ms(listening - detected),
+        to_ms(listening - last_heard_),
+        state_.journal->last_seq(),
+        state_.store->size()
+    };
+    fmt::print("[STANDBY] Promoted: {} tracks at seq {}, detect {}ms takeover {}ms total {}ms\n",
+               recovery_->tracks, recovery_->last_seq, recovery_->detect.count(),
+               recovery_->takeover.count(), recovery_->total.count());
+}
+
+}  // namespace ws
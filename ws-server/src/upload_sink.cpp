@@ -0,0 +1,198 @@
+#include "upload_sink.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <string_view>
+#include <system_error>
+
+#include <fmt/core.h>
+
+namespace ws {
+
+namespace upload = protocol::upload;
+
+namespace {
+
+/// A plain file name: no directories, no dot entries.
+auto safe_name(std::string_view name) -> bool {
+    return !name.empty() && name != "." && name != ".."
+        && name.find_first_of(std::string_view{"/\\\0", 3}) == std::string_view::npos;
+}
+
+}  // namespace
+
+UploadSink::UploadSink(UploadSinkConfig cfg)
+    : cfg_{std::move(cfg)}
+{
+    std::filesystem::create_directories(cfg_.dir);
+}
+
+auto UploadSink::begin(const upload::UploadBegin& begin) -> Ack {
+    const auto now = clock::now();
+    expire(now);
+
+    if (completed_.contains(begin.id)) {
+        return Ack{begin.id, begin.size, upload::UploadStatus::Complete};
+    }
+
+    if (auto it = active_.find(begin.id); it != active_.end()) {
+        const auto& meta = it->second.meta;
+        if (meta.size != begin.size || meta.chunk_size != begin.chunk_size
+            || meta.file_hash != begin.file_hash || meta.name != begin.name) {
+            return reject(begin.id, "resume does not match the upload in progress");
+        }
+        ++stats_.resumed;
+        it->second.last_activity = now;
+        fmt::print("[UPLOAD] {} resumes at {}/{} bytes\n", meta.name, it->second.committed, meta.size);
+        return Ack{begin.id, it->second.committed, upload::UploadStatus::Resume};
+    }
+
+    if (!safe_name(begin.name)) {
+        return reject(begin.id, "bad file name");
+    }
+    if (begin.chunk_size == 0 || begin.chunk_size > upload::kMaxChunkSize) {
+        return reject(begin.id, fmt::format("chunk size {} out of range", begin.chunk_size));
+    }
+    std::error_code ec;
+    if (std::filesystem::exists(cfg_.dir / begin.name, ec)) {
+        return reject(begin.id, "file already exists");
+    }
+    if (std::ranges::any_of(active_, [&](const auto& a) { return a.second.meta.name == begin.name; })) {
+        return reject(begin.id, "name already being uploaded");
+    }
+    if (active_.size() >= cfg_.max_active) {
+        return reject(begin.id, fmt::format("{} uploads already active", active_.size()));
+    }
+
+    Active up;
+    up.meta = begin;
+    up.part = cfg_.dir / fmt::format("{:016x}.part", begin.id);
+    up.running_hash = upload::file_hash_seed(begin.size);
+    up.last_activity = now;
+    try {
+        up.file = protocol::PosixFile::open_read_write(up.part);
+        up.file.truncate(0);
+    } catch (const std::exception& e) {
+        return reject(begin.id, e.what());
+    }
+
+    ++stats_.started;
+    fmt::print("[UPLOAD] {} started ({} bytes, {} KB chunks)\n",
+               begin.name, begin.size, begin.chunk_size / 1024);
+    auto it = active_.emplace(begin.id, std::move(up)).first;
+    if (begin.size == 0) {
+        return finish(it);
+    }
+    return Ack{begin.id, 0, upload::UploadStatus::Resume};
+}
+
+auto UploadSink::chunk(const upload::UploadChunk& chunk) -> std::optional<Ack> {
+    const auto now = clock::now();
+    expire(now);
+
+    auto it = active_.find(chunk.id);
+    if (it == active_.end()) {
+        // Finished, rejected or never begun: the ack tells the client which
+        if (completed_.contains(chunk.id)) {
+            return std::nullopt;
+        }
+        return Ack{chunk.id, 0, upload::UploadStatus::Rejected};
+    }
+
+    auto& up = it->second;
+    up.last_activity = now;
+    if (chunk.offset != up.committed) {
+        return std::nullopt;  // In flight behind a Corrupt ack, or a stale duplicate
+    }
+    if (chunk.data.size() != upload::chunk_length(up.meta.size, up.meta.chunk_size, chunk.offset)
+        || upload::content_hash(chunk.data) != chunk.hash) {
+        ++stats_.corrupt_chunks;
+        return Ack{chunk.id, up.committed, upload::UploadStatus::Corrupt};
+    }
+
+    try {
+        up.file.pwrite_all(chunk.data, chunk.offset);
+    } catch (const std::exception& e) {
+        return reject(chunk.id, e.what());
+    }
+    up.committed += chunk.data.size();
+    up.running_hash = upload::fold_chunk_hash(up.running_hash, chunk.hash);
+    stats_.bytes += chunk.data.size();
+
+    if (up.committed == up.meta.size) {
+        return finish(it);
+    }
+    return Ack{chunk.id, up.committed, upload::UploadStatus::Committed};
+}
+
+auto UploadSink::finish(std::unordered_map<std::uint64_t, Active>::iterator it) -> Ack {
+    auto& up = it->second;
+    const auto id = it->first;
+    if (up.running_hash != up.meta.file_hash) {
+        return reject(id, "file hash mismatch");
+    }
+
+    const auto target = cfg_.dir / up.meta.name;
+    try {
+        up.file.sync();
+        up.file.close();
+        // A hard link fails rather than replace a file that appeared
+        // since begin()
+        std::filesystem::create_hard_link(up.part, target);
+        std::error_code ignored;
+        std::filesystem::remove(up.part, ignored);
+    } catch (const std::exception& e) {
+        return reject(id, e.what());
+    }
+
+    fmt::print("[UPLOAD] {} complete ({} bytes)\n", target.string(), up.meta.size);
+    const auto size = up.meta.size;
+    active_.erase(it);
+    remember_completed(id);
+    ++stats_.completed;
+    return Ack{id, size, upload::UploadStatus::Complete};
+}
+
+auto UploadSink::reject(std::uint64_t id, const std::string& why) -> Ack {
+    if (auto it = active_.find(id); it != active_.end()) {
+        fmt::print("[UPLOAD] {} rejected: {}\n", it->second.meta.name, why);
+        it->second.file.close();
+        std::error_code ignored;
+        std::filesystem::remove(it->second.part, ignored);
+        active_.erase(it);
+    } else {
+        fmt::print("[UPLOAD] Upload {:016x} rejected: {}\n", id, why);
+    }
+    ++stats_.rejected;
+    return Ack{id, 0, upload::UploadStatus::Rejected};
+}
+
+void UploadSink::expire(clock::time_point now) {
+    for (auto it = active_.begin(); it != active_.end();) {
+        auto& up = it->second;
+        if (now - up.last_activity < cfg_.idle_timeout) {
+            ++it;
+            continue;
+        }
+        fmt::print("[UPLOAD] {} abandoned at {}/{} bytes, dropped\n",
+                   up.meta.name, up.committed, up.meta.size);
+        up.file.close();
+        std::error_code ignored;
+        std::filesystem::remove(up.part, ignored);
+        it = active_.erase(it);
+        ++stats_.expired;
+    }
+}
+
+void UploadSink::remember_completed(std::uint64_t id) {
+    if (!completed_.insert(id).second) {
+        return;
+    }
+    completed_order_.push_back(id);
+    while (completed_order_.size() > cfg_.max_completed) {
+        completed_.erase(completed_order_.front());
+        completed_order_.pop_front();
+    }
+}
+
+}  // namespace ws
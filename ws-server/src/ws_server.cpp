@@ -1,10 +1,17 @@
 #include "ws_server.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <exception>
+#include <limits>
 #include <thread>
 
 #include <fmt/core.h>
 
+#include "log_shipping.hpp"
+#include "rpc.hpp"
+#include "upload.hpp"
+
 namespace ws {
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -12,15 +19,69 @@ namespace ws {
 // ═══════════════════════════════════════════════════════════════════════════
 
 // ───────────────────────────────────────────────────────────────────────────
-// Private Constructor
+// Private Constructors
 // ───────────────────────────────────────────────────────────────────────────
 
 WSServer::WSServer(asio::io_context& ioc, const svckit::AddrConfig& cfg)
+    : WSServer{ioc, cfg, protocol::ratelimit::IngestLimitConfig{}}
+{}
+
+WSServer::WSServer(asio::io_context& ioc,
+                   const svckit::AddrConfig& cfg,
+                   const protocol::ratelimit::IngestLimitConfig& limits)
+    : WSServer{ioc, cfg, limits, svckit::ClusterConfig{}}
+{}
+
+WSServer::WSServer(asio::io_context& ioc,
+                   const svckit::AddrConfig& cfg,
+                   svckit::ClusterConfig cluster)
+    : WSServer{ioc, cfg, protocol::ratelimit::IngestLimitConfig{}, std::move(cluster)}
+{}
+
+WSServer::WSServer(asio::io_context& ioc,
+                   const svckit::AddrConfig& cfg,
+                   const protocol::ratelimit::IngestLimitConfig& limits,
+                   svckit::ClusterConfig cluster)
+    : WSServer{ioc, cfg, limits, std::move(cluster), ServerState::in_memory()}
+{}
+
+WSServer::WSServer(asio::io_context& ioc,
+                   const svckit::AddrConfig& cfg,
+                   svckit::ClusterConfig cluster,
+                   ServerState state)
+    : WSServer{ioc, cfg, protocol::ratelimit::IngestLimitConfig{}, std::move(cluster), std::move(state)}
+{}
+
+WSServer::WSServer(asio::io_context& ioc,
+                   const svckit::AddrConfig& cfg,
+                   const protocol::ratelimit::IngestLimitConfig& limits,
+                   svckit::ClusterConfig cluster,
+                   ServerState state)
     : ioc_{ioc}
     , acceptor_{ioc}
     , ssl_ctx_{std::make_unique<ssl::context>(ssl::context::tlsv12_server)}
     , cfg_{cfg}
+    , ingest_cfg_{limits}
+    , node_id_{cluster.node_id()}
+    , store_{std::move(state.store)}
+    , cluster_{Cluster::create(ioc, std::move(cluster), store_)}
+    , journal_{std::move(state.journal)}
+    , snapshot_cache_{std::make_shared<protocol::mirror::SnapshotCache>()}
+    , snapshots_{std::move(state.snapshots)}
+    , snapshot_seq_{state.restored ? state.restored->journal_seq : 0}
+    , uploads_{std::move(state.uploads)}
+    , rpc_{std::make_unique<RpcRouter>(0)}
 {
+    // Journal every store change — local ingest, forwards and replicas
+    // alike — and note it for the mirror snapshot's catch-up
+    store_->set_on_apply([journal = journal_, cache = snapshot_cache_](const protocol::StoredTrack& t) {
+        journal->append(t.stored_ns, t.origin_node, t.origin_seq, t.update);
+        cache->on_apply(t.update.target_id);
+    });
+    if (journal_->config().persistent()) {
+        rpc_->add_journal_query(journal_->config().dir);
+    }
+    
     // Configure SSL context
     ssl_ctx_->set_options(
         ssl::context::default_workarounds |
@@ -73,6 +134,45 @@ WSServer::WSServer(WSServer&& other) noexcept
     , ssl_ctx_{std::exchange(other.ssl_ctx_, nullptr)}  // Transfer + nullify
     , cfg_{std::move(other.cfg_)}  // Move config (value type)
     , api_{std::move(other.api_)}  // Move API (value type)
+    , ingest_cfg_{other.ingest_cfg_}  // Copy limits (trivial value type)
+    , source_limiters_{std::move(other.source_limiters_)}  // Move limiter map
+    , send_rate_cfg_{other.send_rate_cfg_}  // Copy egress tuning
+    , link_cfg_{other.link_cfg_}  // Copy probe tuning
+    , dedup_{std::move(other.dedup_)}
+    , dedup_origins_{std::move(other.dedup_origins_)}
+    , reorder_{std::move(other.reorder_)}
+    , cpa_cfg_{std::move(other.cpa_cfg_)}
+    , cpa_active_{std::move(other.cpa_active_)}
+    , cpa_stats_{other.cpa_stats_}
+    , interceptors_{std::move(other.interceptors_)}
+    , intercept_stats_{other.intercept_stats_}
+    , swarm_{std::move(other.swarm_)}
+    , lod_{std::move(other.lod_)}
+    , lod_views_{std::move(other.lod_views_)}
+    , lod_batches_{other.lod_batches_}
+    , lod_tiles_sent_{other.lod_tiles_sent_}
+    , lifecycle_{std::move(other.lifecycle_)}
+    , anomaly_{std::move(other.anomaly_)}
+    , sectors_{std::move(other.sectors_)}
+    , sector_views_{std::move(other.sector_views_)}
+    , sector_reports_sent_{other.sector_reports_sent_}
+    , anomaly_flags_{std::move(other.anomaly_flags_)}
+    , anomaly_counts_{other.anomaly_counts_}
+    , quarantine_batches_{other.quarantine_batches_}
+    , sessions_{std::move(other.sessions_)}  // Move session registry
+    , next_session_id_{std::exchange(other.next_session_id_, 1)}
+    , node_id_{other.node_id_}
+    , store_{std::move(other.store_)}  // Shared with peer links
+    , cluster_{std::move(other.cluster_)}  // Transfer replication hub
+    , journal_{std::move(other.journal_)}  // Shared with the store hook
+    , snapshot_cache_{std::move(other.snapshot_cache_)}  // Shared with the store hook
+    , shippers_{std::move(other.shippers_)}  // Move standby streams
+    , snapshots_{std::move(other.snapshots_)}  // Shared writer thread
+    , snapshot_seq_{other.snapshot_seq_}
+    , uploads_{std::move(other.uploads_)}
+    , rpc_{std::move(other.rpc_)}
+    , track_view_{std::move(other.track_view_)}
+    , track_view_seq_{other.track_view_seq_}
     , running_{other.running_.exchange(false)}  // Atomic transfer + reset
 {}
 
@@ -112,6 +212,45 @@ WSServer& WSServer::operator=(WSServer&& other) noexcept {
         ssl_ctx_ = std::exchange(other.ssl_ctx_, nullptr);
         cfg_ = std::move(other.cfg_);
         api_ = std::move(other.api_);
+        ingest_cfg_ = other.ingest_cfg_;
+        source_limiters_ = std::move(other.source_limiters_);
+        send_rate_cfg_ = other.send_rate_cfg_;
+        link_cfg_ = other.link_cfg_;
+        dedup_ = std::move(other.dedup_);
+        dedup_origins_ = std::move(other.dedup_origins_);
+        reorder_ = std::move(other.reorder_);
+        cpa_cfg_ = std::move(other.cpa_cfg_);
+        cpa_active_ = std::move(other.cpa_active_);
+        cpa_stats_ = other.cpa_stats_;
+        interceptors_ = std::move(other.interceptors_);
+        intercept_stats_ = other.intercept_stats_;
+        swarm_ = std::move(other.swarm_);
+        lod_ = std::move(other.lod_);
+        lod_views_ = std::move(other.lod_views_);
+        lod_batches_ = other.lod_batches_;
+        lod_tiles_sent_ = other.lod_tiles_sent_;
+        lifecycle_ = std::move(other.lifecycle_);
+        anomaly_ = std::move(other.anomaly_);
+        sectors_ = std::move(other.sectors_);
+        sector_views_ = std::move(other.sector_views_);
+        sector_reports_sent_ = other.sector_reports_sent_;
+        anomaly_flags_ = std::move(other.anomaly_flags_);
+        anomaly_counts_ = other.anomaly_counts_;
+        quarantine_batches_ = other.quarantine_batches_;
+        sessions_ = std::move(other.sessions_);
+        next_session_id_ = std::exchange(other.next_session_id_, 1);
+        node_id_ = other.node_id_;
+        store_ = std::move(other.store_);
+        cluster_ = std::move(other.cluster_);
+        journal_ = std::move(other.journal_);
+        snapshot_cache_ = std::move(other.snapshot_cache_);
+        shippers_ = std::move(other.shippers_);
+        snapshots_ = std::move(other.snapshots_);
+        snapshot_seq_ = other.snapshot_seq_;
+        uploads_ = std::move(other.uploads_);
+        rpc_ = std::move(other.rpc_);
+        track_view_ = std::move(other.track_view_);
+        track_view_seq_ = other.track_view_seq_;
         running_.store(other.running_.exchange(false), std::memory_order_release);
     }
     return *this;
@@ -127,11 +266,83 @@ void WSServer::run() {
     fmt::print("[SERVER] Listening on {}:{}\n", cfg_.host(), cfg_.port());
     
     asio::co_spawn(ioc_, accept_loop(), asio::detached);
+    asio::co_spawn(ioc_, run_journal_flusher(), asio::detached);
+    if (snapshots_) {
+        asio::co_spawn(ioc_, run_snapshotter(), asio::detached);
+    }
+    if (reorder_.config().enabled()) {
+        asio::co_spawn(ioc_, run_reorder(), asio::detached);
+        fmt::print("[SERVER] Reordering sensor reports (hold {}ms, late reports {})\n",
+                   reorder_.config().hold.count(),
+                   reorder_.config().late == protocol::LatePolicy::Drop ? "dropped" : "released");
+    }
+    if (cpa_cfg_) {
+        asio::co_spawn(ioc_, run_cpa(), asio::detached);
+        fmt::print("[SERVER] CPA screening every {}ms (within {:.0f}m, {}s horizon)\n",
+                   cpa_cfg_->interval.count(), cpa_cfg_->distance_m,
+                   std::chrono::duration_cast<std::chrono::seconds>(cpa_cfg_->horizon).count());
+    }
+    if (swarm_) {
+        asio::co_spawn(ioc_, run_swarm(), asio::detached);
+        fmt::print("[SERVER] Swarm detection every {}ms ({}+ tracks within {:.0f}m)\n",
+                   swarm_->config().interval.count(), swarm_->config().min_tracks,
+                   swarm_->config().eps_m);
+    }
+    if (lod_) {
+        asio::co_spawn(ioc_, run_lod(), asio::detached);
+        std::string zooms;
+        for (const auto z : lod_->config().zooms) {
+            zooms += fmt::format("{}{}", zooms.empty() ? "" : "/", static_cast<unsigned>(z));
+        }
+        fmt::print("[SERVER] LOD tiles at zoom {} every {}ms\n", zooms, lod_->config().interval.count());
+    }
+    if (lifecycle_) {
+        store_->for_each([&](const protocol::StoredTrack& t) {
+            lifecycle_->restore(t.update.target_id, t.stored_ns);
+        });
+        asio::co_spawn(ioc_, run_lifecycle(), asio::detached);
+        const auto& lc = lifecycle_->config();
+        fmt::print("[SERVER] Track lifecycle: confirm after {} reports, coast after {}ms, drop after {}ms\n",
+                   lc.confirm_updates, lc.coast_after.count(), lc.drop_after.count());
+    }
+    if (sectors_) {
+        asio::co_spawn(ioc_, run_sectors(), asio::detached);
+        const auto& sc = sectors_->config();
+        fmt::print("[SERVER] Sector statistics: {}° sectors, {}s traffic window, streamed every {}ms\n",
+                   sc.sector_deg, sc.window.count() / 1000, sc.interval.count());
+    }
+    if (anomaly_) {
+        const auto& ac = anomaly_->config();
+        fmt::print("[SERVER] Anomaly screening: speed {:.0f}m/s, acceleration {:.0f}m/s², climb {:.0f}m/s\n",
+                   ac.max_speed_mps, ac.max_accel_mps2, ac.max_climb_mps);
+    }
+    cluster_->start();
 }
 
 void WSServer::stop() {
     running_.store(false, std::memory_order_release);
     
+    // Apply everything still held so the journal and snapshot include it
+    release_reordered(std::numeric_limits<std::int64_t>::max());
+    
+    if (cluster_) {
+        cluster_->stop();
+    }
+    for (auto& [id, shipper] : shippers_) {
+        shipper->stop();
+    }
+    shippers_.clear();
+    if (snapshots_ && journal_ && journal_->last_seq() != snapshot_seq_) {
+        take_snapshot();  // Written by the writer thread before it exits
+    }
+    if (journal_) {
+        try {
+            journal_->sync();
+        } catch (const std::exception& e) {
+            fmt::print("[SERVER] Journal sync failed: {}\n", e.what());
+        }
+    }
+    
     beast::error_code ec;
     acceptor_.close(ec);
     
@@ -166,6 +377,16 @@ auto WSServer::accept_loop() -> asio::awaitable<void> {
 }
 
 auto WSServer::handle_session(tcp::socket socket) -> asio::awaitable<void> {
+    // Identify the source before the socket is moved into the TLS stream
+    beast::error_code addr_ec;
+    const auto remote = socket.remote_endpoint(addr_ec);
+    const std::string source = addr_ec ? std::string{"unknown"} : remote.address().to_string();
+    
+    auto session_limiter = protocol::ratelimit::SteadyIngestLimiter::for_session(ingest_cfg_);
+    auto source_limiter = acquire_source_limiter(source);
+    bool peer_budget = false;
+    std::shared_ptr<Session> session;
+    
     try {
         // Create SSL stream
         ssl::stream<tcp::socket> ssl_stream{std::move(socket), *ssl_ctx_};
@@ -187,13 +408,27 @@ auto WSServer::handle_session(tcp::socket socket) -> asio::awaitable<void> {
         // Accept WebSocket handshake
         co_await ws.async_accept(asio::use_awaitable);
         
-        fmt::print("[SERVER] WebSocket session opened\n");
+        // Hand the stream to a session; its writer owns all outbound traffic
+        session = Session::create(next_session_id_++, source, std::move(ws),
+                                  send_rate_cfg_, link_cfg_);
+        sessions_.emplace(session->id(), session);
+        asio::co_spawn(ioc_, [session]() -> asio::awaitable<void> {
+            co_await session->run_writer();
+        }, asio::detached);
+        asio::co_spawn(ioc_, [session]() -> asio::awaitable<void> {
+            co_await session->run_pinger();
+        }, asio::detached);
+        
+        fmt::print("[SERVER] WebSocket session {} opened ({})\n", session->id(), source);
+        
+        auto& stream = session->stream();
+        asio::steady_timer pause_timer{ioc_};
         
         // Read loop
         while (running_.load(std::memory_order_acquire)) {
             beast::flat_buffer buffer;
             
-            auto [ec, bytes] = co_await ws.async_read(
+            auto [ec, bytes] = co_await stream.async_read(
                 buffer,
                 asio::as_tuple(asio::use_awaitable)
             );
@@ -205,23 +440,902 @@ auto WSServer::handle_session(tcp::socket socket) -> asio::awaitable<void> {
                 break;
             }
             
-            // Process packet
             std::string msg = beast::buffers_to_string(buffer.data());
-            auto pkt = api_.make_packet(msg, protocol::Urgency::Green);
-            api_.dispatch(pkt, *this);
+            auto cost = ingest_cfg_.cost_for(protocol::Urgency::Green);
             
-            // Echo response
-            co_await ws.async_write(
-                asio::buffer(msg),
-                asio::use_awaitable
-            );
+            if (stream.got_binary()) {
+                // Binary protocol (track batches, control frames)
+                cost = on_binary_frame(*session, msg);
+            } else {
+                // Legacy text protocol — dispatch and echo
+                auto pkt = api_.make_packet(msg, protocol::Urgency::Green);
+                api_.dispatch(pkt, *this);
+                cost = ingest_cfg_.cost_for(pkt.urgency());
+                session->send_frame(std::move(msg), false);
+            }
+            
+            // Ingest limiting — the frame is already accepted; if either
+            // bucket is in debt, stop reading so TCP backpressure reaches
+            // the sender instead of dropping frames.
+            if (ingest_cfg_.enabled) {
+                // An identified peer carries a whole node's ingest: it
+                // leaves the session and source budgets for its own
+                if (!peer_budget && session->peer_node()) {
+                    session_limiter = protocol::ratelimit::SteadyIngestLimiter::for_peer(ingest_cfg_);
+                    peer_budget = true;
+                }
+                const auto now = std::chrono::steady_clock::now();
+                const auto pause = peer_budget
+                    ? session_limiter.admit(bytes, cost, now)
+                    : std::max(session_limiter.admit(bytes, cost, now),
+                               source_limiter->admit(bytes, cost, now));
+                
+                if (pause > std::chrono::steady_clock::duration::zero()) {
+                    pause_timer.expires_after(pause);
+                    co_await pause_timer.async_wait(asio::as_tuple(asio::use_awaitable));
+                }
+            }
         }
         
-        fmt::print("[SERVER] WebSocket session closed\n");
+        fmt::print("[SERVER] WebSocket session {} closed\n", session->id());
         
     } catch (const std::exception& e) {
         fmt::print("[SERVER] Session exception: {}\n", e.what());
     }
+    
+    if (session) {
+        const auto link = session->link_stats();
+        if (link.pongs_received > 0) {
+            fmt::print("[SERVER] Session {} link rtt p50 {}us p99 {}us jitter {}us loss {:.1f}%\n",
+                       session->id(), link.rtt_p50.count(), link.rtt_p99.count(),
+                       link.jitter.count(), link.loss_ratio * 100.0);
+        }
+        if (const auto node = session->peer_node()) {
+            cluster_->set_peer_interest(*node, false);
+        }
+        if (const auto offset = reorder_.clock_offset(session->id())) {
+            fmt::print("[SERVER] Session {} sensor clock offset {}us\n",
+                       session->id(), offset->count() / 1000);
+        }
+        reorder_.forget(session->id());
+        interceptors_.erase(session->id());
+        lod_views_.erase(session->id());
+        sector_views_.erase(session->id());
+        if (auto it = shippers_.find(session->id()); it != shippers_.end()) {
+            it->second->stop();
+            shippers_.erase(it);
+            fmt::print("[SERVER] Standby session {} detached\n", session->id());
+        }
+        session->close();
+        sessions_.erase(session->id());
+    }
+    
+    const auto& st = session_limiter.stats();
+    if (st.throttled > 0) {
+        fmt::print("[SERVER] Ingest throttled {} ({}/{} frames, paused {}ms)\n",
+                   source, st.throttled, st.frames, st.paused.count());
+    }
+    release_source_limiter(source, source_limiter);
+}
+
+auto WSServer::run_snapshotter() -> asio::awaitable<void> {
+    asio::steady_timer timer{ioc_};
+    std::int64_t reported_ns = 0;
+    
+    while (running_.load(std::memory_order_acquire)) {
+        timer.expires_after(snapshots_->config().interval);
+        co_await timer.async_wait(asio::as_tuple(asio::use_awaitable));
+        if (!running_.load(std::memory_order_acquire)) {
+            break;
+        }
+        
+        if (const auto last = snapshots_->last(); last && last->taken_ns != reported_ns) {
+            reported_ns = last->taken_ns;
+            fmt::print("[SERVER] Snapshot {} tracks at seq {} ({} KB in {}ms)\n",
+                       last->tracks, last->journal_seq, last->bytes / 1024,
+                       last->elapsed.count() / 1000);
+        }
+        if (journal_->last_seq() != snapshot_seq_ && !snapshots_->busy()) {
+            take_snapshot();
+        }
+    }
+}
+
+void WSServer::take_snapshot() {
+    // Hand the journal to the OS first so it never lags the snapshot
+    journal_->flush();
+    snapshot_seq_ = journal_->last_seq();
+    snapshots_->submit(snapshot_seq_, store_->stored());
+}
+
+auto WSServer::run_reorder() -> asio::awaitable<void> {
+    // Poll at an eighth of the hold: bounds how far past due a report waits
+    const auto tick = std::max(reorder_.config().hold / 8, std::chrono::milliseconds{1});
+    asio::steady_timer timer{ioc_};
+    while (running_.load(std::memory_order_acquire)) {
+        timer.expires_after(tick);
+        co_await timer.async_wait(asio::as_tuple(asio::use_awaitable));
+        release_reordered(protocol::link::wall_clock_ns());
+    }
+}
+
+void WSServer::release_reordered(std::int64_t now_ns) {
+    // Ingest consecutive reports from one session's batch together,
+    // keeping order, with the trace they arrived under
+    const auto ingest_ns = std::min(now_ns, protocol::link::wall_clock_ns());
+    std::vector<protocol::TrackUpdate> run;
+    std::uint64_t run_session = 0;
+    std::shared_ptr<const protocol::LatencyTrace> run_trace;
+    reorder_.drain(now_ns, [&](std::uint64_t session, const protocol::TrackUpdate& t,
+                               const std::shared_ptr<const protocol::LatencyTrace>& trace) {
+        if (!run.empty() && (session != run_session || trace != run_trace)) {
+            ingest_tracks(run_session, run, run_trace, ingest_ns);
+            run.clear();
+        }
+        run_session = session;
+        run_trace = trace;
+        run.push_back(t);
+    });
+    if (!run.empty()) {
+        ingest_tracks(run_session, run, run_trace, ingest_ns);
+    }
+}
+
+auto WSServer::run_cpa() -> asio::awaitable<void> {
+    asio::steady_timer timer{ioc_};
+    auto& pool = rpc_->pool();
+    while (running_.load(std::memory_order_acquire)) {
+        timer.expires_after(cpa_cfg_->interval);
+        co_await timer.async_wait(asio::as_tuple(asio::use_awaitable));
+        if (!running_.load(std::memory_order_acquire)) {
+            break;
+        }
+        
+        // Screen the published view on the workers; the loop stays free
+        auto view = track_view();  // Named: GCC 12 can destroy co_await operand temporaries twice
+        const auto now_ns = protocol::link::wall_clock_ns();
+        const auto cfg = *cpa_cfg_;
+        auto result = co_await pool.run([&] { return protocol::screen_cpa(*view, now_ns, cfg, pool); });
+        cpa_stats_ = result.stats;
+        raise_conflicts(result.conflicts);
+    }
+}
+
+void WSServer::raise_conflicts(const std::vector<protocol::CpaConflict>& conflicts) {
+    // Edge-triggered per (pair, urgency): a pair is raised when first
+    // predicted or when it escalates, then again only after a pass that no
+    // longer predicts it. Pairs over the cap keep what was last raised, so
+    // a later pass raises them.
+    std::map<std::pair<std::uint64_t, std::uint64_t>, protocol::Urgency> active;
+    std::vector<protocol::CpaConflict> alerts;
+    for (const auto& c : conflicts) {
+        const auto pair = std::make_pair(c.target_a, c.target_b);
+        const auto known = cpa_active_.find(pair);
+        if (known != cpa_active_.end() && known->second >= c.urgency) {
+            active.emplace(pair, c.urgency);
+            continue;
+        }
+        if (alerts.size() == kCpaMaxAlerts) {
+            if (known != cpa_active_.end()) {
+                active.emplace(pair, known->second);
+            }
+            continue;
+        }
+        active.emplace(pair, c.urgency);
+        alerts.push_back(c);
+    }
+    
+    if (!alerts.empty()) {
+        const auto frame = protocol::encode_cpa_alerts(alerts);
+        for (auto& [id, session] : sessions_) {
+            if (session->subscribed() && session->is_open()) {
+                session->send_frame(frame, true);
+            }
+        }
+        fmt::print("[SERVER] CPA: {} conflict(s) among {} tracks, {} raised, {} pending "
+                   "({} pairs screened in {}us)\n",
+                   conflicts.size(), cpa_stats_.tracks, alerts.size(), conflicts.size() - active.size(),
+                   cpa_stats_.candidate_pairs, cpa_stats_.elapsed.count());
+    }
+    cpa_active_ = std::move(active);
+}
+
+auto WSServer::run_swarm() -> asio::awaitable<void> {
+    asio::steady_timer timer{ioc_};
+    while (running_.load(std::memory_order_acquire)) {
+        timer.expires_after(swarm_->config().interval);
+        co_await timer.async_wait(asio::as_tuple(asio::use_awaitable));
+        if (!running_.load(std::memory_order_acquire)) {
+            break;
+        }
+        
+        // Cheap enough for the I/O thread: only what moved is reclustered
+        const auto delta = swarm_->refresh(protocol::link::wall_clock_ns());
+        if (delta.empty()) {
+            continue;
+        }
+        const auto frame = protocol::encode_swarm_batch(delta.updated, delta.dissolved);
+        for (auto& [id, session] : sessions_) {
+            if (session->subscribed() && session->is_open()) {
+                session->send_frame(frame, true);
+            }
+        }
+    }
+}
+
+auto WSServer::run_lod() -> asio::awaitable<void> {
+    asio::steady_timer timer{ioc_};
+    std::vector<const protocol::lod::Tile*> in_view;
+    while (running_.load(std::memory_order_acquire)) {
+        timer.expires_after(lod_->config().interval);
+        co_await timer.async_wait(asio::as_tuple(asio::use_awaitable));
+        if (!running_.load(std::memory_order_acquire)) {
+            break;
+        }
+        
+        // Tiles are built once; each subscriber gets the ones on its screen
+        const auto deltas = lod_->drain();
+        if (deltas.empty()) {
+            continue;
+        }
+        for (const auto& [id, sub] : lod_views_) {
+            const auto session = sessions_.find(id);
+            const auto delta = std::find_if(deltas.begin(), deltas.end(),
+                [&](const protocol::lod::LevelDelta& d) { return d.zoom == sub.zoom; });
+            if (session == sessions_.end() || !session->second->is_open() || delta == deltas.end()) {
+                continue;
+            }
+            in_view.clear();
+            for (const auto& tile : delta->tiles) {
+                if (protocol::lod::in_view(sub.zoom, tile, sub.view)) {
+                    in_view.push_back(&tile);
+                }
+            }
+            if (in_view.empty()) {
+                continue;
+            }
+            session->second->send_frame(protocol::lod::encode_tiles(sub.zoom, in_view), true);
+            ++lod_batches_;
+            lod_tiles_sent_ += in_view.size();
+        }
+    }
+}
+
+auto WSServer::run_lifecycle() -> asio::awaitable<void> {
+    asio::steady_timer timer{ioc_};
+    std::vector<std::uint64_t> dropped;
+    while (running_.load(std::memory_order_acquire)) {
+        timer.expires_after(lifecycle_->config().tick);
+        co_await timer.async_wait(asio::as_tuple(asio::use_awaitable));
+        if (!running_.load(std::memory_order_acquire)) {
+            break;
+        }
+        
+        dropped.clear();
+        const auto now_ns = protocol::link::wall_clock_ns();
+        for (const auto& tr : lifecycle_->advance(now_ns)) {
+            if (tr.to == protocol::TrackState::Dropped) {
+                dropped.push_back(tr.target_id);
+            }
+        }
+        if (dropped.empty()) {
+            continue;
+        }
+        for (const auto id : dropped) {
+            // Journalled first, so replay and the standby drop it too
+            if (const auto* last = store_->find(id)) {
+                journal_->append_drop(now_ns, node_id_, last->update);
+            }
+            store_->erase(id);
+            snapshot_cache_->on_erase(id);
+            if (lod_) {
+                lod_->remove(id);
+            }
+            if (sectors_) {
+                sectors_->remove(id);
+            }
+            if (anomaly_) {
+                anomaly_->forget(id);
+            }
+        }
+        const auto frame = protocol::encode_track_drop(dropped);
+        for (auto& [id, session] : sessions_) {
+            for (const auto target : dropped) {
+                session->forget_track(target);
+            }
+            if (session->subscribed() && session->is_open()) {
+                session->send_frame(frame, true);
+            }
+        }
+    }
+}
+
+auto WSServer::run_sectors() -> asio::awaitable<void> {
+    asio::steady_timer timer{ioc_};
+    while (running_.load(std::memory_order_acquire)) {
+        timer.expires_after(sectors_->config().interval);
+        co_await timer.async_wait(asio::as_tuple(asio::use_awaitable));
+        if (!running_.load(std::memory_order_acquire)) {
+            break;
+        }
+        
+        const auto now_ns = protocol::link::wall_clock_ns();
+        sectors_->prune(now_ns);
+        for (const auto& [id, area] : sector_views_) {
+            const auto session = sessions_.find(id);
+            if (session == sessions_.end() || !session->second->is_open()) {
+                continue;
+            }
+            session->second->send_frame(protocol::sector::encode_report(sectors_->report(area, now_ns)), true);
+            ++sector_reports_sent_;
+        }
+    }
+}
+
+auto WSServer::sector_stats() const -> std::optional<SectorFeedStats> {
+    if (!sectors_) {
+        return std::nullopt;
+    }
+    return SectorFeedStats{sectors_->stats(), sector_reports_sent_, sector_views_.size()};
+}
+
+auto WSServer::lod_stats() const -> std::optional<LodFeedStats> {
+    if (!lod_) {
+        return std::nullopt;
+    }
+    return LodFeedStats{lod_->stats(), lod_batches_, lod_tiles_sent_, lod_views_.size()};
+}
+
+auto WSServer::run_journal_flusher() -> asio::awaitable<void> {
+    asio::steady_timer timer{ioc_};
+    while (running_.load(std::memory_order_acquire)) {
+        timer.expires_after(kJournalFlushInterval);
+        co_await timer.async_wait(asio::as_tuple(asio::use_awaitable));
+        try {
+            journal_->flush();
+        } catch (const std::exception& e) {
+            fmt::print("[SERVER] Journal flush failed: {}\n", e.what());
+        }
+    }
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// BINARY FRAMES
+// ═══════════════════════════════════════════════════════════════════════════
+
+auto WSServer::on_binary_frame(Session& from, std::string_view frame) -> double {
+    const auto control_cost = ingest_cfg_.cost_for(protocol::Urgency::Green);
+    const auto header = protocol::wire::peek_header(frame);
+    if (!header) {
+        fmt::print("[SERVER] Session {} sent malformed binary frame ({} bytes)\n",
+                   from.id(), frame.size());
+        return control_cost;
+    }
+    
+    switch (header->kind) {
+        case protocol::wire::FrameKind::TrackBatch: {
+            const auto ingress_ns = protocol::link::wall_clock_ns();
+            auto batch = protocol::decode_track_batch(frame);
+            if (!batch) {
+                fmt::print("[SERVER] Session {} sent malformed track batch\n", from.id());
+                return control_cost;
+            }
+            // Charged per record, duplicates included
+            const auto cost = ingest_cfg_.cost_for_records(batch->tracks);
+            
+            // Drop copies of reports already ingested within the window
+            // (redundant sensors, multi-path links) before any dispatch
+            auto& dups = dedup_origins_[from.source()];
+            const auto received = batch->tracks.size();
+            std::erase_if(batch->tracks, [&](const protocol::TrackUpdate& t) {
+                return dedup_.seen(protocol::report_key(t), ingress_ns);
+            });
+            dups.reports += received;
+            dups.duplicates += received - batch->tracks.size();
+            if (batch->tracks.empty()) {
+                return cost;
+            }
+            
+            // Move the trace onto our clock, then stamp our hop
+            std::shared_ptr<const protocol::LatencyTrace> trace;
+            if (batch->trace) {
+                batch->trace->rebase(from.clock_offset().value_or(std::chrono::nanoseconds{0}));
+                batch->trace->stamp_ingress(node_id_, ingress_ns);
+                trace = std::make_shared<const protocol::LatencyTrace>(std::move(*batch->trace));
+            }
+            
+            // Reorder stage: held with the trace, then ingested by
+            // run_reorder() (the hold shows up before the egress stamp)
+            if (reorder_.config().enabled()) {
+                const auto offset = from.clock_offset();
+                for (const auto& t : batch->tracks) {
+                    reorder_.push(from.id(), t, ingress_ns, offset, trace);
+                }
+                return cost;
+            }
+            
+            ingest_tracks(from.id(), batch->tracks, trace, ingress_ns);
+            return cost;
+        }
+        
+        case protocol::wire::FrameKind::Subscribe:
+            if (const auto node = from.peer_node()) {
+                // A peer node with consoles wants the targets we own
+                cluster_->set_peer_interest(*node, true);
+                return control_cost;
+            }
+            from.set_subscribed(true);
+            cluster_->set_local_interest();
+            
+            // Bring the console up to date with every node's targets: one
+            // compressed snapshot for a mirror (also its resync), else
+            // through the feed
+            if (protocol::mirror::decode_subscribe(frame) == protocol::mirror::kModeMirror) {
+                // Cached frames, then what changed since they were built
+                const auto snap = snapshot_cache_->take(*store_, protocol::link::wall_clock_ns());
+                from.send_snapshot(snap.frames, snap.seq, snap.changed);
+                if (!snap.dropped.empty()) {
+                    from.send_frame(protocol::encode_track_drop(snap.dropped), true);
+                }
+                fmt::print("[SERVER] Session {} subscribed to track feed (mirror, snapshot seq {} "
+                           "+ {} changed, {} dropped)\n",
+                           from.id(), snap.seq, snap.changed.size(), snap.dropped.size());
+            } else {
+                fmt::print("[SERVER] Session {} subscribed to track feed\n", from.id());
+                for (const auto& t : store_->snapshot()) {
+                    from.send_track(t);
+                }
+            }
+            if (swarm_) {
+                const auto swarms = swarm_->summaries();
+                from.send_frame(protocol::encode_swarm_batch(swarms, {}), true);
+            }
+            return control_cost;
+        
+        case protocol::wire::FrameKind::PeerHello: {
+            const auto node = protocol::replication::decode_peer_hello(frame);
+            if (!node) {
+                break;
+            }
+            from.set_peer_node(*node);
+            from.send_frame(protocol::replication::encode_peer_hello(node_id_), true);
+            fmt::print("[SERVER] Session {} is peer node {}\n", from.id(), *node);
+            return control_cost;
+        }
+        
+        case protocol::wire::FrameKind::ReplicaBatch:
+        case protocol::wire::FrameKind::ForwardBatch: {
+            if (!from.peer_node()) {
+                break;  // Only peers that introduced themselves may replicate
+            }
+            const auto ingress_ns = protocol::link::wall_clock_ns();
+            // Forwarded reports are ours now: screen them as our own ingest
+            Cluster::ScreenFn screen;
+            if (anomaly_) {
+                screen = [this](std::vector<protocol::TrackUpdate>& reports) { quarantine_tracks(reports); };
+            }
+            auto applied = cluster_->apply_replica(from, frame, screen);
+            if (!applied) {
+                fmt::print("[SERVER] Session {} sent malformed replica batch\n", from.id());
+                return control_cost;
+            }
+            from.send_frame(std::move(applied->ack), true);
+            for (const auto& t : applied->tracks) {
+                if (lifecycle_) {
+                    lifecycle_->observe(t.target_id, ingress_ns);
+                }
+                if (swarm_) {
+                    swarm_->update(t);
+                }
+                if (lod_) {
+                    lod_->update(t);
+                }
+                if (sectors_) {
+                    sectors_->update(t, ingress_ns);
+                }
+            }
+            solve_intercepts(applied->tracks, ingress_ns);
+            publish_tracks(from.id(), applied->tracks, nullptr);
+            if (applied->forwarded) {
+                cluster_->replicate(applied->tracks, applied->ingest_ns);
+            }
+            return ingest_cfg_.cost_for_records(applied->tracks);
+        }
+        
+        case protocol::wire::FrameKind::StandbyHello: {
+            const auto next_seq = protocol::shipping::decode_standby_hello(frame);
+            if (!next_seq || shippers_.contains(from.id())) {
+                break;
+            }
+            auto session = sessions_.at(from.id());
+            auto shipper = LogShipper::create(ioc_, session, journal_, *next_seq);
+            shippers_.emplace(from.id(), shipper);
+            asio::co_spawn(ioc_, [shipper]() -> asio::awaitable<void> {
+                co_await shipper->run();
+            }, asio::detached);
+            fmt::print("[SERVER] Session {} is a standby from seq {} (journal at {})\n",
+                       from.id(), *next_seq, journal_->last_seq());
+            return control_cost;
+        }
+        
+        case protocol::wire::FrameKind::JournalAck:
+            if (const auto seq = protocol::shipping::decode_journal_ack(frame)) {
+                if (auto it = shippers_.find(from.id()); it != shippers_.end()) {
+                    it->second->on_ack(*seq);
+                    return control_cost;
+                }
+            }
+            break;
+        
+        case protocol::wire::FrameKind::JournalBatch:
+            // Batches flow from primary to standby, never here
+            break;
+        
+        case protocol::wire::FrameKind::UploadBegin: {
+            const auto begin = protocol::upload::decode_upload_begin(frame);
+            if (!begin) {
+                break;
+            }
+            if (!uploads_) {
+                from.send_frame(protocol::upload::encode_upload_ack(
+                    {begin->id, 0, protocol::upload::UploadStatus::Rejected}), true);
+                return control_cost;
+            }
+            from.send_frame(protocol::upload::encode_upload_ack(uploads_->begin(*begin)), true);
+            return control_cost;
+        }
+        
+        case protocol::wire::FrameKind::UploadChunk: {
+            const auto chunk = protocol::upload::decode_upload_chunk(frame);
+            if (!chunk || !uploads_) {
+                break;
+            }
+            // Written straight from the read buffer at its offset
+            if (const auto ack = uploads_->chunk(*chunk)) {
+                from.send_frame(protocol::upload::encode_upload_ack(*ack), true);
+            }
+            return control_cost;
+        }
+        
+        case protocol::wire::FrameKind::UploadAck:
+            // Acks flow back to the uploading client, never here
+            break;
+        
+        case protocol::wire::FrameKind::RpcRequest: {
+            auto request = protocol::rpc::decode_request(frame);
+            if (!request) {
+                break;
+            }
+            if (!rpc_->admit(from.id())) {
+                from.send_frame(protocol::rpc::encode_response(
+                    request->id, protocol::rpc::RpcStatus::Busy, {}), true);
+                return control_cost;
+            }
+            // One coroutine per call: responses leave as each completes.
+            // The caller picks the body's urgency, so it buys no discount.
+            asio::co_spawn(ioc_, serve_call(sessions_.at(from.id()), std::move(*request)),
+                           asio::detached);
+            return control_cost;
+        }
+        
+        case protocol::wire::FrameKind::RpcResponse:
+            // Responses flow back to the calling client, never here
+            break;
+        
+        case protocol::wire::FrameKind::InterceptSubscribe: {
+            auto shooters = protocol::intercept::decode_subscribe(frame);
+            if (!shooters) {
+                break;
+            }
+            if (shooters->empty()) {
+                interceptors_.erase(from.id());
+                fmt::print("[SERVER] Session {} unsubscribed from intercept solutions\n", from.id());
+                return control_cost;
+            }
+            auto& solver = interceptors_.insert_or_assign(
+                from.id(), protocol::intercept::Solver{*shooters}).first->second;
+            fmt::print("[SERVER] Session {} subscribed {} shooter(s) for intercept solutions\n",
+                       from.id(), shooters->size());
+            
+            // Solutions against the hostiles already held (sent even if
+            // empty: it acknowledges the subscription)
+            auto hostile = store_->snapshot();
+            std::erase_if(hostile, [](const protocol::TrackUpdate& t) {
+                return t.urgency != protocol::Urgency::Red;
+            });
+            const auto now_ns = protocol::link::wall_clock_ns();
+            std::vector<protocol::intercept::Solution> solutions;
+            intercept_stats_.counts += solver.solve(hostile, now_ns, solutions);
+            from.send_frame(protocol::intercept::encode_solutions(solutions, now_ns), true);
+            return control_cost;
+        }
+        
+        case protocol::wire::FrameKind::InterceptBatch:
+            // Solutions flow to the subscribing client, never here
+            break;
+        
+        case protocol::wire::FrameKind::SwarmBatch:
+            // Swarm summaries flow to consoles, never here
+            break;
+        
+        case protocol::wire::FrameKind::LodSubscribe: {
+            auto sub = protocol::lod::decode_subscribe(frame);
+            if (!sub) {
+                break;
+            }
+            if (sub->zoom == protocol::lod::kUnsubscribe || !lod_) {
+                lod_views_.erase(from.id());
+                fmt::print("[SERVER] Session {} {}\n", from.id(),
+                           lod_ ? "unsubscribed from LOD tiles" : "asked for LOD tiles (disabled)");
+                return control_cost;
+            }
+            sub->zoom = lod_->level_for(sub->zoom);
+            lod_views_.insert_or_assign(from.id(), *sub);
+            
+            // Everything in view now; deltas from the next interval
+            const auto tiles = lod_->tiles(sub->zoom, sub->view);
+            std::vector<const protocol::lod::Tile*> refs;
+            refs.reserve(tiles.size());
+            for (const auto& t : tiles) {
+                refs.push_back(&t);
+            }
+            from.send_frame(protocol::lod::encode_tiles(sub->zoom, refs), true);
+            fmt::print("[SERVER] Session {} subscribed to LOD zoom {} ({} tiles in view)\n",
+                       from.id(), static_cast<unsigned>(sub->zoom), tiles.size());
+            return control_cost;
+        }
+        
+        case protocol::wire::FrameKind::LodBatch:
+            // Tiles flow to LOD subscribers, never here
+            break;
+        
+        case protocol::wire::FrameKind::TrackDrop:
+            // Drops flow to subscribed consoles, never here
+            break;
+        
+        case protocol::wire::FrameKind::QuarantineBatch:
+            // Quarantined reports flow to subscribed consoles, never here
+            break;
+        
+        case protocol::wire::FrameKind::SectorQuery: {
+            const auto query = protocol::sector::decode_query(frame);
+            if (!query) {
+                break;
+            }
+            if (query->mode == protocol::sector::Mode::Unsubscribe || !sectors_) {
+                sector_views_.erase(from.id());
+                fmt::print("[SERVER] Session {} {}\n", from.id(),
+                           sectors_ ? "unsubscribed from sector statistics" : "asked for sector statistics (disabled)");
+                return control_cost;
+            }
+            if (query->mode == protocol::sector::Mode::Subscribe) {
+                sector_views_.insert_or_assign(from.id(), query->area);
+            }
+            const auto report = sectors_->report(query->area, protocol::link::wall_clock_ns());
+            from.send_frame(protocol::sector::encode_report(report), true);
+            ++sector_reports_sent_;
+            fmt::print("[SERVER] Session {} {} sector statistics ({} sectors in area)\n", from.id(),
+                       query->mode == protocol::sector::Mode::Subscribe ? "subscribed to" : "queried",
+                       report.sectors.size());
+            return control_cost;
+        }
+        
+        case protocol::wire::FrameKind::SectorReport:
+            // Reports flow to the querying session, never here
+            break;
+        
+        case protocol::wire::FrameKind::TrackSnapshot:
+            // Snapshots flow to mirroring consoles, never here
+            break;
+        
+        case protocol::wire::FrameKind::CpaAlert:
+            // Alerts flow to subscribed consoles, never here
+            break;
+        
+        case protocol::wire::FrameKind::Probe:
+            // Probes travel as ping/pong payloads only
+            break;
+        
+        case protocol::wire::FrameKind::ReplicaAck:
+            // Acks flow back to the replicating node's WSClient, never here
+            break;
+    }
+    
+    fmt::print("[SERVER] Session {} sent unexpected frame kind {}\n",
+               from.id(), static_cast<unsigned>(header->kind));
+    return control_cost;
+}
+
+auto WSServer::track_view() -> std::shared_ptr<const TrackView> {
+    if (!track_view_ || journal_->last_seq() != track_view_seq_) {
+        track_view_ = std::make_shared<const TrackView>(store_->snapshot());
+        track_view_seq_ = journal_->last_seq();
+    }
+    return track_view_;
+}
+
+auto WSServer::serve_call(std::shared_ptr<Session> session, protocol::rpc::Request request)
+    -> asio::awaitable<void>
+{
+    auto view = track_view();  // Named: GCC 12 can destroy co_await operand temporaries twice
+    const auto response = co_await rpc_->call(std::move(request), std::move(view));
+    rpc_->release(session->id());
+    
+    if (session->is_open()) {
+        session->send_frame(protocol::rpc::encode_response(response.id, response.status, response.body),
+                            true);
+    }
+}
+
+void WSServer::ingest_tracks(std::uint64_t from_session,
+                             std::span<const protocol::TrackUpdate> tracks,
+                             const std::shared_ptr<const protocol::LatencyTrace>& trace,
+                             std::int64_t ingest_ns) {
+    // Targets owned elsewhere (sharded cluster) go to their owner
+    auto owned = cluster_->route(tracks, ingest_ns);
+    if (anomaly_) {
+        quarantine_tracks(owned);
+    }
+    // Only what the store took goes on: a stale report must reach neither
+    // subscribers nor peers
+    std::erase_if(owned, [&](const protocol::TrackUpdate& t) {
+        return !store_->apply(t, node_id_, 0, ingest_ns);
+    });
+    for (const auto& t : owned) {
+        if (lifecycle_) {
+            lifecycle_->observe(t.target_id, ingest_ns);
+        }
+        if (swarm_) {
+            swarm_->update(t);
+        }
+        if (lod_) {
+            lod_->update(t);
+        }
+        if (sectors_) {
+            sectors_->update(t, ingest_ns);
+        }
+    }
+    // Solutions first: update-to-solution latency is what shooters wait on
+    solve_intercepts(owned, ingest_ns);
+    publish_tracks(from_session, owned, trace);
+    cluster_->replicate(owned, ingest_ns);
+}
+
+void WSServer::quarantine_tracks(std::vector<protocol::TrackUpdate>& reports) {
+    anomaly_counts_ += anomaly_->check(reports, anomaly_flags_);
+    
+    std::vector<protocol::Suspect> suspects;
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < reports.size(); ++i) {
+        if (anomaly_flags_[i] == 0) {
+            reports[kept++] = reports[i];
+            continue;
+        }
+        auto raised = reports[i];
+        raised.urgency = protocol::Urgency::Red;
+        suspects.push_back(protocol::Suspect{raised, anomaly_flags_[i]});
+    }
+    if (suspects.empty()) {
+        return;
+    }
+    reports.resize(kept);
+    
+    ++quarantine_batches_;
+    const auto frame = protocol::encode_quarantine(suspects);
+    for (auto& [id, session] : sessions_) {
+        if (session->subscribed() && session->is_open()) {
+            session->send_frame(frame, true);
+        }
+    }
+}
+
+void WSServer::solve_intercepts(std::span<const protocol::TrackUpdate> tracks, std::int64_t ingress_ns) {
+    if (interceptors_.empty()) {
+        return;
+    }
+    std::vector<protocol::TrackUpdate> hostile;
+    for (const auto& t : tracks) {
+        if (t.urgency == protocol::Urgency::Red) {
+            hostile.push_back(t);
+        }
+    }
+    if (hostile.empty()) {
+        return;
+    }
+    
+    const auto now_ns = protocol::link::wall_clock_ns();
+    std::vector<protocol::intercept::Solution> solutions;
+    for (auto& [id, solver] : interceptors_) {
+        const auto it = sessions_.find(id);
+        if (it == sessions_.end() || !it->second->is_open()) {
+            continue;
+        }
+        solutions.clear();
+        intercept_stats_.counts += solver.solve(hostile, now_ns, solutions);
+        if (solutions.empty()) {
+            continue;
+        }
+        it->second->send_frame(protocol::intercept::encode_solutions(solutions, now_ns), true);
+        ++intercept_stats_.batches;
+        intercept_stats_.latency.record(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::nanoseconds{protocol::link::wall_clock_ns() - ingress_ns}));
+    }
+}
+
+void WSServer::publish_tracks(std::uint64_t from_session,
+                              std::span<const protocol::TrackUpdate> tracks,
+                              const std::shared_ptr<const protocol::LatencyTrace>& trace) {
+    for (auto& [id, session] : sessions_) {
+        if (id == from_session || !session->subscribed()) {
+            continue;
+        }
+        for (const auto& t : tracks) {
+            session->send_track(t, trace);
+        }
+    }
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TELEMETRY
+// ═══════════════════════════════════════════════════════════════════════════
+
+auto WSServer::standby_report() const -> std::vector<StandbyReport> {
+    std::vector<StandbyReport> out;
+    out.reserve(shippers_.size());
+    for (const auto& [id, shipper] : shippers_) {
+        out.push_back(shipper->report());
+    }
+    return out;
+}
+
+auto WSServer::dedup_report() const -> std::vector<DedupReport> {
+    std::vector<DedupReport> out;
+    out.reserve(dedup_origins_.size());
+    for (const auto& [source, counts] : dedup_origins_) {
+        out.push_back(DedupReport{source, counts});
+    }
+    return out;
+}
+
+auto WSServer::link_report() const -> std::vector<SessionLink> {
+    std::vector<SessionLink> out;
+    out.reserve(sessions_.size());
+    for (const auto& [id, session] : sessions_) {
+        out.push_back(SessionLink{id, session->source(), session->link_stats(), session->rate_state()});
+    }
+    return out;
+}
+
+
+// ═══════════════════════════════════════════════════════════════════════════
+// INGEST LIMITING
+// ═══════════════════════════════════════════════════════════════════════════
+
+auto WSServer::acquire_source_limiter(const std::string& source) -> SourceLimiter {
+    prune_source_limiters(std::chrono::steady_clock::now());
+
+    auto& limiter = source_limiters_[source];
+    if (!limiter) {
+        limiter = std::make_shared<protocol::ratelimit::SteadyIngestLimiter>(
+            protocol::ratelimit::SteadyIngestLimiter::for_source(ingest_cfg_)
+        );
+    }
+    return limiter;
+}
+
+void WSServer::release_source_limiter(const std::string& /*source*/, SourceLimiter& limiter) {
+    limiter.reset();
+    prune_source_limiters(std::chrono::steady_clock::now());
+}
+
+void WSServer::prune_source_limiters(std::chrono::steady_clock::time_point now) {
+    // A limiter still in debt outlives its sessions, so reconnecting does
+    // not buy a fresh budget; it is forgotten only once fully refilled.
+    std::erase_if(source_limiters_, [now](auto& entry) {
+        return entry.second.use_count() == 1 && entry.second->idle(now);
+    });
 }
 
 